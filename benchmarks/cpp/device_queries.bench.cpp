@@ -0,0 +1,146 @@
+#include "vk_tut/queue_family.h"
+#include "vk_tut/swapchain_support.h"
+
+#include <benchmark/benchmark.h>
+#include <vulkan/vulkan.h>
+#include <cstring>
+#include <vector>
+
+namespace vk::tut {
+    // A Vulkan instance with the first physical device, and a headless
+    // surface when VK_EXT_headless_surface is available, so that the
+    // queries run without a window.
+    class BenchmarkDevice final {
+    public:
+        // Creates the instance, then finds the device and the surface.
+        BenchmarkDevice() {
+            uint32_t extension_count = 0;
+            vkEnumerateInstanceExtensionProperties(
+                nullptr, &extension_count, nullptr
+            );
+            ::std::vector<VkExtensionProperties> extensions(extension_count);
+            vkEnumerateInstanceExtensionProperties(
+                nullptr, &extension_count, extensions.data()
+            );
+            bool headless_surface_supported = false;
+            for (const VkExtensionProperties& extension : extensions) {
+                if (::std::strcmp(extension.extensionName,
+                VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME) == 0) {
+                    headless_surface_supported = true;
+                }
+            }
+            const ::std::vector<const char*> enabled_extensions = {
+                VK_KHR_SURFACE_EXTENSION_NAME,
+                VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME
+            };
+
+            VkInstanceCreateInfo instance_info{};
+            instance_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+            if (headless_surface_supported) {
+                instance_info.enabledExtensionCount =
+                    static_cast<uint32_t>(enabled_extensions.size());
+                instance_info.ppEnabledExtensionNames =
+                    enabled_extensions.data();
+            }
+            if (vkCreateInstance(&instance_info, nullptr, &m_instance) !=
+            VkResult::VK_SUCCESS) {
+                m_instance = VK_NULL_HANDLE;
+                return;
+            }
+
+            uint32_t device_count = 1;
+            vkEnumeratePhysicalDevices(
+                m_instance, &device_count, &m_physical_device
+            );
+            if (device_count == 0) m_physical_device = VK_NULL_HANDLE;
+
+            if (!headless_surface_supported) return;
+            auto create_headless_surface =
+                reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+                    vkGetInstanceProcAddr(
+                        m_instance, "vkCreateHeadlessSurfaceEXT"
+                    )
+                );
+            VkHeadlessSurfaceCreateInfoEXT surface_info{};
+            surface_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+            if (create_headless_surface == nullptr ||
+            create_headless_surface(m_instance, &surface_info, nullptr,
+            &m_surface) != VkResult::VK_SUCCESS) {
+                m_surface = VK_NULL_HANDLE;
+            }
+        }
+        // Destroys the surface and the instance.
+        ~BenchmarkDevice() {
+            if (m_instance == VK_NULL_HANDLE) return;
+
+            if (m_surface != VK_NULL_HANDLE) {
+                vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+            }
+            vkDestroyInstance(m_instance, nullptr);
+        }
+
+        // Prevent copying.
+        inline BenchmarkDevice(const BenchmarkDevice&) = delete;
+        // Prevent copy re-assignment.
+        inline BenchmarkDevice& operator= (const BenchmarkDevice&) = delete;
+
+        // The device shared by the benchmarks.
+        static BenchmarkDevice& get_instance() {
+            static BenchmarkDevice device;
+            return device;
+        }
+
+        // The instance.
+        VkInstance m_instance = VK_NULL_HANDLE;
+        // The first physical device. Null if there is none.
+        VkPhysicalDevice m_physical_device = VK_NULL_HANDLE;
+        // The headless surface. Null if it is not supported.
+        VkSurfaceKHR m_surface = VK_NULL_HANDLE;
+    };
+
+    // Finding the queue families, as done for each device considered
+    // and again when creating objects bound to a family. The range
+    // selects a null surface (0) or the headless surface (1).
+    static void BM_find_family_indices(::benchmark::State& state) {
+        const BenchmarkDevice& device = BenchmarkDevice::get_instance();
+        if (device.m_physical_device == VK_NULL_HANDLE) {
+            state.SkipWithError("No Vulkan physical device.");
+            return;
+        }
+        if (state.range(0) == 1 && device.m_surface == VK_NULL_HANDLE) {
+            state.SkipWithError("No headless surface support.");
+            return;
+        }
+        const VkSurfaceKHR surface =
+            state.range(0) == 1 ? device.m_surface : VK_NULL_HANDLE;
+
+        for (auto _ : state) {
+            QueueFamilyIndices indices = find_family_indices(
+                device.m_physical_device, surface
+            );
+            ::benchmark::DoNotOptimize(indices);
+        }
+    }
+    BENCHMARK(BM_find_family_indices)->Arg(0)->Arg(1);
+
+    // Querying the surface capabilities, formats and present modes,
+    // as done on each swapchain recreation.
+    static void BM_query_swapchain_support(::benchmark::State& state) {
+        const BenchmarkDevice& device = BenchmarkDevice::get_instance();
+        if (device.m_physical_device == VK_NULL_HANDLE ||
+        device.m_surface == VK_NULL_HANDLE) {
+            state.SkipWithError("No Vulkan device with a headless surface.");
+            return;
+        }
+
+        for (auto _ : state) {
+            SwapChainSupportDetails details = query_swapchain_support(
+                device.m_physical_device, device.m_surface
+            );
+            ::benchmark::DoNotOptimize(details);
+        }
+    }
+    BENCHMARK(BM_query_swapchain_support);
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "vk_tut/application.h"
+#include "vk_tut/frame_statistics.h"
+#include "vk_tut/scene_generator.h"
+
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <string>
+
+namespace vk::tut {
+    // The name of the device the frame benchmarks render with. Defaults
+    // to lavapipe, the software rasterizer of Mesa, which reports itself
+    // as llvmpipe. It needs no GPU, so the numbers are comparable between
+    // commits and machines. VK_TUT_BENCH_DEVICE picks another device,
+    // and set but empty picks the first suitable one.
+    static ::std::string get_benchmark_device_name() {
+        const char* device_name = ::std::getenv("VK_TUT_BENCH_DEVICE");
+        return device_name == nullptr ? "llvmpipe" : device_name;
+    }
+
+    // The options of a windowless renderer drawing the colour wheel
+    // made of triangle_count triangles for frame_count frames.
+    static ApplicationConfig get_headless_config(
+        const uint32_t& triangle_count, const uint32_t& frame_count
+    ) {
+        ApplicationConfig config;
+        config.set_headless(true);
+        config.set_device_name(get_benchmark_device_name());
+        config.set_mesh_triangle_count(triangle_count);
+        config.set_frame_count(frame_count);
+        // Software rendering hitches all the time. Don't log each one.
+        config.set_hitch_threshold_ms(0.0f);
+        return config;
+    }
+
+    // Creating the renderer and rendering a single frame, until the GPU
+    // has finished it. Covers instance and device creation, pipeline
+    // creation and the uploads of the mesh and texture.
+    static void BM_headless_time_to_first_frame(::benchmark::State& state) {
+        const ApplicationConfig config = get_headless_config(1000, 1);
+
+        for (auto _ : state) {
+            ::std::unique_ptr<Application> ptr_app;
+            try {
+                ptr_app = ::std::make_unique<Application>(config);
+                ptr_app->run();
+            }
+            catch (const ::std::exception& ex) {
+                state.SkipWithError(ex.what());
+                return;
+            }
+
+            // Tearing down is not part of the first frame.
+            state.PauseTiming();
+            ptr_app.reset();
+            state.ResumeTiming();
+        }
+    }
+    BENCHMARK(BM_headless_time_to_first_frame)
+        ->Unit(::benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+
+    // Renders config.get_frame_count() frames with the full Vulkan path,
+    // of the scene of ptr_scene_parameters if not nullptr. Reports the
+    // frames per second, and the median CPU time of each draw_frame
+    // stage in microseconds, averaged over the iterations.
+    static void run_headless_frames(
+        ::benchmark::State& state, const ApplicationConfig& config,
+        const SceneGenerator::Parameters* ptr_scene_parameters = nullptr
+    ) {
+        const uint32_t frame_count = config.get_frame_count();
+
+        // The sum of the median of each metric over the iterations.
+        ::std::array<double, static_cast<size_t>(FrameMetric::COUNT)>
+            median_sums{};
+        // Whether each metric got values.
+        ::std::array<bool, static_cast<size_t>(FrameMetric::COUNT)>
+            recorded{};
+        for (auto _ : state) {
+            // Only the frames are timed.
+            state.PauseTiming();
+            ::std::unique_ptr<Application> ptr_app;
+            try {
+                ptr_app = ::std::make_unique<Application>(config);
+                if (ptr_scene_parameters != nullptr) {
+                    ptr_app->load_scene(*ptr_scene_parameters);
+                }
+            }
+            catch (const ::std::exception& ex) {
+                state.SkipWithError(ex.what());
+                return;
+            }
+            state.ResumeTiming();
+
+            ptr_app->run();
+
+            state.PauseTiming();
+            for (size_t i = 0; i < median_sums.size(); i++) {
+                const FrameStatistics::Summary summary =
+                    ptr_app->get_frame_statistics().get_total_summary(
+                        static_cast<FrameMetric>(i)
+                    );
+                median_sums[i] += static_cast<double>(summary.p50);
+                recorded[i] = recorded[i] || summary.count > 0;
+            }
+            ptr_app.reset();
+            state.ResumeTiming();
+        }
+
+        state.counters["fps"] = ::benchmark::Counter(
+            static_cast<double>(state.iterations() * frame_count),
+            ::benchmark::Counter::kIsRate
+        );
+        // The whole frame on the CPU and GPU, then each draw_frame stage.
+        // Stages a frame doesn't go through, such as presenting
+        // in headless mode, have no values and are left out.
+        for (uint32_t i = static_cast<uint32_t>(FrameMetric::CPU_FRAME_TIME);
+        i <= static_cast<uint32_t>(FrameMetric::PRESENT_TIME); i++) {
+            if (recorded[i]) {
+                const char* name =
+                    get_frame_metric_name(static_cast<FrameMetric>(i));
+                state.counters[name] = ::benchmark::Counter(
+                    median_sums[i], ::benchmark::Counter::kAvgIterations
+                );
+            }
+        }
+    }
+
+    // Rendering frames of the colour wheel. The first range is the
+    // number of triangles, the second the number of frames.
+    static void BM_headless_frames(::benchmark::State& state) {
+        run_headless_frames(state, get_headless_config(
+            static_cast<uint32_t>(state.range(0)),
+            static_cast<uint32_t>(state.range(1))
+        ));
+    }
+    BENCHMARK(BM_headless_frames)
+        ->Args({1000, 100})->Args({100000, 100})
+        ->Unit(::benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+
+    // Rendering frames of a synthetic scene of spinning objects. The
+    // first range is the number of objects, the second the most objects
+    // one draw draws, so 1 issues a draw per object and the rest show
+    // what instancing saves.
+    static void BM_headless_scene(::benchmark::State& state) {
+        SceneGenerator::Parameters parameters;
+        parameters.object_count = static_cast<uint32_t>(state.range(0));
+        parameters.instances_per_draw = static_cast<uint32_t>(state.range(1));
+        parameters.mesh_count = 6;
+        parameters.texture_count = 4;
+
+        run_headless_frames(state, get_headless_config(1000, 50), &parameters);
+    }
+    BENCHMARK(BM_headless_scene)
+        ->Args({1000, 1})->Args({1000, 1000})
+        ->Args({10000, 1})->Args({10000, 10000})
+        ->Unit(::benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "vk_tut/job_system.h"
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace vk::tut {
+    // Round trip of scheduling a batch of empty jobs and waiting on them.
+    static void BM_run_and_wait(::benchmark::State& state) {
+        JobSystem job_system(static_cast<uint32_t>(state.range(1)));
+        const int64_t job_count = state.range(0);
+
+        for (auto _ : state) {
+            JobCounter counter;
+            for (int64_t i = 0; i < job_count; i++) {
+                job_system.run([]() {}, &counter);
+            }
+            job_system.wait(counter);
+        }
+        state.SetItemsProcessed(state.iterations() * job_count);
+    }
+    BENCHMARK(BM_run_and_wait)
+        ->ArgsProduct({{1, 64, 1024}, {1, 3, 7}})
+        ->UseRealTime();
+
+    // Jobs spawning jobs, scheduled to the deques of the workers.
+    static void BM_nested_run(::benchmark::State& state) {
+        JobSystem job_system(static_cast<uint32_t>(state.range(0)));
+
+        for (auto _ : state) {
+            JobCounter counter;
+            for (int i = 0; i < 32; i++) {
+                job_system.run([&]() {
+                    for (int j = 0; j < 32; j++) {
+                        job_system.run([]() {}, &counter);
+                    }
+                }, &counter);
+            }
+            job_system.wait(counter);
+        }
+        state.SetItemsProcessed(state.iterations() * 32 * 33);
+    }
+    BENCHMARK(BM_nested_run)->Arg(1)->Arg(3)->Arg(7)->UseRealTime();
+
+    // parallel_for over a cheap body, for the overhead per range.
+    static void BM_parallel_for(::benchmark::State& state) {
+        JobSystem job_system(3);
+        ::std::vector<float> values(1 << 20, 1.0f);
+        const size_t grain_size = static_cast<size_t>(state.range(0));
+
+        for (auto _ : state) {
+            job_system.parallel_for(values.size(), grain_size,
+            [&values](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) values[i] *= 1.0001f;
+            });
+            ::benchmark::DoNotOptimize(values.data());
+        }
+        state.SetItemsProcessed(state.iterations() * values.size());
+    }
+    BENCHMARK(BM_parallel_for)
+        ->RangeMultiplier(8)->Range(256, 1 << 17)->UseRealTime();
+
+    // Owner push and pop without contention.
+    static void BM_deque_push_pop(::benchmark::State& state) {
+        WorkStealingDeque deque(1024);
+        Job job([]() {}, nullptr);
+
+        for (auto _ : state) {
+            deque.push(&job);
+            ::benchmark::DoNotOptimize(deque.pop());
+        }
+    }
+    BENCHMARK(BM_deque_push_pop);
+
+    // Stealing from a deque kept full by the owner.
+    static void BM_deque_steal(::benchmark::State& state) {
+        static ::std::unique_ptr<WorkStealingDeque> s_ptr_deque;
+        static Job s_job([]() {}, nullptr);
+        if (state.thread_index() == 0) {
+            s_ptr_deque = ::std::make_unique<WorkStealingDeque>(1 << 16);
+        }
+
+        for (auto _ : state) {
+            if (state.thread_index() == 0) {
+                if (!s_ptr_deque->push(&s_job)) s_ptr_deque->pop();
+            }
+            else {
+                ::benchmark::DoNotOptimize(s_ptr_deque->steal());
+            }
+        }
+    }
+    BENCHMARK(BM_deque_steal)->Threads(2)->Threads(4)->UseRealTime();
+}
+
+BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "vk_tut/logging.h"
+
+#include <benchmark/benchmark.h>
+#include <ostream>
+
+namespace vk::tut {
+    // Logging a formatted message, as draw_frame would. The messages go
+    // to a stream that discards them. The thread flushes every half
+    // ring, so the cost of writing them out is included, and nothing is
+    // dropped no matter how fast the loop runs.
+    static void BM_log_message(::benchmark::State& state) {
+        ::std::ostream null_stream(nullptr);
+
+        uint32_t i = 0;
+        for (auto _ : state) {
+            VK_TUT_LOG(DEBUG, \033[0;96m, null_stream,
+                "Frame " << i << " took " << 16.6f << " ms.");
+            if (++i % (Logger::RECORDS_PER_THREAD / 2) == 0) {
+                Logger::get_instance().flush();
+            }
+        }
+        Logger::get_instance().flush();
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_log_message);
+
+    // Logging a message below the level of the logger.
+    static void BM_log_filtered_message(::benchmark::State& state) {
+        ::std::ostream null_stream(nullptr);
+        Logger::get_instance().set_level(LogLevel::ERROR);
+
+        uint32_t i = 0;
+        for (auto _ : state) {
+            VK_TUT_LOG(DEBUG, \033[0;96m, null_stream,
+                "Frame " << i << " took " << 16.6f << " ms.");
+            ::benchmark::DoNotOptimize(++i);
+        }
+        Logger::get_instance().set_level(LogLevel::TRACE);
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_log_filtered_message);
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#include "vk_tut/mesh.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace vk::tut {
+    // Generating the colour wheel of load_initial_mesh
+    // at different triangle counts.
+    static void BM_generate_colour_wheel_mesh(::benchmark::State& state) {
+        const uint32_t triangle_count = static_cast<uint32_t>(state.range(0));
+
+        for (auto _ : state) {
+            ::std::vector<Vertex> vertices;
+            ::std::vector<uint32_t> indices;
+            generate_colour_wheel_mesh(triangle_count, vertices, indices);
+            ::benchmark::DoNotOptimize(vertices.data());
+            ::benchmark::DoNotOptimize(indices.data());
+        }
+        state.SetItemsProcessed(state.iterations() * triangle_count);
+    }
+    BENCHMARK(BM_generate_colour_wheel_mesh)
+        ->RangeMultiplier(10)->Range(10, 1000000);
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "vk_tut/scene_generator.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace vk::tut {
+    // Generating the scenes of load_scene at different object counts.
+    static void BM_generate_scene(::benchmark::State& state) {
+        SceneGenerator::Parameters parameters;
+        parameters.object_count = static_cast<uint32_t>(state.range(0));
+        const SceneGenerator generator(parameters);
+
+        for (auto _ : state) {
+            ::std::vector<Vertex> vertices;
+            ::std::vector<uint32_t> indices;
+            ::std::vector<DrawCommand> draw_commands;
+            ::std::vector<InstanceTransform> instances;
+            generator.generate(
+                {0}, vertices, indices, draw_commands, instances
+            );
+            ::benchmark::DoNotOptimize(instances.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(BM_generate_scene)->RangeMultiplier(10)->Range(100, 100000);
+
+    // Animating the instances of a scene, as done every frame.
+    static void BM_animate_scene(::benchmark::State& state) {
+        SceneGenerator::Parameters parameters;
+        parameters.object_count = static_cast<uint32_t>(state.range(0));
+        const SceneGenerator generator(parameters);
+        ::std::vector<Vertex> vertices;
+        ::std::vector<uint32_t> indices;
+        ::std::vector<DrawCommand> draw_commands;
+        ::std::vector<InstanceTransform> instances;
+        generator.generate({0}, vertices, indices, draw_commands, instances);
+
+        ::std::vector<InstanceTransform> animated(instances.size());
+        float time = 0.0f;
+        for (auto _ : state) {
+            generator.animate(time, instances, animated.data());
+            ::benchmark::DoNotOptimize(animated.data());
+            time += 1.0f / 60.0f;
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0) *
+            static_cast<int64_t>(sizeof(InstanceTransform)));
+    }
+    BENCHMARK(BM_animate_scene)->RangeMultiplier(10)->Range(100, 100000);
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "vk_tut/shader_parser.h"
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace vk::tut {
+    // Reading whole files, as done for each shader module.
+    static void BM_get_file_data(::benchmark::State& state) {
+        const size_t file_size = static_cast<size_t>(state.range(0));
+        const ::std::string filepath = (
+            ::std::filesystem::temp_directory_path() /
+            ("vk_tut_bench_" + ::std::to_string(file_size))
+        ).string();
+        {
+            ::std::ofstream file(filepath, ::std::ios::binary);
+            const file_data_t data(file_size, 'v');
+            file.write(data.data(), static_cast<::std::streamsize>(file_size));
+        }
+
+        for (auto _ : state) {
+            file_data_t data = get_file_data(filepath);
+            ::benchmark::DoNotOptimize(data.data());
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+
+        ::std::filesystem::remove(filepath);
+    }
+    BENCHMARK(BM_get_file_data)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+}
\ No newline at end of file
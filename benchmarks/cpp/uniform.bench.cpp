@@ -0,0 +1,18 @@
+#include "vk_tut/uniform.h"
+
+#include <benchmark/benchmark.h>
+
+namespace vk::tut {
+    // Constructing the uniform data, as done each frame.
+    static void BM_uniform_construct(::benchmark::State& state) {
+        const ::glm::mat4 model(1.0f);
+        const ::glm::mat4 view(2.0f);
+        const ::glm::mat4 projection(3.0f);
+
+        for (auto _ : state) {
+            Uniform uniform(model, view, projection);
+            ::benchmark::DoNotOptimize(uniform);
+        }
+    }
+    BENCHMARK(BM_uniform_construct);
+}
\ No newline at end of file
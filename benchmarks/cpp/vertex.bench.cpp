@@ -0,0 +1,49 @@
+#include "vk_tut/vertex.h"
+
+#include <benchmark/benchmark.h>
+#include <utility>
+#include <vector>
+
+namespace vk::tut {
+    // Constructing a vertex from its attributes.
+    static void BM_vertex_construct(::benchmark::State& state) {
+        const ::glm::vec3 position(0.5f, 0.25f, -0.4f);
+        const ::glm::vec3 colour(1.0f, 0.5f, 0.0f);
+        const ::glm::vec2 texture_coordinate(0.5f, 0.5f);
+
+        for (auto _ : state) {
+            Vertex vertex(position, colour, texture_coordinate);
+            ::benchmark::DoNotOptimize(vertex);
+        }
+    }
+    BENCHMARK(BM_vertex_construct);
+
+    // Copying a vertex.
+    static void BM_vertex_copy(::benchmark::State& state) {
+        const Vertex vertex({0.5f, 0.25f, -0.4f}, {1.0f, 0.5f, 0.0f}, {});
+
+        for (auto _ : state) {
+            Vertex copy(vertex);
+            ::benchmark::DoNotOptimize(copy);
+        }
+    }
+    BENCHMARK(BM_vertex_copy);
+
+    // Copying a vertex array, as done when filling the mesh buffer.
+    static void BM_vertex_array_copy(::benchmark::State& state) {
+        const ::std::vector<Vertex> vertices(
+            static_cast<size_t>(state.range(0)),
+            Vertex({0.5f, 0.25f, -0.4f}, {1.0f, 0.5f, 0.0f}, {})
+        );
+
+        for (auto _ : state) {
+            ::std::vector<Vertex> copy(vertices);
+            ::benchmark::DoNotOptimize(copy.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.SetBytesProcessed(
+            state.iterations() * state.range(0) * sizeof(Vertex)
+        );
+    }
+    BENCHMARK(BM_vertex_array_copy)->RangeMultiplier(16)->Range(16, 1 << 16);
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#if !defined(_VK_TUT_ALLOCATION_TRACKER_HEADER_)
+#define _VK_TUT_ALLOCATION_TRACKER_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vk::tut {
+    // Counts the heap allocations of every thread, in total and per call
+    // site. The sites are the innermost trace scopes of the allocating
+    // threads, so VK_TUT_TRACE_SCOPE also names where allocations happen.
+    // Telling sites apart needs the trace scopes compiled in, which they
+    // are in debug builds or with VK_TUT_TRACE. Otherwise every
+    // allocation is counted under "unscoped".
+    //
+    // The library never counts on its own. A binary that wants counts
+    // replaces the global operator new with one calling record(), as the
+    // allocation unit tests do, and turns counting on around the code it
+    // checks.
+    // Never allocates, as it is called from within operator new.
+    class AllocationTracker final {
+    public:
+        // The allocations made from one call site.
+        struct Site {
+            // The name of the trace scope, or "unscoped".
+            const char* name = nullptr;
+            // The number of allocations.
+            uint64_t count = 0;
+            // The number of bytes allocated.
+            uint64_t bytes = 0;
+        };
+
+        // Prevent copying.
+        inline AllocationTracker(const AllocationTracker&) = delete;
+        // Prevent copy re-assignment.
+        inline AllocationTracker& operator= (const AllocationTracker&) = delete;
+
+        // The tracker shared by every thread.
+        static AllocationTracker& get_instance();
+
+        // Counts an allocation of the calling thread, if counting.
+        void record(const size_t& size);
+
+        // Whether allocations are counted.
+        inline bool is_counting() const
+        { return m_is_counting.load(::std::memory_order_relaxed); }
+        // Starts or stops counting. The counts are kept.
+        void set_counting(const bool& counting);
+        // Forgets every count.
+        void reset();
+
+        // The number of allocations counted.
+        inline uint64_t get_count() const
+        { return m_count.load(::std::memory_order_relaxed); }
+        // The number of bytes allocated.
+        inline uint64_t get_bytes() const
+        { return m_bytes.load(::std::memory_order_relaxed); }
+        // Appends the sites that allocated, most allocations first.
+        // Stop counting first, or the copy counts itself.
+        void get_sites(::std::vector<Site>& ref_sites) const;
+
+        // The number of call sites told apart. Allocations from
+        // further sites are counted under "other sites".
+        static constexpr uint32_t MAX_SITES = 128;
+
+    private:
+        // Only created by get_instance().
+        constexpr AllocationTracker() {}
+
+        // A site as counted. Claimed by the first allocation from it.
+        struct SiteSlot {
+            // The name of the site, or nullptr while unclaimed.
+            ::std::atomic<const char*> name{nullptr};
+            // The number of allocations.
+            ::std::atomic<uint64_t> count{0};
+            // The number of bytes allocated.
+            ::std::atomic<uint64_t> bytes{0};
+        };
+
+        // The slot of a site, claiming one if the site is new.
+        SiteSlot& find_site(const char* name);
+
+        // Whether allocations are counted.
+        ::std::atomic<bool> m_is_counting{false};
+        // The number of allocations counted.
+        ::std::atomic<uint64_t> m_count{0};
+        // The number of bytes allocated.
+        ::std::atomic<uint64_t> m_bytes{0};
+        // The sites, as an open addressing hash table keyed by the
+        // address of the name. The last slot takes the overflow.
+        ::std::array<SiteSlot, MAX_SITES + 1> m_sites;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
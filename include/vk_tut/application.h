@@ -14,6 +14,24 @@
 #endif
 
 #include "vk_tut/vertex.h"
+#include "vk_tut/resource_state.h"
+#include "vk_tut/deletion_queue.h"
+#include "vk_tut/descriptor_allocator.h"
+#include "vk_tut/descriptor_set_contents.h"
+#include "vk_tut/draw_command.h"
+#include "vk_tut/instance_transform.h"
+#include "vk_tut/scene_generator.h"
+#include "vk_tut/job_system.h"
+#include "vk_tut/application_config.h"
+#include "vk_tut/render_graph.h"
+#include "vk_tut/readback_ring.h"
+#include "vk_tut/readback_writer.h"
+#include "vk_tut/gpu_profiler.h"
+#include "vk_tut/pipeline_statistics.h"
+#include "vk_tut/trace.h"
+#include "vk_tut/frame_statistics.h"
+#include "vk_tut/frame_arena.h"
+#include "vk_tut/debug_draw.h"
 
 // C++ only region.
 #if defined(__cplusplus)
@@ -21,6 +39,8 @@
 #include <vulkan/vulkan.h>
 #include <GLFW/glfw3.h>
 #include <vector>
+#include <memory>
+#include <chrono>
 
 namespace vk::tut {
     // Vulkan application data encapsulation.
@@ -28,11 +48,30 @@ namespace vk::tut {
     public:
         // Default constructor.
         Application();
+        // Creates the application with the given options.
+        Application(const ApplicationConfig& config);
         // Code cleanup.
         ~Application();
 
         // Runs the application loop.
         void run();
+        // Replaces everything drawn by a scene generated as described,
+        // along with its textures. Waits for the frames in flight.
+        void load_scene(const SceneGenerator::Parameters& parameters);
+
+        // Getter for m_dynamic_scene.
+        inline bool get_dynamic_scene() const { return m_dynamic_scene; }
+        // Copy setter for m_dynamic_scene.
+        void set_dynamic_scene(const bool&);
+        // Getter for m_gpu_profiler.
+        inline const GpuProfiler& get_gpu_profiler() const
+        { return m_gpu_profiler; }
+        // Getter for m_frame_statistics.
+        inline const FrameStatistics& get_frame_statistics() const
+        { return m_frame_statistics; }
+        // Getter for m_debug_draw. The primitives added are drawn
+        // with the next frame, then forgotten.
+        inline DebugDraw& get_debug_draw() { return m_debug_draw; }
 
         // Prevent copying.
         inline constexpr Application(const Application&) = delete;
@@ -44,6 +83,9 @@ namespace vk::tut {
         inline constexpr Application& operator=(Application&&) = delete;
     
     private:
+        // The options the application was created with.
+        ApplicationConfig m_config;
+
         // GLFW Window constants.
         const uint32_t WINDOW_WIDTH = 900, WINDOW_HEIGHT = 600;
         const char* WINDOW_TITLE = "Vulkan Tutorial Sandbox";
@@ -75,33 +117,91 @@ namespace vk::tut {
         // The graphics queue handle.
         VkQueue m_graphics_queue;
         // List of enabled device extensions.
-        const ::std::vector<const char*> m_enabled_extensions = {
-            VK_KHR_SWAPCHAIN_EXTENSION_NAME
+        // The swapchain extension is dropped in headless mode.
+        ::std::vector<const char*> m_enabled_extensions = {
+            VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+            VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME
         };
+        // vkCmdPipelineBarrier2KHR from VK_KHR_synchronization2.
+        PFN_vkCmdPipelineBarrier2KHR m_vk_cmd_pipeline_barrier2 = nullptr;
+        // The layout, access and stage of the images and buffers.
+        ResourceStateTracker m_resource_state_tracker;
         // The swapchain handle.
-        VkSwapchainKHR m_swapchain;
+        // Passed as the old swapchain when the swapchain is recreated.
+        VkSwapchainKHR m_swapchain = VK_NULL_HANDLE;
         // The format of the images in the swapchain.
         VkFormat m_swapchain_image_format;
         // The extent description of the swapchain.
         VkExtent2D m_swapchain_extent;
+        // The format of the depth attachment.
+        VkFormat m_depth_format;
+        // The samples per pixel of the colour and depth attachments.
+        VkSampleCountFlagBits m_msaa_samples = VkSampleCountFlagBits
+            ::VK_SAMPLE_COUNT_1_BIT;
         // The handles to the swapchain images.
         ::std::vector<VkImage> m_swapchain_images;
         // The handles to the swapchain image views.
         ::std::vector<VkImageView> m_swapchain_image_views;
+        // The memory of the offscreen images standing in for the
+        // swapchain images in headless mode.
+        ::std::vector<VkDeviceMemory> m_headless_image_memories;
         // Vertex shader module.
         VkShaderModule m_vertex_shader_module;
         // Fragment shader module.
         VkShaderModule m_fragment_shader_module;
+        // Depth prepass vertex shader module. Only with a depth prepass.
+        VkShaderModule m_depth_prepass_shader_module = VK_NULL_HANDLE;
+        // Debug draw vertex shader module.
+        VkShaderModule m_debug_draw_vertex_shader_module = VK_NULL_HANDLE;
+        // Debug draw fragment shader module.
+        VkShaderModule m_debug_draw_fragment_shader_module = VK_NULL_HANDLE;
         // The render pass handle.
         VkRenderPass m_render_pass;
         // The descriptor layout handle.
         VkDescriptorSetLayout m_descriptor_set_layout;
+        // Writes the uniform buffer and sampler bindings
+        // of a set from a DescriptorSetContents.
+        VkDescriptorUpdateTemplate m_descriptor_update_template;
+        // Writes every slot of the texture table binding
+        // of a set from an array of VkDescriptorImageInfo.
+        VkDescriptorUpdateTemplate m_texture_table_update_template;
         // The graphics pipeline layout.
         VkPipelineLayout m_graphics_pipeline_layout;
         // The handle to the graphics pipeline.
         VkPipeline m_graphics_pipeline;
+        // The pipeline writing the depth of the depth prepass subpass.
+        VkPipeline m_depth_prepass_pipeline = VK_NULL_HANDLE;
+        // The pipeline drawing the debug lines.
+        VkPipeline m_debug_line_pipeline = VK_NULL_HANDLE;
+        // The pipeline drawing the debug points.
+        VkPipeline m_debug_point_pipeline = VK_NULL_HANDLE;
         // The handles to the frame buffers.
         ::std::vector<VkFramebuffer> m_swapchain_frame_buffers;
+        // The passes of a frame. Rebuilt with the swapchain.
+        ::std::unique_ptr<RenderGraph> m_ptr_render_graph;
+        // The swapchain image within the render graph.
+        RenderGraphResource m_swapchain_image_resource = 0;
+        // The depth attachment, a transient image of the render graph.
+        RenderGraphResource m_depth_image_resource = 0;
+        // The multisampled colour attachment, a transient image of the
+        // render graph resolved into the swapchain image at the end of
+        // the render pass. Only with MSAA.
+        RenderGraphResource m_colour_image_resource = 0;
+        // The swapchain image index of the command buffer being recorded.
+        // Read by the passes of the render graph.
+        uint32_t m_recording_image_index = 0;
+        // The secondary command buffers holding the draws of the command
+        // buffer being recorded, empty if none. Read by the main pass.
+        // Only set while recording.
+        const FrameVector<VkCommandBuffer>*
+            m_ptr_recording_secondary_command_buffers = nullptr;
+        // Copies the rendered images back to host memory. Only created
+        // when a readback directory is set. Rebuilt with the swapchain.
+        ::std::unique_ptr<ReadbackRing> m_ptr_readback_ring;
+        // Writes the frames read back to files off the render thread.
+        // Created with the first readback ring and kept across swapchain
+        // rebuilds. Writes the frames still queued when destroyed.
+        ::std::unique_ptr<ReadbackWriter> m_ptr_readback_writer;
         // The command pool handle.
         VkCommandPool m_command_pool;
         // The handle to the texture image.
@@ -116,23 +216,73 @@ namespace vk::tut {
         ::std::vector<Vertex> m_vertices;
         // The value of the index buffers of the object to be rendered.
         ::std::vector<uint32_t> m_indices;
+        // The draws recorded every frame, in order.
+        ::std::vector<DrawCommand> m_draw_commands;
         // The handle to the buffer containing vertex and index data
         // of all meshes loaded to be rendered..
         VkBuffer m_mesh_buffer;
         // The handle to the memory of the mesh buffer in the GPU.
         VkDeviceMemory m_mesh_buffer_memory;
+        // The transforms of the instances drawn, as loaded.
+        ::std::vector<InstanceTransform> m_instances;
+        // The handles to the instance buffers, one per frame in flight.
+        // Host visible, so that animated transforms are written in place.
+        ::std::vector<VkBuffer> m_instance_buffers;
+        // The handles to the memory of the instance buffers.
+        ::std::vector<VkDeviceMemory> m_instance_buffer_memories;
+        // The instance buffers, mapped for as long as they live.
+        ::std::vector<InstanceTransform*> m_mapped_instance_buffers;
+        // Generates the scene loaded by load_scene(). Null until then.
+        ::std::unique_ptr<SceneGenerator> m_ptr_scene_generator;
+        // When the scene was loaded. Its animation starts from there.
+        ::std::chrono::steady_clock::time_point m_scene_start_time;
+        // The handles to the texture images of the scene.
+        ::std::vector<VkImage> m_scene_texture_images;
+        // The handles to the memory of the scene texture images.
+        ::std::vector<VkDeviceMemory> m_scene_texture_image_memories;
+        // The image views of the scene texture images.
+        ::std::vector<VkImageView> m_scene_texture_image_views;
+        // The slots of the scene textures in the bindless texture table.
+        // Kept when the scene is replaced, for the textures of the next.
+        ::std::vector<uint32_t> m_scene_texture_indices;
         // The handles to the buffer containing uniform data.
         ::std::vector<VkBuffer> m_uniform_buffers;
         // The handles to the memory of the uniform buffer in the GPU.
         ::std::vector<VkDeviceMemory> m_uniform_buffer_memories;
-        // The descriptor pool handle.
-        VkDescriptorPool m_descriptor_pool;
+        // The image views registered in the bindless texture table.
+        // The index of a view in this list is its slot in the table.
+        ::std::vector<VkImageView> m_bindless_texture_views;
+        // The slot of the texture image in the bindless texture table.
+        uint32_t m_texture_index = 0;
+        // Allocates the long lived descriptor sets.
+        DescriptorAllocator m_descriptor_allocator;
+        // Allocates the transient descriptor sets of each frame in flight.
+        // Reset once the frame is known to be finished.
+        ::std::vector<DescriptorAllocator> m_frame_descriptor_allocators;
         // The handles to the descriptor sets.
         ::std::vector<VkDescriptorSet> m_descriptor_sets;
         // The index of the current frame being rendered.
         uint32_t m_current_frame_index = 0;
         // The command buffer handles.
+        // Re-recorded every frame when the scene is dynamic.
         ::std::vector<VkCommandBuffer> m_command_buffers;
+        // Whether the scene changes every frame. If not, the cached
+        // command buffers are submitted without being re-recorded.
+        bool m_dynamic_scene = false;
+        // Pre-recorded command buffers, one per swapchain image and frame
+        // slot pair. Indexed by image_index * slot count + frame index.
+        ::std::vector<VkCommandBuffer> m_cached_command_buffers;
+        // Whether each cached command buffer matches the current scene.
+        ::std::vector<bool> m_cached_command_buffer_validity;
+        // Runs the work split across threads.
+        JobSystem m_job_system;
+        // The number of slices the draws of a dynamic scene are split in.
+        uint32_t m_recording_thread_count = 1;
+        // One command pool per frame slot and draw list slice. Indexed
+        // by frame index * m_recording_thread_count + slice index.
+        ::std::vector<VkCommandPool> m_recording_command_pools;
+        // The secondary command buffer of each recording command pool.
+        ::std::vector<VkCommandBuffer> m_recording_command_buffers;
         // GPU sync objects that signals a swapchain
         // image availability in the GPU.
         ::std::vector<VkSemaphore> m_image_available_semaphores;
@@ -142,6 +292,54 @@ namespace vk::tut {
         // CPU sync objects that tells the CPU that the
         // previous frame has finished rendering in the GPU.
         ::std::vector<VkFence> m_in_flight_fences;
+        // The value of the last submitted frame. Starts at 1.
+        uint64_t m_frame_counter = 0;
+        // The frame value last submitted with each in flight fence.
+        ::std::vector<uint64_t> m_frame_submit_values;
+        // The value of the latest frame known to be finished in the GPU.
+        uint64_t m_completed_frame_value = 0;
+        // The transient CPU side data of each frame in flight.
+        // Reset once the frame is known to be finished.
+        ::std::vector<::std::unique_ptr<FrameArena>> m_frame_arenas;
+        // Writes the debug primitives of the next frame.
+        DebugDraw m_debug_draw;
+        // Holds the indirect draw arguments of the debug lines and points
+        // of each frame in flight, then a ring of vertex slots one longer
+        // than the frames in flight, so that the slot of the next frame is
+        // never read by the GPU. Host visible and coherent.
+        VkBuffer m_debug_draw_buffer = VK_NULL_HANDLE;
+        // The memory of the debug draw buffer.
+        VkDeviceMemory m_debug_draw_buffer_memory = VK_NULL_HANDLE;
+        // The indirect draw arguments, lines then points of each frame in
+        // flight. Mapped for as long as the buffer lives.
+        VkDrawIndirectCommand* m_ptr_mapped_debug_draw_arguments = nullptr;
+        // The vertex ring. Mapped for as long as the buffer lives.
+        DebugVertex* m_ptr_mapped_debug_vertices = nullptr;
+        // Where the vertex ring starts in the debug draw buffer.
+        VkDeviceSize m_debug_draw_vertex_offset = 0;
+        // The vertex slot m_debug_draw is writing.
+        uint32_t m_debug_draw_ring_slot = 0;
+        // The number of vertices in each vertex slot.
+        const uint32_t DEBUG_DRAW_VERTEX_CAPACITY = 65536;
+        // Resources waiting for the frames using them to finish.
+        DeletionQueue m_deletion_queue;
+        // Measures the GPU time of the passes of each frame.
+        GpuProfiler m_gpu_profiler;
+        // Counts the vertices and fragments of the main pass.
+        PipelineStatisticsQueries m_pipeline_statistics;
+        // Whether the device features pipeline statistics need are enabled.
+        bool m_pipeline_statistics_supported = false;
+        // Whether points larger than a pixel are enabled.
+        bool m_large_points_supported = false;
+        // The times and counts of the frames.
+        FrameStatistics m_frame_statistics;
+        // When the latest frame started. Only valid once a frame started.
+        ::std::chrono::steady_clock::time_point m_frame_start_time;
+        // The allocations counted by AllocationTracker when the latest
+        // frame started.
+        uint64_t m_frame_start_allocation_count = 0;
+        // The number of GPU frame times recorded into m_frame_statistics.
+        uint64_t m_recorded_gpu_frame_count = 0;
 
         // < -------------------- Vulkan initializations ------------------- >
 
@@ -151,10 +349,21 @@ namespace vk::tut {
         void select_physical_device();
         void create_logical_device();
         void create_swapchain();
+        void create_headless_images();
         void create_swapchain_image_views();
+        void select_attachment_formats();
         void create_render_pass();
         void create_descriptor_set_layout();
+        void create_descriptor_update_template();
         void create_graphics_pipeline();
+        void create_depth_prepass_pipeline(
+            const VkGraphicsPipelineCreateInfo& graphics_pipeline_info
+        );
+        void create_debug_draw_pipelines(
+            const VkGraphicsPipelineCreateInfo& graphics_pipeline_info
+        );
+        void create_readback_ring();
+        void create_render_graph();
         void create_swapchain_frame_buffers();
         void create_command_pool();
         void create_texture_image();
@@ -162,17 +371,32 @@ namespace vk::tut {
         void create_texture_sampler();
         void create_mesh_buffer();
         void create_uniform_buffers();
-        void create_descriptor_pool();
+        void create_instance_buffers();
+        void create_scene_textures();
+        void create_descriptor_allocators();
         void create_descriptor_sets();
         void create_command_buffers();
+        void create_recording_command_pools();
         void create_sync_objects();
+        void create_frame_arenas();
+        void create_debug_draw_buffer();
+        void create_gpu_profiler();
+        void create_pipeline_statistics();
+        void create_frame_statistics();
 
         // < ------------------ END Vulkan initializations ----------------- >
 
         // < ------------------- Vulkan cleanup functions ------------------ >
 
+        void destroy_pipeline_statistics();
+        void destroy_gpu_profiler();
+        void destroy_debug_draw_buffer();
+        void destroy_frame_arenas();
         void destroy_sync_objects();
-        void destroy_descriptor_pool();
+        void destroy_recording_command_pools();
+        void destroy_descriptor_allocators();
+        void destroy_scene_textures();
+        void destroy_instance_buffers();
         void destroy_uniform_buffers();
         void destroy_mesh_buffer();
         void destroy_texture_sampler();
@@ -180,10 +404,14 @@ namespace vk::tut {
         void destroy_texture_image();
         void destroy_command_pool();
         void destroy_swapchain_frame_buffers();
+        void destroy_render_graph();
+        void destroy_readback_ring();
         void destroy_graphics_pipeline();
+        void destroy_descriptor_update_template();
         void destroy_descriptor_set_layout();
         void destroy_render_pass();
         void destroy_swapchain_image_views();
+        void destroy_headless_images();
         void destroy_swapchain();
         void destroy_logical_device();
         void destroy_surface();
@@ -195,13 +423,67 @@ namespace vk::tut {
         // < ---------------------------- Jobs ----------------------------- >
 
         void record_command_buffer(
+            const VkCommandBuffer& command_buffer,
+            const uint32_t& image_index,
+            const bool& record_in_parallel
+        );
+        void record_main_pass(const VkCommandBuffer& command_buffer);
+        void record_draw_commands(
+            const VkCommandBuffer& command_buffer,
+            const uint32_t& first_draw,
+            const uint32_t& draw_count,
+            const bool& depth_only
+        );
+        void record_debug_draws(const VkCommandBuffer& command_buffer);
+        void record_secondary_command_buffers(
+            const uint32_t& image_index,
+            FrameVector<VkCommandBuffer>& ref_secondary_command_buffers
+        );
+        VkCommandBuffer get_cached_command_buffer(
             const uint32_t& image_index
         );
+        void invalidate_cached_command_buffers();
+        void retire_cached_command_buffers();
         void draw_frame();
+        VkImageLayout get_output_image_layout() const;
+        void write_readback_frame(const ReadbackFrame& frame);
+        void wait_for_frames_in_flight();
+        void record_gpu_frame_time();
+        void record_pipeline_statistics(const uint32_t& slot);
         void recreate_swapchain();
         void update_uniform_buffer();
+        void update_instance_buffer();
+        void write_debug_draw_arguments();
+        void add_scene_debug_draws();
         void load_initial_mesh();
         void load_square_mesh();
+        void upload_texture(
+            const void* ptr_pixels,
+            const uint32_t& width, const uint32_t& height,
+            VkImage* ptr_image, VkDeviceMemory* ptr_image_memory
+        );
+        void create_texture_view(
+            const VkImage& image, VkImageView* ptr_image_view
+        );
+        // Registering and writing a texture only take effect
+        // in the descriptor sets at the next write_texture_tables().
+        uint32_t register_bindless_texture(const VkImageView& image_view);
+        void write_bindless_texture(
+            const uint32_t& texture_index, const VkImageView& image_view
+        );
+        // Writes the whole texture table of every descriptor set.
+        // Call with no frame in flight.
+        void write_texture_tables();
+        void write_descriptor_sets(
+            const ::std::vector<VkDescriptorSet>& descriptor_sets,
+            const ::std::vector<DescriptorSetContents>& contents
+        );
+        // A set for data written per draw. Only valid until the fence
+        // of the current frame slot is waited on again.
+        VkDescriptorSet allocate_frame_descriptor_set(
+            const VkDescriptorSetLayout& layout
+        );
+        FrameArena& get_frame_arena();
 
         // < -------------------------- END Jobs --------------------------- >
 
@@ -235,6 +517,14 @@ namespace vk::tut {
         const VkSurfaceCapabilitiesKHR& capabilities,
         GLFWwindow* ptr_window
     );
+    VkFormat find_depth_format(const VkPhysicalDevice& physical_device);
+    VkSampleCountFlagBits find_msaa_sample_count(
+        const VkPhysicalDevice& physical_device,
+        const uint32_t& requested_sample_count
+    );
+    VkMemoryPropertyFlags find_transient_attachment_memory_properties(
+        const VkPhysicalDevice& physical_device
+    );
     uint32_t find_memory_requirements(
         const VkPhysicalDevice& physical_device,
         const uint32_t& type_filter,
@@ -260,9 +550,7 @@ namespace vk::tut {
         VkDeviceMemory* ptr_buffer_memory
     );
     void copy_buffer(
-        const VkDevice& logical_device,
-        const VkCommandPool& command_pool,
-        const VkQueue& queue,
+        const VkCommandBuffer& command_buffer,
         const VkBuffer& src_buffer,
         const VkBuffer& dest_buffer,
         const VkDeviceSize& buffer_size
@@ -274,24 +562,15 @@ namespace vk::tut {
         const VkFormat& format, const VkImageTiling& tiling,
         const VkImageUsageFlags& usage,
         const VkMemoryPropertyFlags& memory_properties,
+        const VkSampleCountFlagBits& samples,
         VkImage* ptr_image,
         VkDeviceMemory* ptr_image_memory
     );
     void copy_buffer_to_image(
-        const VkDevice& logical_device,
-        const VkCommandPool& command_pool,
-        const VkQueue& queue,
+        const VkCommandBuffer& command_buffer,
         const uint32_t& width, const uint32_t& height,
         const VkBuffer& src_buffer, const VkImage& dst_image
     );
-    void transition_image_layout(
-        const VkDevice& logical_device,
-        const VkCommandPool& command_pool,
-        const VkQueue& queue,
-        const VkImageLayout& old_layout,
-        const VkImageLayout& new_layout,
-        const VkImage& image
-    );
 
     // < --------------------- END Helper functions -------------------- >
 
@@ -0,0 +1,140 @@
+#if !defined(_VK_TUT_APPLICATION_CONFIG_HEADER_)
+#define _VK_TUT_APPLICATION_CONFIG_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <cstdint>
+#include <string>
+
+namespace vk::tut {
+    // The options an application is created with.
+    class ApplicationConfig final {
+    public:
+        // Default constructor.
+        inline ApplicationConfig() {}
+
+        // Copy constructor.
+        ApplicationConfig(const ApplicationConfig&);
+        // Move constructor.
+        ApplicationConfig(ApplicationConfig&&);
+        // Copy re-assignment.
+        ApplicationConfig& operator= (const ApplicationConfig&);
+        // Move re-assignment.
+        ApplicationConfig& operator= (ApplicationConfig&&);
+
+        // Getter for m_depth_prepass.
+        inline bool get_depth_prepass() const { return m_depth_prepass; }
+        // Copy setter for m_depth_prepass.
+        void set_depth_prepass(const bool&);
+        // Getter for m_msaa_sample_count.
+        inline uint32_t get_msaa_sample_count() const
+        { return m_msaa_sample_count; }
+        // Copy setter for m_msaa_sample_count.
+        void set_msaa_sample_count(const uint32_t&);
+        // Getter for m_headless.
+        inline bool get_headless() const { return m_headless; }
+        // Copy setter for m_headless.
+        void set_headless(const bool&);
+        // Getter for m_headless_width.
+        inline uint32_t get_headless_width() const { return m_headless_width; }
+        // Copy setter for m_headless_width.
+        void set_headless_width(const uint32_t&);
+        // Getter for m_headless_height.
+        inline uint32_t get_headless_height() const
+        { return m_headless_height; }
+        // Copy setter for m_headless_height.
+        void set_headless_height(const uint32_t&);
+        // Getter for m_frame_count.
+        inline uint32_t get_frame_count() const { return m_frame_count; }
+        // Copy setter for m_frame_count.
+        void set_frame_count(const uint32_t&);
+        // Getter for m_readback_directory.
+        inline const ::std::string& get_readback_directory() const
+        { return m_readback_directory; }
+        // Copy setter for m_readback_directory.
+        void set_readback_directory(const ::std::string&);
+        // Getter for m_trace_path.
+        inline const ::std::string& get_trace_path() const
+        { return m_trace_path; }
+        // Copy setter for m_trace_path.
+        void set_trace_path(const ::std::string&);
+        // Getter for m_statistics_path.
+        inline const ::std::string& get_statistics_path() const
+        { return m_statistics_path; }
+        // Copy setter for m_statistics_path.
+        void set_statistics_path(const ::std::string&);
+        // Getter for m_hitch_threshold_ms.
+        inline float get_hitch_threshold_ms() const
+        { return m_hitch_threshold_ms; }
+        // Copy setter for m_hitch_threshold_ms.
+        void set_hitch_threshold_ms(const float&);
+        // Getter for m_pipeline_statistics.
+        inline bool get_pipeline_statistics() const
+        { return m_pipeline_statistics; }
+        // Copy setter for m_pipeline_statistics.
+        void set_pipeline_statistics(const bool&);
+        // Getter for m_device_name.
+        inline const ::std::string& get_device_name() const
+        { return m_device_name; }
+        // Copy setter for m_device_name.
+        void set_device_name(const ::std::string&);
+        // Getter for m_mesh_triangle_count.
+        inline uint32_t get_mesh_triangle_count() const
+        { return m_mesh_triangle_count; }
+        // Copy setter for m_mesh_triangle_count.
+        void set_mesh_triangle_count(const uint32_t&);
+        // Getter for m_debug_draw.
+        inline bool get_debug_draw() const { return m_debug_draw; }
+        // Copy setter for m_debug_draw.
+        void set_debug_draw(const bool&);
+
+    private:
+        // Whether a position only subpass fills the depth attachment
+        // before the shading subpass, so that each pixel is shaded once.
+        bool m_depth_prepass = false;
+        // The requested samples per pixel of the colour and depth
+        // attachments. Clamped to what the device supports. 1 disables MSAA.
+        uint32_t m_msaa_sample_count = 1;
+        // Whether to render into offscreen images instead of a window.
+        // Needs neither a display nor present support.
+        bool m_headless = false;
+        // The width of the offscreen images in headless mode.
+        uint32_t m_headless_width = 900;
+        // The height of the offscreen images in headless mode.
+        uint32_t m_headless_height = 600;
+        // The number of frames run() renders. 0 renders until the window
+        // is closed, or a single frame in headless mode.
+        uint32_t m_frame_count = 0;
+        // Where the rendered frames are read back to as PPM files.
+        // Empty disables the readback.
+        ::std::string m_readback_directory;
+        // Where the CPU trace is written as Chrome trace JSON.
+        // Empty disables the export.
+        ::std::string m_trace_path;
+        // Where the frame statistics are written as JSON.
+        // Empty disables the export.
+        ::std::string m_statistics_path;
+        // The CPU or GPU frame time above which a frame is a hitch.
+        // 0 disables hitch detection.
+        float m_hitch_threshold_ms = 50.0f;
+        // Whether the main pass counts its vertices, primitives and
+        // fragments with a pipeline statistics query, if supported.
+        bool m_pipeline_statistics = false;
+        // Only devices whose name contains this are considered.
+        // Considers every device if empty.
+        ::std::string m_device_name;
+        // The number of triangles of the initial colour wheel mesh.
+        uint32_t m_mesh_triangle_count = 1000;
+        // Whether every frame draws the world axes and the bounds of each
+        // instance with debug lines and points.
+        bool m_debug_draw = false;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
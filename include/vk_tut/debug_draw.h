@@ -0,0 +1,110 @@
+#if !defined(_VK_TUT_DEBUG_DRAW_HEADER_)
+#define _VK_TUT_DEBUG_DRAW_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+
+namespace vk::tut {
+    // A vertex of a debug line or point, in the space the instances are
+    // placed in. Read by the debug draw vertex shader.
+    struct DebugVertex {
+        // The position.
+        ::glm::vec3 position;
+        // The colour, packed as RGBA with 8 bits each, red lowest.
+        uint32_t colour;
+
+        static VkVertexInputBindingDescription
+        get_binding_description();
+        static std::array<VkVertexInputAttributeDescription, 2>
+        get_attribute_descriptions();
+    };
+
+    // Immediate mode debug drawing. Lines and points are written straight
+    // into the vertex memory of a frame, which is usually mapped device
+    // memory, and forgotten when the next frame begins. Lines fill the
+    // memory from the front and points from the back, so that each kind
+    // is one contiguous range drawn by a single draw call.
+    //
+    // Primitives past the capacity of the frame are dropped and counted.
+    class DebugDraw final {
+    public:
+        // Default constructor. Drops everything until begin() is called.
+        inline DebugDraw() {}
+
+        // Prevent copying.
+        inline DebugDraw(const DebugDraw&) = delete;
+        // Prevent copy re-assignment.
+        inline DebugDraw& operator= (const DebugDraw&) = delete;
+
+        // Starts writing the primitives of a frame into ptr_vertices,
+        // with room for capacity vertices. Forgets the previous frame.
+        void begin(DebugVertex* ptr_vertices, const uint32_t& capacity);
+
+        // Adds a line between two positions.
+        void add_line(
+            const ::glm::vec3& from, const ::glm::vec3& to,
+            const ::glm::vec4& colour
+        );
+        // Adds the edges of an axis aligned box.
+        void add_box(
+            const ::glm::vec3& min, const ::glm::vec3& max,
+            const ::glm::vec4& colour
+        );
+        // Adds the edges of the cube from -1 to 1 on each axis, placed by
+        // transform. Draws oriented boxes.
+        void add_box(const ::glm::mat4& transform, const ::glm::vec4& colour);
+        // Adds the edges of the frustum view_projection maps to the clip
+        // volume, such as the one seen by a camera.
+        void add_frustum(
+            const ::glm::mat4& view_projection, const ::glm::vec4& colour
+        );
+        // Adds a point.
+        void add_point(const ::glm::vec3& position, const ::glm::vec4& colour);
+
+        // The number of line vertices, starting at the first vertex.
+        inline uint32_t get_line_vertex_count() const
+        { return m_line_vertex_count; }
+        // The number of point vertices. They end at the last vertex.
+        inline uint32_t get_point_vertex_count() const
+        { return m_point_vertex_count; }
+        // The vertex the points start at.
+        inline uint32_t get_first_point_vertex() const
+        { return m_capacity - m_point_vertex_count; }
+        // The number of primitives dropped since begin().
+        inline uint32_t get_dropped_count() const { return m_dropped_count; }
+
+        // Packs a colour with components from 0 to 1 as a DebugVertex does.
+        static uint32_t pack_colour(const ::glm::vec4& colour);
+
+    private:
+        // Adds the 12 edges of a box from its 8 corners. Corner i is at
+        // the maximum of axis a when bit a of i is set.
+        void add_box_edges(
+            const ::std::array<::glm::vec3, 8>& corners,
+            const ::glm::vec4& colour
+        );
+
+        // The vertices of the frame.
+        DebugVertex* m_ptr_vertices = nullptr;
+        // The number of vertices m_ptr_vertices has room for.
+        uint32_t m_capacity = 0;
+        // The number of line vertices written.
+        uint32_t m_line_vertex_count = 0;
+        // The number of point vertices written.
+        uint32_t m_point_vertex_count = 0;
+        // The number of primitives dropped.
+        uint32_t m_dropped_count = 0;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
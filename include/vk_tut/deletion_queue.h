@@ -0,0 +1,53 @@
+#if !defined(_VK_TUT_DELETION_QUEUE_HEADER_)
+#define _VK_TUT_DELETION_QUEUE_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+
+namespace vk::tut {
+    // Defers the destruction of GPU resources until the GPU has finished
+    // the last frame that could have used them. Frames are identified by
+    // a monotonically increasing value, such as a frame counter.
+    class DeletionQueue final {
+    public:
+        // Default constructor.
+        inline DeletionQueue() {}
+
+        // Prevent copying.
+        inline DeletionQueue(const DeletionQueue&) = delete;
+        // Prevent copy re-assignment.
+        inline DeletionQueue& operator= (const DeletionQueue&) = delete;
+
+        // Queue a destroy to run once the GPU has passed retire_value.
+        void enqueue(
+            const uint64_t& retire_value,
+            ::std::function<void()>&& destroy
+        );
+        // Run the destroys of every value up to and including
+        // completed_value, in the order they were queued.
+        void flush(const uint64_t& completed_value);
+        // Run every queued destroy. Only call when the GPU is idle.
+        void flush_all();
+
+        // The number of destroys waiting to run.
+        inline size_t get_size() const { return m_entries.size(); }
+
+    private:
+        // The queued destroys with their retire value.
+        // Sorted by retire value.
+        ::std::deque<::std::pair<uint64_t, ::std::function<void()>>>
+            m_entries;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
@@ -0,0 +1,97 @@
+#if !defined(_VK_TUT_DESCRIPTOR_ALLOCATOR_HEADER_)
+#define _VK_TUT_DESCRIPTOR_ALLOCATOR_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace vk::tut {
+    // Allocates descriptor sets from a growing list of descriptor pools.
+    // A new pool is created whenever the current one runs out, so there
+    // is no fixed ceiling on the number of sets. All pools can be reset
+    // at once, which makes it suitable for per-frame transient sets.
+    class DescriptorAllocator final {
+    public:
+        // Default constructor.
+        inline DescriptorAllocator() {}
+
+        // Prevent copying.
+        inline DescriptorAllocator(const DescriptorAllocator&) = delete;
+        // Move constructor.
+        inline DescriptorAllocator(DescriptorAllocator&&) = default;
+        // Prevent copy re-assignment.
+        inline DescriptorAllocator&
+        operator= (const DescriptorAllocator&) = delete;
+        // Move re-assignment.
+        inline DescriptorAllocator&
+        operator= (DescriptorAllocator&&) = default;
+
+        // Sets up the allocator. set_pool_sizes holds the number of
+        // descriptors of each type a single set is expected to use.
+        void create(
+            const VkDevice& logical_device,
+            const ::std::vector<VkDescriptorPoolSize>& set_pool_sizes,
+            const uint32_t& initial_sets_per_pool,
+            const VkDescriptorPoolCreateFlags& pool_flags
+        );
+        // Destroys every pool. Frees every set allocated.
+        void destroy();
+
+        // Allocates one set per layout with a single
+        // vkAllocateDescriptorSets call whenever possible.
+        void allocate(
+            const ::std::vector<VkDescriptorSetLayout>& layouts,
+            ::std::vector<VkDescriptorSet>& ref_descriptor_sets
+        );
+        // Allocates a single set.
+        VkDescriptorSet allocate(const VkDescriptorSetLayout& layout);
+        // Returns every set to the pools with vkResetDescriptorPool.
+        // The sets allocated before must no longer be in use.
+        void reset();
+
+        // The number of pools created so far.
+        inline size_t get_pool_count() const {
+            return m_full_pools.size() + m_ready_pools.size() +
+                (m_current_pool.handle != VK_NULL_HANDLE ? 1 : 0);
+        }
+
+    private:
+        // A pool and the number of sets it has room for.
+        struct Pool {
+            // The pool handle.
+            VkDescriptorPool handle = VK_NULL_HANDLE;
+            // The maxSets the pool was created with.
+            uint32_t max_sets = 0;
+        };
+
+        // Creates a pool with room for max_sets sets.
+        Pool create_pool(const uint32_t& max_sets);
+        // Makes a pool with room for at least min_sets sets current.
+        void next_pool(const uint32_t& min_sets);
+
+        // The logical device the pools are created from.
+        VkDevice m_logical_device = VK_NULL_HANDLE;
+        // The number of descriptors of each type used by one set.
+        ::std::vector<VkDescriptorPoolSize> m_set_pool_sizes;
+        // The flags every pool is created with.
+        VkDescriptorPoolCreateFlags m_pool_flags = 0;
+        // The number of sets the next created pool can hold.
+        // Grows with every created pool.
+        uint32_t m_sets_per_pool = 0;
+        // The pool sets are currently allocated from.
+        Pool m_current_pool;
+        // Pools that ran out of memory.
+        ::std::vector<Pool> m_full_pools;
+        // Pools that were reset and are empty.
+        ::std::vector<Pool> m_ready_pools;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
@@ -0,0 +1,91 @@
+#if !defined(_VK_TUT_DESCRIPTOR_SET_CONTENTS_HEADER_)
+#define _VK_TUT_DESCRIPTOR_SET_CONTENTS_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace vk::tut {
+    // The packed data written to the uniform buffer and sampler bindings
+    // of a descriptor set through a descriptor update template.
+    // The texture table binding is written by a template of its own,
+    // from an array of VkDescriptorImageInfo holding every slot.
+    class DescriptorSetContents final {
+    public:
+        // Default constructor.
+        inline DescriptorSetContents() {}
+        // Copy initializer list constructor.
+        DescriptorSetContents(
+            const VkDescriptorBufferInfo& uniform_buffer_info,
+            const VkDescriptorImageInfo& sampler_info
+        );
+
+        // Copy constructor.
+        DescriptorSetContents(const DescriptorSetContents&);
+        // Move constructor.
+        DescriptorSetContents(DescriptorSetContents&&);
+        // Copy re-assignment.
+        DescriptorSetContents& operator= (const DescriptorSetContents&);
+        // Move re-assignment.
+        DescriptorSetContents& operator= (DescriptorSetContents&&);
+
+        // Whether both write the same descriptors.
+        bool operator== (const DescriptorSetContents&) const;
+        // Whether both write different descriptors.
+        inline bool operator!= (const DescriptorSetContents& other) const
+        { return !(*this == other); }
+
+        // Getter for m_uniform_buffer_info.
+        inline VkDescriptorBufferInfo get_uniform_buffer_info() const
+        { return m_uniform_buffer_info; }
+        // Copy setter for m_uniform_buffer_info.
+        void set_uniform_buffer_info(const VkDescriptorBufferInfo&);
+
+        // Getter for m_sampler_info.
+        inline VkDescriptorImageInfo get_sampler_info() const
+        { return m_sampler_info; }
+        // Copy setter for m_sampler_info.
+        void set_sampler_info(const VkDescriptorImageInfo&);
+
+        // The bindings of the main descriptor set layout.
+        static ::std::vector<VkDescriptorSetLayoutBinding>
+        get_layout_bindings();
+        // The entries of a descriptor update template writing the
+        // bindings held by a DescriptorSetContents. Bindings it does
+        // not hold, such as the texture table, are left out.
+        static ::std::vector<VkDescriptorUpdateTemplateEntry>
+        get_update_template_entries(
+            const ::std::vector<VkDescriptorSetLayoutBinding>& bindings
+        );
+        // The entries of a descriptor update template writing every
+        // slot of the texture table binding from an array of
+        // VkDescriptorImageInfo.
+        static ::std::vector<VkDescriptorUpdateTemplateEntry>
+        get_texture_table_template_entries(
+            const ::std::vector<VkDescriptorSetLayoutBinding>& bindings
+        );
+
+        // The binding of the uniform buffer.
+        static constexpr uint32_t UNIFORM_BUFFER_BINDING = 0;
+        // The binding of the sampler shared by all textures.
+        static constexpr uint32_t SAMPLER_BINDING = 1;
+        // The binding of the bindless texture table.
+        static constexpr uint32_t TEXTURE_TABLE_BINDING = 2;
+
+    private:
+        // Written to UNIFORM_BUFFER_BINDING.
+        VkDescriptorBufferInfo m_uniform_buffer_info{};
+        // Written to SAMPLER_BINDING.
+        VkDescriptorImageInfo m_sampler_info{};
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
@@ -0,0 +1,69 @@
+#if !defined(_VK_TUT_DRAW_COMMAND_HEADER_)
+#define _VK_TUT_DRAW_COMMAND_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <cstdint>
+
+namespace vk::tut {
+    // Encapsulates one indexed draw of the mesh buffer, drawing a range
+    // of the instances of the instance buffer.
+    class DrawCommand final {
+    public:
+        // Default constructor.
+        inline DrawCommand() {}
+        // Copy initializer list constructor.
+        DrawCommand(
+            const uint32_t& index_count,
+            const uint32_t& first_index,
+            const int32_t& vertex_offset,
+            const uint32_t& texture_index,
+            const uint32_t& instance_count = 1,
+            const uint32_t& first_instance = 0
+        );
+
+        // Copy constructor.
+        DrawCommand(const DrawCommand&);
+        // Move constructor.
+        DrawCommand(DrawCommand&&);
+        // Copy re-assignment.
+        DrawCommand& operator= (const DrawCommand&);
+        // Move re-assignment.
+        DrawCommand& operator= (DrawCommand&&);
+
+        // Getter for m_index_count.
+        inline uint32_t get_index_count() const { return m_index_count; }
+        // Getter for m_first_index.
+        inline uint32_t get_first_index() const { return m_first_index; }
+        // Getter for m_vertex_offset.
+        inline int32_t get_vertex_offset() const { return m_vertex_offset; }
+        // Getter for m_texture_index.
+        inline uint32_t get_texture_index() const { return m_texture_index; }
+        // Getter for m_instance_count.
+        inline uint32_t get_instance_count() const { return m_instance_count; }
+        // Getter for m_first_instance.
+        inline uint32_t get_first_instance() const { return m_first_instance; }
+
+    private:
+        // The number of indices drawn.
+        uint32_t m_index_count = 0;
+        // The first index drawn, counted from the start of the indices.
+        uint32_t m_first_index = 0;
+        // Added to every index before fetching the vertex.
+        int32_t m_vertex_offset = 0;
+        // The slot of the texture in the bindless texture table.
+        uint32_t m_texture_index = 0;
+        // The number of instances drawn.
+        uint32_t m_instance_count = 1;
+        // The first instance drawn, counted from the start of the instances.
+        uint32_t m_first_instance = 0;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
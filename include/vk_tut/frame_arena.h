@@ -0,0 +1,103 @@
+#if !defined(_VK_TUT_FRAME_ARENA_HEADER_)
+#define _VK_TUT_FRAME_ARENA_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace vk::tut {
+    // A bump allocator for the CPU side data of one frame, such as draw
+    // lists and staging copies. Nothing is freed on its own. The whole
+    // arena is reset at once when the frame using it is known to be
+    // finished, which is a pointer reset.
+    //
+    // A frame that outgrows the arena takes extra blocks. The next reset
+    // merges them into one block large enough for that frame, so a
+    // steady frame loop stops allocating after its largest frame.
+    //
+    // A ::std::pmr::memory_resource, so the allocator aware containers
+    // of ::std::pmr allocate from it. Used from one thread at a time.
+    class FrameArena final : public ::std::pmr::memory_resource {
+    public:
+        // Creates an arena with a block of initial_size bytes.
+        FrameArena(const size_t& initial_size = DEFAULT_SIZE);
+        // Frees the blocks.
+        ~FrameArena();
+
+        // Prevent copying.
+        inline FrameArena(const FrameArena&) = delete;
+        // Prevent copy re-assignment.
+        inline FrameArena& operator= (const FrameArena&) = delete;
+
+        // Frees everything allocated since the last reset. Nothing
+        // allocated from the arena may be used past this point.
+        void reset();
+
+        // Allocates count uninitialized objects. Only for objects
+        // without a destructor to run, since none is ever run.
+        template<typename T>
+        inline T* allocate_array(const size_t& count) {
+            return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        // The bytes allocated since the last reset, padding included.
+        inline size_t get_used_bytes() const { return m_used_bytes; }
+        // The most bytes allocated between two resets.
+        inline size_t get_peak_bytes() const { return m_peak_bytes; }
+        // The bytes of the blocks held.
+        size_t get_capacity() const;
+        // The number of blocks held. 1 unless the frame overflowed.
+        inline size_t get_block_count() const { return m_blocks.size(); }
+
+        // The bytes of the first block when none are given.
+        static constexpr size_t DEFAULT_SIZE = 64 * 1024;
+
+    protected:
+        // Bumps the offset into the current block past the allocation.
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        // Does nothing. The memory is freed by reset().
+        inline void do_deallocate(void*, size_t, size_t) override {}
+        // Only the arena itself frees its memory.
+        inline bool do_is_equal(
+            const ::std::pmr::memory_resource& other
+        ) const noexcept override { return this == &other; }
+
+    private:
+        // A block the arena allocates from.
+        struct Block {
+            // The memory of the block.
+            unsigned char* ptr_data = nullptr;
+            // The bytes of the block.
+            size_t size = 0;
+        };
+
+        // Appends a block of size bytes and allocates from it next.
+        void add_block(const size_t& size);
+        // Frees every block.
+        void free_blocks();
+
+        // The blocks held. The last is allocated from.
+        ::std::vector<Block> m_blocks;
+        // The bytes allocated from the last block.
+        size_t m_offset = 0;
+        // The bytes allocated since the last reset, padding included.
+        size_t m_used_bytes = 0;
+        // The most bytes allocated between two resets.
+        size_t m_peak_bytes = 0;
+    };
+
+    // A vector of the data of a frame, allocated from a FrameArena.
+    template<typename T>
+    using FrameVector = ::std::pmr::vector<T>;
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
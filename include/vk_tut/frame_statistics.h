@@ -0,0 +1,246 @@
+#if !defined(_VK_TUT_FRAME_STATISTICS_HEADER_)
+#define _VK_TUT_FRAME_STATISTICS_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace vk::tut {
+    // A histogram of integer values with a bounded relative error, like
+    // an HDR histogram. Values below 2^SUB_BUCKET_BITS get a bucket
+    // each. Above that, every power of two range is split into
+    // 2^SUB_BUCKET_BITS buckets, so a value is reported within about 3%.
+    //
+    // Recording only touches atomics, so any thread can record while
+    // another reads. A read during a record may miss that value.
+    class LatencyHistogram final {
+    public:
+        // Default constructor.
+        inline LatencyHistogram() {}
+
+        // Prevent copying.
+        inline LatencyHistogram(const LatencyHistogram&) = delete;
+        // Prevent copy re-assignment.
+        inline LatencyHistogram& operator= (const LatencyHistogram&) = delete;
+
+        // Counts a value. Values past the last bucket count as the
+        // largest value the histogram holds.
+        void record(const uint64_t& value);
+        // Forgets every value.
+        void clear();
+
+        // The number of values recorded.
+        inline uint64_t get_count() const
+        { return m_count.load(::std::memory_order_relaxed); }
+        // The largest value recorded, exactly.
+        inline uint64_t get_max() const
+        { return m_max.load(::std::memory_order_relaxed); }
+        // The value that the given percentage of the values are at or
+        // below, as the highest value of its bucket. 0 if empty.
+        uint64_t get_percentile(const double& percentile) const;
+
+        // The bucket a value is counted in.
+        static uint32_t get_bucket_index(const uint64_t& value);
+        // The highest value counted in a bucket.
+        static uint64_t get_bucket_max(const uint32_t& bucket_index);
+
+        // The number of bits of precision kept for each value.
+        static constexpr uint32_t SUB_BUCKET_BITS = 5;
+        // The number of buckets. Covers values up to about 2^36.
+        static constexpr uint32_t BUCKET_COUNT = 1024;
+
+    private:
+        // The number of values counted in each bucket.
+        ::std::array<::std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+        // The number of values recorded.
+        ::std::atomic<uint64_t> m_count{0};
+        // The largest value recorded.
+        ::std::atomic<uint64_t> m_max{0};
+    };
+
+    // The quantities measured each frame. The counts of the main pass
+    // are only measured with pipeline statistics enabled.
+    enum class FrameMetric : uint32_t {
+        // The time between the starts of two frames, in microseconds.
+        CPU_FRAME_TIME,
+        // The GPU time of the frame command buffer, in microseconds.
+        GPU_FRAME_TIME,
+        // The time spent waiting for the in flight fence, in microseconds.
+        FENCE_WAIT_TIME,
+        // The time spent acquiring a swapchain image, in microseconds.
+        ACQUIRE_TIME,
+        // The time spent recording the frame command buffer, or looking
+        // up its cached recording, in microseconds.
+        RECORD_TIME,
+        // The time spent updating the uniform buffer, in microseconds.
+        UNIFORM_UPDATE_TIME,
+        // The time spent writing the animated instance transforms,
+        // in microseconds. Only measured with an animated scene.
+        INSTANCE_UPDATE_TIME,
+        // The time spent submitting to the graphics queue, in microseconds.
+        SUBMIT_TIME,
+        // The time spent queueing the image for presentation,
+        // in microseconds.
+        PRESENT_TIME,
+        // The vertices read by the main pass.
+        INPUT_ASSEMBLY_VERTICES,
+        // The primitives read by the main pass.
+        INPUT_ASSEMBLY_PRIMITIVES,
+        // The vertex shader invocations of the main pass.
+        VERTEX_SHADER_INVOCATIONS,
+        // The primitives of the main pass that reached clipping.
+        CLIPPING_INVOCATIONS,
+        // The primitives of the main pass that survived clipping.
+        CLIPPING_PRIMITIVES,
+        // The fragment shader invocations of the main pass.
+        FRAGMENT_SHADER_INVOCATIONS,
+        // The pixels of the main pass render target times its samples.
+        RENDER_TARGET_SAMPLES,
+        // The fragment shader invocations of the main pass per hundred
+        // pixels of the render target. Without sample shading the
+        // fragment shader runs once per pixel a primitive covers, so
+        // 100 is every pixel shaded once.
+        FRAGMENT_OVERDRAW_PERCENT,
+        // The heap allocations made from the start of the frame to the
+        // start of the next. Only measured while AllocationTracker counts.
+        ALLOCATION_COUNT,
+        // The bytes the frame allocated from its FrameArena.
+        FRAME_ARENA_BYTES,
+        // The number of metrics. Not a metric.
+        COUNT
+    };
+
+    // The name of a metric, as used in the JSON report.
+    const char* get_frame_metric_name(const FrameMetric& metric);
+
+    // Records the metrics of each frame into histograms covering the
+    // latest window of frames and the whole run, and counts hitches:
+    // values above the threshold of their metric.
+    //
+    // The render thread records and ends frames. Any thread may query.
+    class FrameStatistics final {
+    public:
+        // The percentiles of one metric over some frames.
+        struct Summary {
+            // The number of values.
+            uint64_t count = 0;
+            // The median.
+            uint64_t p50 = 0;
+            // The 90th percentile.
+            uint64_t p90 = 0;
+            // The 99th percentile.
+            uint64_t p99 = 0;
+            // The largest value.
+            uint64_t max = 0;
+            // The number of values above the hitch threshold.
+            uint64_t hitch_count = 0;
+        };
+
+        // Creates statistics whose windows span window_size frames.
+        FrameStatistics(const uint32_t& window_size = 256);
+
+        // Prevent copying.
+        inline FrameStatistics(const FrameStatistics&) = delete;
+        // Prevent copy re-assignment.
+        inline FrameStatistics& operator= (const FrameStatistics&) = delete;
+
+        // Records a value of a metric for the current frame.
+        void record(const FrameMetric& metric, const uint64_t& value);
+        // Ends the current frame, starting a new window once the
+        // current one spans window_size frames.
+        void end_frame();
+        // Sets the value above which a metric counts as a hitch.
+        // 0 disables hitch detection for the metric.
+        void set_hitch_threshold(
+            const FrameMetric& metric, const uint64_t& threshold
+        );
+
+        // The summary of the latest complete window, or of the current
+        // window if none is complete yet.
+        Summary get_window_summary(const FrameMetric& metric) const;
+        // The summary of every frame recorded.
+        Summary get_total_summary(const FrameMetric& metric) const;
+        // The number of frames ended.
+        inline uint64_t get_frame_count() const
+        { return m_frame_count.load(::std::memory_order_relaxed); }
+
+        // Writes the summaries of every metric as a JSON object.
+        void write_json(::std::ostream& stream) const;
+        // Writes the JSON report to a file.
+        void write_json(const ::std::string& path) const;
+        // Logs the summaries of the metrics that have values.
+        void log_summary() const;
+
+    private:
+        // The histograms and hitch counts of one metric.
+        struct MetricData {
+            // The current and the latest complete window.
+            ::std::array<LatencyHistogram, 2> windows;
+            // The hitches of each window.
+            ::std::array<::std::atomic<uint64_t>, 2> window_hitch_counts{};
+            // Every value recorded.
+            LatencyHistogram total;
+            // Every hitch recorded.
+            ::std::atomic<uint64_t> total_hitch_count{0};
+            // The value above which a value is a hitch. 0 if disabled.
+            ::std::atomic<uint64_t> hitch_threshold{0};
+        };
+
+        // Summarizes a histogram.
+        static Summary summarize(
+            const LatencyHistogram& histogram, const uint64_t& hitch_count
+        );
+
+        // The data of each metric.
+        ::std::array<MetricData, static_cast<size_t>(FrameMetric::COUNT)>
+            m_metrics;
+        // The number of frames a window spans.
+        uint32_t m_window_size;
+        // The number of frames ended in the current window.
+        uint32_t m_window_frame_count = 0;
+        // The index of the window being recorded into.
+        ::std::atomic<uint32_t> m_current_window{0};
+        // Whether a window was completed.
+        ::std::atomic<bool> m_has_complete_window{false};
+        // The number of frames ended.
+        ::std::atomic<uint64_t> m_frame_count{0};
+    };
+
+    // Records the time from its construction to its destruction
+    // as a value of a metric, in microseconds.
+    class ScopedFrameTimer final {
+    public:
+        // Starts timing.
+        ScopedFrameTimer(
+            FrameStatistics& statistics, const FrameMetric& metric
+        );
+        // Records the time passed.
+        ~ScopedFrameTimer();
+
+        // Prevent copying.
+        inline ScopedFrameTimer(const ScopedFrameTimer&) = delete;
+        // Prevent copy re-assignment.
+        inline ScopedFrameTimer& operator= (const ScopedFrameTimer&) = delete;
+
+    private:
+        // The statistics recorded into.
+        FrameStatistics& m_statistics;
+        // The metric recorded.
+        FrameMetric m_metric;
+        // When timing started.
+        ::std::chrono::steady_clock::time_point m_start_time;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
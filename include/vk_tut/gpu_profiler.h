@@ -0,0 +1,148 @@
+#if !defined(_VK_TUT_GPU_PROFILER_HEADER_)
+#define _VK_TUT_GPU_PROFILER_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vk::tut {
+    // Rolling statistics over the latest durations of a region.
+    class GpuTimingStats final {
+    public:
+        // Default constructor.
+        inline GpuTimingStats() {}
+
+        // Adds a duration, replacing the oldest one once the window is full.
+        void add_sample(const double& milliseconds);
+
+        // The average of the durations in the window.
+        double get_average() const;
+        // The shortest duration in the window.
+        double get_min() const;
+        // The longest duration in the window.
+        double get_max() const;
+        // The number of durations in the window.
+        inline uint32_t get_sample_count() const { return m_sample_count; }
+        // The latest duration. 0 if there is none.
+        inline double get_latest() const { return m_latest; }
+        // The number of durations ever added.
+        inline uint64_t get_total_sample_count() const
+        { return m_total_sample_count; }
+
+        // The number of durations the statistics are computed over.
+        static constexpr uint32_t WINDOW_SIZE = 64;
+
+    private:
+        // The latest durations in milliseconds, as a ring.
+        ::std::array<double, WINDOW_SIZE> m_samples{};
+        // The index the next duration is written to.
+        uint32_t m_next_sample = 0;
+        // The number of valid durations.
+        uint32_t m_sample_count = 0;
+        // The latest duration.
+        double m_latest = 0.0;
+        // The number of durations ever added.
+        uint64_t m_total_sample_count = 0;
+    };
+
+    // Measures the GPU time of named regions of a command buffer with
+    // timestamp queries. Each frame slot has its own query pool, which is
+    // read once the fence of the slot has signalled, so reading the
+    // results never waits on the GPU.
+    //
+    // Each region name keeps the same queries from frame to frame, so
+    // command buffers recorded once and submitted many times keep working.
+    class GpuProfiler final {
+    public:
+        // Default constructor.
+        inline GpuProfiler() {}
+
+        // Prevent copying.
+        inline GpuProfiler(const GpuProfiler&) = delete;
+        // Prevent copy re-assignment.
+        inline GpuProfiler& operator= (const GpuProfiler&) = delete;
+
+        // Creates one query pool per slot. Does nothing if the queue
+        // family can not write timestamps.
+        void create(
+            const VkPhysicalDevice& physical_device,
+            const VkDevice& logical_device,
+            const uint32_t& queue_family_index,
+            const uint32_t& slot_count
+        );
+        // Destroys what create() made.
+        void destroy(const VkDevice& logical_device);
+
+        // Resets the queries of the slot. Recorded at the start of a
+        // command buffer, outside of any render pass.
+        void begin_frame(
+            const VkCommandBuffer& command_buffer, const uint32_t& slot
+        );
+        // Writes the timestamp starting a region.
+        void begin_region(
+            const VkCommandBuffer& command_buffer,
+            const uint32_t& slot,
+            const ::std::string& name
+        );
+        // Writes the timestamp ending the region last begun with the name.
+        void end_region(
+            const VkCommandBuffer& command_buffer,
+            const uint32_t& slot,
+            const ::std::string& name
+        );
+        // The command buffer recorded for the slot was submitted.
+        void submit(const uint32_t& slot);
+        // Reads the results of the last frame submitted for the slot,
+        // once its fence has signalled. Regions whose timestamps are
+        // not available yet are skipped.
+        void collect(const VkDevice& logical_device, const uint32_t& slot);
+
+        // Logs the statistics of every region.
+        void log_stats() const;
+
+        // Whether timestamps are written.
+        inline bool is_enabled() const { return !m_query_pools.empty(); }
+        // The names of the regions, in the order they were first begun.
+        inline const ::std::vector<::std::string>& get_region_names() const
+        { return m_region_names; }
+        // The statistics of a region. Empty if it was never measured.
+        GpuTimingStats get_stats(const ::std::string& name) const;
+
+        // The number of regions that can be measured.
+        static constexpr uint32_t MAX_REGIONS = 32;
+
+    private:
+        // The index of a region, added on first use. MAX_REGIONS if full.
+        uint32_t find_region(const ::std::string& name);
+
+        // The query pool of each slot. Region i uses queries 2i and 2i+1.
+        ::std::vector<VkQueryPool> m_query_pools;
+        // Whether each slot holds a submitted frame not collected yet.
+        ::std::vector<bool> m_slot_submitted;
+        // The nanoseconds per timestamp tick.
+        double m_timestamp_period = 1.0;
+        // The bits of a timestamp that are valid.
+        uint64_t m_timestamp_mask = 0;
+        // The region names, indexed by region.
+        ::std::vector<::std::string> m_region_names;
+        // The region index of each name.
+        ::std::unordered_map<::std::string, uint32_t> m_region_indices;
+        // The statistics, indexed by region.
+        ::std::vector<GpuTimingStats> m_region_stats;
+        // Receives the timestamps and availability of a pool.
+        ::std::vector<uint64_t> m_query_results;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
@@ -0,0 +1,236 @@
+#if !defined(_VK_TUT_HOST_ALLOCATOR_HEADER_)
+#define _VK_TUT_HOST_ALLOCATOR_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace vk::tut {
+    // The host memory allocator of the Vulkan implementation. Every
+    // object is created with its callbacks, so the host memory the driver
+    // uses is counted per allocation scope and per object type.
+    //
+    // Small allocations come from size class pools carved out of arenas.
+    // Each allocation scope has its own arenas, so the short lived
+    // command scope allocations don't fragment the long lived ones.
+    // Larger allocations go straight to the system allocator.
+    class HostAllocator final {
+    public:
+        // The host memory used by an allocation scope or object type.
+        struct Usage {
+            // The number of live allocations.
+            uint64_t allocation_count = 0;
+            // The bytes of the live allocations, as requested.
+            uint64_t bytes = 0;
+            // The most bytes live at once.
+            uint64_t peak_bytes = 0;
+            // The number of allocations ever made.
+            uint64_t total_allocation_count = 0;
+        };
+
+        // Prevent copying.
+        inline HostAllocator(const HostAllocator&) = delete;
+        // Prevent copy re-assignment.
+        inline HostAllocator& operator= (const HostAllocator&) = delete;
+
+        // The allocator shared by every Vulkan object.
+        static HostAllocator& get_instance();
+
+        // The callbacks to create and destroy objects of the type with.
+        // Object types not in OBJECT_TYPES count as unknown.
+        const VkAllocationCallbacks* get_callbacks(
+            const VkObjectType& object_type
+        ) const;
+
+        // The memory allocated through the callbacks in a scope.
+        Usage get_scope_usage(const VkSystemAllocationScope& scope) const;
+        // The memory allocated through the callbacks of an object type.
+        Usage get_object_type_usage(const VkObjectType& object_type) const;
+        // The memory the implementation allocated by itself, such as
+        // executable memory, as it reported it for a scope.
+        Usage get_internal_usage(const VkSystemAllocationScope& scope) const;
+        // The bytes the pools hold in arenas, in use or not.
+        uint64_t get_arena_bytes() const;
+
+        // Logs the usage of every scope and object type that allocated.
+        void log_stats() const;
+
+        // The name of an allocation scope, for logging.
+        static const char* get_scope_name(
+            const VkSystemAllocationScope& scope
+        );
+        // The name of an object type in OBJECT_TYPES, for logging.
+        static const char* get_object_type_name(
+            const VkObjectType& object_type
+        );
+
+        // The object types counted apart. The first counts the rest.
+        static constexpr ::std::array<VkObjectType, 23> OBJECT_TYPES = {
+            VK_OBJECT_TYPE_UNKNOWN,
+            VK_OBJECT_TYPE_INSTANCE,
+            VK_OBJECT_TYPE_DEVICE,
+            VK_OBJECT_TYPE_SEMAPHORE,
+            VK_OBJECT_TYPE_FENCE,
+            VK_OBJECT_TYPE_DEVICE_MEMORY,
+            VK_OBJECT_TYPE_BUFFER,
+            VK_OBJECT_TYPE_IMAGE,
+            VK_OBJECT_TYPE_QUERY_POOL,
+            VK_OBJECT_TYPE_IMAGE_VIEW,
+            VK_OBJECT_TYPE_SHADER_MODULE,
+            VK_OBJECT_TYPE_PIPELINE_LAYOUT,
+            VK_OBJECT_TYPE_RENDER_PASS,
+            VK_OBJECT_TYPE_PIPELINE,
+            VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+            VK_OBJECT_TYPE_SAMPLER,
+            VK_OBJECT_TYPE_DESCRIPTOR_POOL,
+            VK_OBJECT_TYPE_FRAMEBUFFER,
+            VK_OBJECT_TYPE_COMMAND_POOL,
+            VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE,
+            VK_OBJECT_TYPE_SURFACE_KHR,
+            VK_OBJECT_TYPE_SWAPCHAIN_KHR,
+            VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT
+        };
+        // The number of allocation scopes.
+        static constexpr uint32_t SCOPE_COUNT = 5;
+        // The block size of the smallest size class. Each next size
+        // class has blocks twice as large.
+        static constexpr size_t MIN_BLOCK_SIZE = 32;
+        // The number of size classes. Larger allocations are not pooled.
+        static constexpr uint32_t SIZE_CLASS_COUNT = 9;
+        // The bytes the pools take from the system allocator at once.
+        static constexpr size_t ARENA_SIZE = 64 * 1024;
+
+    private:
+        // Only created by get_instance().
+        HostAllocator();
+        // Frees the arenas.
+        ~HostAllocator();
+
+        // Counts the memory of an allocation scope or object type.
+        // Updated from any thread the implementation allocates on.
+        struct UsageCounters {
+            // The number of live allocations.
+            ::std::atomic<uint64_t> allocation_count{0};
+            // The bytes of the live allocations.
+            ::std::atomic<uint64_t> bytes{0};
+            // The most bytes live at once.
+            ::std::atomic<uint64_t> peak_bytes{0};
+            // The number of allocations ever made.
+            ::std::atomic<uint64_t> total_allocation_count{0};
+
+            // Counts an allocation.
+            void add(const size_t& size);
+            // Counts a free.
+            void remove(const size_t& size);
+            // Copies the counters.
+            Usage get_usage() const;
+        };
+
+        // The blocks of one allocation scope.
+        struct Pool {
+            // Guards the pool.
+            ::std::mutex mutex;
+            // The first free block of each size class. Free blocks
+            // point to the next free block of their size class.
+            ::std::array<void*, SIZE_CLASS_COUNT> free_blocks{};
+            // The arenas the blocks were carved out of.
+            ::std::vector<void*> arenas;
+        };
+
+        // What the callbacks of an object type pass themselves.
+        struct CallbackData {
+            // The allocator.
+            HostAllocator* ptr_allocator = nullptr;
+            // The index of the object type in OBJECT_TYPES.
+            uint32_t object_type_index = 0;
+        };
+
+        // The index of an object type in OBJECT_TYPES. 0 if not found.
+        static uint32_t get_object_type_index(
+            const VkObjectType& object_type
+        );
+        // The index of a scope, treating unknown scopes as object scope.
+        static uint32_t get_scope_index(const VkSystemAllocationScope& scope);
+
+        // Allocates size bytes aligned to alignment.
+        void* allocate(
+            const size_t& size,
+            const size_t& alignment,
+            const VkSystemAllocationScope& scope,
+            const uint32_t& object_type_index
+        );
+        // Frees what allocate() returned. Does nothing for nullptr.
+        void free(void* ptr);
+        // Takes a free block of a size class, carving a new arena if
+        // the size class has no free blocks left.
+        void* take_block(Pool& ref_pool, const uint32_t& size_class);
+
+        // The callback allocating memory.
+        static void* VKAPI_CALL allocation_callback(
+            void* ptr_user_data,
+            size_t size,
+            size_t alignment,
+            VkSystemAllocationScope scope
+        );
+        // The callback resizing an allocation.
+        static void* VKAPI_CALL reallocation_callback(
+            void* ptr_user_data,
+            void* ptr_original,
+            size_t size,
+            size_t alignment,
+            VkSystemAllocationScope scope
+        );
+        // The callback freeing memory.
+        static void VKAPI_CALL free_callback(void* ptr_user_data, void* ptr);
+        // The callback telling of an allocation made by the driver itself.
+        static void VKAPI_CALL internal_allocation_callback(
+            void* ptr_user_data,
+            size_t size,
+            VkInternalAllocationType allocation_type,
+            VkSystemAllocationScope scope
+        );
+        // The callback telling of a free made by the driver itself.
+        static void VKAPI_CALL internal_free_callback(
+            void* ptr_user_data,
+            size_t size,
+            VkInternalAllocationType allocation_type,
+            VkSystemAllocationScope scope
+        );
+
+        // The pools of each allocation scope.
+        ::std::array<Pool, SCOPE_COUNT> m_pools;
+        // The bytes held in arenas.
+        ::std::atomic<uint64_t> m_arena_bytes{0};
+        // The usage of each allocation scope.
+        ::std::array<UsageCounters, SCOPE_COUNT> m_scope_usages;
+        // The usage of each object type in OBJECT_TYPES.
+        ::std::array<UsageCounters, OBJECT_TYPES.size()> m_object_type_usages;
+        // The internal allocations reported for each allocation scope.
+        ::std::array<UsageCounters, SCOPE_COUNT> m_internal_usages;
+        // What the callbacks of each object type pass themselves.
+        ::std::array<CallbackData, OBJECT_TYPES.size()> m_callback_data;
+        // The callbacks of each object type.
+        ::std::array<VkAllocationCallbacks, OBJECT_TYPES.size()> m_callbacks;
+    };
+
+    // The callbacks to create and destroy objects of the type with.
+    inline const VkAllocationCallbacks* get_allocation_callbacks(
+        const VkObjectType& object_type
+    ) {
+        return HostAllocator::get_instance().get_callbacks(object_type);
+    }
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
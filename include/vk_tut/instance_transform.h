@@ -0,0 +1,62 @@
+#if !defined(_VK_TUT_INSTANCE_TRANSFORM_HEADER_)
+#define _VK_TUT_INSTANCE_TRANSFORM_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+#include <array>
+
+namespace vk::tut {
+    // Encapsulate the placement of one instance of a mesh: a rotation,
+    // then a uniform scale, then a translation. Read once per instance
+    // by the vertex shaders, from the second vertex buffer binding.
+    class InstanceTransform final {
+    public:
+        // Default constructor. The identity transform.
+        inline InstanceTransform() {}
+
+        // Copy initializer list.
+        InstanceTransform(
+            const ::glm::vec3& position,
+            const float& scale,
+            const ::glm::vec4& rotation
+        );
+
+        // Copy constructor.
+        InstanceTransform(const InstanceTransform&);
+        // Move constructor.
+        InstanceTransform(InstanceTransform&&);
+        // Copy re-assignment.
+        InstanceTransform& operator= (const InstanceTransform&);
+        // Move re-assignment.
+        InstanceTransform& operator= (InstanceTransform&&);
+
+        // Getter for m_position_scale.
+        inline ::glm::vec4 get_position_scale() const
+        { return m_position_scale; }
+        // Getter for m_rotation.
+        inline ::glm::vec4 get_rotation() const { return m_rotation; }
+        // Copy setter for m_rotation.
+        void set_rotation(const ::glm::vec4&);
+
+        static VkVertexInputBindingDescription
+        get_binding_description();
+        static std::array<VkVertexInputAttributeDescription, 2>
+        get_attribute_descriptions();
+
+    private:
+        // The position in x, y and z, and the scale in w.
+        ::glm::vec4 m_position_scale = {0.0f, 0.0f, 0.0f, 1.0f};
+        // The rotation as a unit quaternion, with the real part in w.
+        ::glm::vec4 m_rotation = {0.0f, 0.0f, 0.0f, 1.0f};
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
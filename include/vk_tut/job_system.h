@@ -0,0 +1,265 @@
+#if !defined(_VK_TUT_JOB_SYSTEM_HEADER_)
+#define _VK_TUT_JOB_SYSTEM_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vk::tut {
+    class Job;
+
+    // Counts the unfinished jobs of a group. Jobs can be
+    // scheduled to run once a counter reaches zero. Keeps the first
+    // exception thrown by its jobs for JobSystem::wait() to rethrow.
+    class JobCounter final {
+    public:
+        // Default constructor.
+        inline JobCounter() {}
+
+        // Prevent copying.
+        inline JobCounter(const JobCounter&) = delete;
+        // Prevent moving.
+        inline JobCounter(JobCounter&&) = delete;
+        // Prevent copy re-assignment.
+        inline JobCounter& operator= (const JobCounter&) = delete;
+        // Prevent move re-assignment.
+        inline JobCounter& operator= (JobCounter&&) = delete;
+
+        // The number of unfinished jobs.
+        inline uint32_t get_value() const
+        { return m_value.load(::std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+        friend class Job;
+
+        // Adds count unfinished jobs.
+        void increment(const uint32_t& count);
+        // Marks a job finished. Returns the jobs
+        // waiting for the counter if it reached zero.
+        ::std::vector<Job*> decrement();
+        // Keeps exception unless one was kept already.
+        void set_exception(const ::std::exception_ptr& exception);
+        // Takes the exception kept, if any.
+        ::std::exception_ptr take_exception();
+
+        // The number of unfinished jobs.
+        ::std::atomic<uint32_t> m_value{0};
+        // Guards m_continuations.
+        ::std::mutex m_mutex;
+        // The jobs waiting for the counter to reach zero.
+        ::std::vector<Job*> m_continuations;
+        // The first exception thrown by a job. Guarded by m_mutex.
+        ::std::exception_ptr m_exception;
+    };
+
+    // A scheduled unit of work.
+    class Job final {
+    public:
+        // Copy initializer list constructor.
+        Job(::std::function<void()>&& function, JobCounter* ptr_counter);
+
+        // Prevent copying.
+        inline Job(const Job&) = delete;
+        // Prevent moving.
+        inline Job(Job&&) = delete;
+        // Prevent copy re-assignment.
+        inline Job& operator= (const Job&) = delete;
+        // Prevent move re-assignment.
+        inline Job& operator= (Job&&) = delete;
+
+        // Runs the job, then marks it finished in its counter, also
+        // when the work throws. The exception is kept by the counter, or
+        // dropped if the job has none. Returns the jobs that were waiting
+        // for that counter.
+        ::std::vector<Job*> execute();
+        // Gives a finished job new work, so jobs can be reused.
+        void reassign(
+            ::std::function<void()>&& function, JobCounter* ptr_counter
+        );
+
+    private:
+        // The work.
+        ::std::function<void()> m_function;
+        // Decremented once the work is done. Optional.
+        JobCounter* m_ptr_counter = nullptr;
+    };
+
+    // A fixed capacity lock-free work-stealing deque (Chase-Lev).
+    // Only the owner thread pushes and pops, at the bottom.
+    // Any thread steals, from the top.
+    class WorkStealingDeque final {
+    public:
+        // Capacity is rounded up to a power of two.
+        WorkStealingDeque(const size_t& capacity);
+
+        // Prevent copying.
+        inline WorkStealingDeque(const WorkStealingDeque&) = delete;
+        // Prevent moving.
+        inline WorkStealingDeque(WorkStealingDeque&&) = delete;
+        // Prevent copy re-assignment.
+        inline WorkStealingDeque&
+        operator= (const WorkStealingDeque&) = delete;
+        // Prevent move re-assignment.
+        inline WorkStealingDeque& operator= (WorkStealingDeque&&) = delete;
+
+        // Owner only. Returns false if the deque is full.
+        bool push(Job* ptr_job);
+        // Owner only. Takes the newest job, or nullptr.
+        Job* pop();
+        // Any thread. Takes the oldest job, or nullptr
+        // if the deque is empty or another thread won the race.
+        Job* steal();
+
+        // The number of jobs, only exact while no thread modifies it.
+        size_t get_size() const;
+
+    private:
+        // The buffer size minus one.
+        int64_t m_mask;
+        // The ring buffer of jobs.
+        ::std::unique_ptr<::std::atomic<Job*>[]> m_buffer;
+        // The next slot stolen from.
+        alignas(64) ::std::atomic<int64_t> m_top{0};
+        // The next slot pushed to.
+        alignas(64) ::std::atomic<int64_t> m_bottom{0};
+    };
+
+    // A thread pool whose workers steal jobs from each other.
+    // Threads waiting on a counter run jobs in the meantime.
+    class JobSystem final {
+    public:
+        // Starts worker_count worker threads. Zero means one less than
+        // the number of hardware threads. If pin_threads is set, worker
+        // i, counted from 1, is pinned to the CPU core i modulo the core
+        // count where supported, which leaves core 0 to the calling thread.
+        JobSystem(
+            const uint32_t& worker_count = 0,
+            const bool& pin_threads = false
+        );
+        // Runs the remaining jobs, then stops the worker threads.
+        // Continuations whose dependency never reached zero are freed
+        // without running.
+        ~JobSystem();
+
+        // Prevent copying.
+        inline JobSystem(const JobSystem&) = delete;
+        // Prevent moving.
+        inline JobSystem(JobSystem&&) = delete;
+        // Prevent copy re-assignment.
+        inline JobSystem& operator= (const JobSystem&) = delete;
+        // Prevent move re-assignment.
+        inline JobSystem& operator= (JobSystem&&) = delete;
+
+        // Schedules a job. The counter, if any, counts it until it is done.
+        void run(
+            ::std::function<void()>&& function,
+            JobCounter* ptr_counter = nullptr
+        );
+        // Schedules a job once dependency reaches zero.
+        void run_after(
+            JobCounter& dependency,
+            ::std::function<void()>&& function,
+            JobCounter* ptr_counter = nullptr
+        );
+        // Runs jobs on the calling thread until counter reaches zero.
+        // Then rethrows the first exception thrown by its jobs, if any.
+        void wait(JobCounter& counter);
+
+        // Calls body(begin, end) over [0, count) in
+        // ranges of grain_size and waits for all of them.
+        // Rethrows the first exception thrown by body, if any.
+        // Does not allocate once the job pool is warm.
+        void parallel_for(
+            const size_t& count,
+            const size_t& grain_size,
+            const ::std::function<void(size_t, size_t)>& body
+        );
+
+        // The worker threads plus the thread waiting on the jobs.
+        inline uint32_t get_thread_count() const
+        { return static_cast<uint32_t>(m_workers.size()) + 1; }
+        // 1 to worker count on the workers of this job system. 0 otherwise.
+        uint32_t get_current_thread_index() const;
+
+    private:
+        // The loop of the worker thread.
+        void worker_main(const uint32_t& worker_index);
+        // Queues a job that is ready to run.
+        void schedule(Job* ptr_job);
+        // Takes a job to run on the calling thread, or nullptr.
+        Job* take_job();
+        // Runs a job, recycles it and schedules what waited on it.
+        void execute(Job* ptr_job);
+        // A job from the pool, or a new one if the pool is empty.
+        Job* acquire_job(
+            ::std::function<void()>&& function, JobCounter* ptr_counter
+        );
+        // Returns a finished job to the pool.
+        void release_job(Job* ptr_job);
+
+        // The finished jobs a worker keeps for itself. Aligned so that
+        // workers do not share the cache line of their vectors.
+        struct alignas(64) WorkerJobPool {
+            // The jobs, only ever touched by the owning worker.
+            ::std::vector<Job*> free_jobs;
+        };
+
+        // One deque per worker, index 0 is unused.
+        ::std::vector<::std::unique_ptr<WorkStealingDeque>> m_deques;
+        // The worker threads.
+        ::std::vector<::std::thread> m_workers;
+        // Jobs scheduled from threads outside of the job system. Taken
+        // from m_injected_head on, and cleared once all are taken so
+        // the capacity is reused.
+        ::std::vector<Job*> m_injected_jobs;
+        // The index of the next injected job to take.
+        size_t m_injected_head = 0;
+        // The number of injected jobs not taken yet, so that the
+        // workers only lock m_injected_mutex when there are some.
+        ::std::atomic<uint32_t> m_injected_job_count{0};
+        // Guards m_injected_jobs and m_injected_head.
+        ::std::mutex m_injected_mutex;
+        // Guards the sleep of the workers.
+        ::std::mutex m_mutex;
+        // Wakes the sleeping workers.
+        ::std::condition_variable m_wake;
+        // The number of workers asleep or about to be. Scheduling only
+        // locks m_mutex to wake one when this is not zero.
+        ::std::atomic<uint32_t> m_sleeping_worker_count{0};
+        // The number of jobs queued but not taken yet.
+        ::std::atomic<uint32_t> m_queued_job_count{0};
+        // Set when the workers should exit.
+        ::std::atomic<bool> m_stop{false};
+
+        // One pool of finished jobs per worker, index 0 is unused.
+        // Workers reuse their own jobs without locking, and trade
+        // them with m_free_jobs in batches.
+        ::std::vector<WorkerJobPool> m_worker_job_pools;
+        // Guards m_jobs and m_free_jobs.
+        ::std::mutex m_free_jobs_mutex;
+        // Every job made, whether running, queued, waiting on a
+        // dependency or pooled. Freed with the job system.
+        ::std::vector<::std::unique_ptr<Job>> m_jobs;
+        // Finished jobs shared by every thread, so that scheduling
+        // does not allocate once as many jobs ran before. Threads
+        // outside of the job system take their jobs from here.
+        ::std::vector<Job*> m_free_jobs;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
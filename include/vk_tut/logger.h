@@ -0,0 +1,273 @@
+#if !defined(_VK_TUT_LOGGER_HEADER_)
+#define _VK_TUT_LOGGER_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace vk::tut {
+    // How important a log message is. The logger skips the messages
+    // below its level without formatting them.
+    enum class LogLevel : uint8_t {
+        TRACE,
+        DEBUG,
+        INFO,
+        ERROR
+    };
+
+    // The level a level name of the log macros stands for, ignoring
+    // case. Names other than TRACE, DEBUG and ERROR stand for INFO.
+    constexpr LogLevel get_log_level(const char* name) {
+        auto equals = [](const char* a, const char* upper_case) {
+            for (; *a != '\0' && *upper_case != '\0'; a++, upper_case++) {
+                const char upper = *a >= 'a' && *a <= 'z' ?
+                    static_cast<char>(*a - 'a' + 'A') : *a;
+                if (upper != *upper_case) return false;
+            }
+            return *a == *upper_case;
+        };
+
+        if (equals(name, "TRACE")) return LogLevel::TRACE;
+        if (equals(name, "DEBUG")) return LogLevel::DEBUG;
+        if (equals(name, "ERROR")) return LogLevel::ERROR;
+        return LogLevel::INFO;
+    }
+
+    // The file name at the end of a path. Evaluated at compile time
+    // by the log macros, so logging never builds a path.
+    constexpr const char* get_file_basename(const char* path) {
+        const char* basename = path;
+        for (const char* ptr_char = path; *ptr_char != '\0'; ptr_char++) {
+            if (*ptr_char == '/' || *ptr_char == '\\') {
+                basename = ptr_char + 1;
+            }
+        }
+        return basename;
+    }
+
+    // A formatted log message, waiting to be written.
+    struct LogRecord {
+        // The number of characters a message keeps. Longer messages
+        // are cut short and end with "...".
+        static constexpr uint32_t TEXT_CAPACITY = 512;
+
+        // Orders the messages of every thread.
+        uint64_t sequence = 0;
+        // How important the message is.
+        LogLevel level = LogLevel::INFO;
+        // The name of the level, as given to the log macro.
+        const char* level_name = nullptr;
+        // The terminal colour code of the level.
+        const char* colour_code = nullptr;
+        // The name of the file that logged.
+        const char* file_name = nullptr;
+        // The line that logged.
+        uint32_t line = 0;
+        // The number of characters of text.
+        uint32_t length = 0;
+        // Where the message is written. Must outlive the message.
+        ::std::ostream* ptr_stream = nullptr;
+        // The message, not null terminated.
+        char text[TEXT_CAPACITY];
+    };
+
+    // The pending messages of one thread. Only the owning thread
+    // pushes and only the draining thread pops, so neither locks.
+    // Messages past the capacity are dropped instead of waiting.
+    class LogRing final {
+    public:
+        // Creates an empty ring. The capacity is a power of 2.
+        LogRing(const uint32_t& capacity);
+
+        // Prevent copying.
+        inline LogRing(const LogRing&) = delete;
+        // Prevent copy re-assignment.
+        inline LogRing& operator= (const LogRing&) = delete;
+
+        // Copies a message in. Returns false if the ring is full.
+        // Only called by the owning thread.
+        bool try_push(const LogRecord& record);
+        // The oldest message, or nullptr if there is none.
+        // Only called by the draining thread.
+        const LogRecord* peek() const;
+        // Forgets the message returned by peek().
+        // Only called by the draining thread.
+        void pop();
+
+        // Counts a dropped message. Only called by the owning thread.
+        inline void count_dropped()
+        { m_dropped_count.fetch_add(1, ::std::memory_order_relaxed); }
+        // Takes the number of messages dropped since the last call.
+        inline uint32_t take_dropped_count()
+        { return m_dropped_count.exchange(0, ::std::memory_order_relaxed); }
+
+        // Whether the owning thread has exited.
+        inline bool is_orphaned() const
+        { return m_is_orphaned.load(::std::memory_order_acquire); }
+        // Marks the owning thread exited.
+        inline void set_orphaned()
+        { m_is_orphaned.store(true, ::std::memory_order_release); }
+
+    private:
+        // The slots, used as a ring.
+        ::std::vector<LogRecord> m_records;
+        // The total number of messages popped.
+        ::std::atomic<uint32_t> m_read_count{0};
+        // The total number of messages pushed.
+        ::std::atomic<uint32_t> m_write_count{0};
+        // The number of messages dropped and not reported yet.
+        ::std::atomic<uint32_t> m_dropped_count{0};
+        // Whether the owning thread has exited.
+        ::std::atomic<bool> m_is_orphaned{false};
+    };
+
+    // Writes the log messages of every thread from a background thread,
+    // so logging costs a copy into the ring of the calling thread and
+    // never waits on the terminal. Error messages are written before
+    // the logging thread carries on, as they are followed by a throw.
+    class Logger final {
+    public:
+        // Prevent copying.
+        inline Logger(const Logger&) = delete;
+        // Prevent copy re-assignment.
+        inline Logger& operator= (const Logger&) = delete;
+
+        // The logger shared by every thread. The level starts at the
+        // VK_TUT_LOG_LEVEL environment variable, or TRACE if unset.
+        static Logger& get_instance();
+
+        // Whether messages of the level are logged.
+        inline bool is_enabled(const LogLevel& level) const
+        { return level >= m_level.load(::std::memory_order_relaxed); }
+        // Getter for m_level.
+        inline LogLevel get_level() const
+        { return m_level.load(::std::memory_order_relaxed); }
+        // Skips the messages below the level from now on.
+        void set_level(const LogLevel& level);
+
+        // Queues a message from the calling thread, numbering it.
+        void submit(LogRecord& ref_record);
+        // Writes every message queued so far, on the calling thread.
+        void flush();
+
+        // The number of messages dropped because a ring was full.
+        inline uint64_t get_dropped_count() const
+        { return m_dropped_count.load(::std::memory_order_relaxed); }
+
+        // The number of messages each thread can have pending.
+        static constexpr uint32_t RECORDS_PER_THREAD = 256;
+
+    private:
+        // Only created by get_instance().
+        Logger();
+        // Writes the pending messages and stops the background thread.
+        ~Logger();
+
+        // The ring of the calling thread, created on first use.
+        LogRing& get_thread_ring();
+        // Writes the pending messages of every ring in order.
+        // Only called with m_drain_mutex locked.
+        void drain();
+        // Runs on the background thread until the logger is destroyed.
+        void run_drain_loop();
+
+        // The lowest level logged.
+        ::std::atomic<LogLevel> m_level{LogLevel::TRACE};
+        // The sequence number of the next message.
+        ::std::atomic<uint64_t> m_next_sequence{0};
+        // The number of messages dropped.
+        ::std::atomic<uint64_t> m_dropped_count{0};
+
+        // Guards m_rings.
+        ::std::mutex m_rings_mutex;
+        // The ring of every thread that logged. Rings of exited
+        // threads are released once their messages are written.
+        ::std::vector<::std::shared_ptr<LogRing>> m_rings;
+
+        // Makes one thread at a time the draining thread.
+        ::std::mutex m_drain_mutex;
+        // The rings drained, copied from m_rings. Only used by drain().
+        ::std::vector<::std::shared_ptr<LogRing>> m_drained_rings;
+        // The streams written since they were last flushed.
+        // Only used by drain().
+        ::std::vector<::std::ostream*> m_written_streams;
+
+        // Guards m_is_stopping.
+        ::std::mutex m_stop_mutex;
+        // Wakes the background thread to stop.
+        ::std::condition_variable m_stop_condition;
+        // Whether the background thread should stop.
+        bool m_is_stopping = false;
+        // Writes the pending messages a few times a frame.
+        ::std::thread m_drain_thread;
+    };
+
+    // Formats one message into a record on the stack, for the log macros.
+    class LogMessage final {
+    public:
+        // Starts an empty message.
+        LogMessage(
+            const LogLevel& level,
+            const char* level_name,
+            const char* colour_code,
+            const char* file_name,
+            const uint32_t& line,
+            ::std::ostream& ref_output_stream
+        );
+
+        // Prevent copying.
+        inline LogMessage(const LogMessage&) = delete;
+        // Prevent copy re-assignment.
+        inline LogMessage& operator= (const LogMessage&) = delete;
+
+        // The stream the message is formatted with.
+        inline ::std::ostream& get_stream() { return m_stream; }
+        // Queues the message to the logger.
+        void submit();
+
+    private:
+        // Writes into the text of the record, cutting off the rest.
+        class TextBuffer final : public ::std::streambuf {
+        public:
+            // Writes into the text.
+            TextBuffer(char* ptr_text, const uint32_t& capacity);
+
+            // The number of characters written.
+            inline uint32_t get_length() const
+            { return static_cast<uint32_t>(pptr() - pbase()); }
+            // Whether characters were cut off.
+            inline bool is_truncated() const { return m_is_truncated; }
+
+        protected:
+            // Called when the text is full.
+            int_type overflow(int_type character) override;
+
+        private:
+            // Whether characters were cut off.
+            bool m_is_truncated = false;
+        };
+
+        // The message being formatted.
+        LogRecord m_record;
+        // Writes into m_record.text.
+        TextBuffer m_buffer;
+        // Formats into m_buffer.
+        ::std::ostream m_stream;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
@@ -3,18 +3,32 @@
 
 // C++ only region.
 #if defined(__cplusplus)
+#include "vk_tut/logger.h"
+
 #include <iostream>
 #include <stdexcept>
-#include <filesystem>
 
 // < --------------------------- Logging Macros --------------------------- >
 
 // General logging macro.
+// Formats the message on the stack and queues it to the logger, which
+// writes it to the output stream from its own thread. Messages below
+// the level of the logger are not formatted at all.
 #if !defined(VK_TUT_LOG)
 #define VK_TUT_LOG(_LEVEL_, _COLOUR_CODE_, _OUTPUT_STREAM_, msg) \
-_OUTPUT_STREAM_ << #_COLOUR_CODE_ << "[" << #_LEVEL_ << "]\033[0m\t" \
-<< msg << " " << #_COLOUR_CODE_ << "[line " << __LINE__ << " of " \
-<< ::std::filesystem::path(__FILE__).filename().string() << "]\033[0m\n"
+do { \
+    constexpr ::vk::tut::LogLevel vk_tut_log_level = \
+        ::vk::tut::get_log_level(#_LEVEL_); \
+    if (::vk::tut::Logger::get_instance().is_enabled(vk_tut_log_level)) { \
+        constexpr const char* vk_tut_log_file_name = \
+            ::vk::tut::get_file_basename(__FILE__); \
+        ::vk::tut::LogMessage vk_tut_log_message(vk_tut_log_level, \
+            #_LEVEL_, #_COLOUR_CODE_, vk_tut_log_file_name, __LINE__, \
+            _OUTPUT_STREAM_); \
+        vk_tut_log_message.get_stream() << msg; \
+        vk_tut_log_message.submit(); \
+    } \
+} while (false)
 #endif
 
 // Trace log macro.
@@ -38,7 +52,8 @@ VK_TUT_LOG(DEBUG, \033[0;96m, ::std::cout, msg)
 // End Debug log macro.
 
 // Error log macro.
-// Will throw a runtime exception when called.
+// Will throw a runtime exception when called,
+// after the message has been written.
 #if !defined(VK_TUT_LOG_ERROR)
 #define VK_TUT_LOG_ERROR(msg) \
 VK_TUT_LOG(ERROR, \033[0;91m, ::std::cerr, msg); \
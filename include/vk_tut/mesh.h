@@ -0,0 +1,46 @@
+#if !defined(_VK_TUT_MESH_HEADER_)
+#define _VK_TUT_MESH_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include "vk_tut/vertex.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vk::tut {
+    // Appends a colour wheel: a fan of thin triangles around a centre
+    // vertex, coloured by angle. The indices are relative to the first
+    // vertex appended.
+    void generate_colour_wheel_mesh(
+        const uint32_t& triangle_count,
+        ::std::vector<Vertex>& ref_vertices,
+        ::std::vector<uint32_t>& ref_indices
+    );
+
+    // Appends a cube of side 1 around the origin, with four vertices
+    // per face so that each face is textured and coloured on its own.
+    // The indices are relative to the first vertex appended.
+    void generate_cube_mesh(
+        ::std::vector<Vertex>& ref_vertices,
+        ::std::vector<uint32_t>& ref_indices
+    );
+
+    // Appends a sphere of radius 0.5 around the origin, split into
+    // segment_count slices around its axis and half as many rings,
+    // coloured by its normal. Appends nothing below 3 segments.
+    // The indices are relative to the first vertex appended.
+    void generate_sphere_mesh(
+        const uint32_t& segment_count,
+        ::std::vector<Vertex>& ref_vertices,
+        ::std::vector<uint32_t>& ref_indices
+    );
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
@@ -0,0 +1,98 @@
+#if !defined(_VK_TUT_PIPELINE_STATISTICS_HEADER_)
+#define _VK_TUT_PIPELINE_STATISTICS_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace vk::tut {
+    // Counts the vertices, primitives and shader invocations of a span
+    // of a command buffer with a pipeline statistics query. Like the
+    // GPU profiler, each frame slot has its own query pool, read once
+    // the fence of the slot has signalled, so reading never waits.
+    //
+    // Needs the pipelineStatisticsQuery device feature, and the
+    // inheritedQueries feature if the span executes secondary command
+    // buffers, which must then inherit get_flags().
+    class PipelineStatisticsQueries final {
+    public:
+        // The counters, in the order the query writes them.
+        enum class Counter : uint32_t {
+            // The vertices read by the input assembly.
+            INPUT_ASSEMBLY_VERTICES,
+            // The primitives read by the input assembly.
+            INPUT_ASSEMBLY_PRIMITIVES,
+            // The vertex shader invocations.
+            VERTEX_SHADER_INVOCATIONS,
+            // The primitives that reached the clipping stage.
+            CLIPPING_INVOCATIONS,
+            // The primitives output by the clipping stage.
+            CLIPPING_PRIMITIVES,
+            // The fragment shader invocations.
+            FRAGMENT_SHADER_INVOCATIONS,
+            // The number of counters. Not a counter.
+            COUNT
+        };
+
+        // Default constructor.
+        inline PipelineStatisticsQueries() {}
+
+        // Prevent copying.
+        inline PipelineStatisticsQueries(
+            const PipelineStatisticsQueries&
+        ) = delete;
+        // Prevent copy re-assignment.
+        inline PipelineStatisticsQueries& operator= (
+            const PipelineStatisticsQueries&
+        ) = delete;
+
+        // Creates one query pool per slot.
+        void create(const VkDevice& logical_device, const uint32_t& slot_count);
+        // Destroys what create() made.
+        void destroy(const VkDevice& logical_device);
+
+        // Resets the query of the slot and starts counting. Recorded
+        // outside of any render pass.
+        void begin(
+            const VkCommandBuffer& command_buffer, const uint32_t& slot
+        );
+        // Stops counting. Recorded outside of any render pass.
+        void end(const VkCommandBuffer& command_buffer, const uint32_t& slot);
+        // The command buffer recorded for the slot was submitted.
+        void submit(const uint32_t& slot);
+        // Reads the counters of the last frame submitted for the slot,
+        // once its fence has signalled. Returns whether they were
+        // available.
+        bool collect(const VkDevice& logical_device, const uint32_t& slot);
+
+        // Whether the counters are queried.
+        inline bool is_enabled() const { return !m_query_pools.empty(); }
+        // The counters of the latest frame collected.
+        inline uint64_t get_latest(const Counter& counter) const
+        { return m_latest_counts[static_cast<size_t>(counter)]; }
+
+        // The statistics queried, which secondary command
+        // buffers executed while counting must inherit.
+        static VkQueryPipelineStatisticFlags get_flags();
+
+    private:
+        // The query pool of each slot, with a single query.
+        ::std::vector<VkQueryPool> m_query_pools;
+        // Whether each slot holds a submitted frame not collected yet.
+        ::std::vector<bool> m_slot_submitted;
+        // The counters of the latest frame collected.
+        ::std::array<uint64_t, static_cast<size_t>(Counter::COUNT)>
+            m_latest_counts{};
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
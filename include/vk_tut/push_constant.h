@@ -0,0 +1,47 @@
+#if !defined(_VK_TUT_PUSH_CONSTANT_HEADER_)
+#define _VK_TUT_PUSH_CONSTANT_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <cstdint>
+
+namespace vk::tut {
+    // The number of slots in the bindless texture table.
+    // Passed to the fragment shader as a specialization constant.
+    inline constexpr uint32_t MAX_BINDLESS_TEXTURES = 1024;
+
+    // Encapsulates the data pushed to the shaders for each draw.
+    class PushConstant final {
+    public:
+        // Default constructor.
+        inline PushConstant() {}
+        // Copy initializer list constructor.
+        PushConstant(const uint32_t& texture_index);
+
+        // Copy constructor.
+        PushConstant(const PushConstant&);
+        // Move constructor.
+        PushConstant(PushConstant&&);
+        // Copy re-assignment.
+        PushConstant& operator= (const PushConstant&);
+        // Move re-assignment.
+        PushConstant& operator= (PushConstant&&);
+
+        // Getter for m_texture_index.
+        inline uint32_t get_texture_index() const { return m_texture_index; }
+        // Copy setter for m_texture_index.
+        void set_texture_index(const uint32_t&);
+
+    private:
+        // The slot of the texture in the bindless texture table.
+        uint32_t m_texture_index = 0;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
@@ -61,6 +61,7 @@ namespace vk::tut {
     };
 
     // Find the family indices of a specific physical device.
+    // A null surface finds a graphics family for both.
     QueueFamilyIndices find_family_indices(
         const VkPhysicalDevice& physical_device, const VkSurfaceKHR& surface
     );
@@ -0,0 +1,141 @@
+#if !defined(_VK_TUT_READBACK_RING_HEADER_)
+#define _VK_TUT_READBACK_RING_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include "vk_tut/resource_state.h"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace vk::tut {
+    // A rendered frame copied back to host memory. Only valid
+    // within the callback it was handed to.
+    class ReadbackFrame final {
+    public:
+        // Copy initializer list constructor.
+        ReadbackFrame(
+            const uint64_t& frame_value,
+            const VkFormat& format,
+            const VkExtent2D& extent,
+            const void* ptr_data,
+            const VkDeviceSize& size
+        );
+
+        // Getter for m_frame_value.
+        inline uint64_t get_frame_value() const { return m_frame_value; }
+        // Getter for m_format.
+        inline VkFormat get_format() const { return m_format; }
+        // Getter for m_extent.
+        inline VkExtent2D get_extent() const { return m_extent; }
+        // Getter for m_ptr_data.
+        inline const void* get_data() const { return m_ptr_data; }
+        // Getter for m_size.
+        inline VkDeviceSize get_size() const { return m_size; }
+
+    private:
+        // The value of the frame the image was rendered in.
+        uint64_t m_frame_value = 0;
+        // The format of the pixels.
+        VkFormat m_format = VkFormat::VK_FORMAT_UNDEFINED;
+        // The size of the image. Rows are tightly packed.
+        VkExtent2D m_extent = {0, 0};
+        // The pixels, in mapped memory.
+        const void* m_ptr_data = nullptr;
+        // The size of the pixels in bytes.
+        VkDeviceSize m_size = 0;
+    };
+
+    // Copies the rendered image of each frame into one of several host
+    // visible buffers. A frame is handed back once the GPU is known to be
+    // done with it, so reading back never waits on the GPU.
+    //
+    // Slots follow the frames in flight: the copy recorded for a slot is
+    // retrieved before the slot is submitted again.
+    class ReadbackRing final {
+    public:
+        // Default constructor.
+        inline ReadbackRing() {}
+
+        // Prevent copying.
+        inline ReadbackRing(const ReadbackRing&) = delete;
+        // Prevent copy re-assignment.
+        inline ReadbackRing& operator= (const ReadbackRing&) = delete;
+
+        // Creates and maps one buffer per slot, each holding an image of
+        // the given format and extent. Prefers host cached memory, which
+        // the CPU reads much faster than write combined memory.
+        void create(
+            const VkPhysicalDevice& physical_device,
+            const VkDevice& logical_device,
+            const VkFormat& format,
+            const VkExtent2D& extent,
+            const uint32_t& bytes_per_pixel,
+            const uint32_t& slot_count
+        );
+        // Destroys what create() made. Pending frames are dropped.
+        void destroy(
+            const VkDevice& logical_device,
+            ResourceStateTracker& tracker
+        );
+
+        // Records copying the image, in the transfer source layout,
+        // into the buffer of the slot.
+        void record_copy(
+            const VkCommandBuffer& command_buffer,
+            const VkImage& image,
+            const uint32_t& slot,
+            ResourceStateTracker& tracker,
+            PFN_vkCmdPipelineBarrier2KHR cmd_pipeline_barrier2
+        );
+        // The copy recorded for the slot was submitted as frame_value.
+        void submit(const uint32_t& slot, const uint64_t& frame_value);
+        // Hands every submitted frame up to and including completed_value
+        // to consume, oldest first.
+        void retrieve(
+            const VkDevice& logical_device,
+            const uint64_t& completed_value,
+            const ::std::function<void(const ReadbackFrame&)>& consume
+        );
+
+        // Whether create() was called since the last destroy().
+        inline bool is_created() const { return !m_slots.empty(); }
+        // The number of submitted frames not retrieved yet.
+        size_t get_pending_count() const;
+
+    private:
+        // One buffer of the ring.
+        struct Slot {
+            // The buffer handle.
+            VkBuffer buffer = VK_NULL_HANDLE;
+            // The memory of the buffer.
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            // The persistently mapped memory.
+            void* ptr_data = nullptr;
+            // The value of the frame copied into the buffer.
+            // 0 if the buffer holds no frame to retrieve.
+            uint64_t frame_value = 0;
+        };
+
+        // The buffers, indexed by slot.
+        ::std::vector<Slot> m_slots;
+        // The format of the images copied.
+        VkFormat m_format = VkFormat::VK_FORMAT_UNDEFINED;
+        // The extent of the images copied.
+        VkExtent2D m_extent = {0, 0};
+        // The size of each buffer.
+        VkDeviceSize m_size = 0;
+        // Whether the memory has to be invalidated before reading it.
+        bool m_needs_invalidate = false;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
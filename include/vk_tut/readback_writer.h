@@ -0,0 +1,116 @@
+#if !defined(_VK_TUT_READBACK_WRITER_HEADER_)
+#define _VK_TUT_READBACK_WRITER_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include "vk_tut/readback_ring.h"
+
+#include <vulkan/vulkan.h>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vk::tut {
+    // Writes read back frames to PPM files on a thread of its own, so
+    // the render thread only copies the pixels out of mapped memory.
+    // The copies go to a fixed number of buffers reused from frame to
+    // frame. Keeps the first exception thrown while writing for
+    // write() or wait_idle() to rethrow.
+    class ReadbackWriter final {
+    public:
+        // Starts the writer thread. Files are named after the frame value
+        // in directory, which has to exist. At most buffer_count frames
+        // wait to be written before write() blocks.
+        ReadbackWriter(
+            const ::std::string& directory,
+            const uint32_t& buffer_count
+        );
+        // Writes the frames still queued, then stops the writer thread.
+        ~ReadbackWriter();
+
+        // Prevent copying.
+        inline ReadbackWriter(const ReadbackWriter&) = delete;
+        // Prevent moving.
+        inline ReadbackWriter(ReadbackWriter&&) = delete;
+        // Prevent copy re-assignment.
+        inline ReadbackWriter& operator= (const ReadbackWriter&) = delete;
+        // Prevent move re-assignment.
+        inline ReadbackWriter& operator= (ReadbackWriter&&) = delete;
+
+        // Copies the pixels of the frame and queues writing them. Only
+        // waits if every buffer is still queued. Supports 8 bit RGBA and
+        // BGRA formats.
+        void write(const ReadbackFrame& frame);
+        // Waits until every queued frame is written.
+        void wait_idle();
+
+        // The number of frames written so far.
+        uint64_t get_written_count() const;
+
+        // Encodes tightly packed 8 bit RGBA or BGRA pixels as a binary PPM
+        // into encoded, whose capacity is reused.
+        static void encode_ppm(
+            const VkFormat& format,
+            const VkExtent2D& extent,
+            const uint8_t* ptr_pixels,
+            ::std::vector<char>& encoded
+        );
+
+    private:
+        // A frame copied out of mapped memory.
+        struct Buffer {
+            // The value of the frame the image was rendered in.
+            uint64_t frame_value = 0;
+            // The format of the pixels.
+            VkFormat format = VkFormat::VK_FORMAT_UNDEFINED;
+            // The size of the image.
+            VkExtent2D extent = {0, 0};
+            // The pixels. Only grows, so it is not reallocated every frame.
+            ::std::vector<uint8_t> pixels;
+        };
+
+        // The loop of the writer thread.
+        void writer_main();
+        // Rethrows the exception kept, if any. Called with m_mutex held.
+        void rethrow_exception();
+
+        // The directory the files are written to.
+        ::std::string m_directory;
+        // The buffers, each either free or queued.
+        ::std::vector<Buffer> m_buffers;
+        // The indices of the free buffers.
+        ::std::vector<uint32_t> m_free_buffers;
+        // The indices of the queued buffers, a ring in queue order.
+        ::std::vector<uint32_t> m_queued_buffers;
+        // The position of the oldest queued buffer in m_queued_buffers.
+        size_t m_queue_head = 0;
+        // The number of queued buffers, including the one being written.
+        size_t m_queued_count = 0;
+        // The number of frames written.
+        uint64_t m_written_count = 0;
+        // The first exception thrown while writing.
+        ::std::exception_ptr m_exception;
+        // Set when the writer thread should exit.
+        bool m_stop = false;
+        // Guards every member above but m_directory.
+        mutable ::std::mutex m_mutex;
+        // Wakes the writer thread once a buffer is queued.
+        ::std::condition_variable m_queued;
+        // Wakes write() and wait_idle() once a buffer is written.
+        ::std::condition_variable m_written;
+        // The writer thread. Started last, so it sees every member.
+        ::std::thread m_thread;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
@@ -0,0 +1,304 @@
+#if !defined(_VK_TUT_RENDER_GRAPH_HEADER_)
+#define _VK_TUT_RENDER_GRAPH_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include "vk_tut/resource_state.h"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vk::tut {
+    // Identifies an image within a render graph.
+    using RenderGraphResource = uint32_t;
+
+    // Describes an image created and owned by a render graph.
+    class RenderGraphImageInfo final {
+    public:
+        // Default constructor.
+        inline RenderGraphImageInfo() {}
+        // Copy initializer list constructor.
+        RenderGraphImageInfo(
+            const VkFormat& format,
+            const VkExtent2D& extent,
+            const VkImageUsageFlags& usage,
+            const VkImageAspectFlags& aspect_mask,
+            const VkSampleCountFlagBits& samples =
+                VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT
+        );
+
+        // Copy constructor.
+        RenderGraphImageInfo(const RenderGraphImageInfo&);
+        // Move constructor.
+        RenderGraphImageInfo(RenderGraphImageInfo&&);
+        // Copy re-assignment.
+        RenderGraphImageInfo& operator= (const RenderGraphImageInfo&);
+        // Move re-assignment.
+        RenderGraphImageInfo& operator= (RenderGraphImageInfo&&);
+
+        // Getter for m_format.
+        inline VkFormat get_format() const { return m_format; }
+        // Getter for m_extent.
+        inline VkExtent2D get_extent() const { return m_extent; }
+        // Getter for m_usage.
+        inline VkImageUsageFlags get_usage() const { return m_usage; }
+        // Getter for m_aspect_mask.
+        inline VkImageAspectFlags get_aspect_mask() const
+        { return m_aspect_mask; }
+        // Getter for m_samples.
+        inline VkSampleCountFlagBits get_samples() const { return m_samples; }
+
+    private:
+        // The format of the image.
+        VkFormat m_format = VkFormat::VK_FORMAT_UNDEFINED;
+        // The size of the image.
+        VkExtent2D m_extent = {0, 0};
+        // Every way the passes use the image.
+        VkImageUsageFlags m_usage = 0;
+        // The aspect of the image view and of the barriers.
+        VkImageAspectFlags m_aspect_mask = 0;
+        // The samples per pixel.
+        VkSampleCountFlagBits m_samples = VkSampleCountFlagBits
+            ::VK_SAMPLE_COUNT_1_BIT;
+    };
+
+    // A pass of a render graph. Declares the images it reads and writes,
+    // and records its commands once the graph has made them usable.
+    class RenderGraphPass final {
+    public:
+        // Copy initializer list constructor.
+        RenderGraphPass(
+            const ::std::string& name,
+            ::std::function<void(const VkCommandBuffer&)>&& record
+        );
+
+        // Prevent copying.
+        inline RenderGraphPass(const RenderGraphPass&) = delete;
+        // Prevent copy re-assignment.
+        inline RenderGraphPass& operator= (const RenderGraphPass&) = delete;
+
+        // The pass reads the image in the given state.
+        RenderGraphPass& read(
+            const RenderGraphResource& resource,
+            const ResourceState& state
+        );
+        // The pass writes the image in the given state.
+        RenderGraphPass& write(
+            const RenderGraphResource& resource,
+            const ResourceState& state
+        );
+        // The pass writes the image in the given state and leaves it
+        // in end_state, like a render pass with a final layout. A state
+        // with an undefined layout means the pass transitions the image
+        // itself, so no image barrier is recorded before it. The first
+        // use of a transient image still waits on the memory it aliases.
+        RenderGraphPass& write(
+            const RenderGraphResource& resource,
+            const ResourceState& state,
+            const ResourceState& end_state
+        );
+        // Keeps the pass even if nothing reads what it writes.
+        RenderGraphPass& set_side_effect();
+
+        // Getter for m_name.
+        inline const ::std::string& get_name() const { return m_name; }
+
+    private:
+        friend class RenderGraph;
+
+        // How the pass uses one image.
+        struct Access {
+            // The image.
+            RenderGraphResource resource = 0;
+            // Whether the pass writes the image.
+            bool write = false;
+            // The state the image has to be in when the pass starts.
+            ResourceState state;
+            // The state the pass leaves the image in.
+            ResourceState end_state;
+        };
+
+        // The name of the pass, for debugging.
+        ::std::string m_name;
+        // Records the commands of the pass.
+        ::std::function<void(const VkCommandBuffer&)> m_record;
+        // The images used by the pass, in declaration order.
+        ::std::vector<Access> m_accesses;
+        // Whether the pass is kept even if its outputs are unused.
+        bool m_side_effect = false;
+    };
+
+    // Orders the passes of a frame from the images they read and write,
+    // culls the passes whose results are never used, records the barriers
+    // between them and lets transient images with disjoint lifetimes
+    // share memory.
+    //
+    // Building a graph goes create_image / import_image, add_pass,
+    // compile(), realize(). execute() can then be called every frame.
+    class RenderGraph final {
+    public:
+        // Default constructor.
+        inline RenderGraph() {}
+
+        // Prevent copying.
+        inline RenderGraph(const RenderGraph&) = delete;
+        // Prevent copy re-assignment.
+        inline RenderGraph& operator= (const RenderGraph&) = delete;
+
+        // Declares an image created by the graph. Its contents only
+        // live from the first to the last pass using it.
+        RenderGraphResource create_image(
+            const ::std::string& name,
+            const RenderGraphImageInfo& info
+        );
+        // Declares an image owned elsewhere, such as a swapchain image.
+        // Passes writing it are never culled. Each execute() starts from
+        // initial_state, such as the wait stage of a semaphore, and ends
+        // with the image in final_state, such as the present layout.
+        // A final state with an undefined layout leaves it as it is.
+        RenderGraphResource import_image(
+            const ::std::string& name,
+            const VkImageAspectFlags& aspect_mask,
+            const ResourceState& initial_state,
+            const ResourceState& final_state = ResourceState()
+        );
+        // Sets the handles of an imported image for the next execute().
+        void set_imported_image(
+            const RenderGraphResource& resource,
+            const VkImage& image,
+            const VkImageView& image_view
+        );
+        // Adds a pass. Passes declared earlier are the ones seen by
+        // a later pass reading the same image.
+        RenderGraphPass& add_pass(
+            const ::std::string& name,
+            ::std::function<void(const VkCommandBuffer&)>&& record
+        );
+
+        // Culls, orders and computes the lifetimes of the images.
+        void compile();
+        // Creates the transient images used by the compiled passes
+        // and binds them to aliased memory. Blocks holding only transient
+        // attachments use lazily allocated memory where available.
+        void realize(
+            const VkPhysicalDevice& physical_device,
+            const VkDevice& logical_device
+        );
+        // Destroys what realize() created and stops tracking its images.
+        void release(
+            const VkDevice& logical_device,
+            ResourceStateTracker& tracker
+        );
+        // Removes every pass and image. Call release() first.
+        void clear();
+
+        // Records the compiled passes with the barriers between them.
+        void execute(
+            const VkCommandBuffer& command_buffer,
+            ResourceStateTracker& tracker,
+            PFN_vkCmdPipelineBarrier2KHR cmd_pipeline_barrier2
+        );
+
+        // Places the transient images into memory blocks. Images whose
+        // lifetimes do not overlap share a block. Indexed by resource,
+        // entries of imported and unused images are ignored.
+        // Returns the total size of the blocks.
+        VkDeviceSize assign_memory(
+            const ::std::vector<VkMemoryRequirements>& requirements
+        );
+
+        // The number of passes added.
+        inline size_t get_pass_count() const { return m_passes.size(); }
+        // The compiled order of the passes that were not culled.
+        inline const ::std::vector<uint32_t>& get_execution_order() const
+        { return m_execution_order; }
+        // Whether compile() removed the pass.
+        bool is_pass_culled(const uint32_t& pass_index) const;
+        // The position in the execution order of the first
+        // pass using the image. UNUSED if none does.
+        uint32_t get_first_use(const RenderGraphResource& resource) const;
+        // The position in the execution order of the last
+        // pass using the image. UNUSED if none does.
+        uint32_t get_last_use(const RenderGraphResource& resource) const;
+        // The number of memory blocks the transient images are placed in.
+        inline size_t get_memory_block_count() const
+        { return m_memory_blocks.size(); }
+        // The memory block of a transient image.
+        uint32_t get_memory_block(const RenderGraphResource& resource) const;
+        // The image handle of a resource.
+        VkImage get_image(const RenderGraphResource& resource) const;
+        // The image view handle of a resource.
+        VkImageView get_image_view(
+            const RenderGraphResource& resource
+        ) const;
+
+        // The position of an image that no pass uses.
+        static constexpr uint32_t UNUSED = UINT32_MAX;
+
+    private:
+        // What the graph knows about an image.
+        struct Resource {
+            // The name of the image, for debugging.
+            ::std::string name;
+            // Describes the image. Only the aspect is used if imported.
+            RenderGraphImageInfo info;
+            // Whether the image is owned elsewhere.
+            bool imported = false;
+            // The state of an imported image when execute() starts.
+            ResourceState initial_state;
+            // The state of an imported image when execute() ends.
+            ResourceState final_state;
+            // The image handle.
+            VkImage image = VK_NULL_HANDLE;
+            // The image view handle.
+            VkImageView image_view = VK_NULL_HANDLE;
+            // The execution position of the first pass using the image.
+            uint32_t first_use = UNUSED;
+            // The execution position of the last pass using the image.
+            uint32_t last_use = UNUSED;
+            // The memory block of a transient image.
+            uint32_t memory_block = UNUSED;
+        };
+
+        // Memory shared by transient images with disjoint lifetimes.
+        struct MemoryBlock {
+            // The size of the largest image in the block.
+            VkDeviceSize size = 0;
+            // The memory types every image in the block can use.
+            uint32_t memory_type_bits = 0;
+            // The images placed in the block.
+            ::std::vector<RenderGraphResource> resources;
+            // The memory handle.
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            // The stages the next image in the block waits on.
+            VkPipelineStageFlags2KHR src_stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+            // The accesses the next image in the block waits on.
+            VkAccessFlags2KHR src_access = VK_ACCESS_2_NONE_KHR;
+        };
+
+        // The passes, in declaration order.
+        ::std::vector<::std::unique_ptr<RenderGraphPass>> m_passes;
+        // The images, indexed by resource.
+        ::std::vector<Resource> m_resources;
+        // The passes each pass has to run after.
+        ::std::vector<::std::vector<uint32_t>> m_dependencies;
+        // Whether each pass was culled.
+        ::std::vector<bool> m_pass_culled;
+        // The compiled order of the passes.
+        ::std::vector<uint32_t> m_execution_order;
+        // The memory of the transient images.
+        ::std::vector<MemoryBlock> m_memory_blocks;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
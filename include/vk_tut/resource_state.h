@@ -0,0 +1,181 @@
+#if !defined(_VK_TUT_RESOURCE_STATE_HEADER_)
+#define _VK_TUT_RESOURCE_STATE_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <vulkan/vulkan.h>
+#include <unordered_map>
+#include <vector>
+
+namespace vk::tut {
+    // The access flags that write to a resource.
+    inline constexpr VkAccessFlags2KHR WRITE_ACCESS_FLAGS =
+        VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR |
+        VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR |
+        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR |
+        VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR |
+        VK_ACCESS_2_HOST_WRITE_BIT_KHR |
+        VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+
+    // How a resource was last used by the GPU, or how it will be used next.
+    class ResourceState final {
+    public:
+        // Default constructor. Describes a resource not yet used.
+        inline ResourceState() {}
+        // Copy initializer list constructor.
+        ResourceState(
+            const VkImageLayout& layout,
+            const VkPipelineStageFlags2KHR& stages,
+            const VkAccessFlags2KHR& access
+        );
+        // Copy initializer list constructor for buffers.
+        ResourceState(
+            const VkPipelineStageFlags2KHR& stages,
+            const VkAccessFlags2KHR& access
+        );
+
+        // Getter for m_layout.
+        inline VkImageLayout get_layout() const { return m_layout; }
+        // Getter for m_stages.
+        inline VkPipelineStageFlags2KHR get_stages() const { return m_stages; }
+        // Getter for m_access.
+        inline VkAccessFlags2KHR get_access() const { return m_access; }
+
+        // Whether any of the access flags writes to the resource.
+        inline bool is_write() const {
+            return (m_access & WRITE_ACCESS_FLAGS) != 0;
+        }
+
+    private:
+        // The image layout. Ignored for buffers.
+        VkImageLayout m_layout = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED;
+        // The pipeline stages accessing the resource.
+        VkPipelineStageFlags2KHR m_stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+        // The kinds of memory access done by those stages.
+        VkAccessFlags2KHR m_access = VK_ACCESS_2_NONE_KHR;
+    };
+
+    // Records the current state of images and buffers and computes the
+    // minimal set of barriers needed to move them to a requested state.
+    // Barriers are queued and emitted together by flush().
+    class ResourceStateTracker final {
+    public:
+        // Default constructor.
+        inline ResourceStateTracker() {}
+
+        // Prevent copying.
+        inline ResourceStateTracker(const ResourceStateTracker&) = delete;
+        // Prevent copy re-assignment.
+        inline ResourceStateTracker&
+        operator= (const ResourceStateTracker&) = delete;
+
+        // Start tracking an image.
+        void track_image(
+            const VkImage& image,
+            const VkImageAspectFlags& aspect_mask,
+            const ResourceState& initial_state = ResourceState()
+        );
+        // Start tracking a buffer.
+        void track_buffer(
+            const VkBuffer& buffer,
+            const ResourceState& initial_state = ResourceState()
+        );
+        // Stop tracking an image. Drops its pending barrier if any.
+        void forget_image(const VkImage& image);
+        // Stop tracking a buffer. Drops its pending barrier if any.
+        void forget_buffer(const VkBuffer& buffer);
+
+        // Queue the barrier, if any, that makes the image usable
+        // in the requested state.
+        void require_image_state(
+            const VkImage& image, const ResourceState& state
+        );
+        // Queue the barrier, if any, that makes the buffer usable
+        // in the requested state.
+        void require_buffer_state(
+            const VkBuffer& buffer, const ResourceState& state
+        );
+        // Queue a global execution and memory dependency, for memory
+        // reused by another resource whose previous state is not tracked
+        // per resource, like the first use of an aliased image.
+        void require_memory_dependency(
+            const VkPipelineStageFlags2KHR& src_stages,
+            const VkAccessFlags2KHR& src_access,
+            const VkPipelineStageFlags2KHR& dst_stages,
+            const VkAccessFlags2KHR& dst_access
+        );
+        // Overwrite the state of the image without a barrier. Used when
+        // something else, like a render pass, changed it on the GPU.
+        void set_image_state(
+            const VkImage& image, const ResourceState& state
+        );
+
+        // Gets the tracked state of the image.
+        ResourceState get_image_state(const VkImage& image) const;
+        // Gets the tracked state of the buffer.
+        ResourceState get_buffer_state(const VkBuffer& buffer) const;
+        // The number of barriers waiting for the next flush.
+        size_t get_pending_barrier_count() const;
+
+        // Record every queued barrier with a single call to
+        // vkCmdPipelineBarrier2KHR. Does nothing if none are queued.
+        void flush(
+            const VkCommandBuffer& command_buffer,
+            PFN_vkCmdPipelineBarrier2KHR cmd_pipeline_barrier2
+        );
+
+    private:
+        // What the tracker remembers about a resource.
+        struct TrackedState {
+            // The aspect of the image to transition. Zero for buffers.
+            VkImageAspectFlags aspect_mask = 0;
+            // The current image layout. Ignored for buffers.
+            VkImageLayout layout = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED;
+            // The stages of the last write or layout transition.
+            VkPipelineStageFlags2KHR write_stages =
+                VK_PIPELINE_STAGE_2_NONE_KHR;
+            // The memory writes of the last write.
+            VkAccessFlags2KHR write_access = VK_ACCESS_2_NONE_KHR;
+            // The read stages already synchronized with the last write.
+            VkPipelineStageFlags2KHR read_stages =
+                VK_PIPELINE_STAGE_2_NONE_KHR;
+            // The read accesses already made visible after the last write.
+            VkAccessFlags2KHR read_access = VK_ACCESS_2_NONE_KHR;
+        };
+
+        // Build the tracked state of a resource first seen in a state.
+        static TrackedState make_tracked_state(
+            const VkImageAspectFlags& aspect_mask,
+            const ResourceState& state
+        );
+        // Move the tracked state to the requested state. Returns false
+        // when no barrier is needed, otherwise fills in the scopes.
+        static bool transition(
+            TrackedState& tracked, const ResourceState& state,
+            const bool& is_image,
+            VkPipelineStageFlags2KHR& src_stages,
+            VkAccessFlags2KHR& src_access
+        );
+
+        // The tracked images.
+        ::std::unordered_map<VkImage, TrackedState> m_images;
+        // The tracked buffers.
+        ::std::unordered_map<VkBuffer, TrackedState> m_buffers;
+        // The image barriers waiting for the next flush.
+        ::std::vector<VkImageMemoryBarrier2KHR> m_pending_image_barriers;
+        // The buffer barriers waiting for the next flush.
+        ::std::vector<VkBufferMemoryBarrier2KHR> m_pending_buffer_barriers;
+        // The global memory barriers waiting for the next flush. At most
+        // one, as later dependencies are merged into it.
+        ::std::vector<VkMemoryBarrier2KHR> m_pending_memory_barriers;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
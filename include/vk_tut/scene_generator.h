@@ -0,0 +1,92 @@
+#if !defined(_VK_TUT_SCENE_GENERATOR_HEADER_)
+#define _VK_TUT_SCENE_GENERATOR_HEADER_
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include "vk_tut/vertex.h"
+#include "vk_tut/draw_command.h"
+#include "vk_tut/instance_transform.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vk::tut {
+    // Generates synthetic scenes of any size for stress testing. The
+    // objects fill a grid inside the view, each an instance of one of
+    // the meshes with one of the textures, and may spin on the spot.
+    //
+    // The objects sharing a mesh and texture are drawn together, by
+    // draws of up to instances_per_draw instances, so the same scene
+    // can be drawn with one draw per object or with a few draws.
+    class SceneGenerator final {
+    public:
+        // What to generate.
+        struct Parameters {
+            // The number of objects. At least 1.
+            uint32_t object_count = 1000;
+            // The number of distinct meshes. Cycles through cubes,
+            // spheres and colour wheels, with more triangles each cycle.
+            uint32_t mesh_count = 3;
+            // The most objects one draw draws. 1 draws each on its own.
+            uint32_t instances_per_draw = 1;
+            // The number of distinct textures.
+            uint32_t texture_count = 1;
+            // Whether the objects spin about their own axis.
+            bool animated = true;
+            // Seeds the orientations and spin speeds of the objects.
+            uint32_t seed = 1;
+        };
+
+        // Generates scenes as described. Counts of 0 count as 1.
+        SceneGenerator(const Parameters& parameters);
+
+        // Prevent copying.
+        inline SceneGenerator(const SceneGenerator&) = delete;
+        // Prevent copy re-assignment.
+        inline SceneGenerator& operator= (const SceneGenerator&) = delete;
+
+        // Appends the meshes, draws and instances of the scene. The
+        // draws use texture_indices[i] as the slot of the i-th texture,
+        // so texture_indices holds texture_count slots.
+        void generate(
+            const ::std::vector<uint32_t>& texture_indices,
+            ::std::vector<Vertex>& ref_vertices,
+            ::std::vector<uint32_t>& ref_indices,
+            ::std::vector<DrawCommand>& ref_draw_commands,
+            ::std::vector<InstanceTransform>& ref_instances
+        ) const;
+        // Writes the generated instances as they are time seconds into
+        // the animation to ptr_animated, which holds as many instances.
+        void animate(
+            const float& time,
+            const ::std::vector<InstanceTransform>& instances,
+            InstanceTransform* ptr_animated
+        ) const;
+
+        // Writes the RGBA pixels of a scene texture: a checkerboard
+        // with a colour of its own, TEXTURE_SIZE pixels wide and high.
+        static void generate_texture(
+            const uint32_t& texture_index,
+            ::std::vector<uint8_t>& ref_pixels
+        );
+
+        // Getter for m_parameters.
+        inline const Parameters& get_parameters() const
+        { return m_parameters; }
+
+        // The width and height of the scene textures.
+        static constexpr uint32_t TEXTURE_SIZE = 64;
+
+    private:
+        // What is generated, with the counts of 0 raised to 1.
+        Parameters m_parameters;
+    };
+}
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
@@ -32,11 +32,11 @@ namespace vk::tut {
         SwapChainSupportDetails& operator= (SwapChainSupportDetails&&);
 
         // Gets the value of m_capabilities.
-        VkSurfaceCapabilitiesKHR get_capabilities() const;
-        // Gets the value of m_formats.
-        ::std::vector<VkSurfaceFormatKHR> get_formats() const;
-        // Gets the value of m_present_modes.
-        ::std::vector<VkPresentModeKHR> get_present_modes() const;
+        const VkSurfaceCapabilitiesKHR& get_capabilities() const;
+        // Gets the value of m_formats, without copying it.
+        const ::std::vector<VkSurfaceFormatKHR>& get_formats() const;
+        // Gets the value of m_present_modes, without copying it.
+        const ::std::vector<VkPresentModeKHR>& get_present_modes() const;
 
         // Describes whether a device has adequate swapchain support.
         bool is_swapchain_support_adequate() const;
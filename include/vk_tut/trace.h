@@ -0,0 +1,189 @@
+#if !defined(_VK_TUT_TRACE_HEADER_)
+#define _VK_TUT_TRACE_HEADER_
+
+// Enable tracing in non-release modes.
+// Release builds opt in with the VK_TUT_TRACE CMake option.
+#if !defined(NDEBUG) && !defined(_NDEBUG)
+#if !defined(_VK_TUT_TRACE_ENABLED_)
+#define _VK_TUT_TRACE_ENABLED_
+#endif
+#endif
+
+// C++ only region.
+#if defined(__cplusplus)
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace vk::tut {
+    // The timed scopes of one thread. Only the owning thread writes,
+    // so recording an event takes no lock. Events past the capacity
+    // are dropped instead of overwriting the ones already published.
+    class TraceBuffer final {
+    public:
+        // A timed scope.
+        struct Event {
+            // The name of the scope. Must outlive the buffer.
+            const char* name = nullptr;
+            // When the scope began, in nanoseconds since the trace start.
+            uint64_t start_ns = 0;
+            // How long the scope lasted, in nanoseconds.
+            uint64_t duration_ns = 0;
+        };
+
+        // Creates an empty buffer for the thread.
+        TraceBuffer(const uint32_t& thread_id, const uint32_t& capacity);
+
+        // Prevent copying.
+        inline TraceBuffer(const TraceBuffer&) = delete;
+        // Prevent copy re-assignment.
+        inline TraceBuffer& operator= (const TraceBuffer&) = delete;
+
+        // Records an event. Only called by the owning thread.
+        void push(
+            const char* name,
+            const uint64_t& start_ns,
+            const uint64_t& duration_ns
+        );
+        // Forgets every event. Only called while the thread is not tracing.
+        void clear();
+
+        // The number of events that can be read.
+        inline uint32_t get_count() const
+        { return m_count.load(::std::memory_order_acquire); }
+        // An event below get_count().
+        inline const Event& get_event(const uint32_t& index) const
+        { return m_events[index]; }
+        // The number of events dropped because the buffer was full.
+        inline uint32_t get_dropped_count() const
+        { return m_dropped_count.load(::std::memory_order_relaxed); }
+        // The identifier of the thread in the trace.
+        inline uint32_t get_thread_id() const { return m_thread_id; }
+
+    private:
+        friend class Tracer;
+
+        // The events, written up to m_count.
+        ::std::vector<Event> m_events;
+        // The number of events published to readers.
+        ::std::atomic<uint32_t> m_count{0};
+        // The number of events dropped.
+        ::std::atomic<uint32_t> m_dropped_count{0};
+        // The identifier of the thread in the trace.
+        uint32_t m_thread_id;
+        // The name of the thread in the trace. Guarded by the tracer.
+        ::std::string m_thread_name;
+    };
+
+    // Collects the trace buffers of every thread and exports them
+    // in the Chrome trace event format, which Perfetto also reads.
+    class Tracer final {
+    public:
+        // Prevent copying.
+        inline Tracer(const Tracer&) = delete;
+        // Prevent copy re-assignment.
+        inline Tracer& operator= (const Tracer&) = delete;
+
+        // The tracer shared by every thread.
+        static Tracer& get_instance();
+        // The nanoseconds elapsed since the trace started.
+        static uint64_t now();
+
+        // The buffer of the calling thread, created on first use.
+        TraceBuffer& get_thread_buffer();
+        // Names the calling thread in the trace.
+        void set_thread_name(const ::std::string& name);
+
+        // Writes every event recorded so far as a Chrome trace.
+        // Only called while no other thread is tracing.
+        void write_chrome_trace(::std::ostream& stream) const;
+        // Writes the Chrome trace to a file.
+        void write_chrome_trace(const ::std::string& path) const;
+        // Forgets every event. Only called while no thread is tracing.
+        void clear();
+
+        // The number of events each thread can record.
+        static constexpr uint32_t EVENTS_PER_THREAD = 1 << 15;
+
+    private:
+        // Only created by get_instance().
+        inline Tracer() {}
+
+        // Guards m_buffers and the thread names.
+        mutable ::std::mutex m_mutex;
+        // The buffer of every thread that traced, in creation order.
+        // Kept after the thread exits so that its events are exported.
+        ::std::vector<::std::unique_ptr<TraceBuffer>> m_buffers;
+    };
+
+    // Times the enclosing scope into the buffer of the calling thread.
+    class TraceScope final {
+    public:
+        // Starts timing. The name must outlive the trace.
+        TraceScope(const char* name);
+        // Stops timing and records the event.
+        ~TraceScope();
+
+        // The name of the innermost scope of the calling thread,
+        // or nullptr outside of any scope.
+        static const char* get_current_name();
+
+        // Prevent copying.
+        inline TraceScope(const TraceScope&) = delete;
+        // Prevent copy re-assignment.
+        inline TraceScope& operator= (const TraceScope&) = delete;
+
+    private:
+        // The name of the scope.
+        const char* m_name;
+        // The name of the scope this one is nested in.
+        const char* m_parent_name;
+        // When the scope began.
+        uint64_t m_start_ns;
+    };
+}
+
+// < ---------------------------- Trace Macros ---------------------------- >
+
+// Pastes the line number into the name of a scope variable.
+#define _VK_TUT_TRACE_CONCAT_(a, b) a##b
+#define _VK_TUT_TRACE_VARIABLE_(line) \
+_VK_TUT_TRACE_CONCAT_(vk_tut_trace_scope_, line)
+
+// Times the rest of the enclosing scope.
+// Compiled out when tracing is disabled.
+#if !defined(VK_TUT_TRACE_SCOPE)
+#if defined(_VK_TUT_TRACE_ENABLED_)
+#define VK_TUT_TRACE_SCOPE(name) \
+::vk::tut::TraceScope _VK_TUT_TRACE_VARIABLE_(__LINE__)(name)
+#else
+#define VK_TUT_TRACE_SCOPE(name)
+#endif
+#endif
+// End Trace scope macro.
+
+// Names the calling thread in the trace.
+// Compiled out when tracing is disabled.
+#if !defined(VK_TUT_TRACE_THREAD_NAME)
+#if defined(_VK_TUT_TRACE_ENABLED_)
+#define VK_TUT_TRACE_THREAD_NAME(name) \
+::vk::tut::Tracer::get_instance().set_thread_name(name)
+#else
+#define VK_TUT_TRACE_THREAD_NAME(name)
+#endif
+#endif
+// End Trace thread name macro.
+
+// < -------------------------- END Trace Macros -------------------------- >
+
+#endif
+// End C++ only region.
+
+#endif
+// End of file.
+// Do NOT write beyond here.
\ No newline at end of file
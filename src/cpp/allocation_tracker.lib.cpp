@@ -0,0 +1,89 @@
+#include "vk_tut/allocation_tracker.h"
+#include "vk_tut/trace.h"
+
+#include <algorithm>
+
+namespace vk::tut {
+    // The site of the allocations made outside of any trace scope.
+    static const char* const UNSCOPED_SITE_NAME = "unscoped";
+    // The site of the allocations past MAX_SITES sites.
+    static const char* const OVERFLOW_SITE_NAME = "other sites";
+
+    AllocationTracker& AllocationTracker::get_instance() {
+        // Constant initialized, so it is usable before main and from
+        // within operator new.
+        static AllocationTracker tracker;
+        return tracker;
+    }
+
+    void AllocationTracker::record(const size_t& size) {
+        if (!is_counting()) return;
+
+        m_count.fetch_add(1, ::std::memory_order_relaxed);
+        m_bytes.fetch_add(size, ::std::memory_order_relaxed);
+
+        const char* name = TraceScope::get_current_name();
+        SiteSlot& site = find_site(name != nullptr ? name : UNSCOPED_SITE_NAME);
+        site.count.fetch_add(1, ::std::memory_order_relaxed);
+        site.bytes.fetch_add(size, ::std::memory_order_relaxed);
+    }
+
+    void AllocationTracker::set_counting(const bool& counting) {
+        m_is_counting.store(counting, ::std::memory_order_relaxed);
+    }
+
+    void AllocationTracker::reset() {
+        m_count.store(0, ::std::memory_order_relaxed);
+        m_bytes.store(0, ::std::memory_order_relaxed);
+        for (SiteSlot& site : m_sites) {
+            site.count.store(0, ::std::memory_order_relaxed);
+            site.bytes.store(0, ::std::memory_order_relaxed);
+        }
+    }
+
+    void AllocationTracker::get_sites(::std::vector<Site>& ref_sites) const {
+        const size_t first_site = ref_sites.size();
+        for (const SiteSlot& slot : m_sites) {
+            const uint64_t count = slot.count.load(::std::memory_order_relaxed);
+            if (count == 0) continue;
+
+            Site site;
+            site.name = slot.name.load(::std::memory_order_acquire);
+            site.count = count;
+            site.bytes = slot.bytes.load(::std::memory_order_relaxed);
+            ref_sites.emplace_back(site);
+        }
+
+        ::std::sort(ref_sites.begin() + first_site, ref_sites.end(),
+            [](const Site& a, const Site& b) { return a.count > b.count; }
+        );
+    }
+
+    AllocationTracker::SiteSlot& AllocationTracker::find_site(
+        const char* name
+    ) {
+        // Names are string literals, so their addresses tell them apart.
+        const uintptr_t hash = reinterpret_cast<uintptr_t>(name) >> 3;
+        for (uint32_t i = 0; i < MAX_SITES; i++) {
+            SiteSlot& slot = m_sites[(hash + i) % MAX_SITES];
+
+            const char* slot_name =
+                slot.name.load(::std::memory_order_acquire);
+            if (slot_name == name) return slot;
+            if (slot_name == nullptr && slot.name.compare_exchange_strong(
+                slot_name, name, ::std::memory_order_acq_rel
+            )) {
+                return slot;
+            }
+            // Another thread claimed the slot first, maybe for this name.
+            if (slot_name == name) return slot;
+        }
+
+        SiteSlot& overflow_slot = m_sites[MAX_SITES];
+        const char* overflow_name = nullptr;
+        overflow_slot.name.compare_exchange_strong(
+            overflow_name, OVERFLOW_SITE_NAME, ::std::memory_order_acq_rel
+        );
+        return overflow_slot;
+    }
+}
\ No newline at end of file
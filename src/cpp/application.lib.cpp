@@ -1,7 +1,10 @@
 #include "vk_tut/application.h"
+#include "vk_tut/allocation_tracker.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 #include "vk_tut/uniform.h"
 
+#include <algorithm>
 #include <limits>
 #include <chrono>
 #include <cstring>
@@ -12,7 +15,13 @@
 
 namespace vk::tut {
     // Default constructor.
-    Application::Application() {
+    Application::Application() : Application(ApplicationConfig()) {}
+
+    // Creates the application with the given options.
+    Application::Application(const ApplicationConfig& config) :
+    m_config(config) {
+        VK_TUT_TRACE_THREAD_NAME("main");
+        VK_TUT_TRACE_SCOPE("initialize");
         VK_TUT_LOG_DEBUG("...Initializing application data...");
 
         create_and_show_window();
@@ -25,9 +34,13 @@ namespace vk::tut {
         create_logical_device();
         create_swapchain();
         create_swapchain_image_views();
+        select_attachment_formats();
         create_render_pass();
         create_descriptor_set_layout();
+        create_descriptor_update_template();
         create_graphics_pipeline();
+        create_readback_ring();
+        create_render_graph();
         create_swapchain_frame_buffers();
         create_command_pool();
         create_texture_image();
@@ -36,10 +49,17 @@ namespace vk::tut {
         load_initial_mesh();
         create_mesh_buffer();
         create_uniform_buffers();
-        create_descriptor_pool();
+        create_instance_buffers();
+        create_descriptor_allocators();
         create_descriptor_sets();
         create_command_buffers();
+        create_recording_command_pools();
         create_sync_objects();
+        create_frame_arenas();
+        create_debug_draw_buffer();
+        create_gpu_profiler();
+        create_pipeline_statistics();
+        create_frame_statistics();
 
         VK_TUT_LOG_DEBUG("...FINISHED Initializing application data...");
     }
@@ -48,16 +68,33 @@ namespace vk::tut {
     Application::~Application() {
         VK_TUT_LOG_DEBUG("...Cleaning up application data...");
 
+        // The in flight fences do not cover presentation, which may still
+        // use the semaphores and the swapchain. Wait for all of it, also
+        // when run() was left early by an exception.
+        vkDeviceWaitIdle(m_logical_device);
+        // The GPU is idle by now. Run the destroys still waiting for it.
+        m_deletion_queue.flush_all();
+
+        destroy_pipeline_statistics();
+        destroy_gpu_profiler();
+        destroy_debug_draw_buffer();
+        destroy_frame_arenas();
         destroy_sync_objects();
-        destroy_descriptor_pool();
+        destroy_recording_command_pools();
+        destroy_descriptor_allocators();
+        destroy_instance_buffers();
         destroy_uniform_buffers();
         destroy_mesh_buffer();
+        destroy_scene_textures();
         destroy_texture_sampler();
         destroy_texture_image_view();
         destroy_texture_image();
         destroy_command_pool();
         destroy_swapchain_frame_buffers();
+        destroy_render_graph();
+        destroy_readback_ring();
         destroy_graphics_pipeline();
+        destroy_descriptor_update_template();
         destroy_descriptor_set_layout();
         destroy_render_pass();
         destroy_swapchain_image_views();
@@ -66,7 +103,8 @@ namespace vk::tut {
         destroy_surface();
 #if defined(_VK_TUT_VALIDATION_LAYER_ENABLED_)
         destroy_debug_utils_messengerEXT(m_vulkan_instance,
-            m_debug_messenger, nullptr);
+            m_debug_messenger,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT));
 #endif
         destroy_vulkan_instance();
         destroy_window();
@@ -78,49 +116,162 @@ namespace vk::tut {
     void Application::run() {
         VK_TUT_LOG_DEBUG("Running the application.");
 
-        load_square_mesh();
+        // A loaded scene replaces the default meshes.
+        if (m_ptr_scene_generator == nullptr) {
+            load_square_mesh();
+        }
 
-        // The main application loop.
-        // This keeps running until a close event is received by
-        // the GLFW API.
-        while(!glfwWindowShouldClose(m_ptr_window)) {
-            glfwPollEvents();
-            draw_frame();
+        // Without a window there is no close event to wait for.
+        if (m_config.get_headless()) {
+            const uint32_t frame_count = ::std::max(
+                m_config.get_frame_count(), static_cast<uint32_t>(1)
+            );
+            for (uint32_t i = 0; i < frame_count; i++) {
+                draw_frame();
+            }
+        }
+        else {
+            // The main application loop.
+            // This keeps running until a close event is received by
+            // the GLFW API, or until the requested frames are rendered.
+            uint32_t frames_drawn = 0;
+            while(!glfwWindowShouldClose(m_ptr_window) &&
+            (m_config.get_frame_count() == 0 ||
+            frames_drawn < m_config.get_frame_count())) {
+                glfwPollEvents();
+                draw_frame();
+                frames_drawn++;
+            }
         }
 
-        // Wait for the logical device's resource
-        // to be available before exiting the function.
+        // Wait for the logical device's resource to be available before
+        // exiting the function. The in flight fences alone do not cover
+        // the presentation of the last frames.
         vkDeviceWaitIdle(m_logical_device);
+        // Collect the results of the frames in flight.
+        wait_for_frames_in_flight();
+        m_gpu_profiler.log_stats();
+        HostAllocator::get_instance().log_stats();
+        m_frame_statistics.log_summary();
+
+        if (!m_config.get_statistics_path().empty()) {
+            m_frame_statistics.write_json(m_config.get_statistics_path());
+        }
+
+        if (!m_config.get_trace_path().empty()) {
+#if defined(_VK_TUT_TRACE_ENABLED_)
+            Tracer::get_instance().write_chrome_trace(
+                m_config.get_trace_path()
+            );
+#else
+            VK_TUT_LOG_DEBUG("Tracing is compiled out of this build.");
+#endif
+        }
+    }
+
+    // Copy setter for m_dynamic_scene.
+    void Application::set_dynamic_scene(const bool& dynamic_scene) {
+        m_dynamic_scene = dynamic_scene;
     }
 
     void Application::draw_frame() {
+        VK_TUT_TRACE_SCOPE("draw_frame");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
+        // A frame ends when the next one starts.
+        const auto frame_start_time = ::std::chrono::steady_clock::now();
+        const AllocationTracker& allocation_tracker =
+            AllocationTracker::get_instance();
+        const uint64_t frame_start_allocation_count =
+            allocation_tracker.get_count();
+        if (m_frame_counter > 0) {
+            m_frame_statistics.record(FrameMetric::CPU_FRAME_TIME,
+                static_cast<uint64_t>(::std::chrono::duration_cast
+                <::std::chrono::microseconds>(
+                    frame_start_time - m_frame_start_time
+                ).count())
+            );
+            if (allocation_tracker.is_counting()) {
+                m_frame_statistics.record(FrameMetric::ALLOCATION_COUNT,
+                    frame_start_allocation_count -
+                    m_frame_start_allocation_count
+                );
+            }
+            m_frame_statistics.end_frame();
+        }
+        m_frame_start_time = frame_start_time;
+        m_frame_start_allocation_count = frame_start_allocation_count;
+
         // Wait until the previous frame has finished rendering in the GPU.
-        result = vkWaitForFences(
-            m_logical_device, 1, &m_in_flight_fences[m_current_frame_index],
-            VK_TRUE, ::std::numeric_limits<uint64_t>::max()
-        );
-        if (result != VkResult::VK_SUCCESS) {
-            VK_TUT_LOG_ERROR("Failed to wait for fences.");
+        {
+            VK_TUT_TRACE_SCOPE("wait_for_fence");
+            ScopedFrameTimer timer(
+                m_frame_statistics, FrameMetric::FENCE_WAIT_TIME
+            );
+            result = vkWaitForFences(m_logical_device, 1,
+                &m_in_flight_fences[m_current_frame_index],
+                VK_TRUE, ::std::numeric_limits<uint64_t>::max()
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to wait for fences.");
+            }
         }
 
-        // Acquire the next available image from the swapchain.
-        uint32_t image_index = 0;
-        result = vkAcquireNextImageKHR(
-            m_logical_device, m_swapchain,
-            ::std::numeric_limits<uint64_t>::max(),
-            m_image_available_semaphores[m_current_frame_index],
-            VK_NULL_HANDLE, &image_index
-        );
-        if (result == VkResult::VK_ERROR_OUT_OF_DATE_KHR) {
-            recreate_swapchain();
-            return;
+        // Fences of one queue signal in submission order, so every frame
+        // up to the one that used this fence is done. Destroy what those
+        // frames kept alive.
+        if (m_frame_submit_values[m_current_frame_index] >
+        m_completed_frame_value) {
+            m_completed_frame_value =
+                m_frame_submit_values[m_current_frame_index];
         }
-        else if (result != VkResult::VK_SUCCESS &&
-        result != VkResult::VK_SUBOPTIMAL_KHR) {
-            VK_TUT_LOG_ERROR("Failed to acquire swap chain image!");
+        m_deletion_queue.flush(m_completed_frame_value);
+        // The frames finished by now are read back without waiting.
+        if (m_ptr_readback_ring != nullptr) {
+            m_ptr_readback_ring->retrieve(m_logical_device,
+                m_completed_frame_value, [this](const ReadbackFrame& frame) {
+                    write_readback_frame(frame);
+                }
+            );
+        }
+        // The timestamps of the frame that used this slot are written.
+        m_gpu_profiler.collect(m_logical_device, m_current_frame_index);
+        record_gpu_frame_time();
+        record_pipeline_statistics(m_current_frame_index);
+        // The transient descriptor sets of this frame are no longer in use.
+        m_frame_descriptor_allocators[m_current_frame_index].reset();
+        // Neither is the CPU side data the frame kept in its arena.
+        m_frame_statistics.record(FrameMetric::FRAME_ARENA_BYTES,
+            get_frame_arena().get_used_bytes()
+        );
+        get_frame_arena().reset();
+
+        // Acquire the next available image from the swapchain.
+        // In headless mode each frame slot owns one offscreen image,
+        // which the fence waited on above has already released.
+        const bool headless = m_config.get_headless();
+        uint32_t image_index = m_current_frame_index;
+        if (!headless) {
+            VK_TUT_TRACE_SCOPE("acquire_next_image");
+            ScopedFrameTimer timer(
+                m_frame_statistics, FrameMetric::ACQUIRE_TIME
+            );
+            result = vkAcquireNextImageKHR(
+                m_logical_device, m_swapchain,
+                ::std::numeric_limits<uint64_t>::max(),
+                m_image_available_semaphores[m_current_frame_index],
+                VK_NULL_HANDLE, &image_index
+            );
+            if (result == VkResult::VK_ERROR_OUT_OF_DATE_KHR) {
+                recreate_swapchain();
+                return;
+            }
+            else if (result != VkResult::VK_SUCCESS &&
+            result != VkResult::VK_SUBOPTIMAL_KHR) {
+                VK_TUT_LOG_ERROR("Failed to acquire swap chain image!");
+            }
         }
 
         // Reset the fence for drawing in the GPU.
@@ -131,17 +282,36 @@ namespace vk::tut {
             VK_TUT_LOG_ERROR("Failed to reset fences.");
         }
 
-        // Reset the command buffer.
-        result = vkResetCommandBuffer(
-            m_command_buffers[m_current_frame_index], 0
-        );
-        if (result != VkResult::VK_SUCCESS) {
-            VK_TUT_LOG_ERROR("Failed to reset command buffer.");
+        // Hand the debug primitives added since the last frame to this one.
+        if (m_config.get_debug_draw()) {
+            add_scene_debug_draws();
         }
+        write_debug_draw_arguments();
+
+        // The command buffer to be submitted for this frame.
+        VkCommandBuffer command_buffer;
+        {
+            ScopedFrameTimer timer(
+                m_frame_statistics, FrameMetric::RECORD_TIME
+            );
+            if (m_dynamic_scene) {
+                command_buffer = m_command_buffers[m_current_frame_index];
 
-        // Record the command buffer with the command that we want.
-        // In our case, to draw our triangle.
-        record_command_buffer(image_index);
+                // Reset the command buffer.
+                result = vkResetCommandBuffer(command_buffer, 0);
+                if (result != VkResult::VK_SUCCESS) {
+                    VK_TUT_LOG_ERROR("Failed to reset command buffer.");
+                }
+
+                // Record the command buffer with the command that we want.
+                // The draw list is recorded by several threads.
+                record_command_buffer(command_buffer, image_index, true);
+            }
+            else {
+                // Only recorded again when the scene or swapchain changed.
+                command_buffer = get_cached_command_buffer(image_index);
+            }
+        }
 
         // Define our wait stages.
         // Our command gets executed in the colour attachment stage in
@@ -150,29 +320,55 @@ namespace vk::tut {
             VkPipelineStageFlagBits::VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
         };
 
-        update_uniform_buffer();
+        {
+            ScopedFrameTimer timer(
+                m_frame_statistics, FrameMetric::UNIFORM_UPDATE_TIME
+            );
+            update_uniform_buffer();
+        }
+        update_instance_buffer();
 
         // Information to be submitted to the graphics queue.
         VkSubmitInfo submit_info{};
         submit_info.sType = VkStructureType::VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submit_info.commandBufferCount = 1;
-        submit_info.pCommandBuffers = &m_command_buffers[m_current_frame_index];
-        submit_info.waitSemaphoreCount = 1;
+        submit_info.pCommandBuffers = &command_buffer;
+        // Nothing is acquired or presented in headless mode.
+        submit_info.waitSemaphoreCount = headless ? 0 : 1;
         submit_info.pWaitSemaphores =
             &m_image_available_semaphores[m_current_frame_index];
         submit_info.pWaitDstStageMask = wait_stages;
-        submit_info.signalSemaphoreCount = 1;
+        submit_info.signalSemaphoreCount = headless ? 0 : 1;
         submit_info.pSignalSemaphores =
             &m_render_finished_semaphores[m_current_frame_index];
 
         // Submit to the graphics queue.
         // Signals the m_in_flight_fence when graphics rendering is done.
-        result = vkQueueSubmit(
-            m_graphics_queue, 1, &submit_info,
-            m_in_flight_fences[m_current_frame_index]
-        );
-        if (result != VkResult::VK_SUCCESS) {
-            VK_TUT_LOG_ERROR("Failed to submit draw command buffer.");
+        {
+            VK_TUT_TRACE_SCOPE("queue_submit");
+            ScopedFrameTimer timer(
+                m_frame_statistics, FrameMetric::SUBMIT_TIME
+            );
+            result = vkQueueSubmit(
+                m_graphics_queue, 1, &submit_info,
+                m_in_flight_fences[m_current_frame_index]
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to submit draw command buffer.");
+            }
+        }
+        m_frame_counter++;
+        m_frame_submit_values[m_current_frame_index] = m_frame_counter;
+        if (m_ptr_readback_ring != nullptr) {
+            m_ptr_readback_ring->submit(m_current_frame_index, m_frame_counter);
+        }
+        m_gpu_profiler.submit(m_current_frame_index);
+        m_pipeline_statistics.submit(m_current_frame_index);
+
+        if (headless) {
+            m_current_frame_index = (m_current_frame_index + 1) %
+                m_swapchain_frame_buffers.size();
+            return;
         }
 
         // Presentation information.
@@ -188,9 +384,13 @@ namespace vk::tut {
 
         // Waits for the graphics rendering before
         // presenting the image back to the swapchain.
-        result = vkQueuePresentKHR(
-            m_present_queue, &present_info
-        );
+        {
+            VK_TUT_TRACE_SCOPE("queue_present");
+            ScopedFrameTimer timer(
+                m_frame_statistics, FrameMetric::PRESENT_TIME
+            );
+            result = vkQueuePresentKHR(m_present_queue, &present_info);
+        }
         if (result == VkResult::VK_ERROR_OUT_OF_DATE_KHR ||
         result == VkResult::VK_SUBOPTIMAL_KHR) {
             recreate_swapchain();
@@ -207,7 +407,39 @@ namespace vk::tut {
             m_swapchain_frame_buffers.size();
     }
 
+    void Application::wait_for_frames_in_flight() {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        result = vkWaitForFences(
+            m_logical_device,
+            static_cast<uint32_t>(m_in_flight_fences.size()),
+            m_in_flight_fences.data(), VK_TRUE,
+            ::std::numeric_limits<uint64_t>::max()
+        );
+        if (result != VkResult::VK_SUCCESS) {
+            VK_TUT_LOG_ERROR("Failed to wait for fences.");
+        }
+
+        m_completed_frame_value = m_frame_counter;
+        m_deletion_queue.flush(m_completed_frame_value);
+        for (uint32_t slot = 0; slot < m_in_flight_fences.size(); slot++) {
+            m_gpu_profiler.collect(m_logical_device, slot);
+            record_gpu_frame_time();
+            record_pipeline_statistics(slot);
+        }
+        if (m_ptr_readback_ring != nullptr) {
+            m_ptr_readback_ring->retrieve(m_logical_device,
+                m_completed_frame_value, [this](const ReadbackFrame& frame) {
+                    write_readback_frame(frame);
+                }
+            );
+        }
+    }
+
     void Application::update_uniform_buffer() {
+        VK_TUT_TRACE_SCOPE("update_uniform_buffer");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -228,10 +460,12 @@ namespace vk::tut {
                 ::glm::vec3(0.0f, 0.0f, 0.0f),
                 ::glm::vec3(0.0f, 0.0f, 1.0f)
             ),
-            ::glm::perspective(
+            // Reverse-Z: the near and far planes are swapped so that the
+            // float depth precision is spent on the far distances.
+            ::glm::perspectiveRH_ZO(
                 ::glm::radians(45.0f),
                 m_swapchain_extent.width / (float) m_swapchain_extent.height,
-                0.1f, 10.0f
+                10.0f, 0.1f
             )
         );
 
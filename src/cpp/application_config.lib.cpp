@@ -0,0 +1,176 @@
+#include "vk_tut/application_config.h"
+#include "vk_tut/logging.h"
+
+#include <utility>
+
+namespace vk::tut {
+    // Copy constructor.
+    ApplicationConfig::ApplicationConfig(const ApplicationConfig& from) :
+    m_depth_prepass(from.m_depth_prepass),
+    m_msaa_sample_count(from.m_msaa_sample_count),
+    m_headless(from.m_headless),
+    m_headless_width(from.m_headless_width),
+    m_headless_height(from.m_headless_height),
+    m_frame_count(from.m_frame_count),
+    m_readback_directory(from.m_readback_directory),
+    m_trace_path(from.m_trace_path),
+    m_statistics_path(from.m_statistics_path),
+    m_hitch_threshold_ms(from.m_hitch_threshold_ms),
+    m_pipeline_statistics(from.m_pipeline_statistics),
+    m_device_name(from.m_device_name),
+    m_mesh_triangle_count(from.m_mesh_triangle_count),
+    m_debug_draw(from.m_debug_draw) {}
+
+    // Move constructor.
+    ApplicationConfig::ApplicationConfig(ApplicationConfig&& from) :
+    m_depth_prepass(::std::move(from.m_depth_prepass)),
+    m_msaa_sample_count(::std::move(from.m_msaa_sample_count)),
+    m_headless(::std::move(from.m_headless)),
+    m_headless_width(::std::move(from.m_headless_width)),
+    m_headless_height(::std::move(from.m_headless_height)),
+    m_frame_count(::std::move(from.m_frame_count)),
+    m_readback_directory(::std::move(from.m_readback_directory)),
+    m_trace_path(::std::move(from.m_trace_path)),
+    m_statistics_path(::std::move(from.m_statistics_path)),
+    m_hitch_threshold_ms(::std::move(from.m_hitch_threshold_ms)),
+    m_pipeline_statistics(::std::move(from.m_pipeline_statistics)),
+    m_device_name(::std::move(from.m_device_name)),
+    m_mesh_triangle_count(::std::move(from.m_mesh_triangle_count)),
+    m_debug_draw(::std::move(from.m_debug_draw)) {}
+
+    // Copy re-assignment.
+    ApplicationConfig& ApplicationConfig::operator= (
+        const ApplicationConfig& from
+    ) {
+        m_depth_prepass = from.m_depth_prepass;
+        m_msaa_sample_count = from.m_msaa_sample_count;
+        m_headless = from.m_headless;
+        m_headless_width = from.m_headless_width;
+        m_headless_height = from.m_headless_height;
+        m_frame_count = from.m_frame_count;
+        m_readback_directory = from.m_readback_directory;
+        m_trace_path = from.m_trace_path;
+        m_statistics_path = from.m_statistics_path;
+        m_hitch_threshold_ms = from.m_hitch_threshold_ms;
+        m_pipeline_statistics = from.m_pipeline_statistics;
+        m_device_name = from.m_device_name;
+        m_mesh_triangle_count = from.m_mesh_triangle_count;
+        m_debug_draw = from.m_debug_draw;
+
+        return *this;
+    }
+
+    // Move re-assignment.
+    ApplicationConfig& ApplicationConfig::operator= (
+        ApplicationConfig&& from
+    ) {
+        m_depth_prepass = ::std::move(from.m_depth_prepass);
+        m_msaa_sample_count = ::std::move(from.m_msaa_sample_count);
+        m_headless = ::std::move(from.m_headless);
+        m_headless_width = ::std::move(from.m_headless_width);
+        m_headless_height = ::std::move(from.m_headless_height);
+        m_frame_count = ::std::move(from.m_frame_count);
+        m_readback_directory = ::std::move(from.m_readback_directory);
+        m_trace_path = ::std::move(from.m_trace_path);
+        m_statistics_path = ::std::move(from.m_statistics_path);
+        m_hitch_threshold_ms = ::std::move(from.m_hitch_threshold_ms);
+        m_pipeline_statistics = ::std::move(from.m_pipeline_statistics);
+        m_device_name = ::std::move(from.m_device_name);
+        m_mesh_triangle_count = ::std::move(from.m_mesh_triangle_count);
+        m_debug_draw = ::std::move(from.m_debug_draw);
+
+        return *this;
+    }
+
+    // Copy setter for m_depth_prepass.
+    void ApplicationConfig::set_depth_prepass(const bool& depth_prepass) {
+        m_depth_prepass = depth_prepass;
+    }
+
+    // Copy setter for m_msaa_sample_count.
+    void ApplicationConfig::set_msaa_sample_count(
+        const uint32_t& msaa_sample_count
+    ) {
+        m_msaa_sample_count = msaa_sample_count;
+    }
+
+    // Copy setter for m_headless.
+    void ApplicationConfig::set_headless(const bool& headless) {
+        m_headless = headless;
+    }
+
+    // Copy setter for m_headless_width.
+    void ApplicationConfig::set_headless_width(const uint32_t& headless_width) {
+        // An empty image cannot be rendered to.
+        if (headless_width == 0) {
+            VK_TUT_LOG_ERROR("The headless width must be positive.");
+        }
+        m_headless_width = headless_width;
+    }
+
+    // Copy setter for m_headless_height.
+    void ApplicationConfig::set_headless_height(
+        const uint32_t& headless_height
+    ) {
+        // An empty image cannot be rendered to.
+        if (headless_height == 0) {
+            VK_TUT_LOG_ERROR("The headless height must be positive.");
+        }
+        m_headless_height = headless_height;
+    }
+
+    // Copy setter for m_frame_count.
+    void ApplicationConfig::set_frame_count(const uint32_t& frame_count) {
+        m_frame_count = frame_count;
+    }
+
+    // Copy setter for m_readback_directory.
+    void ApplicationConfig::set_readback_directory(
+        const ::std::string& readback_directory
+    ) {
+        m_readback_directory = readback_directory;
+    }
+
+    // Copy setter for m_trace_path.
+    void ApplicationConfig::set_trace_path(const ::std::string& trace_path) {
+        m_trace_path = trace_path;
+    }
+
+    // Copy setter for m_statistics_path.
+    void ApplicationConfig::set_statistics_path(
+        const ::std::string& statistics_path
+    ) {
+        m_statistics_path = statistics_path;
+    }
+
+    // Copy setter for m_hitch_threshold_ms.
+    void ApplicationConfig::set_hitch_threshold_ms(
+        const float& hitch_threshold_ms
+    ) {
+        m_hitch_threshold_ms = hitch_threshold_ms;
+    }
+
+    // Copy setter for m_pipeline_statistics.
+    void ApplicationConfig::set_pipeline_statistics(
+        const bool& pipeline_statistics
+    ) {
+        m_pipeline_statistics = pipeline_statistics;
+    }
+
+    // Copy setter for m_device_name.
+    void ApplicationConfig::set_device_name(const ::std::string& device_name) {
+        m_device_name = device_name;
+    }
+
+    // Copy setter for m_mesh_triangle_count.
+    void ApplicationConfig::set_mesh_triangle_count(
+        const uint32_t& mesh_triangle_count
+    ) {
+        m_mesh_triangle_count = mesh_triangle_count;
+    }
+
+    // Copy setter for m_debug_draw.
+    void ApplicationConfig::set_debug_draw(const bool& debug_draw) {
+        m_debug_draw = debug_draw;
+    }
+}
\ No newline at end of file
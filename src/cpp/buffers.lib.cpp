@@ -1,4 +1,5 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 #include "vk_tut/uniform.h"
 
@@ -6,6 +7,8 @@
 
 namespace vk::tut {
     void Application::create_mesh_buffer() {
+        VK_TUT_TRACE_SCOPE("create_mesh_buffer");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -70,19 +73,53 @@ namespace vk::tut {
             &m_mesh_buffer_memory
         );
 
+        VkCommandBuffer upload_command_buffer = begin_single_time_commands(
+            m_logical_device, m_command_pool
+        );
+
         // Copy the staging buffer to the vertex buffer.
+        // The buffer is new, so this needs no barrier.
+        m_resource_state_tracker.track_buffer(m_mesh_buffer);
+        m_resource_state_tracker.require_buffer_state(m_mesh_buffer,
+            ResourceState(
+                VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+            )
+        );
         copy_buffer(
-            m_logical_device, m_command_pool, m_graphics_queue,
+            upload_command_buffer,
             staging_objects_buffer, m_mesh_buffer, objects_buffer_size
         );
 
-        vkFreeMemory(m_logical_device, staging_objects_buffer_memory, nullptr);
-        vkDestroyBuffer(m_logical_device, staging_objects_buffer, nullptr);
+        // Make the copy visible to the vertex input stage.
+        m_resource_state_tracker.require_buffer_state(m_mesh_buffer,
+            ResourceState(
+                VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR |
+                VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR,
+                VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR |
+                VK_ACCESS_2_INDEX_READ_BIT_KHR
+            )
+        );
+        m_resource_state_tracker.flush(
+            upload_command_buffer, m_vk_cmd_pipeline_barrier2
+        );
+
+        end_single_time_commands(
+            m_logical_device, m_command_pool, m_graphics_queue,
+            upload_command_buffer
+        );
+
+        vkFreeMemory(m_logical_device, staging_objects_buffer_memory,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+        vkDestroyBuffer(m_logical_device, staging_objects_buffer,
+            get_allocation_callbacks(VK_OBJECT_TYPE_BUFFER));
 
         VK_TUT_LOG_DEBUG("Successfully created and allocated objects buffer.");
     }
 
     void Application::create_uniform_buffers() {
+        VK_TUT_TRACE_SCOPE("create_uniform_buffers");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -117,14 +154,80 @@ namespace vk::tut {
         VK_TUT_LOG_DEBUG("Successfully created and allocated uniform buffers.");
     }
 
+    void Application::create_instance_buffers() {
+        VK_TUT_TRACE_SCOPE("create_instance_buffers");
+
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        VkDeviceSize instance_buffer_size = static_cast<VkDeviceSize>(
+            sizeof(InstanceTransform) * m_instances.size()
+        );
+
+        // One buffer per frame in flight, so an animated scene
+        // writes the transforms of a frame while others are drawn.
+        const size_t slot_count = m_swapchain_frame_buffers.size();
+        m_instance_buffers.resize(slot_count);
+        m_instance_buffer_memories.resize(slot_count);
+        m_mapped_instance_buffers.resize(slot_count);
+        for (size_t i = 0; i < slot_count; i++) {
+            create_and_allocate_buffer(
+                m_physical_device, m_logical_device, instance_buffer_size,
+                VkBufferUsageFlagBits::VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                &m_instance_buffers[i], &m_instance_buffer_memories[i]
+            );
+
+            // Kept mapped until the buffer is destroyed.
+            void* data;
+            result = vkMapMemory(
+                m_logical_device, m_instance_buffer_memories[i], 0,
+                instance_buffer_size, 0, &data
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to map memory.");
+            }
+            memcpy(data, m_instances.data(),
+                static_cast<size_t>(instance_buffer_size)
+            );
+            m_mapped_instance_buffers[i] =
+                static_cast<InstanceTransform*>(data);
+        }
+
+        VK_TUT_LOG_DEBUG(
+            "Successfully created and allocated instance buffers."
+        );
+    }
+
+    void Application::destroy_instance_buffers() {
+        // Freeing the memory unmaps it.
+        for (const VkDeviceMemory& instance_buffer_memory :
+        m_instance_buffer_memories) {
+            vkFreeMemory(m_logical_device, instance_buffer_memory,
+                get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+        }
+        m_instance_buffer_memories.clear();
+        for (const VkBuffer& instance_buffer : m_instance_buffers) {
+            vkDestroyBuffer(m_logical_device, instance_buffer,
+                get_allocation_callbacks(VK_OBJECT_TYPE_BUFFER));
+        }
+        m_instance_buffers.clear();
+        m_mapped_instance_buffers.clear();
+
+        VK_TUT_LOG_DEBUG("Destroyed instance buffers.");
+    }
+
     void Application::destroy_uniform_buffers() {
         for (const VkDeviceMemory& uniform_buffer_memory :
         m_uniform_buffer_memories) {
-            vkFreeMemory(m_logical_device, uniform_buffer_memory, nullptr);
+            vkFreeMemory(m_logical_device, uniform_buffer_memory,
+                get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
         }
         m_uniform_buffer_memories.clear();
         for (const VkBuffer& uniform_buffer : m_uniform_buffers) {
-            vkDestroyBuffer(m_logical_device, uniform_buffer, nullptr);
+            vkDestroyBuffer(m_logical_device, uniform_buffer,
+                get_allocation_callbacks(VK_OBJECT_TYPE_BUFFER));
         }
         m_uniform_buffers.clear();
 
@@ -132,8 +235,11 @@ namespace vk::tut {
     }
 
     void Application::destroy_mesh_buffer() {
-        vkFreeMemory(m_logical_device, m_mesh_buffer_memory, nullptr);
-        vkDestroyBuffer(m_logical_device, m_mesh_buffer, nullptr);
+        m_resource_state_tracker.forget_buffer(m_mesh_buffer);
+        vkFreeMemory(m_logical_device, m_mesh_buffer_memory,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+        vkDestroyBuffer(m_logical_device, m_mesh_buffer,
+            get_allocation_callbacks(VK_OBJECT_TYPE_BUFFER));
 
         VK_TUT_LOG_DEBUG("Destroyed mesh buffer.");
     }
@@ -182,7 +288,8 @@ namespace vk::tut {
 
         // Create the buffer.
         result = vkCreateBuffer(
-            logical_device, &buffer_info, nullptr, ptr_buffer
+            logical_device, &buffer_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_BUFFER), ptr_buffer
         );
         if(result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -207,7 +314,9 @@ namespace vk::tut {
 
         // Allocate memory.
         result = vkAllocateMemory(
-            logical_device, &alloc_info, nullptr, ptr_buffer_memory
+            logical_device, &alloc_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY),
+            ptr_buffer_memory
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR("Failed to allocate buffer memory.");
@@ -223,29 +332,19 @@ namespace vk::tut {
     }
 
     void copy_buffer(
-        const VkDevice& logical_device,
-        const VkCommandPool& command_pool,
-        const VkQueue& queue,
+        const VkCommandBuffer& command_buffer,
         const VkBuffer& src_buffer,
         const VkBuffer& dest_buffer,
         const VkDeviceSize& buffer_size
     ) {
-        VkCommandBuffer copy_command_buffer = begin_single_time_commands(
-            logical_device, command_pool
-        );
-        
         // Information about how the copy happens.
         VkBufferCopy copy_region{};
         copy_region.srcOffset = 0; // Optional
         copy_region.dstOffset = 0; // Optional
         copy_region.size = buffer_size;
         vkCmdCopyBuffer(
-            copy_command_buffer, src_buffer,
+            command_buffer, src_buffer,
             dest_buffer, 1, &copy_region
         );
-
-        end_single_time_commands(
-            logical_device, command_pool, queue, copy_command_buffer
-        );
     }
 }
\ No newline at end of file
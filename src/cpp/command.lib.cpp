@@ -1,9 +1,23 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 #include "vk_tut/queue_family.h"
+#include "vk_tut/push_constant.h"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <string>
 
 namespace vk::tut {
+    // The upper bound of the number of threads recording a frame.
+    static constexpr uint32_t MAX_RECORDING_THREADS = 8;
+    // Draw lists are only split in slices of at least this many draws.
+    static constexpr uint32_t MIN_DRAWS_PER_RECORDING_THREAD = 64;
+
     void Application::create_command_pool() {
+        VK_TUT_TRACE_SCOPE("create_command_pool");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -30,7 +44,9 @@ namespace vk::tut {
         
         // Create the command pool.
         result = vkCreateCommandPool(
-            m_logical_device, &command_pool_info, nullptr, &m_command_pool
+            m_logical_device, &command_pool_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_COMMAND_POOL),
+            &m_command_pool
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -42,6 +58,8 @@ namespace vk::tut {
     }
 
     void Application::create_command_buffers() {
+        VK_TUT_TRACE_SCOPE("create_command_buffers");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -76,29 +94,134 @@ namespace vk::tut {
         VK_TUT_LOG_DEBUG("Successfully allocated command buffers.");
     }
 
+    void Application::create_recording_command_pools() {
+        VK_TUT_TRACE_SCOPE("create_recording_command_pools");
+
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        m_recording_thread_count = ::std::clamp(
+            m_job_system.get_thread_count(), 1U, MAX_RECORDING_THREADS
+        );
+
+        QueueFamilyIndices indices = find_family_indices(
+            m_physical_device, m_surface
+        );
+
+        // The information about each command pool. Their buffers
+        // are recorded once and reset with the whole pool.
+        VkCommandPoolCreateInfo command_pool_info{};
+        command_pool_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_info.queueFamilyIndex = ::std::get<1>(
+            indices.get_graphics_family_index()
+        );
+        command_pool_info.flags = VkCommandPoolCreateFlagBits
+            ::VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        // One pool per frame slot and draw list slice, since a
+        // command pool may only be used by one thread at a time.
+        const size_t pool_count = m_swapchain_frame_buffers.size() *
+            m_recording_thread_count;
+        m_recording_command_pools.reserve(pool_count);
+        m_recording_command_buffers.reserve(pool_count);
+
+        for (size_t i = 0; i < pool_count; i++) {
+            // The command pool to be created.
+            VkCommandPool command_pool;
+
+            result = vkCreateCommandPool(
+                m_logical_device, &command_pool_info,
+                get_allocation_callbacks(VK_OBJECT_TYPE_COMMAND_POOL),
+                &command_pool
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR(
+                    "Failed to create recording command pool."
+                );
+            }
+            m_recording_command_pools.emplace_back(command_pool);
+
+            VkCommandBufferAllocateInfo command_buffer_info{};
+            command_buffer_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            command_buffer_info.commandPool = command_pool;
+            command_buffer_info.level = VkCommandBufferLevel
+                ::VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            command_buffer_info.commandBufferCount = 1;
+
+            // The secondary command buffer to be allocated.
+            VkCommandBuffer command_buffer;
+
+            result = vkAllocateCommandBuffers(
+                m_logical_device, &command_buffer_info, &command_buffer
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR(
+                    "Failed to allocate secondary command buffer."
+                );
+            }
+            m_recording_command_buffers.emplace_back(command_buffer);
+        }
+
+        VK_TUT_LOG_DEBUG("Successfully created recording command pools for " +
+            ::std::to_string(m_recording_thread_count) + " draw list slices.");
+    }
+
+    void Application::destroy_recording_command_pools() {
+        for (const VkCommandPool& command_pool : m_recording_command_pools) {
+            vkDestroyCommandPool(m_logical_device, command_pool,
+                get_allocation_callbacks(VK_OBJECT_TYPE_COMMAND_POOL));
+        }
+        m_recording_command_pools.clear();
+        m_recording_command_buffers.clear();
+
+        VK_TUT_LOG_DEBUG("Destroyed recording command pools.");
+    }
+
     void Application::destroy_command_pool() {
         // This also frees the command buffers.
         // No need to explicitly free the command buffers.
-        vkDestroyCommandPool(m_logical_device, m_command_pool, nullptr);
+        vkDestroyCommandPool(m_logical_device, m_command_pool,
+            get_allocation_callbacks(VK_OBJECT_TYPE_COMMAND_POOL));
 
         VK_TUT_LOG_DEBUG("Destroyed command pool.");
     }
 
     void Application::record_command_buffer(
-        const uint32_t& image_index
+        const VkCommandBuffer& command_buffer,
+        const uint32_t& image_index,
+        const bool& record_in_parallel
     ) {
+        VK_TUT_TRACE_SCOPE("record_command_buffer");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
+        // The secondary command buffers only live as long as the frame.
+        FrameVector<VkCommandBuffer> secondary_command_buffers(
+            &get_frame_arena()
+        );
+        if (record_in_parallel) {
+            secondary_command_buffers.reserve(m_recording_thread_count);
+            record_secondary_command_buffers(
+                image_index, secondary_command_buffers
+            );
+        }
+
+        // The passes of the render graph read these while recording.
+        m_recording_image_index = image_index;
+        m_ptr_recording_secondary_command_buffers = &secondary_command_buffers;
+
         // Information about how the command buffer begins recording.
         VkCommandBufferBeginInfo command_buffer_begin_info{};
         command_buffer_begin_info.sType = VkStructureType
             ::VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        // Optional. Only relevant if we're using secondary command buffers.
+        // Only relevant for secondary command buffers.
         command_buffer_begin_info.pInheritanceInfo = nullptr;
         
         result = vkBeginCommandBuffer(
-            m_command_buffers[m_current_frame_index], &command_buffer_begin_info
+            command_buffer, &command_buffer_begin_info
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -106,8 +229,46 @@ namespace vk::tut {
             );
         }
 
-        // Turn the background into black.
-        VkClearValue clear_colour[] = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+        // The command buffer belongs to the current frame slot, whether
+        // it is recorded for this frame or cached for later ones.
+        m_gpu_profiler.begin_frame(command_buffer, m_current_frame_index);
+        m_gpu_profiler.begin_region(
+            command_buffer, m_current_frame_index, "frame"
+        );
+
+        // Record the passes of the frame with the barriers between them.
+        m_ptr_render_graph->set_imported_image(m_swapchain_image_resource,
+            m_swapchain_images[image_index],
+            m_swapchain_image_views[image_index]
+        );
+        m_ptr_render_graph->execute(
+            command_buffer, m_resource_state_tracker,
+            m_vk_cmd_pipeline_barrier2
+        );
+
+        m_gpu_profiler.end_region(
+            command_buffer, m_current_frame_index, "frame"
+        );
+
+        m_ptr_recording_secondary_command_buffers = nullptr;
+
+        // End command buffer recording.
+        result = vkEndCommandBuffer(command_buffer);
+        if (result != VkResult::VK_SUCCESS) {
+            VK_TUT_LOG_ERROR("Failed to record command buffer.");
+        }
+    }
+
+    void Application::record_main_pass(const VkCommandBuffer& command_buffer) {
+        const FrameVector<VkCommandBuffer>& secondary_command_buffers =
+            *m_ptr_recording_secondary_command_buffers;
+
+        // Turn the background into black. Clear the depth
+        // to 0, which is the far plane under reverse-Z.
+        // The resolve attachment, if any, is not cleared.
+        ::std::array<VkClearValue, 2> clear_values{};
+        clear_values[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clear_values[1].depthStencil = {0.0f, 0};
 
         // Information about beginning render pass.
         VkRenderPassBeginInfo render_pass_begin_info{};
@@ -115,30 +276,82 @@ namespace vk::tut {
             ::VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
         render_pass_begin_info.renderPass = m_render_pass;
         render_pass_begin_info.framebuffer =
-            m_swapchain_frame_buffers[image_index];
+            m_swapchain_frame_buffers[m_recording_image_index];
         render_pass_begin_info.renderArea.offset = {0, 0};
         render_pass_begin_info.renderArea.extent = m_swapchain_extent;
-        render_pass_begin_info.clearValueCount = 1;
-        render_pass_begin_info.pClearValues = clear_colour;
-
-        // Begin the render pass.
-        vkCmdBeginRenderPass(
-            m_command_buffers[m_current_frame_index],
-            &render_pass_begin_info,
-            VkSubpassContents::VK_SUBPASS_CONTENTS_INLINE
+        render_pass_begin_info.clearValueCount = static_cast<uint32_t>(
+            clear_values.size()
         );
-        
+        render_pass_begin_info.pClearValues = clear_values.data();
+
+        // How the draws of the shading subpass are recorded.
+        const VkSubpassContents shading_subpass_contents =
+            secondary_command_buffers.empty() ?
+            VkSubpassContents::VK_SUBPASS_CONTENTS_INLINE :
+            VkSubpassContents::VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+
+        if (m_config.get_depth_prepass()) {
+            // Begin the render pass with the depth prepass subpass.
+            vkCmdBeginRenderPass(
+                command_buffer,
+                &render_pass_begin_info,
+                VkSubpassContents::VK_SUBPASS_CONTENTS_INLINE
+            );
+            record_draw_commands(
+                command_buffer, 0,
+                static_cast<uint32_t>(m_draw_commands.size()), true
+            );
+            vkCmdNextSubpass(command_buffer, shading_subpass_contents);
+        }
+        else {
+            // Begin the render pass.
+            vkCmdBeginRenderPass(
+                command_buffer,
+                &render_pass_begin_info,
+                shading_subpass_contents
+            );
+        }
+
+        if (secondary_command_buffers.empty()) {
+            record_draw_commands(
+                command_buffer, 0,
+                static_cast<uint32_t>(m_draw_commands.size()), false
+            );
+            record_debug_draws(command_buffer);
+        }
+        else {
+            vkCmdExecuteCommands(
+                command_buffer,
+                static_cast<uint32_t>(secondary_command_buffers.size()),
+                secondary_command_buffers.data()
+            );
+        }
+
+        // End the render pass.
+        vkCmdEndRenderPass(command_buffer);
+    }
+
+    void Application::record_draw_commands(
+        const VkCommandBuffer& command_buffer,
+        const uint32_t& first_draw,
+        const uint32_t& draw_count,
+        const bool& depth_only
+    ) {
         // Bind the command buffer to the graphics pipeline.
         vkCmdBindPipeline(
-            m_command_buffers[m_current_frame_index],
+            command_buffer,
             VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_GRAPHICS,
-            m_graphics_pipeline
+            depth_only ? m_depth_prepass_pipeline : m_graphics_pipeline
         );
 
-        // Bind the vertex buffers.
-        VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(m_command_buffers[m_current_frame_index],
-            0, 1, &m_mesh_buffer, offsets
+        // Bind the vertex buffers: the vertices of the meshes, then the
+        // instance transforms written for this frame slot.
+        VkBuffer vertex_buffers[] = {
+            m_mesh_buffer, m_instance_buffers[m_current_frame_index]
+        };
+        VkDeviceSize offsets[] = {0, 0};
+        vkCmdBindVertexBuffers(command_buffer,
+            0, 2, vertex_buffers, offsets
         );
 
         // The data of the index buffer follows after the vertex array.
@@ -146,33 +359,262 @@ namespace vk::tut {
             sizeof(Vertex) * m_vertices.size()
         );
         // Bind the indices data.
-        vkCmdBindIndexBuffer(m_command_buffers[m_current_frame_index],
+        vkCmdBindIndexBuffer(command_buffer,
             m_mesh_buffer, index_data_offset,
             VkIndexType::VK_INDEX_TYPE_UINT32
         );
 
-        // Bind the uniform buffers.
+        // Bind the uniform buffer and the bindless texture table.
+        // This is the only descriptor set bind of the command buffer.
         vkCmdBindDescriptorSets(
-            m_command_buffers[m_current_frame_index],
+            command_buffer,
             VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_GRAPHICS,
             m_graphics_pipeline_layout, 0, 1,
             &m_descriptor_sets[m_current_frame_index], 0, nullptr
         );
 
-        // Draw the three vertices specified in our vertex shader.
-        vkCmdDrawIndexed(
-            m_command_buffers[m_current_frame_index],
-            static_cast<uint32_t>(m_indices.size()), 1, 0, 0, 0
+        // The texture slot last pushed. Only pushed again when it changes.
+        uint32_t pushed_texture_index = MAX_BINDLESS_TEXTURES;
+
+        for (uint32_t i = first_draw; i < first_draw + draw_count; i++) {
+            const DrawCommand& draw_command = m_draw_commands[i];
+
+            // Select the texture from the bindless texture table.
+            if (!depth_only &&
+            draw_command.get_texture_index() != pushed_texture_index) {
+                PushConstant push_constant(draw_command.get_texture_index());
+                vkCmdPushConstants(
+                    command_buffer,
+                    m_graphics_pipeline_layout,
+                    VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT,
+                    0, sizeof(PushConstant), &push_constant
+                );
+                pushed_texture_index = draw_command.get_texture_index();
+            }
+
+            vkCmdDrawIndexed(
+                command_buffer, draw_command.get_index_count(),
+                draw_command.get_instance_count(),
+                draw_command.get_first_index(),
+                draw_command.get_vertex_offset(),
+                draw_command.get_first_instance()
+            );
+        }
+    }
+
+    void Application::record_secondary_command_buffers(
+        const uint32_t& image_index,
+        FrameVector<VkCommandBuffer>& ref_secondary_command_buffers
+    ) {
+        const uint32_t draw_count = static_cast<uint32_t>(
+            m_draw_commands.size()
         );
+        if (draw_count == 0) return;
 
-        // End the render pass.
-        vkCmdEndRenderPass(m_command_buffers[m_current_frame_index]);
+        // Small draw lists are not worth splitting across threads.
+        const uint32_t slice_count = ::std::min(
+            m_recording_thread_count,
+            (draw_count + MIN_DRAWS_PER_RECORDING_THREAD - 1) /
+            MIN_DRAWS_PER_RECORDING_THREAD
+        );
+        const uint32_t draws_per_slice =
+            (draw_count + slice_count - 1) / slice_count;
+
+        // Records one contiguous slice of the draw list into the secondary
+        // command buffer of the slice. Each slice owns its command pool,
+        // so no pool is used by two threads at once.
+        auto record_slice = [&](const uint32_t& slice_index) {
+            VK_TUT_TRACE_SCOPE("record_slice");
+
+            // The variable that stores the result of any vulkan function called.
+            VkResult result;
+
+            const size_t pool_index = m_current_frame_index *
+                m_recording_thread_count + slice_index;
+            const VkCommandBuffer& command_buffer =
+                m_recording_command_buffers[pool_index];
+
+            // The frame fence was waited on. Nothing
+            // allocated from this pool is in use.
+            result = vkResetCommandPool(
+                m_logical_device, m_recording_command_pools[pool_index], 0
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to reset command pool.");
+            }
 
-        // End command buffer recording.
-        result = vkEndCommandBuffer(m_command_buffers[m_current_frame_index]);
-        if (result != VkResult::VK_SUCCESS) {
-            VK_TUT_LOG_ERROR("Failed to record command buffer.");
+            // The render pass and frame buffer the draws are executed in.
+            VkCommandBufferInheritanceInfo inheritance_info{};
+            inheritance_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritance_info.renderPass = m_render_pass;
+            inheritance_info.subpass = m_config.get_depth_prepass() ? 1 : 0;
+            inheritance_info.framebuffer =
+                m_swapchain_frame_buffers[image_index];
+            // The main pass counts the draws with a query left active.
+            inheritance_info.pipelineStatistics =
+                m_pipeline_statistics.is_enabled() ?
+                PipelineStatisticsQueries::get_flags() : 0;
+
+            VkCommandBufferBeginInfo command_buffer_begin_info{};
+            command_buffer_begin_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            command_buffer_begin_info.flags = VkCommandBufferUsageFlagBits
+                ::VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                VkCommandBufferUsageFlagBits
+                ::VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            command_buffer_begin_info.pInheritanceInfo = &inheritance_info;
+
+            result = vkBeginCommandBuffer(
+                command_buffer, &command_buffer_begin_info
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR(
+                    "Failed to begin recording secondary command buffer."
+                );
+            }
+
+            const uint32_t first_draw = slice_index * draws_per_slice;
+            record_draw_commands(
+                command_buffer, first_draw,
+                ::std::min(draws_per_slice, draw_count - first_draw), false
+            );
+            // Debug primitives are drawn over the last slice.
+            if (slice_index == slice_count - 1) {
+                record_debug_draws(command_buffer);
+            }
+
+            result = vkEndCommandBuffer(command_buffer);
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to record secondary command buffer.");
+            }
+        };
+
+        // The errors of each slice. Rethrown on the calling thread.
+        ::std::array<::std::exception_ptr, MAX_RECORDING_THREADS> errors;
+        auto record_slice_safely = [&](const uint32_t& slice_index) {
+            try {
+                record_slice(slice_index);
+            }
+            catch (...) {
+                errors[slice_index] = ::std::current_exception();
+            }
+        };
+
+        JobCounter counter;
+        for (uint32_t t = 1; t < slice_count; t++) {
+            // Small enough for ::std::function to store in place.
+            m_job_system.run(
+                [&record_slice_safely, t]() { record_slice_safely(t); },
+                &counter
+            );
+        }
+        // The calling thread records the first slice, then helps out.
+        record_slice_safely(0);
+        m_job_system.wait(counter);
+        for (const ::std::exception_ptr& error : errors) {
+            if (error) ::std::rethrow_exception(error);
         }
+
+        // Executed in the order of the draw list.
+        for (uint32_t t = 0; t < slice_count; t++) {
+            ref_secondary_command_buffers.emplace_back(
+                m_recording_command_buffers[
+                    m_current_frame_index * m_recording_thread_count + t
+                ]
+            );
+        }
+    }
+
+    VkCommandBuffer Application::get_cached_command_buffer(
+        const uint32_t& image_index
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        const size_t slot_count = m_in_flight_fences.size();
+
+        // Allocate the cache lazily, after every swapchain (re)creation.
+        if (m_cached_command_buffers.empty()) {
+            m_cached_command_buffers.resize(
+                m_swapchain_frame_buffers.size() * slot_count
+            );
+
+            VkCommandBufferAllocateInfo command_buffer_info{};
+            command_buffer_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            command_buffer_info.commandPool = m_command_pool;
+            command_buffer_info.level = VkCommandBufferLevel
+                ::VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            command_buffer_info.commandBufferCount = static_cast<uint32_t>(
+                m_cached_command_buffers.size()
+            );
+
+            result = vkAllocateCommandBuffers(
+                m_logical_device, &command_buffer_info,
+                m_cached_command_buffers.data()
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                m_cached_command_buffers.clear();
+                VK_TUT_LOG_ERROR(
+                    "Failed to allocate cached command buffers."
+                );
+            }
+            m_cached_command_buffer_validity.assign(
+                m_cached_command_buffers.size(), false
+            );
+
+            VK_TUT_LOG_DEBUG("Allocated " +
+                ::std::to_string(m_cached_command_buffers.size()) +
+                " cached command buffers.");
+        }
+
+        const size_t cache_index = image_index * slot_count +
+            m_current_frame_index;
+
+        // A cached command buffer is only ever submitted from its own
+        // frame slot, whose fence was waited on. Re-recording is safe.
+        if (!m_cached_command_buffer_validity[cache_index]) {
+            result = vkResetCommandBuffer(
+                m_cached_command_buffers[cache_index], 0
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to reset command buffer.");
+            }
+
+            record_command_buffer(
+                m_cached_command_buffers[cache_index], image_index, false
+            );
+            m_cached_command_buffer_validity[cache_index] = true;
+        }
+
+        return m_cached_command_buffers[cache_index];
+    }
+
+    void Application::invalidate_cached_command_buffers() {
+        m_cached_command_buffer_validity.assign(
+            m_cached_command_buffer_validity.size(), false
+        );
+    }
+
+    void Application::retire_cached_command_buffers() {
+        if (m_cached_command_buffers.empty()) return;
+
+        // The frames in flight may still execute them.
+        VkDevice logical_device = m_logical_device;
+        VkCommandPool command_pool = m_command_pool;
+        ::std::vector<VkCommandBuffer> old_command_buffers =
+            ::std::move(m_cached_command_buffers);
+        m_deletion_queue.enqueue(m_frame_counter, [=]() {
+            vkFreeCommandBuffers(
+                logical_device, command_pool,
+                static_cast<uint32_t>(old_command_buffers.size()),
+                old_command_buffers.data()
+            );
+        });
+
+        m_cached_command_buffers.clear();
+        m_cached_command_buffer_validity.clear();
     }
 
     VkCommandBuffer begin_single_time_commands(
@@ -0,0 +1,150 @@
+#include "vk_tut/debug_draw.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace vk::tut {
+    // < --------------------------- DebugVertex -------------------------- >
+
+    VkVertexInputBindingDescription DebugVertex::get_binding_description() {
+        VkVertexInputBindingDescription description{};
+        description.binding = 0;
+        description.stride = sizeof(DebugVertex);
+        description.inputRate = VkVertexInputRate::VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return description;
+    }
+
+    std::array<VkVertexInputAttributeDescription, 2>
+    DebugVertex::get_attribute_descriptions() {
+        std::array<VkVertexInputAttributeDescription, 2>
+        attribute_descriptions{};
+
+        // The position, as in_3D_position.
+        attribute_descriptions[0].binding = 0;
+        attribute_descriptions[0].location = 0;
+        attribute_descriptions[0].format = VkFormat
+            ::VK_FORMAT_R32G32B32_SFLOAT;
+        attribute_descriptions[0].offset = offsetof(DebugVertex, position);
+
+        // The packed colour, as in_colour.
+        attribute_descriptions[1].binding = 0;
+        attribute_descriptions[1].location = 1;
+        attribute_descriptions[1].format = VkFormat
+            ::VK_FORMAT_R8G8B8A8_UNORM;
+        attribute_descriptions[1].offset = offsetof(DebugVertex, colour);
+
+        return attribute_descriptions;
+    }
+
+    // < ---------------------------- DebugDraw --------------------------- >
+
+    void DebugDraw::begin(DebugVertex* ptr_vertices, const uint32_t& capacity) {
+        m_ptr_vertices = ptr_vertices;
+        m_capacity = ptr_vertices != nullptr ? capacity : 0;
+        m_line_vertex_count = 0;
+        m_point_vertex_count = 0;
+        m_dropped_count = 0;
+    }
+
+    void DebugDraw::add_line(
+        const ::glm::vec3& from, const ::glm::vec3& to,
+        const ::glm::vec4& colour
+    ) {
+        if (m_line_vertex_count + m_point_vertex_count + 2 > m_capacity) {
+            m_dropped_count++;
+            return;
+        }
+
+        // Each vertex is written once, as the memory is often mapped.
+        const uint32_t packed_colour = pack_colour(colour);
+        m_ptr_vertices[m_line_vertex_count++] = DebugVertex{from, packed_colour};
+        m_ptr_vertices[m_line_vertex_count++] = DebugVertex{to, packed_colour};
+    }
+
+    void DebugDraw::add_box(
+        const ::glm::vec3& min, const ::glm::vec3& max,
+        const ::glm::vec4& colour
+    ) {
+        ::std::array<::glm::vec3, 8> corners;
+        for (uint32_t i = 0; i < corners.size(); i++) {
+            corners[i] = ::glm::vec3(
+                (i & 1) ? max.x : min.x,
+                (i & 2) ? max.y : min.y,
+                (i & 4) ? max.z : min.z
+            );
+        }
+        add_box_edges(corners, colour);
+    }
+
+    void DebugDraw::add_box(
+        const ::glm::mat4& transform, const ::glm::vec4& colour
+    ) {
+        ::std::array<::glm::vec3, 8> corners;
+        for (uint32_t i = 0; i < corners.size(); i++) {
+            corners[i] = ::glm::vec3(transform * ::glm::vec4(
+                (i & 1) ? 1.0f : -1.0f,
+                (i & 2) ? 1.0f : -1.0f,
+                (i & 4) ? 1.0f : -1.0f,
+                1.0f
+            ));
+        }
+        add_box_edges(corners, colour);
+    }
+
+    void DebugDraw::add_frustum(
+        const ::glm::mat4& view_projection, const ::glm::vec4& colour
+    ) {
+        // The corners of the clip volume, with Vulkan depths from 0 to 1,
+        // taken back through the projection.
+        const ::glm::mat4 inverse = ::glm::inverse(view_projection);
+        ::std::array<::glm::vec3, 8> corners;
+        for (uint32_t i = 0; i < corners.size(); i++) {
+            const ::glm::vec4 corner = inverse * ::glm::vec4(
+                (i & 1) ? 1.0f : -1.0f,
+                (i & 2) ? 1.0f : -1.0f,
+                (i & 4) ? 1.0f : 0.0f,
+                1.0f
+            );
+            corners[i] = ::glm::vec3(corner) / corner.w;
+        }
+        add_box_edges(corners, colour);
+    }
+
+    void DebugDraw::add_point(
+        const ::glm::vec3& position, const ::glm::vec4& colour
+    ) {
+        if (m_line_vertex_count + m_point_vertex_count + 1 > m_capacity) {
+            m_dropped_count++;
+            return;
+        }
+
+        m_point_vertex_count++;
+        m_ptr_vertices[m_capacity - m_point_vertex_count] =
+            DebugVertex{position, pack_colour(colour)};
+    }
+
+    uint32_t DebugDraw::pack_colour(const ::glm::vec4& colour) {
+        uint32_t packed = 0;
+        for (int channel = 0; channel < 4; channel++) {
+            const float value = ::std::clamp(colour[channel], 0.0f, 1.0f);
+            packed |= static_cast<uint32_t>(value * 255.0f + 0.5f) <<
+                (8 * channel);
+        }
+        return packed;
+    }
+
+    void DebugDraw::add_box_edges(
+        const ::std::array<::glm::vec3, 8>& corners,
+        const ::glm::vec4& colour
+    ) {
+        // Every pair of corners one axis apart is an edge.
+        for (uint32_t i = 0; i < corners.size(); i++) {
+            for (uint32_t axis_bit = 1; axis_bit < 8; axis_bit <<= 1) {
+                if ((i & axis_bit) == 0) {
+                    add_line(corners[i], corners[i | axis_bit], colour);
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
+#include "vk_tut/logging.h"
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace vk::tut {
+    void Application::create_debug_draw_buffer() {
+        VK_TUT_TRACE_SCOPE("create_debug_draw_buffer");
+
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        const VkDeviceSize slot_count = m_in_flight_fences.size();
+        m_debug_draw_vertex_offset = static_cast<VkDeviceSize>(
+            sizeof(VkDrawIndirectCommand) * 2 * slot_count
+        );
+        const VkDeviceSize debug_draw_buffer_size =
+            m_debug_draw_vertex_offset + static_cast<VkDeviceSize>(
+                sizeof(DebugVertex) * DEBUG_DRAW_VERTEX_CAPACITY
+            ) * (slot_count + 1);
+
+        // Written by the CPU every frame and read once by the GPU,
+        // so it is not worth staging.
+        create_and_allocate_buffer(
+            m_physical_device, m_logical_device, debug_draw_buffer_size,
+            VkBufferUsageFlagBits::VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+            VkBufferUsageFlagBits::VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+            VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            &m_debug_draw_buffer, &m_debug_draw_buffer_memory
+        );
+
+        // Kept mapped until the buffer is destroyed.
+        void* data;
+        result = vkMapMemory(
+            m_logical_device, m_debug_draw_buffer_memory, 0,
+            debug_draw_buffer_size, 0, &data
+        );
+        if (result != VkResult::VK_SUCCESS) {
+            VK_TUT_LOG_ERROR("Failed to map memory.");
+        }
+        m_ptr_mapped_debug_draw_arguments =
+            static_cast<VkDrawIndirectCommand*>(data);
+        m_ptr_mapped_debug_vertices = reinterpret_cast<DebugVertex*>(
+            static_cast<char*>(data) + m_debug_draw_vertex_offset
+        );
+
+        // Until a frame writes its own, every frame draws nothing.
+        for (VkDeviceSize i = 0; i < 2 * slot_count; i++) {
+            m_ptr_mapped_debug_draw_arguments[i] = {0, 1, 0, 0};
+        }
+        m_debug_draw_ring_slot = 0;
+        m_debug_draw.begin(
+            m_ptr_mapped_debug_vertices, DEBUG_DRAW_VERTEX_CAPACITY
+        );
+
+        VK_TUT_LOG_DEBUG(
+            "Successfully created and allocated debug draw buffer."
+        );
+    }
+
+    void Application::destroy_debug_draw_buffer() {
+        // Nothing is written past this point.
+        m_debug_draw.begin(nullptr, 0);
+        m_ptr_mapped_debug_draw_arguments = nullptr;
+        m_ptr_mapped_debug_vertices = nullptr;
+
+        // Freeing the memory unmaps it.
+        vkFreeMemory(m_logical_device, m_debug_draw_buffer_memory,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+        vkDestroyBuffer(m_logical_device, m_debug_draw_buffer,
+            get_allocation_callbacks(VK_OBJECT_TYPE_BUFFER));
+
+        VK_TUT_LOG_DEBUG("Destroyed debug draw buffer.");
+    }
+
+    void Application::write_debug_draw_arguments() {
+        // The fence of this frame slot was waited on, so the GPU is done
+        // with its arguments. The vertex counts are read from here when
+        // the command buffer runs, so cached command buffers stay valid.
+        VkDrawIndirectCommand* ptr_arguments =
+            m_ptr_mapped_debug_draw_arguments + 2 * m_current_frame_index;
+        const uint32_t first_vertex =
+            m_debug_draw_ring_slot * DEBUG_DRAW_VERTEX_CAPACITY;
+        ptr_arguments[0] = {
+            m_debug_draw.get_line_vertex_count(), 1, first_vertex, 0
+        };
+        ptr_arguments[1] = {
+            m_debug_draw.get_point_vertex_count(), 1,
+            first_vertex + m_debug_draw.get_first_point_vertex(), 0
+        };
+        if (m_debug_draw.get_dropped_count() > 0) {
+            VK_TUT_LOG_DEBUG("Dropped " << m_debug_draw.get_dropped_count()
+                << " debug primitives past the capacity of a frame.");
+        }
+
+        // The next slot was last drawn by the frame that used this frame
+        // slot before, which has finished.
+        const uint32_t ring_slot_count =
+            static_cast<uint32_t>(m_in_flight_fences.size()) + 1;
+        m_debug_draw_ring_slot =
+            (m_debug_draw_ring_slot + 1) % ring_slot_count;
+        m_debug_draw.begin(
+            m_ptr_mapped_debug_vertices +
+                m_debug_draw_ring_slot * DEBUG_DRAW_VERTEX_CAPACITY,
+            DEBUG_DRAW_VERTEX_CAPACITY
+        );
+    }
+
+    void Application::record_debug_draws(
+        const VkCommandBuffer& command_buffer
+    ) {
+        // The descriptor set bound for the draws is compatible, as the
+        // debug pipelines share the layout of the shading pipeline.
+        const VkDeviceSize arguments_offset = static_cast<VkDeviceSize>(
+            sizeof(VkDrawIndirectCommand) * 2 * m_current_frame_index
+        );
+        vkCmdBindVertexBuffers(command_buffer,
+            0, 1, &m_debug_draw_buffer, &m_debug_draw_vertex_offset
+        );
+
+        // Every line of the frame in one draw.
+        vkCmdBindPipeline(
+            command_buffer,
+            VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_GRAPHICS,
+            m_debug_line_pipeline
+        );
+        vkCmdDrawIndirect(
+            command_buffer, m_debug_draw_buffer, arguments_offset, 1,
+            sizeof(VkDrawIndirectCommand)
+        );
+
+        // Then every point.
+        vkCmdBindPipeline(
+            command_buffer,
+            VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_GRAPHICS,
+            m_debug_point_pipeline
+        );
+        vkCmdDrawIndirect(
+            command_buffer, m_debug_draw_buffer,
+            arguments_offset + sizeof(VkDrawIndirectCommand), 1,
+            sizeof(VkDrawIndirectCommand)
+        );
+    }
+
+    void Application::add_scene_debug_draws() {
+        VK_TUT_TRACE_SCOPE("add_scene_debug_draws");
+
+        // The world axes: x in red, y in green and z in blue.
+        const ::glm::vec3 origin(0.0f, 0.0f, 0.0f);
+        m_debug_draw.add_line(origin, ::glm::vec3(1.0f, 0.0f, 0.0f),
+            ::glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+        m_debug_draw.add_line(origin, ::glm::vec3(0.0f, 1.0f, 0.0f),
+            ::glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+        m_debug_draw.add_line(origin, ::glm::vec3(0.0f, 0.0f, 1.0f),
+            ::glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+
+        // The placement of each instance: the cube its rotation and
+        // scale map the unit cube to, and a point at its position.
+        const ::glm::vec4 box_colour(1.0f, 1.0f, 0.0f, 1.0f);
+        const ::glm::vec4 point_colour(0.0f, 1.0f, 1.0f, 1.0f);
+        for (const InstanceTransform& instance : m_instances) {
+            const ::glm::vec4 position_scale = instance.get_position_scale();
+            const ::glm::vec4 rotation = instance.get_rotation();
+            const ::glm::vec3 position(position_scale);
+            const ::glm::mat4 transform = ::glm::scale(
+                ::glm::translate(::glm::mat4(1.0f), position) *
+                ::glm::mat4_cast(::glm::quat(
+                    rotation.w, rotation.x, rotation.y, rotation.z
+                )),
+                ::glm::vec3(position_scale.w)
+            );
+            m_debug_draw.add_box(transform, box_colour);
+            m_debug_draw.add_point(position, point_colour);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "vk_tut/deletion_queue.h"
+
+namespace vk::tut {
+    void DeletionQueue::enqueue(
+        const uint64_t& retire_value,
+        ::std::function<void()>&& destroy
+    ) {
+        // Keep the entries sorted. Destroying later than
+        // requested is always safe.
+        uint64_t value = retire_value;
+        if (!m_entries.empty() && m_entries.back().first > value) {
+            value = m_entries.back().first;
+        }
+
+        m_entries.emplace_back(value, ::std::move(destroy));
+    }
+
+    void DeletionQueue::flush(const uint64_t& completed_value) {
+        while (!m_entries.empty() &&
+        m_entries.front().first <= completed_value) {
+            // Pop before running in case the destroy enqueues more.
+            ::std::function<void()> destroy = ::std::move(
+                m_entries.front().second
+            );
+            m_entries.pop_front();
+            destroy();
+        }
+    }
+
+    void DeletionQueue::flush_all() {
+        while (!m_entries.empty()) {
+            ::std::function<void()> destroy = ::std::move(
+                m_entries.front().second
+            );
+            m_entries.pop_front();
+            destroy();
+        }
+    }
+}
\ No newline at end of file
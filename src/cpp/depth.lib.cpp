@@ -0,0 +1,29 @@
+#include "vk_tut/application.h"
+#include "vk_tut/logging.h"
+
+namespace vk::tut {
+    VkFormat find_depth_format(const VkPhysicalDevice& physical_device) {
+        // Reverse-Z only pays off with a floating point depth format.
+        // The fixed point format is a last resort.
+        const VkFormat candidates[] = {
+            VkFormat::VK_FORMAT_D32_SFLOAT,
+            VkFormat::VK_FORMAT_D32_SFLOAT_S8_UINT,
+            VkFormat::VK_FORMAT_X8_D24_UNORM_PACK32
+        };
+
+        for (const VkFormat& format : candidates) {
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(
+                physical_device, format, &properties
+            );
+
+            if (properties.optimalTilingFeatures &
+            VkFormatFeatureFlagBits
+                ::VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+                return format;
+            }
+        }
+
+        VK_TUT_LOG_ERROR("Failed to find a supported depth format.");
+    }
+}
\ No newline at end of file
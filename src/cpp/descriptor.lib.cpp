@@ -1,40 +1,56 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 #include "vk_tut/uniform.h"
+#include "vk_tut/push_constant.h"
+#include "vk_tut/descriptor_set_contents.h"
 
 #include <array>
+#include <string>
 
 namespace vk::tut {
     void Application::create_descriptor_set_layout() {
+        VK_TUT_TRACE_SCOPE("create_descriptor_set_layout");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
-        // Descriptor set binding for the uniform object.
-        VkDescriptorSetLayoutBinding uniform_layout_binding{};
-        uniform_layout_binding.binding = 0;
-        uniform_layout_binding.descriptorType = VkDescriptorType
-            ::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        uniform_layout_binding.descriptorCount = 1;
-        uniform_layout_binding.stageFlags = VkShaderStageFlagBits
-            ::VK_SHADER_STAGE_VERTEX_BIT;
-        
-        // Descriptor set for the texture.
-        VkDescriptorSetLayoutBinding texture_layout_binding{};
-        texture_layout_binding.binding = 1;
-        texture_layout_binding.descriptorCount = 1;
-        texture_layout_binding.descriptorType = VkDescriptorType
-            ::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        texture_layout_binding.stageFlags = VkShaderStageFlagBits
-            ::VK_SHADER_STAGE_FRAGMENT_BIT;
-
-        ::std::array<VkDescriptorSetLayoutBinding, 2> bindings = {
-            uniform_layout_binding, texture_layout_binding
-        };
+        ::std::vector<VkDescriptorSetLayoutBinding> bindings =
+            DescriptorSetContents::get_layout_bindings();
+
+        // The texture table does not need every slot to be populated,
+        // and is rewritten while the cached command buffers bind the set.
+        ::std::vector<VkDescriptorBindingFlags> binding_flags(
+            bindings.size(), 0
+        );
+        for (size_t i = 0; i < bindings.size(); i++) {
+            if (bindings[i].binding !=
+            DescriptorSetContents::TEXTURE_TABLE_BINDING) {
+                continue;
+            }
+            binding_flags[i] = VkDescriptorBindingFlagBits
+                ::VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                VkDescriptorBindingFlagBits
+                ::VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                VkDescriptorBindingFlagBits
+                ::VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        }
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info{};
+        binding_flags_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        binding_flags_info.bindingCount = static_cast<uint32_t>(
+            binding_flags.size()
+        );
+        binding_flags_info.pBindingFlags = binding_flags.data();
 
         // Information about the descriptor set layout.
         VkDescriptorSetLayoutCreateInfo descriptor_set_layout_info{};
         descriptor_set_layout_info.sType = VkStructureType
             ::VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        descriptor_set_layout_info.pNext = &binding_flags_info;
+        descriptor_set_layout_info.flags = VkDescriptorSetLayoutCreateFlagBits
+            ::VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
         descriptor_set_layout_info.bindingCount = static_cast<uint32_t>(
             bindings.size()
         );
@@ -43,7 +59,8 @@ namespace vk::tut {
         // Create the descriptor set layout.
         result = vkCreateDescriptorSetLayout(
             m_logical_device, &descriptor_set_layout_info,
-            nullptr, &m_descriptor_set_layout
+            get_allocation_callbacks(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT),
+            &m_descriptor_set_layout
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -54,81 +71,113 @@ namespace vk::tut {
         VK_TUT_LOG_DEBUG("Successfully created descriptor set layout.");
     }
 
-    void Application::create_descriptor_pool() {
+    void Application::create_descriptor_update_template() {
+        VK_TUT_TRACE_SCOPE("create_descriptor_update_template");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
-        ::std::array<VkDescriptorPoolSize, 2> descriptor_pool_sizes;
-
-        descriptor_pool_sizes[0].type = VkDescriptorType
-            ::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptor_pool_sizes[0].descriptorCount = static_cast<uint32_t>(
-            m_swapchain_frame_buffers.size()
-        );
+        // Both templates are generated from the bindings of the layout.
+        ::std::vector<VkDescriptorSetLayoutBinding> bindings =
+            DescriptorSetContents::get_layout_bindings();
+        ::std::array<::std::vector<VkDescriptorUpdateTemplateEntry>, 2>
+        template_entries = {
+            DescriptorSetContents::get_update_template_entries(bindings),
+            DescriptorSetContents::get_texture_table_template_entries(
+                bindings
+            )
+        };
+        ::std::array<VkDescriptorUpdateTemplate*, 2> ptr_templates = {
+            &m_descriptor_update_template, &m_texture_table_update_template
+        };
 
-        descriptor_pool_sizes[1].type = VkDescriptorType
-            ::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptor_pool_sizes[1].descriptorCount = static_cast<uint32_t>(
-            m_swapchain_frame_buffers.size()
-        );
+        for (size_t i = 0; i < template_entries.size(); i++) {
+            // Information about the descriptor update template.
+            VkDescriptorUpdateTemplateCreateInfo update_template_info{};
+            update_template_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+            update_template_info.descriptorUpdateEntryCount =
+                static_cast<uint32_t>(template_entries[i].size());
+            update_template_info.pDescriptorUpdateEntries =
+                template_entries[i].data();
+            update_template_info.templateType = VkDescriptorUpdateTemplateType
+                ::VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+            update_template_info.descriptorSetLayout = m_descriptor_set_layout;
 
-        VkDescriptorPoolCreateInfo descriptor_pool_info{};
-        descriptor_pool_info.sType = VkStructureType
-            ::VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        descriptor_pool_info.poolSizeCount = static_cast<uint32_t>(
-            descriptor_pool_sizes.size()
-        );
-        descriptor_pool_info.pPoolSizes = descriptor_pool_sizes.data();
-        descriptor_pool_info.maxSets = static_cast<uint32_t>(
-            m_swapchain_frame_buffers.size()
-        );
-        
-        result = vkCreateDescriptorPool(
-            m_logical_device, &descriptor_pool_info,
-            nullptr, &m_descriptor_pool
-        );
-        if(result != VkResult::VK_SUCCESS) {
-            VK_TUT_LOG_ERROR(
-                "Failed to create descriptor pool."
+            result = vkCreateDescriptorUpdateTemplate(
+                m_logical_device, &update_template_info,
+                get_allocation_callbacks(
+                    VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE
+                ),
+                ptr_templates[i]
             );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR(
+                    "Failed to create descriptor update template."
+                );
+            }
         }
-        
-        VK_TUT_LOG_DEBUG("Successfully created descriptor pool.");
+
+        VK_TUT_LOG_DEBUG("Successfully created descriptor update templates.");
     }
 
-    void Application::create_descriptor_sets() {
-        // The variable that stores the result of any vulkan function called.
-        VkResult result;
+    void Application::create_descriptor_allocators() {
+        VK_TUT_TRACE_SCOPE("create_descriptor_allocators");
 
-        // Create the same number of descriptor sets as the frame buffers.
-        m_descriptor_sets.reserve(m_swapchain_frame_buffers.size());
+        // The descriptors used by one set of the main descriptor set layout.
+        ::std::vector<VkDescriptorPoolSize> set_pool_sizes = {
+            {VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1},
+            {VkDescriptorType::VK_DESCRIPTOR_TYPE_SAMPLER, 1},
+            {
+                VkDescriptorType::VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                MAX_BINDLESS_TEXTURES
+            }
+        };
 
-        for (int i = 0; i < m_descriptor_sets.capacity(); i++) {
-            // Information about the descriptor set to be allocated.
-            VkDescriptorSetAllocateInfo descriptor_set_alloc_info{};
-            descriptor_set_alloc_info.sType = VkStructureType
-                ::VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            descriptor_set_alloc_info.descriptorPool = m_descriptor_pool;
-            descriptor_set_alloc_info.descriptorSetCount = 1;
-            descriptor_set_alloc_info.pSetLayouts = &m_descriptor_set_layout;
+        // Long lived sets. The pools are required to be update after bind
+        // by the texture table binding.
+        m_descriptor_allocator.create(
+            m_logical_device, set_pool_sizes,
+            static_cast<uint32_t>(m_swapchain_frame_buffers.size()),
+            VkDescriptorPoolCreateFlagBits
+                ::VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT
+        );
 
-            // Descriptor set to be allocated.
-            VkDescriptorSet descriptor_set;
+        // The descriptors expected of one transient set. The ratios are
+        // only a sizing hint since the pools grow as needed.
+        ::std::vector<VkDescriptorPoolSize> transient_set_pool_sizes = {
+            {VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+            {VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2},
+            {VkDescriptorType::VK_DESCRIPTOR_TYPE_SAMPLER, 1},
+            {VkDescriptorType::VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4},
+            {VkDescriptorType::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4}
+        };
 
-            result = vkAllocateDescriptorSets(
-                m_logical_device, &descriptor_set_alloc_info, &descriptor_set
+        // One transient allocator per frame in flight, reset
+        // as a whole once the frame using it has finished.
+        m_frame_descriptor_allocators.resize(m_swapchain_frame_buffers.size());
+        for (DescriptorAllocator& allocator : m_frame_descriptor_allocators) {
+            allocator.create(
+                m_logical_device, transient_set_pool_sizes, 64, 0
             );
-            if(result != VkResult::VK_SUCCESS) {
-                VK_TUT_LOG_ERROR(
-                    "Failed to allocate descriptor set."
-                );
-            }
-
-            m_descriptor_sets.emplace_back(::std::move(descriptor_set));
         }
 
-        // Populate descriptor sets with data.
-        for (int i = 0; i < m_descriptor_sets.size(); i++) {
+        VK_TUT_LOG_DEBUG("Successfully created descriptor allocators.");
+    }
+
+    void Application::create_descriptor_sets() {
+        VK_TUT_TRACE_SCOPE("create_descriptor_sets");
+
+        // One set per frame buffer, all allocated in a single call.
+        ::std::vector<VkDescriptorSetLayout> layouts(
+            m_swapchain_frame_buffers.size(), m_descriptor_set_layout
+        );
+        m_descriptor_allocator.allocate(layouts, m_descriptor_sets);
+
+        // The uniform buffer and sampler written to each set.
+        ::std::vector<DescriptorSetContents> contents;
+        contents.reserve(m_descriptor_sets.size());
+        for (size_t i = 0; i < m_descriptor_sets.size(); i++) {
             // Provides handle to the corresponding uniform buffer.
             VkDescriptorBufferInfo uniform_buffer_info{};
             uniform_buffer_info.offset = 0;
@@ -137,59 +186,119 @@ namespace vk::tut {
                 sizeof(Uniform)
             );
 
-            VkDescriptorImageInfo image_info{};
-            image_info.imageLayout = VkImageLayout
+            VkDescriptorImageInfo sampler_info{};
+            sampler_info.sampler = m_texture_sampler;
+
+            contents.emplace_back(uniform_buffer_info, sampler_info);
+        }
+        write_descriptor_sets(m_descriptor_sets, contents);
+
+        // Populate the texture tables with the textures
+        // registered before the descriptor sets existed.
+        write_texture_tables();
+
+        VK_TUT_LOG_DEBUG("Successfully created and allocated descriptor sets.");
+    }
+
+    uint32_t Application::register_bindless_texture(
+        const VkImageView& image_view
+    ) {
+        if (m_bindless_texture_views.size() >= MAX_BINDLESS_TEXTURES) {
+            VK_TUT_LOG_ERROR("The bindless texture table is full.");
+        }
+
+        // The slot of the texture in the table.
+        uint32_t texture_index = static_cast<uint32_t>(
+            m_bindless_texture_views.size()
+        );
+        m_bindless_texture_views.emplace_back(image_view);
+        write_bindless_texture(texture_index, image_view);
+
+        VK_TUT_LOG_DEBUG("Registered texture in bindless texture slot " +
+            ::std::to_string(texture_index) + ".");
+
+        return texture_index;
+    }
+
+    void Application::write_bindless_texture(
+        const uint32_t& texture_index, const VkImageView& image_view
+    ) {
+        m_bindless_texture_views[texture_index] = image_view;
+    }
+
+    void Application::write_texture_tables() {
+        if (m_descriptor_sets.empty() || m_bindless_texture_views.empty()) {
+            return;
+        }
+
+        // Every slot is written, so the ones not registered
+        // repeat the texture image registered first.
+        ::std::vector<VkDescriptorImageInfo> texture_infos(
+            MAX_BINDLESS_TEXTURES
+        );
+        for (size_t i = 0; i < texture_infos.size(); i++) {
+            texture_infos[i].imageLayout = VkImageLayout
                 ::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            image_info.imageView = m_texture_image_view;
-            image_info.sampler = m_texture_sampler;
-
-            ::std::array<VkWriteDescriptorSet, 2> descriptor_writes;
-
-            // Descriptor write for the uniform buffer.
-            descriptor_writes[0].sType = VkStructureType
-                ::VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptor_writes[0].dstSet = m_descriptor_sets[i];
-            descriptor_writes[0].dstBinding = 0;
-            descriptor_writes[0].dstArrayElement = 0;
-            descriptor_writes[0].descriptorType = VkDescriptorType
-                ::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptor_writes[0].descriptorCount = 1;
-            descriptor_writes[0].pBufferInfo = &uniform_buffer_info;
-            descriptor_writes[0].pNext = nullptr;
-
-            // Descriptor write for the texture.
-            descriptor_writes[1].sType = VkStructureType
-                ::VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptor_writes[1].dstSet = m_descriptor_sets[i];
-            descriptor_writes[1].dstBinding = 1;
-            descriptor_writes[1].dstArrayElement = 0;
-            descriptor_writes[1].descriptorType = VkDescriptorType
-                ::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            descriptor_writes[1].descriptorCount = 1;
-            descriptor_writes[1].pImageInfo = &image_info;
-            descriptor_writes[1].pNext = nullptr;
-
-            vkUpdateDescriptorSets(
-                m_logical_device,
-                static_cast<uint32_t>(descriptor_writes.size()),
-                descriptor_writes.data(), 0, nullptr
+            texture_infos[i].imageView = i < m_bindless_texture_views.size() ?
+                m_bindless_texture_views[i] : m_bindless_texture_views[0];
+        }
+
+        for (const VkDescriptorSet& descriptor_set : m_descriptor_sets) {
+            vkUpdateDescriptorSetWithTemplate(
+                m_logical_device, descriptor_set,
+                m_texture_table_update_template, texture_infos.data()
             );
         }
+    }
 
-        VK_TUT_LOG_DEBUG("Successfully created and allocated descriptor sets.");
+    void Application::write_descriptor_sets(
+        const ::std::vector<VkDescriptorSet>& descriptor_sets,
+        const ::std::vector<DescriptorSetContents>& contents
+    ) {
+        for (size_t i = 0; i < descriptor_sets.size(); i++) {
+            vkUpdateDescriptorSetWithTemplate(
+                m_logical_device, descriptor_sets[i],
+                m_descriptor_update_template, &contents[i]
+            );
+        }
     }
 
-    void Application::destroy_descriptor_pool() {
-        vkDestroyDescriptorPool(m_logical_device,
-            m_descriptor_pool, nullptr);
+    VkDescriptorSet Application::allocate_frame_descriptor_set(
+        const VkDescriptorSetLayout& layout
+    ) {
+        return m_frame_descriptor_allocators[m_current_frame_index]
+            .allocate(layout);
+    }
+
+    void Application::destroy_descriptor_allocators() {
+        for (DescriptorAllocator& allocator : m_frame_descriptor_allocators) {
+            allocator.destroy();
+        }
+        m_frame_descriptor_allocators.clear();
+
+        m_descriptor_allocator.destroy();
         m_descriptor_sets.clear();
 
-        VK_TUT_LOG_DEBUG("Destroyed descriptor pool.");
+        VK_TUT_LOG_DEBUG("Destroyed descriptor allocators.");
+    }
+
+    void Application::destroy_descriptor_update_template() {
+        vkDestroyDescriptorUpdateTemplate(m_logical_device,
+            m_texture_table_update_template,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE)
+        );
+        vkDestroyDescriptorUpdateTemplate(m_logical_device,
+            m_descriptor_update_template,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE)
+        );
+
+        VK_TUT_LOG_DEBUG("Destroyed descriptor update templates.");
     }
 
     void Application::destroy_descriptor_set_layout() {
         vkDestroyDescriptorSetLayout(m_logical_device,
-            m_descriptor_set_layout, nullptr);
+            m_descriptor_set_layout,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT));
 
         VK_TUT_LOG_DEBUG("Destroyed descriptor set layout.");
     }
@@ -0,0 +1,172 @@
+#include "vk_tut/descriptor_allocator.h"
+#include "vk_tut/host_allocator.h"
+#include "vk_tut/logging.h"
+
+#include <algorithm>
+
+namespace vk::tut {
+    // The upper bound of the growth of m_sets_per_pool.
+    static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+    void DescriptorAllocator::create(
+        const VkDevice& logical_device,
+        const ::std::vector<VkDescriptorPoolSize>& set_pool_sizes,
+        const uint32_t& initial_sets_per_pool,
+        const VkDescriptorPoolCreateFlags& pool_flags
+    ) {
+        m_logical_device = logical_device;
+        m_set_pool_sizes = set_pool_sizes;
+        m_sets_per_pool = ::std::max(initial_sets_per_pool, 1U);
+        m_pool_flags = pool_flags;
+    }
+
+    void DescriptorAllocator::destroy() {
+        reset();
+
+        for (const Pool& pool : m_ready_pools) {
+            vkDestroyDescriptorPool(m_logical_device, pool.handle,
+                get_allocation_callbacks(VK_OBJECT_TYPE_DESCRIPTOR_POOL));
+        }
+        m_ready_pools.clear();
+    }
+
+    void DescriptorAllocator::allocate(
+        const ::std::vector<VkDescriptorSetLayout>& layouts,
+        ::std::vector<VkDescriptorSet>& ref_descriptor_sets
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        if (layouts.empty()) return;
+
+        const uint32_t set_count = static_cast<uint32_t>(layouts.size());
+        const size_t first_set = ref_descriptor_sets.size();
+        ref_descriptor_sets.resize(first_set + layouts.size());
+
+        if (m_current_pool.handle == VK_NULL_HANDLE) next_pool(set_count);
+
+        // Information about the descriptor sets to be allocated.
+        VkDescriptorSetAllocateInfo descriptor_set_alloc_info{};
+        descriptor_set_alloc_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        descriptor_set_alloc_info.descriptorPool = m_current_pool.handle;
+        descriptor_set_alloc_info.descriptorSetCount = set_count;
+        descriptor_set_alloc_info.pSetLayouts = layouts.data();
+
+        result = vkAllocateDescriptorSets(
+            m_logical_device, &descriptor_set_alloc_info,
+            ref_descriptor_sets.data() + first_set
+        );
+
+        // The current pool is used up. Retry once with a pool that can
+        // hold the whole batch.
+        if (result == VkResult::VK_ERROR_OUT_OF_POOL_MEMORY ||
+        result == VkResult::VK_ERROR_FRAGMENTED_POOL) {
+            next_pool(set_count);
+            descriptor_set_alloc_info.descriptorPool = m_current_pool.handle;
+
+            result = vkAllocateDescriptorSets(
+                m_logical_device, &descriptor_set_alloc_info,
+                ref_descriptor_sets.data() + first_set
+            );
+        }
+        if (result != VkResult::VK_SUCCESS) {
+            ref_descriptor_sets.resize(first_set);
+            VK_TUT_LOG_ERROR("Failed to allocate descriptor sets.");
+        }
+    }
+
+    VkDescriptorSet DescriptorAllocator::allocate(
+        const VkDescriptorSetLayout& layout
+    ) {
+        ::std::vector<VkDescriptorSet> descriptor_sets;
+        allocate({layout}, descriptor_sets);
+
+        return descriptor_sets[0];
+    }
+
+    void DescriptorAllocator::reset() {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        if (m_current_pool.handle != VK_NULL_HANDLE) {
+            m_full_pools.emplace_back(m_current_pool);
+            m_current_pool = Pool();
+        }
+
+        for (const Pool& pool : m_full_pools) {
+            result = vkResetDescriptorPool(m_logical_device, pool.handle, 0);
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to reset descriptor pool.");
+            }
+            m_ready_pools.emplace_back(pool);
+        }
+        m_full_pools.clear();
+    }
+
+    DescriptorAllocator::Pool DescriptorAllocator::create_pool(
+        const uint32_t& max_sets
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        // Scale the per set descriptor counts to the size of the pool.
+        ::std::vector<VkDescriptorPoolSize> descriptor_pool_sizes(
+            m_set_pool_sizes
+        );
+        for (VkDescriptorPoolSize& pool_size : descriptor_pool_sizes) {
+            pool_size.descriptorCount *= max_sets;
+        }
+
+        VkDescriptorPoolCreateInfo descriptor_pool_info{};
+        descriptor_pool_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        descriptor_pool_info.flags = m_pool_flags;
+        descriptor_pool_info.poolSizeCount = static_cast<uint32_t>(
+            descriptor_pool_sizes.size()
+        );
+        descriptor_pool_info.pPoolSizes = descriptor_pool_sizes.data();
+        descriptor_pool_info.maxSets = max_sets;
+
+        // The pool to be created.
+        Pool pool;
+        pool.max_sets = max_sets;
+
+        result = vkCreateDescriptorPool(
+            m_logical_device, &descriptor_pool_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DESCRIPTOR_POOL),
+            &pool.handle
+        );
+        if (result != VkResult::VK_SUCCESS) {
+            VK_TUT_LOG_ERROR("Failed to create descriptor pool.");
+        }
+
+        VK_TUT_LOG_DEBUG("Created descriptor pool for " +
+            ::std::to_string(max_sets) + " sets.");
+
+        return pool;
+    }
+
+    void DescriptorAllocator::next_pool(const uint32_t& min_sets) {
+        if (m_current_pool.handle != VK_NULL_HANDLE) {
+            m_full_pools.emplace_back(m_current_pool);
+            m_current_pool = Pool();
+        }
+
+        // Reuse a reset pool with room for the request when possible,
+        // the most recently reset first.
+        for (size_t i = m_ready_pools.size(); i > 0; i--) {
+            if (m_ready_pools[i - 1].max_sets < min_sets) continue;
+
+            m_current_pool = m_ready_pools[i - 1];
+            m_ready_pools[i - 1] = m_ready_pools.back();
+            m_ready_pools.pop_back();
+            return;
+        }
+
+        m_current_pool = create_pool(::std::max(m_sets_per_pool, min_sets));
+        m_sets_per_pool = ::std::min(
+            m_sets_per_pool + m_sets_per_pool / 2 + 1, MAX_SETS_PER_POOL
+        );
+    }
+}
\ No newline at end of file
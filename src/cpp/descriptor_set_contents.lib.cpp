@@ -0,0 +1,165 @@
+#include "vk_tut/descriptor_set_contents.h"
+#include "vk_tut/push_constant.h"
+
+#include <cstddef>
+#include <utility>
+
+namespace vk::tut {
+    // Copy initializer list constructor.
+    DescriptorSetContents::DescriptorSetContents(
+        const VkDescriptorBufferInfo& uniform_buffer_info,
+        const VkDescriptorImageInfo& sampler_info
+    ) : m_uniform_buffer_info(uniform_buffer_info),
+    m_sampler_info(sampler_info) {}
+
+    // Copy constructor.
+    DescriptorSetContents::DescriptorSetContents(
+        const DescriptorSetContents& from
+    ) : m_uniform_buffer_info(from.m_uniform_buffer_info),
+    m_sampler_info(from.m_sampler_info) {}
+
+    // Move constructor.
+    DescriptorSetContents::DescriptorSetContents(
+        DescriptorSetContents&& from
+    ) : m_uniform_buffer_info(::std::move(from.m_uniform_buffer_info)),
+    m_sampler_info(::std::move(from.m_sampler_info)) {}
+
+    // Copy re-assignment.
+    DescriptorSetContents& DescriptorSetContents::operator= (
+        const DescriptorSetContents& from
+    ) {
+        m_uniform_buffer_info = from.m_uniform_buffer_info;
+        m_sampler_info = from.m_sampler_info;
+
+        return *this;
+    }
+
+    // Move re-assignment.
+    DescriptorSetContents& DescriptorSetContents::operator= (
+        DescriptorSetContents&& from
+    ) {
+        m_uniform_buffer_info = ::std::move(from.m_uniform_buffer_info);
+        m_sampler_info = ::std::move(from.m_sampler_info);
+
+        return *this;
+    }
+
+    bool DescriptorSetContents::operator== (
+        const DescriptorSetContents& other
+    ) const {
+        return m_uniform_buffer_info.buffer ==
+            other.m_uniform_buffer_info.buffer &&
+            m_uniform_buffer_info.offset ==
+            other.m_uniform_buffer_info.offset &&
+            m_uniform_buffer_info.range ==
+            other.m_uniform_buffer_info.range &&
+            m_sampler_info.sampler == other.m_sampler_info.sampler &&
+            m_sampler_info.imageView == other.m_sampler_info.imageView &&
+            m_sampler_info.imageLayout == other.m_sampler_info.imageLayout;
+    }
+
+    // Copy setter for m_uniform_buffer_info.
+    void DescriptorSetContents::set_uniform_buffer_info(
+        const VkDescriptorBufferInfo& uniform_buffer_info
+    ) {
+        m_uniform_buffer_info = uniform_buffer_info;
+    }
+
+    // Copy setter for m_sampler_info.
+    void DescriptorSetContents::set_sampler_info(
+        const VkDescriptorImageInfo& sampler_info
+    ) {
+        m_sampler_info = sampler_info;
+    }
+
+    ::std::vector<VkDescriptorSetLayoutBinding>
+    DescriptorSetContents::get_layout_bindings() {
+        ::std::vector<VkDescriptorSetLayoutBinding> bindings(3);
+
+        // The uniform object.
+        bindings[0].binding = UNIFORM_BUFFER_BINDING;
+        bindings[0].descriptorType = VkDescriptorType
+            ::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        bindings[0].descriptorCount = 1;
+        bindings[0].stageFlags = VkShaderStageFlagBits
+            ::VK_SHADER_STAGE_VERTEX_BIT;
+
+        // The sampler shared by all textures.
+        bindings[1].binding = SAMPLER_BINDING;
+        bindings[1].descriptorType = VkDescriptorType
+            ::VK_DESCRIPTOR_TYPE_SAMPLER;
+        bindings[1].descriptorCount = 1;
+        bindings[1].stageFlags = VkShaderStageFlagBits
+            ::VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        // The bindless texture table.
+        bindings[2].binding = TEXTURE_TABLE_BINDING;
+        bindings[2].descriptorType = VkDescriptorType
+            ::VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        bindings[2].descriptorCount = MAX_BINDLESS_TEXTURES;
+        bindings[2].stageFlags = VkShaderStageFlagBits
+            ::VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        return bindings;
+    }
+
+    ::std::vector<VkDescriptorUpdateTemplateEntry>
+    DescriptorSetContents::get_update_template_entries(
+        const ::std::vector<VkDescriptorSetLayoutBinding>& bindings
+    ) {
+        ::std::vector<VkDescriptorUpdateTemplateEntry> entries;
+        entries.reserve(bindings.size());
+        for (const VkDescriptorSetLayoutBinding& binding : bindings) {
+            // Where the descriptors of the binding are in the contents.
+            size_t offset;
+            size_t stride;
+            switch (binding.binding) {
+                case UNIFORM_BUFFER_BINDING:
+                    offset = offsetof(
+                        DescriptorSetContents, m_uniform_buffer_info
+                    );
+                    stride = sizeof(VkDescriptorBufferInfo);
+                    break;
+                case SAMPLER_BINDING:
+                    offset = offsetof(DescriptorSetContents, m_sampler_info);
+                    stride = sizeof(VkDescriptorImageInfo);
+                    break;
+                default:
+                    continue;
+            }
+
+            VkDescriptorUpdateTemplateEntry entry{};
+            entry.dstBinding = binding.binding;
+            entry.dstArrayElement = 0;
+            entry.descriptorCount = binding.descriptorCount;
+            entry.descriptorType = binding.descriptorType;
+            entry.offset = offset;
+            entry.stride = stride;
+            entries.emplace_back(entry);
+        }
+
+        return entries;
+    }
+
+    ::std::vector<VkDescriptorUpdateTemplateEntry>
+    DescriptorSetContents::get_texture_table_template_entries(
+        const ::std::vector<VkDescriptorSetLayoutBinding>& bindings
+    ) {
+        ::std::vector<VkDescriptorUpdateTemplateEntry> entries;
+        for (const VkDescriptorSetLayoutBinding& binding : bindings) {
+            if (binding.binding != TEXTURE_TABLE_BINDING) continue;
+
+            // Slot i is read from the i-th element of the array.
+            VkDescriptorUpdateTemplateEntry entry{};
+            entry.dstBinding = binding.binding;
+            entry.dstArrayElement = 0;
+            entry.descriptorCount = binding.descriptorCount;
+            entry.descriptorType = binding.descriptorType;
+            entry.offset = 0;
+            entry.stride = sizeof(VkDescriptorImageInfo);
+            entries.emplace_back(entry);
+        }
+
+        return entries;
+    }
+}
\ No newline at end of file
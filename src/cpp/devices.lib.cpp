@@ -1,15 +1,29 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 #include "vk_tut/queue_family.h"
 #include "vk_tut/swapchain_support.h"
+#include "vk_tut/push_constant.h"
 
+#include <algorithm>
 #include <set>
+#include <string>
 
 namespace vk::tut {
     void Application::select_physical_device() {
+        VK_TUT_TRACE_SCOPE("select_physical_device");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
+        // Headless mode never creates a swapchain.
+        if (m_config.get_headless()) {
+            m_enabled_extensions.erase(::std::remove(
+                m_enabled_extensions.begin(), m_enabled_extensions.end(),
+                VK_KHR_SWAPCHAIN_EXTENSION_NAME
+            ), m_enabled_extensions.end());
+        }
+
         // Obtain the handles of the available physical devices.
         uint32_t available_physical_devices_count = 0;
         result = vkEnumeratePhysicalDevices(
@@ -36,23 +50,74 @@ namespace vk::tut {
             QueueFamilyIndices indices = find_family_indices(
                 physical_device, m_surface);
 
-            SwapChainSupportDetails swapchain_support_details =
-                query_swapchain_support(physical_device, m_surface);
+            // Without a surface there is no swapchain support to query.
+            bool swapchain_support_adequate = m_config.get_headless() ||
+                query_swapchain_support(physical_device, m_surface)
+                    .is_swapchain_support_adequate();
             
-            VkPhysicalDeviceFeatures supported_features;
-            vkGetPhysicalDeviceFeatures(physical_device, &supported_features);
+            // Query the core and Vulkan 1.2 features in one go.
+            VkPhysicalDeviceVulkan12Features supported_vulkan12_features{};
+            supported_vulkan12_features.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            VkPhysicalDeviceSynchronization2FeaturesKHR
+                supported_synchronization2_features{};
+            supported_synchronization2_features.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+            supported_vulkan12_features.pNext =
+                &supported_synchronization2_features;
+            VkPhysicalDeviceFeatures2 supported_features{};
+            supported_features.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            supported_features.pNext = &supported_vulkan12_features;
+            vkGetPhysicalDeviceFeatures2(physical_device, &supported_features);
+
+            // The bindless texture table must fit in the fragment stage.
+            VkPhysicalDeviceVulkan12Properties vulkan12_properties{};
+            vulkan12_properties.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+            VkPhysicalDeviceProperties2 properties{};
+            properties.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties.pNext = &vulkan12_properties;
+            vkGetPhysicalDeviceProperties2(physical_device, &properties);
+
+            bool descriptor_indexing_supported =
+                supported_vulkan12_features.descriptorBindingPartiallyBound &&
+                supported_vulkan12_features
+                    .descriptorBindingSampledImageUpdateAfterBind &&
+                supported_vulkan12_features
+                    .descriptorBindingUpdateUnusedWhilePending &&
+                vulkan12_properties
+                    .maxPerStageDescriptorUpdateAfterBindSampledImages >=
+                    MAX_BINDLESS_TEXTURES &&
+                vulkan12_properties
+                    .maxDescriptorSetUpdateAfterBindSampledImages >=
+                    MAX_BINDLESS_TEXTURES;
             
-            bool physical_device_suitable = indices.is_complete() &&
+            // A requested device, such as the software rasterizer used
+            // for reproducible benchmarks, rules out every other one.
+            const ::std::string& device_name = m_config.get_device_name();
+            bool name_matches = device_name.empty() ||
+                ::std::string(properties.properties.deviceName)
+                    .find(device_name) != ::std::string::npos;
+
+            bool physical_device_suitable = name_matches &&
+                indices.is_complete() &&
                 check_device_extension_support(physical_device,
                 m_enabled_extensions) &&
-                swapchain_support_details.is_swapchain_support_adequate() &&
-                supported_features.samplerAnisotropy;
+                swapchain_support_adequate &&
+                supported_features.features.samplerAnisotropy &&
+                supported_features.features
+                    .shaderSampledImageArrayDynamicIndexing &&
+                supported_synchronization2_features.synchronization2 &&
+                descriptor_indexing_supported;
 
             // Select the suitable device.
             if (physical_device_suitable) {
                 m_physical_device = physical_device;
                 VK_TUT_LOG_DEBUG(
-                    "Successfully found a suitable physical device."
+                    "Successfully found a suitable physical device: " <<
+                    properties.properties.deviceName
                 );
                 return;
             }
@@ -64,6 +129,8 @@ namespace vk::tut {
     }
 
     void Application::create_logical_device() {
+        VK_TUT_TRACE_SCOPE("create_logical_device");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -94,9 +161,60 @@ namespace vk::tut {
             device_queue_infos.emplace_back(device_queue_info);
         }
 
+        // Descriptor indexing features used by the bindless texture table.
+        VkPhysicalDeviceVulkan12Features enabled_vulkan12_features{};
+        enabled_vulkan12_features.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        enabled_vulkan12_features.descriptorBindingPartiallyBound = VK_TRUE;
+        enabled_vulkan12_features
+            .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        enabled_vulkan12_features
+            .descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+
+        // Batched barriers are recorded with vkCmdPipelineBarrier2KHR.
+        VkPhysicalDeviceSynchronization2FeaturesKHR
+            enabled_synchronization2_features{};
+        enabled_synchronization2_features.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+        enabled_synchronization2_features.synchronization2 = VK_TRUE;
+        enabled_vulkan12_features.pNext = &enabled_synchronization2_features;
+
         // Information about the device features to be enabled.
-        VkPhysicalDeviceFeatures enabled_device_features{};
-        enabled_device_features.samplerAnisotropy = VK_TRUE;
+        VkPhysicalDeviceFeatures2 enabled_device_features{};
+        enabled_device_features.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        enabled_device_features.pNext = &enabled_vulkan12_features;
+        enabled_device_features.features.samplerAnisotropy = VK_TRUE;
+        // Textures are indexed with a push constant.
+        enabled_device_features.features
+            .shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+
+        // The pipeline statistics query of the main pass stays active
+        // while its secondary command buffers execute.
+        if (m_config.get_pipeline_statistics()) {
+            VkPhysicalDeviceFeatures supported_features;
+            vkGetPhysicalDeviceFeatures(
+                m_physical_device, &supported_features
+            );
+            m_pipeline_statistics_supported =
+                supported_features.pipelineStatisticsQuery &&
+                supported_features.inheritedQueries;
+            if (!m_pipeline_statistics_supported) {
+                VK_TUT_LOG_DEBUG("Pipeline statistics queries are not "
+                    "supported. Pipeline statistics are disabled.");
+            }
+        }
+        enabled_device_features.features.pipelineStatisticsQuery =
+            m_pipeline_statistics_supported ? VK_TRUE : VK_FALSE;
+        enabled_device_features.features.inheritedQueries =
+            m_pipeline_statistics_supported ? VK_TRUE : VK_FALSE;
+
+        // Debug points are drawn larger than a pixel, if supported.
+        VkPhysicalDeviceFeatures supported_features;
+        vkGetPhysicalDeviceFeatures(m_physical_device, &supported_features);
+        m_large_points_supported = supported_features.largePoints;
+        enabled_device_features.features.largePoints =
+            m_large_points_supported ? VK_TRUE : VK_FALSE;
 
         // Information about the logical device.
         VkDeviceCreateInfo logical_device_info{};
@@ -106,7 +224,9 @@ namespace vk::tut {
             static_cast<uint32_t>(device_queue_infos.size());
         logical_device_info.pQueueCreateInfos =
             device_queue_infos.data();
-        logical_device_info.pEnabledFeatures = &enabled_device_features;
+        // Features are chained through pNext instead of pEnabledFeatures.
+        logical_device_info.pNext = &enabled_device_features;
+        logical_device_info.pEnabledFeatures = nullptr;
         logical_device_info.enabledExtensionCount =
             static_cast<uint32_t>(m_enabled_extensions.size());
         logical_device_info.ppEnabledExtensionNames =
@@ -120,7 +240,8 @@ namespace vk::tut {
         
         // Create the logical device.
         result = vkCreateDevice(
-            m_physical_device, &logical_device_info, nullptr, &m_logical_device
+            m_physical_device, &logical_device_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE), &m_logical_device
         );
         if(result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -139,11 +260,20 @@ namespace vk::tut {
             0, &m_graphics_queue
         );
 
+        // vkCmdPipelineBarrier2KHR is an extension function.
+        // Therefore, it needed to be looked up using vkGetDeviceProcAddr
+        m_vk_cmd_pipeline_barrier2 = (PFN_vkCmdPipelineBarrier2KHR)
+            vkGetDeviceProcAddr(m_logical_device, "vkCmdPipelineBarrier2KHR");
+        if (m_vk_cmd_pipeline_barrier2 == nullptr) {
+            VK_TUT_LOG_ERROR("Failed to load vkCmdPipelineBarrier2KHR.");
+        }
+
         VK_TUT_LOG_DEBUG("Successfully created a logical device.");
     }
 
     void Application::destroy_logical_device() {
-        vkDestroyDevice(m_logical_device, nullptr);
+        vkDestroyDevice(m_logical_device,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE));
 
         VK_TUT_LOG_DEBUG("Destroyed logical device.");
     }
@@ -0,0 +1,58 @@
+#include "vk_tut/draw_command.h"
+
+#include <utility>
+
+namespace vk::tut {
+    // Copy initializer list constructor.
+    DrawCommand::DrawCommand(
+        const uint32_t& index_count,
+        const uint32_t& first_index,
+        const int32_t& vertex_offset,
+        const uint32_t& texture_index,
+        const uint32_t& instance_count,
+        const uint32_t& first_instance
+    ) : m_index_count(index_count), m_first_index(first_index),
+    m_vertex_offset(vertex_offset), m_texture_index(texture_index),
+    m_instance_count(instance_count), m_first_instance(first_instance) {}
+
+    // Copy constructor.
+    DrawCommand::DrawCommand(const DrawCommand& from) :
+    m_index_count(from.m_index_count), m_first_index(from.m_first_index),
+    m_vertex_offset(from.m_vertex_offset),
+    m_texture_index(from.m_texture_index),
+    m_instance_count(from.m_instance_count),
+    m_first_instance(from.m_first_instance) {}
+
+    // Move constructor.
+    DrawCommand::DrawCommand(DrawCommand&& from) :
+    m_index_count(::std::move(from.m_index_count)),
+    m_first_index(::std::move(from.m_first_index)),
+    m_vertex_offset(::std::move(from.m_vertex_offset)),
+    m_texture_index(::std::move(from.m_texture_index)),
+    m_instance_count(::std::move(from.m_instance_count)),
+    m_first_instance(::std::move(from.m_first_instance)) {}
+
+    // Copy re-assignment.
+    DrawCommand& DrawCommand::operator= (const DrawCommand& from) {
+        m_index_count = from.m_index_count;
+        m_first_index = from.m_first_index;
+        m_vertex_offset = from.m_vertex_offset;
+        m_texture_index = from.m_texture_index;
+        m_instance_count = from.m_instance_count;
+        m_first_instance = from.m_first_instance;
+
+        return *this;
+    }
+
+    // Move re-assignment.
+    DrawCommand& DrawCommand::operator= (DrawCommand&& from) {
+        m_index_count = ::std::move(from.m_index_count);
+        m_first_index = ::std::move(from.m_first_index);
+        m_vertex_offset = ::std::move(from.m_vertex_offset);
+        m_texture_index = ::std::move(from.m_texture_index);
+        m_instance_count = ::std::move(from.m_instance_count);
+        m_first_instance = ::std::move(from.m_first_instance);
+
+        return *this;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "vk_tut/frame_arena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace vk::tut {
+    // Creates an arena with a block of initial_size bytes.
+    FrameArena::FrameArena(const size_t& initial_size) {
+        add_block(::std::max<size_t>(initial_size, 1));
+    }
+
+    // Frees the blocks.
+    FrameArena::~FrameArena() {
+        free_blocks();
+    }
+
+    void FrameArena::reset() {
+        // Merge the blocks of a frame that overflowed, so that a frame
+        // as large fits in the first block from now on.
+        if (m_blocks.size() > 1) {
+            const size_t capacity = get_capacity();
+            free_blocks();
+            add_block(capacity);
+        }
+
+        m_offset = 0;
+        m_used_bytes = 0;
+    }
+
+    size_t FrameArena::get_capacity() const {
+        size_t capacity = 0;
+        for (const Block& block : m_blocks) {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+        const Block& block = m_blocks.back();
+        const uintptr_t address =
+            reinterpret_cast<uintptr_t>(block.ptr_data) + m_offset;
+        size_t padding = (alignment - address % alignment) % alignment;
+
+        if (m_offset + padding + bytes > block.size) {
+            // Twice the last block, or enough for the allocation.
+            add_block(::std::max(block.size * 2, bytes + alignment));
+            const uintptr_t new_address =
+                reinterpret_cast<uintptr_t>(m_blocks.back().ptr_data);
+            padding = (alignment - new_address % alignment) % alignment;
+        }
+
+        void* ptr = m_blocks.back().ptr_data + m_offset + padding;
+        m_offset += padding + bytes;
+        m_used_bytes += padding + bytes;
+        m_peak_bytes = ::std::max(m_peak_bytes, m_used_bytes);
+        return ptr;
+    }
+
+    void FrameArena::add_block(const size_t& size) {
+        Block block;
+        block.ptr_data = static_cast<unsigned char*>(::operator new(size));
+        block.size = size;
+        m_blocks.emplace_back(block);
+        m_offset = 0;
+    }
+
+    void FrameArena::free_blocks() {
+        for (const Block& block : m_blocks) {
+            ::operator delete(block.ptr_data);
+        }
+        m_blocks.clear();
+    }
+}
\ No newline at end of file
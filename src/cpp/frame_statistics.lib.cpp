@@ -0,0 +1,293 @@
+#include "vk_tut/frame_statistics.h"
+#include "vk_tut/logging.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace vk::tut {
+    // The largest value a histogram tells apart from larger ones.
+    static const uint64_t MAX_TRACKED_VALUE =
+        LatencyHistogram::get_bucket_max(LatencyHistogram::BUCKET_COUNT - 1);
+
+    // < ------------------------ LatencyHistogram ------------------------ >
+
+    void LatencyHistogram::record(const uint64_t& value) {
+        const uint64_t clamped_value = ::std::min(value, MAX_TRACKED_VALUE);
+        m_buckets[get_bucket_index(clamped_value)].fetch_add(
+            1, ::std::memory_order_relaxed
+        );
+        m_count.fetch_add(1, ::std::memory_order_relaxed);
+
+        uint64_t max = m_max.load(::std::memory_order_relaxed);
+        while (value > max && !m_max.compare_exchange_weak(
+            max, value, ::std::memory_order_relaxed
+        )) {}
+    }
+
+    void LatencyHistogram::clear() {
+        for (::std::atomic<uint64_t>& bucket : m_buckets) {
+            bucket.store(0, ::std::memory_order_relaxed);
+        }
+        m_count.store(0, ::std::memory_order_relaxed);
+        m_max.store(0, ::std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::get_percentile(const double& percentile) const {
+        const uint64_t count = get_count();
+        if (count == 0) return 0;
+
+        // The rank of the value, counting from 1.
+        const uint64_t rank = ::std::clamp<uint64_t>(
+            static_cast<uint64_t>(::std::ceil(percentile / 100.0 * count)),
+            1, count
+        );
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+            seen += m_buckets[i].load(::std::memory_order_relaxed);
+            if (seen >= rank) return ::std::min(get_bucket_max(i), get_max());
+        }
+
+        return get_max();
+    }
+
+    uint32_t LatencyHistogram::get_bucket_index(const uint64_t& value) {
+        // Keeps the top SUB_BUCKET_BITS + 1 bits of the value, and
+        // how far they were shifted.
+        const uint32_t bit_count =
+            static_cast<uint32_t>(::std::bit_width(value));
+        const uint32_t shift = bit_count > SUB_BUCKET_BITS + 1 ?
+            bit_count - (SUB_BUCKET_BITS + 1) : 0;
+
+        return static_cast<uint32_t>(
+            (shift << SUB_BUCKET_BITS) + (value >> shift)
+        );
+    }
+
+    uint64_t LatencyHistogram::get_bucket_max(const uint32_t& bucket_index) {
+        // The first buckets hold a single value each.
+        if (bucket_index < (2U << SUB_BUCKET_BITS)) return bucket_index;
+
+        const uint32_t shift = (bucket_index >> SUB_BUCKET_BITS) - 1;
+        const uint64_t mantissa = bucket_index - (shift << SUB_BUCKET_BITS);
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    // < -------------------------- FrameMetric -------------------------- >
+
+    const char* get_frame_metric_name(const FrameMetric& metric) {
+        switch (metric) {
+        case FrameMetric::CPU_FRAME_TIME:
+            return "cpu_frame_time_us";
+        case FrameMetric::GPU_FRAME_TIME:
+            return "gpu_frame_time_us";
+        case FrameMetric::FENCE_WAIT_TIME:
+            return "fence_wait_time_us";
+        case FrameMetric::ACQUIRE_TIME:
+            return "acquire_time_us";
+        case FrameMetric::RECORD_TIME:
+            return "record_time_us";
+        case FrameMetric::UNIFORM_UPDATE_TIME:
+            return "uniform_update_time_us";
+        case FrameMetric::INSTANCE_UPDATE_TIME:
+            return "instance_update_time_us";
+        case FrameMetric::SUBMIT_TIME:
+            return "submit_time_us";
+        case FrameMetric::PRESENT_TIME:
+            return "present_time_us";
+        case FrameMetric::INPUT_ASSEMBLY_VERTICES:
+            return "input_assembly_vertices";
+        case FrameMetric::INPUT_ASSEMBLY_PRIMITIVES:
+            return "input_assembly_primitives";
+        case FrameMetric::VERTEX_SHADER_INVOCATIONS:
+            return "vertex_shader_invocations";
+        case FrameMetric::CLIPPING_INVOCATIONS:
+            return "clipping_invocations";
+        case FrameMetric::CLIPPING_PRIMITIVES:
+            return "clipping_primitives";
+        case FrameMetric::FRAGMENT_SHADER_INVOCATIONS:
+            return "fragment_shader_invocations";
+        case FrameMetric::RENDER_TARGET_SAMPLES:
+            return "render_target_samples";
+        case FrameMetric::FRAGMENT_OVERDRAW_PERCENT:
+            return "fragment_overdraw_percent";
+        case FrameMetric::ALLOCATION_COUNT:
+            return "allocation_count";
+        case FrameMetric::FRAME_ARENA_BYTES:
+            return "frame_arena_bytes";
+        default:
+            return "unknown";
+        }
+    }
+
+    // < ------------------------- FrameStatistics ------------------------ >
+
+    // Creates statistics whose windows span window_size frames.
+    FrameStatistics::FrameStatistics(const uint32_t& window_size) :
+    m_window_size(::std::max(window_size, 1U)) {}
+
+    void FrameStatistics::record(
+        const FrameMetric& metric, const uint64_t& value
+    ) {
+        MetricData& data = m_metrics[static_cast<size_t>(metric)];
+        const uint32_t window =
+            m_current_window.load(::std::memory_order_acquire);
+        data.windows[window].record(value);
+        data.total.record(value);
+
+        const uint64_t threshold =
+            data.hitch_threshold.load(::std::memory_order_relaxed);
+        if (threshold == 0 || value <= threshold) return;
+
+        data.window_hitch_counts[window].fetch_add(
+            1, ::std::memory_order_relaxed
+        );
+        data.total_hitch_count.fetch_add(1, ::std::memory_order_relaxed);
+
+        char line[128];
+        ::std::snprintf(line, sizeof(line),
+            "Hitch in frame %llu: %s of %llu.",
+            static_cast<unsigned long long>(get_frame_count()),
+            get_frame_metric_name(metric),
+            static_cast<unsigned long long>(value)
+        );
+        VK_TUT_LOG_DEBUG(line);
+    }
+
+    void FrameStatistics::end_frame() {
+        m_frame_count.fetch_add(1, ::std::memory_order_relaxed);
+        if (++m_window_frame_count < m_window_size) return;
+        m_window_frame_count = 0;
+
+        // The oldest window is emptied, then recorded into.
+        const uint32_t next_window =
+            1 - m_current_window.load(::std::memory_order_relaxed);
+        for (MetricData& data : m_metrics) {
+            data.windows[next_window].clear();
+            data.window_hitch_counts[next_window].store(
+                0, ::std::memory_order_relaxed
+            );
+        }
+        m_current_window.store(next_window, ::std::memory_order_release);
+        m_has_complete_window.store(true, ::std::memory_order_release);
+    }
+
+    void FrameStatistics::set_hitch_threshold(
+        const FrameMetric& metric, const uint64_t& threshold
+    ) {
+        m_metrics[static_cast<size_t>(metric)].hitch_threshold.store(
+            threshold, ::std::memory_order_relaxed
+        );
+    }
+
+    FrameStatistics::Summary FrameStatistics::get_window_summary(
+        const FrameMetric& metric
+    ) const {
+        const MetricData& data = m_metrics[static_cast<size_t>(metric)];
+        uint32_t window = m_current_window.load(::std::memory_order_acquire);
+        if (m_has_complete_window.load(::std::memory_order_acquire)) {
+            window = 1 - window;
+        }
+
+        return summarize(data.windows[window],
+            data.window_hitch_counts[window].load(::std::memory_order_relaxed)
+        );
+    }
+
+    FrameStatistics::Summary FrameStatistics::get_total_summary(
+        const FrameMetric& metric
+    ) const {
+        const MetricData& data = m_metrics[static_cast<size_t>(metric)];
+        return summarize(data.total,
+            data.total_hitch_count.load(::std::memory_order_relaxed)
+        );
+    }
+
+    void FrameStatistics::write_json(::std::ostream& stream) const {
+        auto write_summary = [&](const Summary& summary) {
+            stream << "{\"count\":" << summary.count
+                << ",\"p50\":" << summary.p50
+                << ",\"p90\":" << summary.p90
+                << ",\"p99\":" << summary.p99
+                << ",\"max\":" << summary.max
+                << ",\"hitches\":" << summary.hitch_count << "}";
+        };
+
+        stream << "{\"frame_count\":" << get_frame_count()
+            << ",\"window_size\":" << m_window_size << ",\"metrics\":{";
+        for (uint32_t i = 0; i < m_metrics.size(); i++) {
+            const FrameMetric metric = static_cast<FrameMetric>(i);
+            stream << (i == 0 ? "\n" : ",\n") << "\""
+                << get_frame_metric_name(metric) << "\":{\"window\":";
+            write_summary(get_window_summary(metric));
+            stream << ",\"total\":";
+            write_summary(get_total_summary(metric));
+            stream << "}";
+        }
+        stream << "\n}}\n";
+    }
+
+    void FrameStatistics::write_json(const ::std::string& path) const {
+        ::std::ofstream file(path);
+        if (!file.is_open()) {
+            VK_TUT_LOG_ERROR("Failed to open " + path + ".");
+        }
+
+        write_json(file);
+
+        VK_TUT_LOG_DEBUG("Wrote the frame statistics to " + path + ".");
+    }
+
+    void FrameStatistics::log_summary() const {
+        for (uint32_t i = 0; i < m_metrics.size(); i++) {
+            const FrameMetric metric = static_cast<FrameMetric>(i);
+            const Summary summary = get_total_summary(metric);
+            if (summary.count == 0) continue;
+
+            char line[160];
+            ::std::snprintf(line, sizeof(line),
+                "%-28s p50 %9llu  p90 %9llu  p99 %9llu  max %9llu  "
+                "hitches %llu", get_frame_metric_name(metric),
+                static_cast<unsigned long long>(summary.p50),
+                static_cast<unsigned long long>(summary.p90),
+                static_cast<unsigned long long>(summary.p99),
+                static_cast<unsigned long long>(summary.max),
+                static_cast<unsigned long long>(summary.hitch_count)
+            );
+            VK_TUT_LOG_DEBUG(line);
+        }
+    }
+
+    FrameStatistics::Summary FrameStatistics::summarize(
+        const LatencyHistogram& histogram, const uint64_t& hitch_count
+    ) {
+        Summary summary;
+        summary.count = histogram.get_count();
+        summary.p50 = histogram.get_percentile(50.0);
+        summary.p90 = histogram.get_percentile(90.0);
+        summary.p99 = histogram.get_percentile(99.0);
+        summary.max = histogram.get_max();
+        summary.hitch_count = hitch_count;
+        return summary;
+    }
+
+    // < ------------------------ ScopedFrameTimer ------------------------ >
+
+    // Starts timing.
+    ScopedFrameTimer::ScopedFrameTimer(
+        FrameStatistics& statistics, const FrameMetric& metric
+    ) : m_statistics(statistics), m_metric(metric),
+    m_start_time(::std::chrono::steady_clock::now()) {}
+
+    // Records the time passed.
+    ScopedFrameTimer::~ScopedFrameTimer() {
+        m_statistics.record(m_metric,
+            static_cast<uint64_t>(::std::chrono::duration_cast
+            <::std::chrono::microseconds>(
+                ::std::chrono::steady_clock::now() - m_start_time
+            ).count())
+        );
+    }
+}
\ No newline at end of file
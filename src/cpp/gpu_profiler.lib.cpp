@@ -0,0 +1,247 @@
+#include "vk_tut/gpu_profiler.h"
+#include "vk_tut/host_allocator.h"
+#include "vk_tut/logging.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace vk::tut {
+    // < ------------------------ GpuTimingStats ------------------------- >
+
+    void GpuTimingStats::add_sample(const double& milliseconds) {
+        m_samples[m_next_sample] = milliseconds;
+        m_next_sample = (m_next_sample + 1) % WINDOW_SIZE;
+        m_sample_count = ::std::min(m_sample_count + 1, WINDOW_SIZE);
+        m_latest = milliseconds;
+        m_total_sample_count++;
+    }
+
+    double GpuTimingStats::get_average() const {
+        if (m_sample_count == 0) return 0.0;
+
+        double sum = 0.0;
+        for (uint32_t i = 0; i < m_sample_count; i++) sum += m_samples[i];
+        return sum / m_sample_count;
+    }
+
+    double GpuTimingStats::get_min() const {
+        if (m_sample_count == 0) return 0.0;
+
+        return *::std::min_element(
+            m_samples.begin(), m_samples.begin() + m_sample_count
+        );
+    }
+
+    double GpuTimingStats::get_max() const {
+        if (m_sample_count == 0) return 0.0;
+
+        return *::std::max_element(
+            m_samples.begin(), m_samples.begin() + m_sample_count
+        );
+    }
+
+    // < -------------------------- GpuProfiler -------------------------- >
+
+    void GpuProfiler::create(
+        const VkPhysicalDevice& physical_device,
+        const VkDevice& logical_device,
+        const uint32_t& queue_family_index,
+        const uint32_t& slot_count
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        uint32_t queue_family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(
+            physical_device, &queue_family_count, nullptr
+        );
+        ::std::vector<VkQueueFamilyProperties> queue_families(
+            queue_family_count
+        );
+        vkGetPhysicalDeviceQueueFamilyProperties(
+            physical_device, &queue_family_count, queue_families.data()
+        );
+        const uint32_t valid_bits =
+            queue_families[queue_family_index].timestampValidBits;
+        if (valid_bits == 0) {
+            VK_TUT_LOG_DEBUG("Timestamps are not supported. "
+                "GPU profiling is disabled.");
+            return;
+        }
+        m_timestamp_mask = valid_bits >= 64 ? UINT64_MAX :
+            (static_cast<uint64_t>(1) << valid_bits) - 1;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physical_device, &properties);
+        m_timestamp_period =
+            static_cast<double>(properties.limits.timestampPeriod);
+
+        VkQueryPoolCreateInfo query_pool_info{};
+        query_pool_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        query_pool_info.queryType = VkQueryType::VK_QUERY_TYPE_TIMESTAMP;
+        query_pool_info.queryCount = MAX_REGIONS * 2;
+
+        m_query_pools.resize(slot_count, VK_NULL_HANDLE);
+        for (VkQueryPool& query_pool : m_query_pools) {
+            result = vkCreateQueryPool(
+                logical_device, &query_pool_info,
+                get_allocation_callbacks(VK_OBJECT_TYPE_QUERY_POOL), &query_pool
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to create timestamp query pool.");
+            }
+        }
+        m_slot_submitted.assign(slot_count, false);
+        // A value and an availability word per query.
+        m_query_results.resize(MAX_REGIONS * 2 * 2);
+
+        VK_TUT_LOG_DEBUG("Successfully created GPU profiler.");
+    }
+
+    void GpuProfiler::destroy(const VkDevice& logical_device) {
+        for (const VkQueryPool& query_pool : m_query_pools) {
+            vkDestroyQueryPool(logical_device, query_pool,
+                get_allocation_callbacks(VK_OBJECT_TYPE_QUERY_POOL));
+        }
+        m_query_pools.clear();
+        m_slot_submitted.clear();
+
+        VK_TUT_LOG_DEBUG("Destroyed GPU profiler.");
+    }
+
+    void GpuProfiler::begin_frame(
+        const VkCommandBuffer& command_buffer, const uint32_t& slot
+    ) {
+        if (!is_enabled()) return;
+
+        vkCmdResetQueryPool(
+            command_buffer, m_query_pools[slot], 0, MAX_REGIONS * 2
+        );
+    }
+
+    void GpuProfiler::begin_region(
+        const VkCommandBuffer& command_buffer,
+        const uint32_t& slot,
+        const ::std::string& name
+    ) {
+        if (!is_enabled()) return;
+
+        const uint32_t region = find_region(name);
+        if (region == MAX_REGIONS) return;
+
+        // Starts once every earlier command has started.
+        vkCmdWriteTimestamp(command_buffer,
+            VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            m_query_pools[slot], region * 2
+        );
+    }
+
+    void GpuProfiler::end_region(
+        const VkCommandBuffer& command_buffer,
+        const uint32_t& slot,
+        const ::std::string& name
+    ) {
+        if (!is_enabled()) return;
+
+        const uint32_t region = find_region(name);
+        if (region == MAX_REGIONS) return;
+
+        // Ends once every earlier command has finished.
+        vkCmdWriteTimestamp(command_buffer,
+            VkPipelineStageFlagBits::VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            m_query_pools[slot], region * 2 + 1
+        );
+    }
+
+    void GpuProfiler::submit(const uint32_t& slot) {
+        if (!is_enabled()) return;
+
+        m_slot_submitted[slot] = true;
+    }
+
+    void GpuProfiler::collect(
+        const VkDevice& logical_device, const uint32_t& slot
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        // Queries of a slot never submitted were never reset.
+        if (!is_enabled() || !m_slot_submitted[slot]) return;
+        m_slot_submitted[slot] = false;
+
+        const uint32_t query_count =
+            static_cast<uint32_t>(m_region_names.size()) * 2;
+        if (query_count == 0) return;
+
+        // Without the wait flag, unavailable queries are reported
+        // as such instead of blocking.
+        result = vkGetQueryPoolResults(
+            logical_device, m_query_pools[slot], 0, query_count,
+            query_count * 2 * sizeof(uint64_t), m_query_results.data(),
+            2 * sizeof(uint64_t),
+            VkQueryResultFlagBits::VK_QUERY_RESULT_64_BIT |
+            VkQueryResultFlagBits::VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+        );
+        if (result != VkResult::VK_SUCCESS &&
+        result != VkResult::VK_NOT_READY) {
+            VK_TUT_LOG_ERROR("Failed to get timestamp query results.");
+        }
+
+        for (uint32_t region = 0; region < m_region_names.size(); region++) {
+            const uint64_t* ptr_begin = &m_query_results[region * 4];
+            const uint64_t* ptr_end = &m_query_results[region * 4 + 2];
+            // Regions not recorded in this frame are never available.
+            if (ptr_begin[1] == 0 || ptr_end[1] == 0) continue;
+
+            const uint64_t ticks = ((ptr_end[0] & m_timestamp_mask) -
+                (ptr_begin[0] & m_timestamp_mask)) & m_timestamp_mask;
+            m_region_stats[region].add_sample(
+                static_cast<double>(ticks) * m_timestamp_period / 1.0e6
+            );
+        }
+    }
+
+    void GpuProfiler::log_stats() const {
+        for (uint32_t region = 0; region < m_region_names.size(); region++) {
+            const GpuTimingStats& stats = m_region_stats[region];
+            if (stats.get_sample_count() == 0) continue;
+
+            char line[128];
+            ::std::snprintf(line, sizeof(line),
+                "GPU %-12s avg %8.3f ms  min %8.3f ms  max %8.3f ms",
+                m_region_names[region].c_str(), stats.get_average(),
+                stats.get_min(), stats.get_max()
+            );
+            VK_TUT_LOG_DEBUG(line);
+        }
+    }
+
+    GpuTimingStats GpuProfiler::get_stats(const ::std::string& name) const {
+        auto iterator = m_region_indices.find(name);
+        if (iterator == m_region_indices.end() ||
+        iterator->second == MAX_REGIONS) {
+            return GpuTimingStats();
+        }
+
+        return m_region_stats[iterator->second];
+    }
+
+    uint32_t GpuProfiler::find_region(const ::std::string& name) {
+        auto iterator = m_region_indices.find(name);
+        if (iterator != m_region_indices.end()) return iterator->second;
+
+        // Remembered as unmeasured, so this is only logged once.
+        if (m_region_names.size() == MAX_REGIONS) {
+            VK_TUT_LOG_DEBUG("No queries left to profile " + name + ".");
+            m_region_indices.emplace(name, MAX_REGIONS);
+            return MAX_REGIONS;
+        }
+
+        const uint32_t region = static_cast<uint32_t>(m_region_names.size());
+        m_region_names.emplace_back(name);
+        m_region_indices.emplace(name, region);
+        m_region_stats.emplace_back();
+        return region;
+    }
+}
\ No newline at end of file
@@ -1,25 +1,53 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 #include "vk_tut/shader_parser.h"
 #include "vk_tut/vertex.h"
+#include "vk_tut/instance_transform.h"
+#include "vk_tut/push_constant.h"
+#include "vk_tut/debug_draw.h"
+
+#include <algorithm>
 
 namespace vk::tut {
     void Application::create_graphics_pipeline() {
+        VK_TUT_TRACE_SCOPE("create_graphics_pipeline");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
-        VkVertexInputBindingDescription binding_description =
-            Vertex::get_binding_description();
+        // The vertices of the mesh buffer, then the instance transforms.
+        std::array<VkVertexInputBindingDescription, 2> binding_descriptions = {
+            Vertex::get_binding_description(),
+            InstanceTransform::get_binding_description()
+        };
+        std::array<VkVertexInputAttributeDescription, 5>
+        attribute_descriptions{};
         std::array<VkVertexInputAttributeDescription, 3>
-        attribute_descriptions = Vertex::get_attribute_descriptions();
+        vertex_attribute_descriptions = Vertex::get_attribute_descriptions();
+        std::array<VkVertexInputAttributeDescription, 2>
+        instance_attribute_descriptions =
+            InstanceTransform::get_attribute_descriptions();
+        std::copy(
+            vertex_attribute_descriptions.begin(),
+            vertex_attribute_descriptions.end(),
+            attribute_descriptions.begin()
+        );
+        std::copy(
+            instance_attribute_descriptions.begin(),
+            instance_attribute_descriptions.end(),
+            attribute_descriptions.begin() +
+                vertex_attribute_descriptions.size()
+        );
         
         // Information about how the input buffer layout.
         VkPipelineVertexInputStateCreateInfo vertex_input_state_info{};
         vertex_input_state_info.sType = VkStructureType
             ::VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertex_input_state_info.vertexBindingDescriptionCount = 1;
+        vertex_input_state_info.vertexBindingDescriptionCount =
+            static_cast<uint32_t>(binding_descriptions.size());
         vertex_input_state_info.pVertexBindingDescriptions =
-            &binding_description;
+            binding_descriptions.data();
         vertex_input_state_info.vertexAttributeDescriptionCount =
             static_cast<uint32_t>(attribute_descriptions.size());
         vertex_input_state_info.pVertexAttributeDescriptions =
@@ -41,6 +69,18 @@ namespace vk::tut {
             _VK_TUT_FRAGMENT_SHADER_FILEPATH_
         );
 
+        // The size of the bindless texture table in the fragment shader.
+        VkSpecializationMapEntry texture_table_size_entry{};
+        texture_table_size_entry.constantID = 0;
+        texture_table_size_entry.offset = 0;
+        texture_table_size_entry.size = sizeof(MAX_BINDLESS_TEXTURES);
+
+        VkSpecializationInfo fragment_specialization_info{};
+        fragment_specialization_info.mapEntryCount = 1;
+        fragment_specialization_info.pMapEntries = &texture_table_size_entry;
+        fragment_specialization_info.dataSize = sizeof(MAX_BINDLESS_TEXTURES);
+        fragment_specialization_info.pData = &MAX_BINDLESS_TEXTURES;
+
         // Contains programmable pipeline stages.
         VkPipelineShaderStageCreateInfo shader_stages_info[2]{};
 
@@ -59,6 +99,8 @@ namespace vk::tut {
             ::VK_SHADER_STAGE_FRAGMENT_BIT;
         shader_stages_info[1].module = m_fragment_shader_module;
         shader_stages_info[1].pName = "main"; // Entrypoint function name.
+        shader_stages_info[1].pSpecializationInfo =
+            &fragment_specialization_info;
 
         // Viewport.
         VkViewport viewport{};
@@ -100,8 +142,7 @@ namespace vk::tut {
         multisampling_info.sType = VkStructureType
             ::VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
         multisampling_info.sampleShadingEnable = VK_FALSE;
-        multisampling_info.rasterizationSamples = VkSampleCountFlagBits
-            ::VK_SAMPLE_COUNT_1_BIT;
+        multisampling_info.rasterizationSamples = m_msaa_samples;
         multisampling_info.minSampleShading = 1.0f; // Optional
 
         // Colour Blend Attachment.
@@ -138,19 +179,48 @@ namespace vk::tut {
         colour_blending_info.blendConstants[2] = 0.0f; // Optional
         colour_blending_info.blendConstants[3] = 0.0f; // Optional
 
+        // Depth testing under reverse-Z, where nearer is greater. After a
+        // depth prepass, only the fragments it kept are shaded, and the
+        // depth is already written.
+        VkPipelineDepthStencilStateCreateInfo depth_stencil_info{};
+        depth_stencil_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depth_stencil_info.depthTestEnable = VK_TRUE;
+        if (m_config.get_depth_prepass()) {
+            depth_stencil_info.depthWriteEnable = VK_FALSE;
+            depth_stencil_info.depthCompareOp = VkCompareOp
+                ::VK_COMPARE_OP_EQUAL;
+        }
+        else {
+            depth_stencil_info.depthWriteEnable = VK_TRUE;
+            depth_stencil_info.depthCompareOp = VkCompareOp
+                ::VK_COMPARE_OP_GREATER_OR_EQUAL;
+        }
+        depth_stencil_info.depthBoundsTestEnable = VK_FALSE;
+        depth_stencil_info.stencilTestEnable = VK_FALSE;
+
+        // The texture index is pushed per draw.
+        VkPushConstantRange push_constant_range{};
+        push_constant_range.stageFlags = VkShaderStageFlagBits
+            ::VK_SHADER_STAGE_FRAGMENT_BIT;
+        push_constant_range.offset = 0;
+        push_constant_range.size = sizeof(PushConstant);
+
         // Graphics Pipeline layout information.
         VkPipelineLayoutCreateInfo graphics_pipeline_layout_info{};
         graphics_pipeline_layout_info.sType = VkStructureType
             ::VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         graphics_pipeline_layout_info.setLayoutCount = 1;
         graphics_pipeline_layout_info.pSetLayouts = &m_descriptor_set_layout;
-        graphics_pipeline_layout_info.pushConstantRangeCount = 0; // Optional
-        graphics_pipeline_layout_info.pPushConstantRanges = nullptr; // Optional
+        graphics_pipeline_layout_info.pushConstantRangeCount = 1;
+        graphics_pipeline_layout_info.pPushConstantRanges =
+            &push_constant_range;
 
         // Create the pipeline layout.
         result = vkCreatePipelineLayout(
             m_logical_device, &graphics_pipeline_layout_info,
-            nullptr, &m_graphics_pipeline_layout
+            get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE_LAYOUT),
+            &m_graphics_pipeline_layout
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -171,12 +241,15 @@ namespace vk::tut {
         graphics_pipeline_info.pRasterizationState = &rasterization_info;
         graphics_pipeline_info.pColorBlendState = &colour_blending_info;
         graphics_pipeline_info.pMultisampleState = &multisampling_info;
+        graphics_pipeline_info.pDepthStencilState = &depth_stencil_info;
         graphics_pipeline_info.renderPass = m_render_pass;
+        graphics_pipeline_info.subpass = m_config.get_depth_prepass() ? 1 : 0;
 
         // Create the graphics pipeline.
         result = vkCreateGraphicsPipelines(
             m_logical_device, nullptr, 1, &graphics_pipeline_info,
-            nullptr, &m_graphics_pipeline
+            get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE),
+            &m_graphics_pipeline
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -184,17 +257,238 @@ namespace vk::tut {
             );
         }
 
+        if (m_config.get_depth_prepass()) {
+            create_depth_prepass_pipeline(graphics_pipeline_info);
+        }
+        create_debug_draw_pipelines(graphics_pipeline_info);
+
         VK_TUT_LOG_DEBUG("Successfully created graphics pipeline.");
     }
 
+    void Application::create_depth_prepass_pipeline(
+        const VkGraphicsPipelineCreateInfo& graphics_pipeline_info
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        // Only the positions of the shared vertex buffer
+        // and the instance transforms are read.
+        std::array<VkVertexInputBindingDescription, 2> binding_descriptions = {
+            Vertex::get_binding_description(),
+            InstanceTransform::get_binding_description()
+        };
+        std::array<VkVertexInputAttributeDescription, 2>
+        instance_attribute_descriptions =
+            InstanceTransform::get_attribute_descriptions();
+        std::array<VkVertexInputAttributeDescription, 3>
+        attribute_descriptions = {
+            Vertex::get_attribute_descriptions()[0],
+            instance_attribute_descriptions[0],
+            instance_attribute_descriptions[1]
+        };
+
+        VkPipelineVertexInputStateCreateInfo vertex_input_state_info{};
+        vertex_input_state_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertex_input_state_info.vertexBindingDescriptionCount =
+            static_cast<uint32_t>(binding_descriptions.size());
+        vertex_input_state_info.pVertexBindingDescriptions =
+            binding_descriptions.data();
+        vertex_input_state_info.vertexAttributeDescriptionCount =
+            static_cast<uint32_t>(attribute_descriptions.size());
+        vertex_input_state_info.pVertexAttributeDescriptions =
+            attribute_descriptions.data();
+
+        m_depth_prepass_shader_module = create_shader_module(
+            m_logical_device, _VK_TUT_DEPTH_PREPASS_VERTEX_SHADER_FILEPATH_
+        );
+
+        // No fragment shader. Only the depth is written.
+        VkPipelineShaderStageCreateInfo shader_stage_info{};
+        shader_stage_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shader_stage_info.stage = VkShaderStageFlagBits
+            ::VK_SHADER_STAGE_VERTEX_BIT;
+        shader_stage_info.module = m_depth_prepass_shader_module;
+        shader_stage_info.pName = "main"; // Entrypoint function name.
+
+        VkPipelineDepthStencilStateCreateInfo depth_stencil_info{};
+        depth_stencil_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depth_stencil_info.depthTestEnable = VK_TRUE;
+        depth_stencil_info.depthWriteEnable = VK_TRUE;
+        depth_stencil_info.depthCompareOp = VkCompareOp
+            ::VK_COMPARE_OP_GREATER;
+
+        // The depth prepass subpass has no colour attachment.
+        VkPipelineColorBlendStateCreateInfo colour_blending_info{};
+        colour_blending_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colour_blending_info.attachmentCount = 0;
+
+        // Everything else matches the shading pipeline.
+        VkGraphicsPipelineCreateInfo depth_prepass_pipeline_info =
+            graphics_pipeline_info;
+        depth_prepass_pipeline_info.pVertexInputState =
+            &vertex_input_state_info;
+        depth_prepass_pipeline_info.stageCount = 1;
+        depth_prepass_pipeline_info.pStages = &shader_stage_info;
+        depth_prepass_pipeline_info.pDepthStencilState = &depth_stencil_info;
+        depth_prepass_pipeline_info.pColorBlendState = &colour_blending_info;
+        depth_prepass_pipeline_info.subpass = 0;
+
+        result = vkCreateGraphicsPipelines(
+            m_logical_device, nullptr, 1, &depth_prepass_pipeline_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE),
+            &m_depth_prepass_pipeline
+        );
+        if (result != VkResult::VK_SUCCESS) {
+            VK_TUT_LOG_ERROR(
+                "Failed to create depth prepass pipeline."
+            );
+        }
+
+        VK_TUT_LOG_DEBUG("Successfully created depth prepass pipeline.");
+    }
+
+    void Application::create_debug_draw_pipelines(
+        const VkGraphicsPipelineCreateInfo& graphics_pipeline_info
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        VkVertexInputBindingDescription binding_description =
+            DebugVertex::get_binding_description();
+        std::array<VkVertexInputAttributeDescription, 2>
+        attribute_descriptions = DebugVertex::get_attribute_descriptions();
+
+        VkPipelineVertexInputStateCreateInfo vertex_input_state_info{};
+        vertex_input_state_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertex_input_state_info.vertexBindingDescriptionCount = 1;
+        vertex_input_state_info.pVertexBindingDescriptions =
+            &binding_description;
+        vertex_input_state_info.vertexAttributeDescriptionCount =
+            static_cast<uint32_t>(attribute_descriptions.size());
+        vertex_input_state_info.pVertexAttributeDescriptions =
+            attribute_descriptions.data();
+
+        m_debug_draw_vertex_shader_module = create_shader_module(
+            m_logical_device, _VK_TUT_DEBUG_DRAW_VERTEX_SHADER_FILEPATH_
+        );
+        m_debug_draw_fragment_shader_module = create_shader_module(
+            m_logical_device, _VK_TUT_DEBUG_DRAW_FRAGMENT_SHADER_FILEPATH_
+        );
+
+        // Points are only guaranteed to be a pixel large.
+        const float point_size = m_large_points_supported ? 4.0f : 1.0f;
+        VkSpecializationMapEntry point_size_entry{};
+        point_size_entry.constantID = 0;
+        point_size_entry.offset = 0;
+        point_size_entry.size = sizeof(point_size);
+
+        VkSpecializationInfo vertex_specialization_info{};
+        vertex_specialization_info.mapEntryCount = 1;
+        vertex_specialization_info.pMapEntries = &point_size_entry;
+        vertex_specialization_info.dataSize = sizeof(point_size);
+        vertex_specialization_info.pData = &point_size;
+
+        VkPipelineShaderStageCreateInfo shader_stages_info[2]{};
+        shader_stages_info[0].sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shader_stages_info[0].stage = VkShaderStageFlagBits
+            ::VK_SHADER_STAGE_VERTEX_BIT;
+        shader_stages_info[0].module = m_debug_draw_vertex_shader_module;
+        shader_stages_info[0].pName = "main"; // Entrypoint function name.
+        shader_stages_info[0].pSpecializationInfo =
+            &vertex_specialization_info;
+        shader_stages_info[1].sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shader_stages_info[1].stage = VkShaderStageFlagBits
+            ::VK_SHADER_STAGE_FRAGMENT_BIT;
+        shader_stages_info[1].module = m_debug_draw_fragment_shader_module;
+        shader_stages_info[1].pName = "main"; // Entrypoint function name.
+
+        // Tested against the depth of the scene, but never hiding it.
+        VkPipelineDepthStencilStateCreateInfo depth_stencil_info{};
+        depth_stencil_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depth_stencil_info.depthTestEnable = VK_TRUE;
+        depth_stencil_info.depthWriteEnable = VK_FALSE;
+        depth_stencil_info.depthCompareOp = VkCompareOp
+            ::VK_COMPARE_OP_GREATER_OR_EQUAL;
+
+        // Lines, then points. Everything else matches the shading
+        // pipeline, so both are drawn in the shading subpass.
+        std::array<VkPipelineInputAssemblyStateCreateInfo, 2>
+        input_assembly_infos{};
+        std::array<VkGraphicsPipelineCreateInfo, 2> debug_pipeline_infos;
+        const VkPrimitiveTopology topologies[2] = {
+            VkPrimitiveTopology::VK_PRIMITIVE_TOPOLOGY_LINE_LIST,
+            VkPrimitiveTopology::VK_PRIMITIVE_TOPOLOGY_POINT_LIST
+        };
+        for (size_t i = 0; i < debug_pipeline_infos.size(); i++) {
+            input_assembly_infos[i].sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+            input_assembly_infos[i].topology = topologies[i];
+            input_assembly_infos[i].primitiveRestartEnable = VK_FALSE;
+
+            debug_pipeline_infos[i] = graphics_pipeline_info;
+            debug_pipeline_infos[i].pVertexInputState =
+                &vertex_input_state_info;
+            debug_pipeline_infos[i].pInputAssemblyState =
+                &input_assembly_infos[i];
+            debug_pipeline_infos[i].stageCount = 2;
+            debug_pipeline_infos[i].pStages = shader_stages_info;
+            debug_pipeline_infos[i].pDepthStencilState = &depth_stencil_info;
+        }
+
+        VkPipeline debug_pipelines[2];
+        result = vkCreateGraphicsPipelines(
+            m_logical_device, nullptr,
+            static_cast<uint32_t>(debug_pipeline_infos.size()),
+            debug_pipeline_infos.data(),
+            get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE),
+            debug_pipelines
+        );
+        if (result != VkResult::VK_SUCCESS) {
+            VK_TUT_LOG_ERROR(
+                "Failed to create debug draw pipelines."
+            );
+        }
+        m_debug_line_pipeline = debug_pipelines[0];
+        m_debug_point_pipeline = debug_pipelines[1];
+
+        VK_TUT_LOG_DEBUG("Successfully created debug draw pipelines.");
+    }
+
     void Application::destroy_graphics_pipeline() {
-        // Destroy the graphics pipeline itself.
-        vkDestroyPipeline(m_logical_device, m_graphics_pipeline, nullptr);
+        // Destroy the graphics pipelines themselves.
+        vkDestroyPipeline(m_logical_device, m_graphics_pipeline,
+            get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE));
+        vkDestroyPipeline(m_logical_device, m_depth_prepass_pipeline,
+            get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE));
+        vkDestroyPipeline(m_logical_device, m_debug_line_pipeline,
+            get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE));
+        vkDestroyPipeline(m_logical_device, m_debug_point_pipeline,
+            get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE));
         // Destroy graphics pipeline layout.
-        vkDestroyPipelineLayout(m_logical_device, m_graphics_pipeline_layout, nullptr);
+        vkDestroyPipelineLayout(m_logical_device, m_graphics_pipeline_layout,
+            get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE_LAYOUT));
         // Destroy shader modules.
-        vkDestroyShaderModule(m_logical_device, m_vertex_shader_module, nullptr);
-        vkDestroyShaderModule(m_logical_device, m_fragment_shader_module, nullptr);
+        vkDestroyShaderModule(m_logical_device, m_vertex_shader_module,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
+        vkDestroyShaderModule(m_logical_device, m_fragment_shader_module,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
+        vkDestroyShaderModule(m_logical_device,
+            m_depth_prepass_shader_module,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
+        vkDestroyShaderModule(m_logical_device,
+            m_debug_draw_vertex_shader_module,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
+        vkDestroyShaderModule(m_logical_device,
+            m_debug_draw_fragment_shader_module,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
 
         VK_TUT_LOG_DEBUG("Destroyed graphics pipeline.");
     }
@@ -0,0 +1,63 @@
+#include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
+#include "vk_tut/logging.h"
+
+namespace vk::tut {
+    // The number of offscreen images rendered to in headless mode.
+    // One per frame in flight, like a triple buffered swapchain.
+    static constexpr uint32_t HEADLESS_IMAGE_COUNT = 3;
+
+    void Application::create_headless_images() {
+        // The same format a window surface would most likely pick,
+        // so both modes render the same pixels.
+        m_swapchain_image_format = VkFormat::VK_FORMAT_B8G8R8A8_SRGB;
+        m_swapchain_extent = {
+            m_config.get_headless_width(), m_config.get_headless_height()
+        };
+
+        m_swapchain_images.resize(HEADLESS_IMAGE_COUNT);
+        m_headless_image_memories.resize(HEADLESS_IMAGE_COUNT);
+        for (uint32_t i = 0; i < HEADLESS_IMAGE_COUNT; i++) {
+            // Copied from once rendered, instead of being presented.
+            create_and_allocate_image(
+                m_physical_device, m_logical_device,
+                static_cast<int>(m_swapchain_extent.width),
+                static_cast<int>(m_swapchain_extent.height),
+                m_swapchain_image_format,
+                VkImageTiling::VK_IMAGE_TILING_OPTIMAL,
+                VkImageUsageFlagBits::VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT,
+                &m_swapchain_images[i], &m_headless_image_memories[i]
+            );
+        }
+
+        VK_TUT_LOG_DEBUG("Successfully created headless images.");
+    }
+
+    void Application::destroy_headless_images() {
+        for (size_t i = 0; i < m_swapchain_images.size(); i++) {
+            vkDestroyImage(m_logical_device, m_swapchain_images[i],
+                get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE));
+            vkFreeMemory(
+                m_logical_device, m_headless_image_memories[i],
+                get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY)
+            );
+        }
+        m_swapchain_images.clear();
+        m_headless_image_memories.clear();
+
+        VK_TUT_LOG_DEBUG("Destroyed headless images.");
+    }
+
+    VkImageLayout Application::get_output_image_layout() const {
+        // The present layout belongs to the swapchain extension,
+        // which headless mode does not enable. A frame read back is
+        // copied first, then moved to the present layout by the graph.
+        return m_config.get_headless() ||
+            !m_config.get_readback_directory().empty() ?
+            VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL :
+            VkImageLayout::VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "vk_tut/host_allocator.h"
+#include "vk_tut/logging.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace vk::tut {
+    // Stored right before each allocation, so it can be freed and
+    // counted without looking it up.
+    struct alignas(16) AllocationHeader {
+        // The block, or system allocation, the allocation is in.
+        void* ptr_block;
+        // The bytes requested.
+        uint64_t size;
+        // The index of the object type in HostAllocator::OBJECT_TYPES.
+        uint32_t object_type_index;
+        // The size class of the block. SIZE_CLASS_COUNT if not pooled.
+        uint8_t size_class;
+        // The index of the allocation scope.
+        uint8_t scope_index;
+    };
+
+    // Logs a usage, if anything was ever allocated.
+    static void log_usage(
+        const char* kind, const char* name, const HostAllocator::Usage& usage
+    ) {
+        if (usage.total_allocation_count == 0) return;
+
+        char line[160];
+        ::std::snprintf(line, sizeof(line),
+            "Host %-8s %-26s %8" PRIu64 " live %10" PRIu64 " bytes  "
+            "peak %10" PRIu64 " bytes %10" PRIu64 " total",
+            kind, name, usage.allocation_count, usage.bytes,
+            usage.peak_bytes, usage.total_allocation_count
+        );
+        VK_TUT_LOG_DEBUG(line);
+    }
+
+    // < -------------------------- UsageCounters ------------------------- >
+
+    void HostAllocator::UsageCounters::add(const size_t& size) {
+        allocation_count.fetch_add(1, ::std::memory_order_relaxed);
+        total_allocation_count.fetch_add(1, ::std::memory_order_relaxed);
+        const uint64_t new_bytes =
+            bytes.fetch_add(size, ::std::memory_order_relaxed) + size;
+
+        uint64_t peak = peak_bytes.load(::std::memory_order_relaxed);
+        while (new_bytes > peak && !peak_bytes.compare_exchange_weak(
+            peak, new_bytes, ::std::memory_order_relaxed
+        )) {}
+    }
+
+    void HostAllocator::UsageCounters::remove(const size_t& size) {
+        allocation_count.fetch_sub(1, ::std::memory_order_relaxed);
+        bytes.fetch_sub(size, ::std::memory_order_relaxed);
+    }
+
+    HostAllocator::Usage HostAllocator::UsageCounters::get_usage() const {
+        Usage usage;
+        usage.allocation_count =
+            allocation_count.load(::std::memory_order_relaxed);
+        usage.bytes = bytes.load(::std::memory_order_relaxed);
+        usage.peak_bytes = peak_bytes.load(::std::memory_order_relaxed);
+        usage.total_allocation_count =
+            total_allocation_count.load(::std::memory_order_relaxed);
+        return usage;
+    }
+
+    // < -------------------------- HostAllocator ------------------------- >
+
+    // Sets up the callbacks of each object type.
+    HostAllocator::HostAllocator() {
+        for (uint32_t i = 0; i < OBJECT_TYPES.size(); i++) {
+            m_callback_data[i].ptr_allocator = this;
+            m_callback_data[i].object_type_index = i;
+
+            VkAllocationCallbacks& callbacks = m_callbacks[i];
+            callbacks.pUserData = &m_callback_data[i];
+            callbacks.pfnAllocation = &HostAllocator::allocation_callback;
+            callbacks.pfnReallocation =
+                &HostAllocator::reallocation_callback;
+            callbacks.pfnFree = &HostAllocator::free_callback;
+            callbacks.pfnInternalAllocation =
+                &HostAllocator::internal_allocation_callback;
+            callbacks.pfnInternalFree =
+                &HostAllocator::internal_free_callback;
+        }
+    }
+
+    // Frees the arenas.
+    HostAllocator::~HostAllocator() {
+        for (Pool& pool : m_pools) {
+            for (void* ptr_arena : pool.arenas) {
+                ::std::free(ptr_arena);
+            }
+        }
+    }
+
+    HostAllocator& HostAllocator::get_instance() {
+        static HostAllocator allocator;
+        return allocator;
+    }
+
+    const VkAllocationCallbacks* HostAllocator::get_callbacks(
+        const VkObjectType& object_type
+    ) const {
+        return &m_callbacks[get_object_type_index(object_type)];
+    }
+
+    HostAllocator::Usage HostAllocator::get_scope_usage(
+        const VkSystemAllocationScope& scope
+    ) const {
+        return m_scope_usages[get_scope_index(scope)].get_usage();
+    }
+
+    HostAllocator::Usage HostAllocator::get_object_type_usage(
+        const VkObjectType& object_type
+    ) const {
+        return m_object_type_usages[
+            get_object_type_index(object_type)
+        ].get_usage();
+    }
+
+    HostAllocator::Usage HostAllocator::get_internal_usage(
+        const VkSystemAllocationScope& scope
+    ) const {
+        return m_internal_usages[get_scope_index(scope)].get_usage();
+    }
+
+    uint64_t HostAllocator::get_arena_bytes() const {
+        return m_arena_bytes.load(::std::memory_order_relaxed);
+    }
+
+    void HostAllocator::log_stats() const {
+        for (uint32_t i = 0; i < SCOPE_COUNT; i++) {
+            const VkSystemAllocationScope scope =
+                static_cast<VkSystemAllocationScope>(i);
+            log_usage("scope", get_scope_name(scope), get_scope_usage(scope));
+        }
+        for (const VkObjectType& object_type : OBJECT_TYPES) {
+            log_usage("object", get_object_type_name(object_type),
+                get_object_type_usage(object_type)
+            );
+        }
+        for (uint32_t i = 0; i < SCOPE_COUNT; i++) {
+            const VkSystemAllocationScope scope =
+                static_cast<VkSystemAllocationScope>(i);
+            log_usage("internal", get_scope_name(scope),
+                get_internal_usage(scope)
+            );
+        }
+
+        char line[96];
+        ::std::snprintf(line, sizeof(line),
+            "Host arenas %" PRIu64 " bytes", get_arena_bytes()
+        );
+        VK_TUT_LOG_DEBUG(line);
+    }
+
+    const char* HostAllocator::get_scope_name(
+        const VkSystemAllocationScope& scope
+    ) {
+        switch (scope) {
+        case VkSystemAllocationScope::VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:
+            return "command";
+        case VkSystemAllocationScope::VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:
+            return "object";
+        case VkSystemAllocationScope::VK_SYSTEM_ALLOCATION_SCOPE_CACHE:
+            return "cache";
+        case VkSystemAllocationScope::VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:
+            return "device";
+        case VkSystemAllocationScope::VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE:
+            return "instance";
+        default:
+            return "unknown";
+        }
+    }
+
+    const char* HostAllocator::get_object_type_name(
+        const VkObjectType& object_type
+    ) {
+        switch (object_type) {
+        case VkObjectType::VK_OBJECT_TYPE_INSTANCE:
+            return "instance";
+        case VkObjectType::VK_OBJECT_TYPE_DEVICE:
+            return "device";
+        case VkObjectType::VK_OBJECT_TYPE_SEMAPHORE:
+            return "semaphore";
+        case VkObjectType::VK_OBJECT_TYPE_FENCE:
+            return "fence";
+        case VkObjectType::VK_OBJECT_TYPE_DEVICE_MEMORY:
+            return "device_memory";
+        case VkObjectType::VK_OBJECT_TYPE_BUFFER:
+            return "buffer";
+        case VkObjectType::VK_OBJECT_TYPE_IMAGE:
+            return "image";
+        case VkObjectType::VK_OBJECT_TYPE_QUERY_POOL:
+            return "query_pool";
+        case VkObjectType::VK_OBJECT_TYPE_IMAGE_VIEW:
+            return "image_view";
+        case VkObjectType::VK_OBJECT_TYPE_SHADER_MODULE:
+            return "shader_module";
+        case VkObjectType::VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+            return "pipeline_layout";
+        case VkObjectType::VK_OBJECT_TYPE_RENDER_PASS:
+            return "render_pass";
+        case VkObjectType::VK_OBJECT_TYPE_PIPELINE:
+            return "pipeline";
+        case VkObjectType::VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT:
+            return "descriptor_set_layout";
+        case VkObjectType::VK_OBJECT_TYPE_SAMPLER:
+            return "sampler";
+        case VkObjectType::VK_OBJECT_TYPE_DESCRIPTOR_POOL:
+            return "descriptor_pool";
+        case VkObjectType::VK_OBJECT_TYPE_FRAMEBUFFER:
+            return "framebuffer";
+        case VkObjectType::VK_OBJECT_TYPE_COMMAND_POOL:
+            return "command_pool";
+        case VkObjectType::VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE:
+            return "descriptor_update_template";
+        case VkObjectType::VK_OBJECT_TYPE_SURFACE_KHR:
+            return "surface";
+        case VkObjectType::VK_OBJECT_TYPE_SWAPCHAIN_KHR:
+            return "swapchain";
+        case VkObjectType::VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT:
+            return "debug_utils_messenger";
+        default:
+            return "unknown";
+        }
+    }
+
+    uint32_t HostAllocator::get_object_type_index(
+        const VkObjectType& object_type
+    ) {
+        for (uint32_t i = 1; i < OBJECT_TYPES.size(); i++) {
+            if (OBJECT_TYPES[i] == object_type) return i;
+        }
+        return 0;
+    }
+
+    uint32_t HostAllocator::get_scope_index(
+        const VkSystemAllocationScope& scope
+    ) {
+        const uint32_t index = static_cast<uint32_t>(scope);
+        return index < SCOPE_COUNT ? index : static_cast<uint32_t>(
+            VkSystemAllocationScope::VK_SYSTEM_ALLOCATION_SCOPE_OBJECT
+        );
+    }
+
+    void* HostAllocator::allocate(
+        const size_t& size,
+        const size_t& alignment,
+        const VkSystemAllocationScope& scope,
+        const uint32_t& object_type_index
+    ) {
+        // The header sits right before the allocation, so the allocation
+        // is aligned to at least the alignment of the header.
+        const size_t align = ::std::max(alignment, alignof(AllocationHeader));
+        // Blocks are only aligned to the system allocator, so room is
+        // left to align within them.
+        const size_t needed_size = sizeof(AllocationHeader) + align - 1 +
+            ::std::max<size_t>(size, 1);
+
+        uint32_t size_class = 0;
+        while (size_class < SIZE_CLASS_COUNT &&
+        (MIN_BLOCK_SIZE << size_class) < needed_size) {
+            size_class++;
+        }
+
+        const uint32_t scope_index = get_scope_index(scope);
+        void* ptr_block = size_class < SIZE_CLASS_COUNT ?
+            take_block(m_pools[scope_index], size_class) :
+            ::std::malloc(needed_size);
+        if (ptr_block == nullptr) return nullptr;
+
+        const uintptr_t address = (reinterpret_cast<uintptr_t>(ptr_block) +
+            sizeof(AllocationHeader) + align - 1) & ~(uintptr_t(align) - 1);
+        void* ptr = reinterpret_cast<void*>(address);
+
+        AllocationHeader& header =
+            *(reinterpret_cast<AllocationHeader*>(ptr) - 1);
+        header.ptr_block = ptr_block;
+        header.size = size;
+        header.object_type_index = object_type_index;
+        header.size_class = static_cast<uint8_t>(size_class);
+        header.scope_index = static_cast<uint8_t>(scope_index);
+
+        m_scope_usages[scope_index].add(size);
+        m_object_type_usages[object_type_index].add(size);
+        return ptr;
+    }
+
+    void HostAllocator::free(void* ptr) {
+        if (ptr == nullptr) return;
+
+        const AllocationHeader& header =
+            *(reinterpret_cast<const AllocationHeader*>(ptr) - 1);
+        m_scope_usages[header.scope_index].remove(header.size);
+        m_object_type_usages[header.object_type_index].remove(header.size);
+
+        if (header.size_class == SIZE_CLASS_COUNT) {
+            ::std::free(header.ptr_block);
+            return;
+        }
+
+        // Back to the front of the free list of its size class.
+        Pool& pool = m_pools[header.scope_index];
+        void* ptr_block = header.ptr_block;
+        const uint8_t size_class = header.size_class;
+        ::std::lock_guard<::std::mutex> lock(pool.mutex);
+        *static_cast<void**>(ptr_block) = pool.free_blocks[size_class];
+        pool.free_blocks[size_class] = ptr_block;
+    }
+
+    void* HostAllocator::take_block(
+        Pool& ref_pool, const uint32_t& size_class
+    ) {
+        ::std::lock_guard<::std::mutex> lock(ref_pool.mutex);
+
+        void*& ref_free_block = ref_pool.free_blocks[size_class];
+        if (ref_free_block == nullptr) {
+            char* ptr_arena = static_cast<char*>(::std::malloc(ARENA_SIZE));
+            if (ptr_arena == nullptr) return nullptr;
+            ref_pool.arenas.emplace_back(ptr_arena);
+            m_arena_bytes.fetch_add(ARENA_SIZE, ::std::memory_order_relaxed);
+
+            // Links the blocks of the arena, first block first.
+            const size_t block_size = MIN_BLOCK_SIZE << size_class;
+            void* ptr_next = nullptr;
+            for (size_t offset = ARENA_SIZE / block_size * block_size;
+            offset > 0; offset -= block_size) {
+                void* ptr_block = ptr_arena + offset - block_size;
+                *static_cast<void**>(ptr_block) = ptr_next;
+                ptr_next = ptr_block;
+            }
+            ref_free_block = ptr_next;
+        }
+
+        void* ptr_block = ref_free_block;
+        ref_free_block = *static_cast<void**>(ptr_block);
+        return ptr_block;
+    }
+
+    void* VKAPI_CALL HostAllocator::allocation_callback(
+        void* ptr_user_data,
+        size_t size,
+        size_t alignment,
+        VkSystemAllocationScope scope
+    ) {
+        const CallbackData& data =
+            *static_cast<const CallbackData*>(ptr_user_data);
+        return data.ptr_allocator->allocate(
+            size, alignment, scope, data.object_type_index
+        );
+    }
+
+    void* VKAPI_CALL HostAllocator::reallocation_callback(
+        void* ptr_user_data,
+        void* ptr_original,
+        size_t size,
+        size_t alignment,
+        VkSystemAllocationScope scope
+    ) {
+        const CallbackData& data =
+            *static_cast<const CallbackData*>(ptr_user_data);
+        if (ptr_original == nullptr) {
+            return data.ptr_allocator->allocate(
+                size, alignment, scope, data.object_type_index
+            );
+        }
+        if (size == 0) {
+            data.ptr_allocator->free(ptr_original);
+            return nullptr;
+        }
+
+        // The original is left alone if the new allocation fails.
+        void* ptr = data.ptr_allocator->allocate(
+            size, alignment, scope, data.object_type_index
+        );
+        if (ptr == nullptr) return nullptr;
+
+        const AllocationHeader& original_header =
+            *(reinterpret_cast<const AllocationHeader*>(ptr_original) - 1);
+        ::std::memcpy(ptr, ptr_original, ::std::min<size_t>(
+            size, original_header.size
+        ));
+        data.ptr_allocator->free(ptr_original);
+        return ptr;
+    }
+
+    void VKAPI_CALL HostAllocator::free_callback(
+        void* ptr_user_data, void* ptr
+    ) {
+        static_cast<const CallbackData*>(ptr_user_data)
+            ->ptr_allocator->free(ptr);
+    }
+
+    void VKAPI_CALL HostAllocator::internal_allocation_callback(
+        void* ptr_user_data,
+        size_t size,
+        VkInternalAllocationType,
+        VkSystemAllocationScope scope
+    ) {
+        static_cast<const CallbackData*>(ptr_user_data)->ptr_allocator
+            ->m_internal_usages[get_scope_index(scope)].add(size);
+    }
+
+    void VKAPI_CALL HostAllocator::internal_free_callback(
+        void* ptr_user_data,
+        size_t size,
+        VkInternalAllocationType,
+        VkSystemAllocationScope scope
+    ) {
+        static_cast<const CallbackData*>(ptr_user_data)->ptr_allocator
+            ->m_internal_usages[get_scope_index(scope)].remove(size);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "vk_tut/instance_transform.h"
+
+#include <utility>
+
+namespace vk::tut {
+    // Copy initializer list.
+    InstanceTransform::InstanceTransform(
+        const ::glm::vec3& position,
+        const float& scale,
+        const ::glm::vec4& rotation
+    ) : m_position_scale(position, scale), m_rotation(rotation) {}
+
+    // Copy constructor.
+    InstanceTransform::InstanceTransform(const InstanceTransform& from) :
+    m_position_scale(from.m_position_scale),
+    m_rotation(from.m_rotation) {}
+
+    // Move constructor.
+    InstanceTransform::InstanceTransform(InstanceTransform&& from) :
+    m_position_scale(::std::move(from.m_position_scale)),
+    m_rotation(::std::move(from.m_rotation)) {}
+
+    // Copy re-assignment.
+    InstanceTransform& InstanceTransform::operator= (
+        const InstanceTransform& from
+    ) {
+        m_position_scale = from.m_position_scale;
+        m_rotation = from.m_rotation;
+
+        return *this;
+    }
+
+    // Move re-assignment.
+    InstanceTransform& InstanceTransform::operator= (
+        InstanceTransform&& from
+    ) {
+        m_position_scale = ::std::move(from.m_position_scale);
+        m_rotation = ::std::move(from.m_rotation);
+
+        return *this;
+    }
+
+    // Copy setter for m_rotation.
+    void InstanceTransform::set_rotation(const ::glm::vec4& rotation) {
+        m_rotation = rotation;
+    }
+
+    VkVertexInputBindingDescription
+    InstanceTransform::get_binding_description() {
+        VkVertexInputBindingDescription description{};
+        description.binding = 1;
+        description.stride = sizeof(InstanceTransform);
+        description.inputRate = VkVertexInputRate
+            ::VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        return description;
+    }
+
+    std::array<VkVertexInputAttributeDescription, 2>
+    InstanceTransform::get_attribute_descriptions() {
+        std::array<VkVertexInputAttributeDescription, 2>
+        attribute_descriptions{};
+
+        // The position and scale, as in_position_scale.
+        attribute_descriptions[0].binding = 1;
+        attribute_descriptions[0].location = 3;
+        attribute_descriptions[0].format = VkFormat
+            ::VK_FORMAT_R32G32B32A32_SFLOAT;
+        attribute_descriptions[0].offset = offsetof(
+            InstanceTransform, m_position_scale
+        );
+
+        // The rotation quaternion, as in_rotation.
+        attribute_descriptions[1].binding = 1;
+        attribute_descriptions[1].location = 4;
+        attribute_descriptions[1].format = VkFormat
+            ::VK_FORMAT_R32G32B32A32_SFLOAT;
+        attribute_descriptions[1].offset = offsetof(
+            InstanceTransform, m_rotation
+        );
+
+        return attribute_descriptions;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,508 @@
+#include "vk_tut/job_system.h"
+#include "vk_tut/trace.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace vk::tut {
+    // The number of jobs each worker deque holds.
+    static constexpr size_t WORKER_DEQUE_CAPACITY = 4096;
+    // The number of failed attempts to find a job before a worker sleeps.
+    static constexpr uint32_t SPINS_BEFORE_SLEEP = 64;
+    // The number of jobs a worker trades with the shared pool at once.
+    // A worker keeps up to twice as many for itself.
+    static constexpr size_t JOB_POOL_BATCH_SIZE = 32;
+
+    // The job system the current thread is a worker of.
+    static thread_local const JobSystem* t_ptr_job_system = nullptr;
+    // The index of the current thread within t_ptr_job_system.
+    static thread_local uint32_t t_worker_index = 0;
+
+    // < --------------------------- JobCounter --------------------------- >
+
+    void JobCounter::increment(const uint32_t& count) {
+        m_value.fetch_add(count, ::std::memory_order_relaxed);
+    }
+
+    ::std::vector<Job*> JobCounter::decrement() {
+        // Not the last job. Nothing else to do.
+        uint32_t value = m_value.load(::std::memory_order_relaxed);
+        while (value > 1) {
+            if (m_value.compare_exchange_weak(value, value - 1,
+            ::std::memory_order_acq_rel, ::std::memory_order_relaxed)) {
+                return {};
+            }
+        }
+
+        // Possibly the last job. Reaching zero happens under the lock so
+        // that a waiter can not destroy the counter before it is released.
+        ::std::vector<Job*> continuations;
+        ::std::lock_guard<::std::mutex> lock(m_mutex);
+        if (m_value.fetch_sub(1, ::std::memory_order_acq_rel) == 1) {
+            continuations.swap(m_continuations);
+        }
+
+        return continuations;
+    }
+
+    void JobCounter::set_exception(const ::std::exception_ptr& exception) {
+        ::std::lock_guard<::std::mutex> lock(m_mutex);
+        if (m_exception == nullptr) m_exception = exception;
+    }
+
+    ::std::exception_ptr JobCounter::take_exception() {
+        ::std::lock_guard<::std::mutex> lock(m_mutex);
+        ::std::exception_ptr exception;
+        exception.swap(m_exception);
+        return exception;
+    }
+
+    // < ------------------------------ Job ------------------------------- >
+
+    // Copy initializer list constructor.
+    Job::Job(::std::function<void()>&& function, JobCounter* ptr_counter) :
+    m_function(::std::move(function)), m_ptr_counter(ptr_counter) {}
+
+    ::std::vector<Job*> Job::execute() {
+        // The counter is decremented either way, or its waiter would
+        // wait forever. The exception is handed to the waiter.
+        try {
+            m_function();
+        }
+        catch (...) {
+            if (m_ptr_counter != nullptr) {
+                m_ptr_counter->set_exception(::std::current_exception());
+            }
+        }
+        // Releases what the work captured now, not when reassigned.
+        m_function = nullptr;
+
+        if (m_ptr_counter == nullptr) return {};
+        return m_ptr_counter->decrement();
+    }
+
+    void Job::reassign(
+        ::std::function<void()>&& function, JobCounter* ptr_counter
+    ) {
+        m_function = ::std::move(function);
+        m_ptr_counter = ptr_counter;
+    }
+
+    // < ----------------------- WorkStealingDeque ------------------------ >
+
+    WorkStealingDeque::WorkStealingDeque(const size_t& capacity) {
+        size_t buffer_size = 1;
+        while (buffer_size < capacity) buffer_size <<= 1;
+
+        m_mask = static_cast<int64_t>(buffer_size) - 1;
+        m_buffer = ::std::make_unique<::std::atomic<Job*>[]>(buffer_size);
+    }
+
+    bool WorkStealingDeque::push(Job* ptr_job) {
+        const int64_t bottom = m_bottom.load(::std::memory_order_relaxed);
+        const int64_t top = m_top.load(::std::memory_order_acquire);
+        if (bottom - top > m_mask) return false;
+
+        // Publish the job before the new bottom.
+        m_buffer[bottom & m_mask].store(ptr_job, ::std::memory_order_release);
+        m_bottom.store(bottom + 1, ::std::memory_order_release);
+
+        return true;
+    }
+
+    Job* WorkStealingDeque::pop() {
+        const int64_t bottom = m_bottom.load(::std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, ::std::memory_order_relaxed);
+        // Order the bottom store before the top load against stealers.
+        ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+        int64_t top = m_top.load(::std::memory_order_relaxed);
+
+        if (top > bottom) {
+            // Empty.
+            m_bottom.store(bottom + 1, ::std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* ptr_job = m_buffer[bottom & m_mask].load(
+            ::std::memory_order_relaxed
+        );
+        if (top == bottom) {
+            // The last job. Race the stealers for it.
+            if (!m_top.compare_exchange_strong(top, top + 1,
+            ::std::memory_order_seq_cst, ::std::memory_order_relaxed)) {
+                ptr_job = nullptr;
+            }
+            m_bottom.store(bottom + 1, ::std::memory_order_relaxed);
+        }
+
+        return ptr_job;
+    }
+
+    Job* WorkStealingDeque::steal() {
+        int64_t top = m_top.load(::std::memory_order_acquire);
+        // Order the top load before the bottom load against the owner.
+        ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(::std::memory_order_acquire);
+        if (top >= bottom) return nullptr;
+
+        Job* ptr_job = m_buffer[top & m_mask].load(
+            ::std::memory_order_acquire
+        );
+        if (!m_top.compare_exchange_strong(top, top + 1,
+        ::std::memory_order_seq_cst, ::std::memory_order_relaxed)) {
+            return nullptr;
+        }
+
+        return ptr_job;
+    }
+
+    size_t WorkStealingDeque::get_size() const {
+        const int64_t bottom = m_bottom.load(::std::memory_order_relaxed);
+        const int64_t top = m_top.load(::std::memory_order_relaxed);
+
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    // < --------------------------- JobSystem ---------------------------- >
+
+    JobSystem::JobSystem(
+        const uint32_t& worker_count,
+        const bool& pin_threads
+    ) {
+        // hardware_concurrency() may be 0 when it is not known.
+        const uint32_t core_count = ::std::max(
+            ::std::thread::hardware_concurrency(), 2U
+        );
+        const uint32_t count = worker_count != 0 ?
+            worker_count : core_count - 1;
+
+        // Every deque exists before any worker may steal from it.
+        m_deques.emplace_back(nullptr);
+        for (uint32_t i = 1; i <= count; i++) {
+            m_deques.emplace_back(
+                ::std::make_unique<WorkStealingDeque>(WORKER_DEQUE_CAPACITY)
+            );
+        }
+        // Worker pools never grow past what they are reserved for.
+        m_worker_job_pools.resize(count + 1);
+        for (uint32_t i = 1; i <= count; i++) {
+            m_worker_job_pools[i].free_jobs.reserve(2 * JOB_POOL_BATCH_SIZE);
+        }
+
+        m_workers.reserve(count);
+        for (uint32_t i = 1; i <= count; i++) {
+            m_workers.emplace_back(&JobSystem::worker_main, this, i);
+
+            if (!pin_threads) continue;
+#if defined(__linux__)
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(i % core_count, &cpu_set);
+            pthread_setaffinity_np(
+                m_workers.back().native_handle(), sizeof(cpu_set), &cpu_set
+            );
+#elif defined(_WIN32)
+            SetThreadAffinityMask(
+                m_workers.back().native_handle(),
+                DWORD_PTR(1) << (i % core_count)
+            );
+#endif
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_stop.store(true, ::std::memory_order_release);
+        }
+        m_wake.notify_all();
+
+        for (::std::thread& worker : m_workers) {
+            worker.join();
+        }
+
+        // m_jobs frees every job, including the continuations
+        // still waiting on a counter.
+        m_free_jobs.clear();
+        m_worker_job_pools.clear();
+    }
+
+    void JobSystem::run(
+        ::std::function<void()>&& function,
+        JobCounter* ptr_counter
+    ) {
+        if (ptr_counter != nullptr) ptr_counter->increment(1);
+
+        schedule(acquire_job(::std::move(function), ptr_counter));
+    }
+
+    void JobSystem::run_after(
+        JobCounter& dependency,
+        ::std::function<void()>&& function,
+        JobCounter* ptr_counter
+    ) {
+        if (ptr_counter != nullptr) ptr_counter->increment(1);
+
+        Job* ptr_job = acquire_job(::std::move(function), ptr_counter);
+        {
+            // The dependency can not reach zero while this is held
+            // without its continuations being handed over after.
+            ::std::lock_guard<::std::mutex> lock(dependency.m_mutex);
+            if (dependency.get_value() != 0) {
+                dependency.m_continuations.emplace_back(ptr_job);
+                return;
+            }
+        }
+
+        schedule(ptr_job);
+    }
+
+    void JobSystem::wait(JobCounter& counter) {
+        uint32_t spins = 0;
+        while (counter.get_value() != 0) {
+            Job* ptr_job = take_job();
+            if (ptr_job != nullptr) {
+                execute(ptr_job);
+                spins = 0;
+            }
+            else if (++spins > SPINS_BEFORE_SLEEP) {
+                ::std::this_thread::yield();
+            }
+        }
+
+        // Waits for the thread that reached zero to let go of the
+        // counter, then hands over what its jobs threw.
+        ::std::exception_ptr exception = counter.take_exception();
+        if (exception != nullptr) ::std::rethrow_exception(exception);
+    }
+
+    void JobSystem::parallel_for(
+        const size_t& count,
+        const size_t& grain_size,
+        const ::std::function<void(size_t, size_t)>& body
+    ) {
+        const size_t grain = ::std::max<size_t>(grain_size, 1);
+        if (count <= grain) {
+            if (count != 0) body(0, count);
+            return;
+        }
+
+        // The jobs capture a pointer to this and their first index
+        // only, small enough for ::std::function to store in place.
+        struct Range {
+            // The body of the loop.
+            const ::std::function<void(size_t, size_t)>* ptr_body;
+            // The size of a range.
+            size_t grain;
+            // The end of the last range.
+            size_t count;
+        } range{&body, grain, count};
+
+        JobCounter counter;
+        // The calling thread takes the first range itself.
+        for (size_t begin = grain; begin < count; begin += grain) {
+            run([ptr_range = &range, begin]() {
+                (*ptr_range->ptr_body)(begin, ::std::min(
+                    begin + ptr_range->grain, ptr_range->count
+                ));
+            }, &counter);
+        }
+        // The other ranges refer to range and counter, so they are waited
+        // for even if this one throws.
+        try {
+            body(0, grain);
+        }
+        catch (...) {
+            counter.set_exception(::std::current_exception());
+        }
+
+        wait(counter);
+    }
+
+    uint32_t JobSystem::get_current_thread_index() const {
+        return t_ptr_job_system == this ? t_worker_index : 0;
+    }
+
+    void JobSystem::worker_main(const uint32_t& worker_index) {
+        t_ptr_job_system = this;
+        t_worker_index = worker_index;
+        VK_TUT_TRACE_THREAD_NAME("worker " + ::std::to_string(worker_index));
+
+        uint32_t spins = 0;
+        while (true) {
+            Job* ptr_job = take_job();
+            if (ptr_job != nullptr) {
+                execute(ptr_job);
+                spins = 0;
+                continue;
+            }
+            if (++spins < SPINS_BEFORE_SLEEP) {
+                ::std::this_thread::yield();
+                continue;
+            }
+
+            // Sleep until there is something to take. The sleeper is
+            // counted before the queue is checked, and schedule() counts
+            // the job before it checks for sleepers, so either this sees
+            // the job or schedule() sees this and wakes it.
+            ::std::unique_lock<::std::mutex> lock(m_mutex);
+            m_sleeping_worker_count.fetch_add(1, ::std::memory_order_seq_cst);
+            m_wake.wait(lock, [this]() {
+                return m_stop.load(::std::memory_order_acquire) ||
+                    m_queued_job_count.load(::std::memory_order_seq_cst) != 0;
+            });
+            m_sleeping_worker_count.fetch_sub(1, ::std::memory_order_relaxed);
+            // Only exit once every queued job was taken.
+            if (m_stop.load(::std::memory_order_acquire) &&
+            m_queued_job_count.load(::std::memory_order_acquire) == 0) {
+                return;
+            }
+            spins = 0;
+        }
+    }
+
+    void JobSystem::schedule(Job* ptr_job) {
+        m_queued_job_count.fetch_add(1, ::std::memory_order_seq_cst);
+
+        const uint32_t worker_index = get_current_thread_index();
+        if (worker_index == 0 || !m_deques[worker_index]->push(ptr_job)) {
+            ::std::lock_guard<::std::mutex> lock(m_injected_mutex);
+            m_injected_jobs.emplace_back(ptr_job);
+            m_injected_job_count.fetch_add(1, ::std::memory_order_release);
+        }
+
+        // Only wake a worker if one sleeps. Locking pairs with the
+        // predicate check of a worker about to sleep.
+        if (m_sleeping_worker_count.load(::std::memory_order_seq_cst) != 0) {
+            { ::std::lock_guard<::std::mutex> lock(m_mutex); }
+            m_wake.notify_one();
+        }
+    }
+
+    Job* JobSystem::take_job() {
+        if (m_queued_job_count.load(::std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+
+        Job* ptr_job = nullptr;
+
+        // Own jobs first, newest first for cache locality.
+        const uint32_t worker_index = get_current_thread_index();
+        if (worker_index != 0) ptr_job = m_deques[worker_index]->pop();
+
+        // Then the jobs scheduled from outside.
+        if (ptr_job == nullptr &&
+        m_injected_job_count.load(::std::memory_order_acquire) != 0) {
+            ::std::lock_guard<::std::mutex> lock(m_injected_mutex);
+            if (m_injected_head < m_injected_jobs.size()) {
+                ptr_job = m_injected_jobs[m_injected_head++];
+                m_injected_job_count.fetch_sub(
+                    1, ::std::memory_order_relaxed
+                );
+                // Rewinds once empty, so the vector never grows
+                // past the most jobs queued at once.
+                if (m_injected_head == m_injected_jobs.size()) {
+                    m_injected_jobs.clear();
+                    m_injected_head = 0;
+                }
+            }
+        }
+
+        // Then steal the oldest job of another worker.
+        for (size_t i = 1; ptr_job == nullptr && i < m_deques.size(); i++) {
+            const size_t victim = (worker_index + i) % m_deques.size();
+            if (victim == 0 || victim == worker_index) continue;
+            ptr_job = m_deques[victim]->steal();
+        }
+
+        if (ptr_job != nullptr) {
+            m_queued_job_count.fetch_sub(1, ::std::memory_order_acq_rel);
+        }
+
+        return ptr_job;
+    }
+
+    void JobSystem::execute(Job* ptr_job) {
+        ::std::vector<Job*> continuations = ptr_job->execute();
+        release_job(ptr_job);
+
+        for (Job* ptr_continuation : continuations) {
+            schedule(ptr_continuation);
+        }
+    }
+
+    Job* JobSystem::acquire_job(
+        ::std::function<void()>&& function, JobCounter* ptr_counter
+    ) {
+        Job* ptr_job = nullptr;
+
+        const uint32_t worker_index = get_current_thread_index();
+        if (worker_index != 0) {
+            // Own jobs first. Refill them with a batch of shared ones.
+            ::std::vector<Job*>& free_jobs =
+                m_worker_job_pools[worker_index].free_jobs;
+            if (free_jobs.empty()) {
+                ::std::lock_guard<::std::mutex> lock(m_free_jobs_mutex);
+                const size_t count = ::std::min(
+                    m_free_jobs.size(), JOB_POOL_BATCH_SIZE
+                );
+                free_jobs.insert(
+                    free_jobs.end(), m_free_jobs.end() - count,
+                    m_free_jobs.end()
+                );
+                m_free_jobs.resize(m_free_jobs.size() - count);
+            }
+            if (!free_jobs.empty()) {
+                ptr_job = free_jobs.back();
+                free_jobs.pop_back();
+            }
+        }
+        else {
+            ::std::lock_guard<::std::mutex> lock(m_free_jobs_mutex);
+            if (!m_free_jobs.empty()) {
+                ptr_job = m_free_jobs.back();
+                m_free_jobs.pop_back();
+            }
+        }
+
+        if (ptr_job != nullptr) {
+            ptr_job->reassign(::std::move(function), ptr_counter);
+            return ptr_job;
+        }
+
+        ::std::lock_guard<::std::mutex> lock(m_free_jobs_mutex);
+        m_jobs.emplace_back(
+            ::std::make_unique<Job>(::std::move(function), ptr_counter)
+        );
+        return m_jobs.back().get();
+    }
+
+    void JobSystem::release_job(Job* ptr_job) {
+        const uint32_t worker_index = get_current_thread_index();
+        if (worker_index == 0) {
+            ::std::lock_guard<::std::mutex> lock(m_free_jobs_mutex);
+            m_free_jobs.emplace_back(ptr_job);
+            return;
+        }
+
+        // Keep the job, and share a batch once there are too many, so
+        // that the threads scheduling from outside get them back.
+        ::std::vector<Job*>& free_jobs =
+            m_worker_job_pools[worker_index].free_jobs;
+        if (free_jobs.size() == 2 * JOB_POOL_BATCH_SIZE) {
+            ::std::lock_guard<::std::mutex> lock(m_free_jobs_mutex);
+            m_free_jobs.insert(
+                m_free_jobs.end(), free_jobs.end() - JOB_POOL_BATCH_SIZE,
+                free_jobs.end()
+            );
+            free_jobs.resize(free_jobs.size() - JOB_POOL_BATCH_SIZE);
+        }
+        free_jobs.emplace_back(ptr_job);
+    }
+}
\ No newline at end of file
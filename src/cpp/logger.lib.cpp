@@ -0,0 +1,281 @@
+#include "vk_tut/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace vk::tut {
+    // How long the background thread sleeps between writing messages.
+    static const auto DRAIN_PERIOD = ::std::chrono::milliseconds(2);
+
+    // Owns the ring of the current thread with the logger, and marks it
+    // orphaned when the thread exits so the logger can release it.
+    struct ThreadLogRing {
+        // The ring of the thread, or nullptr before the thread logs.
+        ::std::shared_ptr<LogRing> ptr_ring;
+
+        // Marks the ring orphaned.
+        inline ~ThreadLogRing() {
+            if (ptr_ring != nullptr) ptr_ring->set_orphaned();
+        }
+    };
+    // The ring of the current thread.
+    static thread_local ThreadLogRing t_thread_log_ring;
+
+    // Writes a message the way the log macros always have.
+    static void write_record(const LogRecord& record) {
+        ::std::ostream& stream = *record.ptr_stream;
+        stream << record.colour_code << "[" << record.level_name
+            << "]\033[0m\t";
+        stream.write(record.text, record.length);
+        stream << " " << record.colour_code << "[line " << record.line
+            << " of " << record.file_name << "]\033[0m\n";
+    }
+
+    // Adds a stream to a set of streams, kept as a vector.
+    static void add_stream(
+        ::std::vector<::std::ostream*>& ref_streams, ::std::ostream* ptr_stream
+    ) {
+        if (::std::find(ref_streams.begin(), ref_streams.end(), ptr_stream) ==
+        ref_streams.end()) {
+            ref_streams.push_back(ptr_stream);
+        }
+    }
+
+    // < ----------------------------- LogRing ---------------------------- >
+
+    // Creates an empty ring. The capacity is a power of 2.
+    LogRing::LogRing(const uint32_t& capacity) : m_records(capacity) {}
+
+    bool LogRing::try_push(const LogRecord& record) {
+        const uint32_t write_count =
+            m_write_count.load(::std::memory_order_relaxed);
+        const uint32_t read_count =
+            m_read_count.load(::std::memory_order_acquire);
+        if (write_count - read_count == m_records.size()) return false;
+
+        // Only the characters in use are copied.
+        LogRecord& slot = m_records[write_count & (m_records.size() - 1)];
+        slot.sequence = record.sequence;
+        slot.level = record.level;
+        slot.level_name = record.level_name;
+        slot.colour_code = record.colour_code;
+        slot.file_name = record.file_name;
+        slot.line = record.line;
+        slot.length = record.length;
+        slot.ptr_stream = record.ptr_stream;
+        ::std::memcpy(slot.text, record.text, record.length);
+
+        // Publishes the message to the draining thread.
+        m_write_count.store(write_count + 1, ::std::memory_order_release);
+        return true;
+    }
+
+    const LogRecord* LogRing::peek() const {
+        const uint32_t read_count =
+            m_read_count.load(::std::memory_order_relaxed);
+        if (read_count == m_write_count.load(::std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &m_records[read_count & (m_records.size() - 1)];
+    }
+
+    void LogRing::pop() {
+        // Hands the slot back to the owning thread.
+        m_read_count.store(
+            m_read_count.load(::std::memory_order_relaxed) + 1,
+            ::std::memory_order_release
+        );
+    }
+
+    // < ----------------------------- Logger ----------------------------- >
+
+    // Starts the background thread.
+    Logger::Logger() {
+        const char* level_name = ::std::getenv("VK_TUT_LOG_LEVEL");
+        if (level_name != nullptr) {
+            m_level.store(get_log_level(level_name));
+        }
+
+        m_drain_thread = ::std::thread(&Logger::run_drain_loop, this);
+    }
+
+    // Writes the pending messages and stops the background thread.
+    Logger::~Logger() {
+        {
+            ::std::lock_guard<::std::mutex> lock(m_stop_mutex);
+            m_is_stopping = true;
+        }
+        m_stop_condition.notify_one();
+        m_drain_thread.join();
+
+        flush();
+    }
+
+    Logger& Logger::get_instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    void Logger::set_level(const LogLevel& level) {
+        m_level.store(level, ::std::memory_order_relaxed);
+    }
+
+    void Logger::submit(LogRecord& ref_record) {
+        ref_record.sequence =
+            m_next_sequence.fetch_add(1, ::std::memory_order_relaxed);
+
+        LogRing& ring = get_thread_ring();
+        const bool is_error = ref_record.level == LogLevel::ERROR;
+        if (!ring.try_push(ref_record)) {
+            if (!is_error) {
+                ring.count_dropped();
+                return;
+            }
+            // Errors are never dropped. Emptying the ring makes room.
+            flush();
+            ring.try_push(ref_record);
+        }
+
+        // The error is written before the throw that follows it.
+        if (is_error) flush();
+    }
+
+    void Logger::flush() {
+        ::std::lock_guard<::std::mutex> lock(m_drain_mutex);
+        drain();
+    }
+
+    LogRing& Logger::get_thread_ring() {
+        if (t_thread_log_ring.ptr_ring != nullptr) {
+            return *t_thread_log_ring.ptr_ring;
+        }
+
+        // Only locked once per thread.
+        ::std::lock_guard<::std::mutex> lock(m_rings_mutex);
+        t_thread_log_ring.ptr_ring =
+            ::std::make_shared<LogRing>(RECORDS_PER_THREAD);
+        m_rings.push_back(t_thread_log_ring.ptr_ring);
+        return *t_thread_log_ring.ptr_ring;
+    }
+
+    void Logger::drain() {
+        {
+            ::std::lock_guard<::std::mutex> lock(m_rings_mutex);
+            m_drained_rings.assign(m_rings.begin(), m_rings.end());
+        }
+
+        // Messages numbered later are left for the next drain,
+        // so a thread that keeps logging can't keep this one busy.
+        const uint64_t end_sequence =
+            m_next_sequence.load(::std::memory_order_relaxed);
+        while (true) {
+            // Merges the rings by writing the oldest message first.
+            LogRing* ptr_oldest_ring = nullptr;
+            const LogRecord* ptr_oldest_record = nullptr;
+            for (const ::std::shared_ptr<LogRing>& ptr_ring :
+            m_drained_rings) {
+                const LogRecord* ptr_record = ptr_ring->peek();
+                if (ptr_record != nullptr &&
+                ptr_record->sequence < end_sequence &&
+                (ptr_oldest_record == nullptr ||
+                ptr_record->sequence < ptr_oldest_record->sequence)) {
+                    ptr_oldest_ring = ptr_ring.get();
+                    ptr_oldest_record = ptr_record;
+                }
+            }
+            if (ptr_oldest_record == nullptr) break;
+
+            write_record(*ptr_oldest_record);
+            add_stream(m_written_streams, ptr_oldest_record->ptr_stream);
+            ptr_oldest_ring->pop();
+        }
+
+        for (const ::std::shared_ptr<LogRing>& ptr_ring : m_drained_rings) {
+            const uint32_t dropped_count = ptr_ring->take_dropped_count();
+            if (dropped_count > 0) {
+                m_dropped_count.fetch_add(
+                    dropped_count, ::std::memory_order_relaxed
+                );
+                ::std::cerr << "[" << dropped_count
+                    << " log messages dropped]\n";
+                add_stream(m_written_streams, &::std::cerr);
+            }
+        }
+
+        // Once per drain instead of once per message.
+        for (::std::ostream* ptr_stream : m_written_streams) {
+            ptr_stream->flush();
+        }
+        m_written_streams.clear();
+        m_drained_rings.clear();
+
+        // An orphaned ring gets no more messages, so once it is empty
+        // it is done with.
+        ::std::lock_guard<::std::mutex> lock(m_rings_mutex);
+        ::std::erase_if(m_rings,
+            [](const ::std::shared_ptr<LogRing>& ptr_ring) {
+                return ptr_ring->is_orphaned() && ptr_ring->peek() == nullptr;
+            }
+        );
+    }
+
+    void Logger::run_drain_loop() {
+        ::std::unique_lock<::std::mutex> lock(m_stop_mutex);
+        while (!m_is_stopping) {
+            m_stop_condition.wait_for(lock, DRAIN_PERIOD, [this] {
+                return m_is_stopping;
+            });
+
+            // Writes without holding m_stop_mutex.
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    // < --------------------------- LogMessage --------------------------- >
+
+    // Starts an empty message.
+    LogMessage::LogMessage(
+        const LogLevel& level,
+        const char* level_name,
+        const char* colour_code,
+        const char* file_name,
+        const uint32_t& line,
+        ::std::ostream& ref_output_stream
+    ) : m_buffer(m_record.text, LogRecord::TEXT_CAPACITY),
+    m_stream(&m_buffer) {
+        m_record.level = level;
+        m_record.level_name = level_name;
+        m_record.colour_code = colour_code;
+        m_record.file_name = file_name;
+        m_record.line = line;
+        m_record.ptr_stream = &ref_output_stream;
+    }
+
+    void LogMessage::submit() {
+        m_record.length = m_buffer.get_length();
+        if (m_buffer.is_truncated()) {
+            ::std::memcpy(m_record.text + m_record.length - 3, "...", 3);
+        }
+
+        Logger::get_instance().submit(m_record);
+    }
+
+    // Writes into the text.
+    LogMessage::TextBuffer::TextBuffer(
+        char* ptr_text, const uint32_t& capacity
+    ) {
+        setp(ptr_text, ptr_text + capacity);
+    }
+
+    LogMessage::TextBuffer::int_type LogMessage::TextBuffer::overflow(
+        int_type
+    ) {
+        m_is_truncated = true;
+        return traits_type::eof();
+    }
+}
\ No newline at end of file
@@ -1,14 +1,147 @@
 #include "vk_tut/application.h"
 #include "vk_tut/logging.h"
 
+#include <cstdlib>
 #include <iostream>
 #include <exception>
+#include <limits>
+#include <string>
+#include <string_view>
+
+// Parses the value of a size option as a positive integer.
+// Anything else is a usage error.
+static uint32_t parse_extent(const char* option, const char* value) {
+    char* end = nullptr;
+    const unsigned long extent = ::std::strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || value[0] == '-' || extent == 0 ||
+    extent > ::std::numeric_limits<uint32_t>::max()) {
+        VK_TUT_LOG_ERROR("Usage: " + ::std::string(option) +
+            " <positive integer>, got \"" + value + "\".");
+    }
+
+    return static_cast<uint32_t>(extent);
+}
 
 // Executable entry point.
 int main(int argc, char** argv) {
     try {
+        // Apply the command line options.
+        ::vk::tut::ApplicationConfig config;
+        // The synthetic scene to draw instead of the default meshes.
+        ::vk::tut::SceneGenerator::Parameters scene_parameters;
+        bool load_scene = false;
+        for (int i = 1; i < argc; i++) {
+            if (::std::string_view(argv[i]) == "--depth-prepass") {
+                config.set_depth_prepass(true);
+            }
+            else if (::std::string_view(argv[i]) == "--msaa" &&
+            i + 1 < argc) {
+                config.set_msaa_sample_count(static_cast<uint32_t>(
+                    ::std::strtoul(argv[++i], nullptr, 10)
+                ));
+            }
+            else if (::std::string_view(argv[i]) == "--headless") {
+                config.set_headless(true);
+            }
+            else if (::std::string_view(argv[i]) == "--frames" &&
+            i + 1 < argc) {
+                config.set_frame_count(static_cast<uint32_t>(
+                    ::std::strtoul(argv[++i], nullptr, 10)
+                ));
+            }
+            else if (::std::string_view(argv[i]) == "--readback" &&
+            i + 1 < argc) {
+                config.set_readback_directory(argv[++i]);
+            }
+            else if (::std::string_view(argv[i]) == "--trace" &&
+            i + 1 < argc) {
+                config.set_trace_path(argv[++i]);
+            }
+            else if (::std::string_view(argv[i]) == "--stats" &&
+            i + 1 < argc) {
+                config.set_statistics_path(argv[++i]);
+            }
+            else if (::std::string_view(argv[i]) == "--pipeline-stats") {
+                config.set_pipeline_statistics(true);
+            }
+            else if (::std::string_view(argv[i]) == "--debug-draw") {
+                config.set_debug_draw(true);
+            }
+            else if (::std::string_view(argv[i]) == "--hitch-ms" &&
+            i + 1 < argc) {
+                config.set_hitch_threshold_ms(
+                    ::std::strtof(argv[++i], nullptr)
+                );
+            }
+            else if (::std::string_view(argv[i]) == "--device" &&
+            i + 1 < argc) {
+                config.set_device_name(argv[++i]);
+            }
+            else if (::std::string_view(argv[i]) == "--triangles" &&
+            i + 1 < argc) {
+                config.set_mesh_triangle_count(static_cast<uint32_t>(
+                    ::std::strtoul(argv[++i], nullptr, 10)
+                ));
+            }
+            else if (::std::string_view(argv[i]) == "--scene-objects" &&
+            i + 1 < argc) {
+                scene_parameters.object_count = static_cast<uint32_t>(
+                    ::std::strtoul(argv[++i], nullptr, 10)
+                );
+                load_scene = true;
+            }
+            else if (::std::string_view(argv[i]) == "--scene-meshes" &&
+            i + 1 < argc) {
+                scene_parameters.mesh_count = static_cast<uint32_t>(
+                    ::std::strtoul(argv[++i], nullptr, 10)
+                );
+                load_scene = true;
+            }
+            else if (::std::string_view(argv[i]) == "--scene-instances" &&
+            i + 1 < argc) {
+                scene_parameters.instances_per_draw = static_cast<uint32_t>(
+                    ::std::strtoul(argv[++i], nullptr, 10)
+                );
+                load_scene = true;
+            }
+            else if (::std::string_view(argv[i]) == "--scene-textures" &&
+            i + 1 < argc) {
+                scene_parameters.texture_count = static_cast<uint32_t>(
+                    ::std::strtoul(argv[++i], nullptr, 10)
+                );
+                load_scene = true;
+            }
+            else if (::std::string_view(argv[i]) == "--scene-static") {
+                scene_parameters.animated = false;
+                load_scene = true;
+            }
+            else if (::std::string_view(argv[i]) == "--log-level" &&
+            i + 1 < argc) {
+                ::vk::tut::Logger::get_instance().set_level(
+                    ::vk::tut::get_log_level(argv[++i])
+                );
+            }
+            else if (::std::string_view(argv[i]) == "--width" &&
+            i + 1 < argc) {
+                config.set_headless_width(
+                    parse_extent(argv[i], argv[i + 1])
+                );
+                i++;
+            }
+            else if (::std::string_view(argv[i]) == "--height" &&
+            i + 1 < argc) {
+                config.set_headless_height(
+                    parse_extent(argv[i], argv[i + 1])
+                );
+                i++;
+            }
+        }
+
         VK_TUT_LOG_TRACE("Creating Application Instance.");
-        ::vk::tut::Application app;
+        ::vk::tut::Application app(config);
+        if (load_scene) {
+            app.load_scene(scene_parameters);
+        }
         app.run();
     }
     catch(const ::std::exception& ex) {
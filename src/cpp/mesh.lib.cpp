@@ -0,0 +1,170 @@
+#include "vk_tut/mesh.h"
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace vk::tut {
+    void generate_colour_wheel_mesh(
+        const uint32_t& triangle_count,
+        ::std::vector<Vertex>& ref_vertices,
+        ::std::vector<uint32_t>& ref_indices
+    ) {
+        if (triangle_count == 0) return;
+
+        const uint32_t vertices_count = triangle_count + 1;
+        const uint32_t first_vertex =
+            static_cast<uint32_t>(ref_vertices.size());
+
+        ref_vertices.reserve(ref_vertices.size() + vertices_count);
+        // Define the origin.
+        ref_vertices.emplace_back(
+            Vertex({0.00f, 0.00f, -0.40f}, {0.00f, 0.00f, 0.00f}, {})
+        );
+
+        for (uint32_t i = 1; i < vertices_count; i++) {
+            const float angle = i * ::glm::radians(360.0f) / vertices_count;
+            ref_vertices.emplace_back(
+                Vertex(
+                    {
+                        0.50f * ::glm::cos(angle),
+                        0.50f * ::glm::sin(angle),
+                        -0.40f
+                    },
+                    {
+                        1.00f * ::glm::cos(
+                            angle + ::glm::radians(0.0f)
+                        ) + 1.00f,
+                        1.00f * ::glm::cos(
+                            angle + ::glm::radians(120.0f)
+                        ) + 1.00f,
+                        1.00f * ::glm::cos(
+                            angle + ::glm::radians(240.0f)
+                        ) + 1.00f
+                    },
+                    {
+                        1.0f * ::glm::cos(angle),
+                        1.0f * ::glm::sin(angle)
+                    }
+                )
+            );
+        }
+
+        const uint32_t index_count = triangle_count * 3;
+        ref_indices.reserve(ref_indices.size() + index_count);
+        for (uint32_t i = 0; i < index_count - 1; i++) {
+            if (i % 3 == 0) {
+                ref_indices.emplace_back(first_vertex);
+                continue;
+            }
+
+            ref_indices.emplace_back(first_vertex + (i + 1) / 3);
+        }
+
+        ref_indices.emplace_back(first_vertex + 1);
+    }
+
+    void generate_cube_mesh(
+        ::std::vector<Vertex>& ref_vertices,
+        ::std::vector<uint32_t>& ref_indices
+    ) {
+        const uint32_t first_vertex =
+            static_cast<uint32_t>(ref_vertices.size());
+
+        // The normal of each face, and two axes spanning it whose
+        // cross product is the normal, so the faces wind the same way.
+        const ::glm::vec3 normals[] = {
+            {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
+            {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}
+        };
+        const ::glm::vec3 u_axes[] = {
+            {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}
+        };
+
+        ref_vertices.reserve(ref_vertices.size() + 24);
+        ref_indices.reserve(ref_indices.size() + 36);
+        for (uint32_t face = 0; face < 6; face++) {
+            const ::glm::vec3& normal = normals[face];
+            const ::glm::vec3& u_axis = u_axes[face];
+            const ::glm::vec3 v_axis = ::glm::cross(normal, u_axis);
+            const ::glm::vec3 colour = 0.5f * normal + 0.5f;
+            const uint32_t face_vertex = first_vertex + face * 4;
+
+            for (uint32_t corner = 0; corner < 4; corner++) {
+                const float u = (corner & 1) ? 1.0f : 0.0f;
+                const float v = (corner & 2) ? 1.0f : 0.0f;
+                ref_vertices.emplace_back(
+                    Vertex(
+                        0.5f * normal + (u - 0.5f) * u_axis +
+                            (v - 0.5f) * v_axis,
+                        colour,
+                        {u, v}
+                    )
+                );
+            }
+
+            ref_indices.emplace_back(face_vertex);
+            ref_indices.emplace_back(face_vertex + 1);
+            ref_indices.emplace_back(face_vertex + 2);
+            ref_indices.emplace_back(face_vertex + 2);
+            ref_indices.emplace_back(face_vertex + 1);
+            ref_indices.emplace_back(face_vertex + 3);
+        }
+    }
+
+    void generate_sphere_mesh(
+        const uint32_t& segment_count,
+        ::std::vector<Vertex>& ref_vertices,
+        ::std::vector<uint32_t>& ref_indices
+    ) {
+        if (segment_count < 3) return;
+
+        const uint32_t ring_count = ::glm::max(segment_count / 2, 2U);
+        const uint32_t first_vertex =
+            static_cast<uint32_t>(ref_vertices.size());
+        // Each ring repeats its first vertex at its end, where the
+        // texture coordinates wrap around.
+        const uint32_t ring_vertex_count = segment_count + 1;
+
+        ref_vertices.reserve(
+            ref_vertices.size() + (ring_count + 1) * ring_vertex_count
+        );
+        for (uint32_t ring = 0; ring <= ring_count; ring++) {
+            const float v = static_cast<float>(ring) / ring_count;
+            const float polar_angle = v * ::glm::radians(180.0f);
+            for (uint32_t segment = 0; segment <= segment_count; segment++) {
+                const float u = static_cast<float>(segment) / segment_count;
+                const float azimuth = u * ::glm::radians(360.0f);
+                const ::glm::vec3 normal = {
+                    ::glm::sin(polar_angle) * ::glm::cos(azimuth),
+                    ::glm::sin(polar_angle) * ::glm::sin(azimuth),
+                    ::glm::cos(polar_angle)
+                };
+                ref_vertices.emplace_back(
+                    Vertex(0.5f * normal, 0.5f * normal + 0.5f, {u, v})
+                );
+            }
+        }
+
+        ref_indices.reserve(
+            ref_indices.size() + ring_count * segment_count * 6
+        );
+        for (uint32_t ring = 0; ring < ring_count; ring++) {
+            const uint32_t ring_vertex =
+                first_vertex + ring * ring_vertex_count;
+            for (uint32_t segment = 0; segment < segment_count; segment++) {
+                const uint32_t top = ring_vertex + segment;
+                const uint32_t bottom = top + ring_vertex_count;
+
+                ref_indices.emplace_back(top);
+                ref_indices.emplace_back(bottom);
+                ref_indices.emplace_back(top + 1);
+                ref_indices.emplace_back(top + 1);
+                ref_indices.emplace_back(bottom);
+                ref_indices.emplace_back(bottom + 1);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -1,66 +1,26 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
+#include "vk_tut/mesh.h"
 
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
 
 namespace vk::tut {
     void Application::load_initial_mesh() {
-        // For now, simply create colour wheel circle.
+        VK_TUT_TRACE_SCOPE("load_initial_mesh");
 
-        // Define the number of triangles to be drawn.
-        const uint32_t triangle_count = 1000;
-        const uint32_t vertices_count = triangle_count + 1;
-
-        m_vertices.reserve(vertices_count);
-        // Define the origin.
-        m_vertices.emplace_back(
-            Vertex({0.00f, 0.00f, -0.40f}, {0.00f, 0.00f, 0.00f}, {})
+        // For now, simply create colour wheel circle,
+        // made of as many triangles as configured.
+        generate_colour_wheel_mesh(
+            m_config.get_mesh_triangle_count(), m_vertices, m_indices
         );
-        
-        for (uint32_t i = 1; i < vertices_count; i++) {
-            m_vertices.emplace_back(
-                Vertex(
-                    {
-                        0.50f * ::glm::cos(i * ::glm::radians(360.0f) / vertices_count),
-                        0.50f * ::glm::sin(i * ::glm::radians(360.0f) / vertices_count),
-                        -0.40f
-                    },
-                    {
-                        1.00f * ::glm::cos(
-                            (i * ::glm::radians(360.0f) / vertices_count) +
-                            ::glm::radians(0.0f)
-                        ) + 1.00f,
-                        1.00f * ::glm::cos(
-                            (i * ::glm::radians(360.0f) / vertices_count) +
-                            ::glm::radians(120.0f)
-                        ) + 1.00f,
-                        1.00f * ::glm::cos(
-                            (i * ::glm::radians(360.0f) / vertices_count) +
-                            ::glm::radians(240.0f)
-                        ) + 1.00f
-                    }, 
-                    {
-                        1.0f * ::glm::cos(i * ::glm::radians(360.0f) / vertices_count),
-                        1.0f * ::glm::sin(i * ::glm::radians(360.0f) / vertices_count)
-                    }
-                )
-            );
-        }
 
-        m_indices.reserve(triangle_count * 3);
-        for (int i = 0; i < m_indices.capacity() - 1; i++) {
-            if (i % 3 == 0) {
-                m_indices.emplace_back(0U);
-                continue;
-            }
-            
-            m_indices.emplace_back(
-                static_cast<uint32_t>((i + 1) / 3)
-            );
-        }
-
-        m_indices.emplace_back(1);
+        m_draw_commands.emplace_back(
+            static_cast<uint32_t>(m_indices.size()), 0, 0, m_texture_index
+        );
+        // Drawn once, where the mesh was made.
+        m_instances.emplace_back();
     }
 
     void Application::load_square_mesh() {
@@ -76,6 +36,8 @@ namespace vk::tut {
         m_indices.reserve(new_indices_capacity);
 
         ::glm::vec3 square_colour = { 0.98f, 0.32f, 0.93f };
+        // The square indices follow after the existing ones.
+        const uint32_t first_index = static_cast<uint32_t>(m_indices.size());
 
         m_vertices.emplace_back(
             Vertex(
@@ -113,8 +75,75 @@ namespace vk::tut {
         m_indices.emplace_back(new_vertices_capacity - 1);
         m_indices.emplace_back(new_vertices_capacity - 2);
 
-        // Reload the mesh buffers.
+        m_draw_commands.emplace_back(6, first_index, 0, m_texture_index);
+
+        // Reload the mesh buffers. The frames in flight may still read
+        // the current one, so it is destroyed once they are done.
+        VkDevice logical_device = m_logical_device;
+        VkBuffer old_mesh_buffer = m_mesh_buffer;
+        VkDeviceMemory old_mesh_buffer_memory = m_mesh_buffer_memory;
+        m_resource_state_tracker.forget_buffer(old_mesh_buffer);
+        m_deletion_queue.enqueue(m_frame_counter, [=]() {
+            vkFreeMemory(logical_device, old_mesh_buffer_memory,
+                get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+            vkDestroyBuffer(logical_device, old_mesh_buffer,
+                get_allocation_callbacks(VK_OBJECT_TYPE_BUFFER));
+        });
+        create_mesh_buffer();
+
+        // The cached command buffers draw the old mesh.
+        invalidate_cached_command_buffers();
+    }
+
+    void Application::load_scene(
+        const SceneGenerator::Parameters& parameters
+    ) {
+        VK_TUT_TRACE_SCOPE("load_scene");
+
+        // The frames in flight draw the buffers and textures replaced.
+        wait_for_frames_in_flight();
+
+        m_ptr_scene_generator = ::std::make_unique<SceneGenerator>(parameters);
+        destroy_scene_textures();
+        create_scene_textures();
+
+        m_vertices.clear();
+        m_indices.clear();
+        m_draw_commands.clear();
+        m_instances.clear();
+        m_ptr_scene_generator->generate(m_scene_texture_indices,
+            m_vertices, m_indices, m_draw_commands, m_instances
+        );
+
         destroy_mesh_buffer();
         create_mesh_buffer();
+        destroy_instance_buffers();
+        create_instance_buffers();
+        m_scene_start_time = ::std::chrono::steady_clock::now();
+
+        // The cached command buffers draw the old scene.
+        invalidate_cached_command_buffers();
+
+        VK_TUT_LOG_DEBUG("Loaded a scene of " << m_instances.size() <<
+            " objects drawn by " << m_draw_commands.size() << " draws.");
+    }
+
+    void Application::update_instance_buffer() {
+        if (m_ptr_scene_generator == nullptr ||
+        !m_ptr_scene_generator->get_parameters().animated) {
+            return;
+        }
+
+        VK_TUT_TRACE_SCOPE("update_instance_buffer");
+        ScopedFrameTimer timer(
+            m_frame_statistics, FrameMetric::INSTANCE_UPDATE_TIME
+        );
+
+        const float time_passed = ::std::chrono::duration<float>(
+            ::std::chrono::steady_clock::now() - m_scene_start_time
+        ).count();
+        m_ptr_scene_generator->animate(time_passed, m_instances,
+            m_mapped_instance_buffers[m_current_frame_index]
+        );
     }
 }
\ No newline at end of file
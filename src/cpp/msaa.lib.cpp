@@ -0,0 +1,48 @@
+#include "vk_tut/application.h"
+#include "vk_tut/logging.h"
+
+namespace vk::tut {
+    VkSampleCountFlagBits find_msaa_sample_count(
+        const VkPhysicalDevice& physical_device,
+        const uint32_t& requested_sample_count
+    ) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physical_device, &properties);
+
+        // Both attachments of the subpass use the same sample count.
+        const VkSampleCountFlags supported_counts =
+            properties.limits.framebufferColorSampleCounts &
+            properties.limits.framebufferDepthSampleCounts;
+
+        // The highest supported count not above the requested one.
+        for (uint32_t count = VkSampleCountFlagBits::VK_SAMPLE_COUNT_64_BIT;
+        count > VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT; count >>= 1) {
+            if (count <= requested_sample_count && (supported_counts & count)) {
+                return static_cast<VkSampleCountFlagBits>(count);
+            }
+        }
+
+        return VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT;
+    }
+
+    VkMemoryPropertyFlags find_transient_attachment_memory_properties(
+        const VkPhysicalDevice& physical_device
+    ) {
+        VkPhysicalDeviceMemoryProperties mem_properties;
+        vkGetPhysicalDeviceMemoryProperties(physical_device, &mem_properties);
+
+        // Tile based GPUs expose lazily allocated memory, which is
+        // only committed if the attachment has to leave the tile memory.
+        const VkMemoryPropertyFlags lazy_properties =
+            VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+            VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        for (uint32_t i = 0; i < mem_properties.memoryTypeCount; i++) {
+            if ((mem_properties.memoryTypes[i].propertyFlags & lazy_properties)
+            == lazy_properties) {
+                return lazy_properties;
+            }
+        }
+
+        return VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "vk_tut/pipeline_statistics.h"
+#include "vk_tut/host_allocator.h"
+#include "vk_tut/logging.h"
+
+namespace vk::tut {
+    void PipelineStatisticsQueries::create(
+        const VkDevice& logical_device, const uint32_t& slot_count
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        VkQueryPoolCreateInfo query_pool_info{};
+        query_pool_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        query_pool_info.queryType =
+            VkQueryType::VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        query_pool_info.queryCount = 1;
+        query_pool_info.pipelineStatistics = get_flags();
+
+        m_query_pools.resize(slot_count, VK_NULL_HANDLE);
+        for (VkQueryPool& query_pool : m_query_pools) {
+            result = vkCreateQueryPool(
+                logical_device, &query_pool_info,
+                get_allocation_callbacks(VK_OBJECT_TYPE_QUERY_POOL), &query_pool
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR(
+                    "Failed to create pipeline statistics query pool."
+                );
+            }
+        }
+        m_slot_submitted.assign(slot_count, false);
+
+        VK_TUT_LOG_DEBUG("Successfully created pipeline statistics queries.");
+    }
+
+    void PipelineStatisticsQueries::destroy(const VkDevice& logical_device) {
+        for (const VkQueryPool& query_pool : m_query_pools) {
+            vkDestroyQueryPool(logical_device, query_pool,
+                get_allocation_callbacks(VK_OBJECT_TYPE_QUERY_POOL));
+        }
+        m_query_pools.clear();
+        m_slot_submitted.clear();
+
+        VK_TUT_LOG_DEBUG("Destroyed pipeline statistics queries.");
+    }
+
+    void PipelineStatisticsQueries::begin(
+        const VkCommandBuffer& command_buffer, const uint32_t& slot
+    ) {
+        if (!is_enabled()) return;
+
+        vkCmdResetQueryPool(command_buffer, m_query_pools[slot], 0, 1);
+        vkCmdBeginQuery(command_buffer, m_query_pools[slot], 0, 0);
+    }
+
+    void PipelineStatisticsQueries::end(
+        const VkCommandBuffer& command_buffer, const uint32_t& slot
+    ) {
+        if (!is_enabled()) return;
+
+        vkCmdEndQuery(command_buffer, m_query_pools[slot], 0);
+    }
+
+    void PipelineStatisticsQueries::submit(const uint32_t& slot) {
+        if (!is_enabled()) return;
+
+        m_slot_submitted[slot] = true;
+    }
+
+    bool PipelineStatisticsQueries::collect(
+        const VkDevice& logical_device, const uint32_t& slot
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        // The query of a slot never submitted was never reset.
+        if (!is_enabled() || !m_slot_submitted[slot]) return false;
+        m_slot_submitted[slot] = false;
+
+        // The counters, followed by the availability word.
+        ::std::array<uint64_t, static_cast<size_t>(Counter::COUNT) + 1>
+            query_result{};
+        result = vkGetQueryPoolResults(
+            logical_device, m_query_pools[slot], 0, 1,
+            sizeof(query_result), query_result.data(), sizeof(query_result),
+            VkQueryResultFlagBits::VK_QUERY_RESULT_64_BIT |
+            VkQueryResultFlagBits::VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+        );
+        if (result != VkResult::VK_SUCCESS &&
+        result != VkResult::VK_NOT_READY) {
+            VK_TUT_LOG_ERROR("Failed to get pipeline statistics results.");
+        }
+        if (query_result.back() == 0) return false;
+
+        for (size_t i = 0; i < m_latest_counts.size(); i++) {
+            m_latest_counts[i] = query_result[i];
+        }
+        return true;
+    }
+
+    VkQueryPipelineStatisticFlags PipelineStatisticsQueries::get_flags() {
+        // The results are written in the order of the bits,
+        // which is the order of Counter.
+        return VkQueryPipelineStatisticFlagBits
+            ::VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+            VkQueryPipelineStatisticFlagBits
+            ::VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+            VkQueryPipelineStatisticFlagBits
+            ::VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+            VkQueryPipelineStatisticFlagBits
+            ::VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+            VkQueryPipelineStatisticFlagBits
+            ::VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+            VkQueryPipelineStatisticFlagBits
+            ::VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "vk_tut/application.h"
+#include "vk_tut/logging.h"
+#include "vk_tut/queue_family.h"
+
+#include <array>
+#include <utility>
+
+namespace vk::tut {
+    void Application::create_gpu_profiler() {
+        VK_TUT_TRACE_SCOPE("create_gpu_profiler");
+
+        QueueFamilyIndices indices = find_family_indices(
+            m_physical_device, m_surface
+        );
+
+        // One query pool per frame in flight, read after its fence.
+        m_gpu_profiler.create(
+            m_physical_device, m_logical_device,
+            ::std::get<1>(indices.get_graphics_family_index()),
+            static_cast<uint32_t>(m_in_flight_fences.size())
+        );
+    }
+
+    void Application::create_pipeline_statistics() {
+        VK_TUT_TRACE_SCOPE("create_pipeline_statistics");
+
+        if (!m_pipeline_statistics_supported) return;
+
+        // One query pool per frame in flight, read after its fence.
+        m_pipeline_statistics.create(m_logical_device,
+            static_cast<uint32_t>(m_in_flight_fences.size())
+        );
+    }
+
+    void Application::create_frame_statistics() {
+        VK_TUT_TRACE_SCOPE("create_frame_statistics");
+
+        // The statistics hold microseconds.
+        const uint64_t hitch_threshold = static_cast<uint64_t>(
+            m_config.get_hitch_threshold_ms() * 1000.0f
+        );
+        m_frame_statistics.set_hitch_threshold(
+            FrameMetric::CPU_FRAME_TIME, hitch_threshold
+        );
+        m_frame_statistics.set_hitch_threshold(
+            FrameMetric::GPU_FRAME_TIME, hitch_threshold
+        );
+    }
+
+    void Application::destroy_pipeline_statistics() {
+        if (!m_pipeline_statistics.is_enabled()) return;
+
+        m_pipeline_statistics.destroy(m_logical_device);
+    }
+
+    void Application::destroy_gpu_profiler() {
+        m_gpu_profiler.destroy(m_logical_device);
+    }
+
+    void Application::record_gpu_frame_time() {
+        // Only the durations collected since the last call are new.
+        const GpuTimingStats stats = m_gpu_profiler.get_stats("frame");
+        if (stats.get_total_sample_count() == m_recorded_gpu_frame_count) {
+            return;
+        }
+        m_recorded_gpu_frame_count = stats.get_total_sample_count();
+
+        m_frame_statistics.record(FrameMetric::GPU_FRAME_TIME,
+            static_cast<uint64_t>(stats.get_latest() * 1000.0)
+        );
+    }
+
+    void Application::record_pipeline_statistics(const uint32_t& slot) {
+        using Counter = PipelineStatisticsQueries::Counter;
+
+        if (!m_pipeline_statistics.collect(m_logical_device, slot)) return;
+
+        // With the depth prepass, the vertex counts include both
+        // subpasses.
+        const ::std::array<::std::pair<Counter, FrameMetric>,
+            static_cast<size_t>(Counter::COUNT)> metrics = {{
+            {Counter::INPUT_ASSEMBLY_VERTICES,
+                FrameMetric::INPUT_ASSEMBLY_VERTICES},
+            {Counter::INPUT_ASSEMBLY_PRIMITIVES,
+                FrameMetric::INPUT_ASSEMBLY_PRIMITIVES},
+            {Counter::VERTEX_SHADER_INVOCATIONS,
+                FrameMetric::VERTEX_SHADER_INVOCATIONS},
+            {Counter::CLIPPING_INVOCATIONS,
+                FrameMetric::CLIPPING_INVOCATIONS},
+            {Counter::CLIPPING_PRIMITIVES,
+                FrameMetric::CLIPPING_PRIMITIVES},
+            {Counter::FRAGMENT_SHADER_INVOCATIONS,
+                FrameMetric::FRAGMENT_SHADER_INVOCATIONS}
+        }};
+        for (const auto& [counter, metric] : metrics) {
+            m_frame_statistics.record(
+                metric, m_pipeline_statistics.get_latest(counter)
+            );
+        }
+
+        // The overdraw is the fragment shader invocations over the pixels
+        // of the render target. The samples are recorded next to it for
+        // runs comparing against sample rate shading.
+        const uint64_t pixel_count =
+            static_cast<uint64_t>(m_swapchain_extent.width) *
+            m_swapchain_extent.height;
+        m_frame_statistics.record(FrameMetric::RENDER_TARGET_SAMPLES,
+            pixel_count * static_cast<uint64_t>(m_msaa_samples)
+        );
+        if (pixel_count > 0) {
+            m_frame_statistics.record(FrameMetric::FRAGMENT_OVERDRAW_PERCENT,
+                m_pipeline_statistics.get_latest(
+                    Counter::FRAGMENT_SHADER_INVOCATIONS
+                ) * 100 / pixel_count
+            );
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "vk_tut/push_constant.h"
+
+#include <utility>
+
+namespace vk::tut {
+    // Copy initializer list constructor.
+    PushConstant::PushConstant(const uint32_t& texture_index) :
+    m_texture_index(texture_index) {}
+
+    // Copy constructor.
+    PushConstant::PushConstant(const PushConstant& from) :
+    m_texture_index(from.m_texture_index) {}
+
+    // Move constructor.
+    PushConstant::PushConstant(PushConstant&& from) :
+    m_texture_index(::std::move(from.m_texture_index)) {}
+
+    // Copy re-assignment.
+    PushConstant& PushConstant::operator= (const PushConstant& from) {
+        m_texture_index = from.m_texture_index;
+
+        return *this;
+    }
+
+    // Move re-assignment.
+    PushConstant& PushConstant::operator= (PushConstant&& from) {
+        m_texture_index = ::std::move(from.m_texture_index);
+
+        return *this;
+    }
+
+    // Copy setter for m_texture_index.
+    void PushConstant::set_texture_index(const uint32_t& texture_index) {
+        m_texture_index = texture_index;
+    }
+}
\ No newline at end of file
@@ -1,9 +1,14 @@
 #include "vk_tut/queue_family.h"
 #include "vk_tut/logging.h"
 
+#include <array>
+#include <span>
 #include <vector>
 
 namespace vk::tut {
+    // The number of queue families find_family_indices() looks at.
+    static constexpr uint32_t MAX_QUEUE_FAMILIES = 16;
+
     // Copy initializer list constructor.
     QueueFamilyIndices::QueueFamilyIndices(
         const uint32_t& graphics_family_index,
@@ -100,29 +105,35 @@ namespace vk::tut {
         QueueFamilyIndices result;
 
         // Obtain the queue family properties of the physical device.
-        uint32_t queue_family_props_count = 0;
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device,
-            &queue_family_props_count, nullptr);
-        ::std::vector<VkQueueFamilyProperties> queue_family_props(
-            queue_family_props_count
-        );
+        // Devices have a handful of families, so they are read into the
+        // stack instead of the heap, and any past the array are ignored.
+        ::std::array<VkQueueFamilyProperties, MAX_QUEUE_FAMILIES>
+            queue_family_props;
+        uint32_t queue_family_props_count = MAX_QUEUE_FAMILIES;
         vkGetPhysicalDeviceQueueFamilyProperties(physical_device,
             &queue_family_props_count, queue_family_props.data());
-        
+
         // The index of the current queue_family_prop being evaluated.
         uint32_t current_index = 0;
         // Loop through the queue_family_props
         for (const VkQueueFamilyProperties& queue_family_prop :
-        queue_family_props) {
+        ::std::span(queue_family_props.data(), queue_family_props_count)) {
             // Querying for graphics capability.
             if (queue_family_prop.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
                 result.set_graphics_family_index(current_index);
             }
 
-            // Querying for present support.
+            // Querying for present support. Without a surface nothing
+            // is presented, so the graphics family stands in for it.
             VkBool32 present_support = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(physical_device,
-                current_index, surface, &present_support);
+            if (surface == VK_NULL_HANDLE) {
+                present_support = (queue_family_prop.queueFlags &
+                    VkQueueFlagBits::VK_QUEUE_GRAPHICS_BIT) != 0;
+            }
+            else {
+                vkGetPhysicalDeviceSurfaceSupportKHR(physical_device,
+                    current_index, surface, &present_support);
+            }
             if (present_support) {
                 result.set_present_family_index(current_index);
             }
@@ -0,0 +1,60 @@
+#include "vk_tut/application.h"
+#include "vk_tut/logging.h"
+
+#include <filesystem>
+
+namespace vk::tut {
+    void Application::create_readback_ring() {
+        VK_TUT_TRACE_SCOPE("create_readback_ring");
+
+        if (m_config.get_readback_directory().empty()) return;
+
+        // The PPM writer only knows 8 bit RGBA and BGRA pixels.
+        switch (m_swapchain_image_format) {
+        case VkFormat::VK_FORMAT_B8G8R8A8_SRGB:
+        case VkFormat::VK_FORMAT_B8G8R8A8_UNORM:
+        case VkFormat::VK_FORMAT_R8G8B8A8_SRGB:
+        case VkFormat::VK_FORMAT_R8G8B8A8_UNORM:
+            break;
+        default:
+            VK_TUT_LOG_ERROR("Unsupported format for the frame readback.");
+        }
+
+        ::std::filesystem::create_directories(
+            m_config.get_readback_directory()
+        );
+
+        // One buffer per frame in flight. A frame is read back when its
+        // fence is next waited on, right before its slot is reused.
+        m_ptr_readback_ring = ::std::make_unique<ReadbackRing>();
+        m_ptr_readback_ring->create(
+            m_physical_device, m_logical_device,
+            m_swapchain_image_format, m_swapchain_extent, 4,
+            static_cast<uint32_t>(m_swapchain_images.size())
+        );
+
+        // As many copies as frames read back at once, so the
+        // render thread only waits if the disk falls behind.
+        if (m_ptr_readback_writer == nullptr) {
+            m_ptr_readback_writer = ::std::make_unique<ReadbackWriter>(
+                m_config.get_readback_directory(),
+                static_cast<uint32_t>(m_swapchain_images.size())
+            );
+        }
+    }
+
+    void Application::destroy_readback_ring() {
+        if (m_ptr_readback_ring == nullptr) return;
+
+        m_ptr_readback_ring->destroy(
+            m_logical_device, m_resource_state_tracker
+        );
+        m_ptr_readback_ring.reset();
+    }
+
+    void Application::write_readback_frame(const ReadbackFrame& frame) {
+        // Only copies the pixels out of mapped memory. Encoding and
+        // writing the file happen on the writer thread.
+        m_ptr_readback_writer->write(frame);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "vk_tut/readback_ring.h"
+#include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
+#include "vk_tut/logging.h"
+
+#include <algorithm>
+
+namespace vk::tut {
+    // < ------------------------- ReadbackFrame ------------------------- >
+
+    // Copy initializer list constructor.
+    ReadbackFrame::ReadbackFrame(
+        const uint64_t& frame_value,
+        const VkFormat& format,
+        const VkExtent2D& extent,
+        const void* ptr_data,
+        const VkDeviceSize& size
+    ) : m_frame_value(frame_value), m_format(format), m_extent(extent),
+    m_ptr_data(ptr_data), m_size(size) {}
+
+    // < ------------------------- ReadbackRing -------------------------- >
+
+    // The host visible memory the CPU reads the fastest. Cached memory
+    // is not always coherent, so it may have to be invalidated.
+    static VkMemoryPropertyFlags find_readback_memory_properties(
+        const VkPhysicalDevice& physical_device
+    ) {
+        VkPhysicalDeviceMemoryProperties mem_properties;
+        vkGetPhysicalDeviceMemoryProperties(physical_device, &mem_properties);
+
+        const VkMemoryPropertyFlags cached_properties =
+            VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+            VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        for (uint32_t i = 0; i < mem_properties.memoryTypeCount; i++) {
+            if ((mem_properties.memoryTypes[i].propertyFlags &
+            cached_properties) == cached_properties) {
+                return cached_properties;
+            }
+        }
+
+        return VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+            VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    }
+
+    void ReadbackRing::create(
+        const VkPhysicalDevice& physical_device,
+        const VkDevice& logical_device,
+        const VkFormat& format,
+        const VkExtent2D& extent,
+        const uint32_t& bytes_per_pixel,
+        const uint32_t& slot_count
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        m_format = format;
+        m_extent = extent;
+        m_size = static_cast<VkDeviceSize>(extent.width) * extent.height *
+            bytes_per_pixel;
+
+        const VkMemoryPropertyFlags memory_properties =
+            find_readback_memory_properties(physical_device);
+        m_needs_invalidate = (memory_properties &
+            VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+            == 0;
+
+        m_slots.resize(slot_count);
+        for (Slot& slot : m_slots) {
+            create_and_allocate_buffer(
+                physical_device, logical_device, m_size,
+                VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                memory_properties, &slot.buffer, &slot.memory
+            );
+
+            // Mapped for the lifetime of the ring.
+            result = vkMapMemory(
+                logical_device, slot.memory, 0, VK_WHOLE_SIZE, 0,
+                &slot.ptr_data
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to map readback memory.");
+            }
+        }
+
+        VK_TUT_LOG_DEBUG("Successfully created readback ring.");
+    }
+
+    void ReadbackRing::destroy(
+        const VkDevice& logical_device,
+        ResourceStateTracker& tracker
+    ) {
+        for (const Slot& slot : m_slots) {
+            tracker.forget_buffer(slot.buffer);
+            vkUnmapMemory(logical_device, slot.memory);
+            vkFreeMemory(logical_device, slot.memory,
+                get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+            vkDestroyBuffer(logical_device, slot.buffer,
+                get_allocation_callbacks(VK_OBJECT_TYPE_BUFFER));
+        }
+        m_slots.clear();
+
+        VK_TUT_LOG_DEBUG("Destroyed readback ring.");
+    }
+
+    void ReadbackRing::record_copy(
+        const VkCommandBuffer& command_buffer,
+        const VkImage& image,
+        const uint32_t& slot,
+        ResourceStateTracker& tracker,
+        PFN_vkCmdPipelineBarrier2KHR cmd_pipeline_barrier2
+    ) {
+        const VkBuffer& buffer = m_slots[slot].buffer;
+
+        // The host read the buffer before this submission, which
+        // orders it before the copy without a barrier.
+        tracker.track_buffer(buffer);
+        tracker.require_buffer_state(buffer, ResourceState(
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+        ));
+        tracker.flush(command_buffer, cmd_pipeline_barrier2);
+
+        // A buffer row length of 0 packs the rows tightly.
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VkImageAspectFlagBits
+            ::VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {m_extent.width, m_extent.height, 1};
+
+        vkCmdCopyImageToBuffer(
+            command_buffer, image,
+            VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            buffer, 1, &region
+        );
+
+        // Make the copy available to the host once the fence signals.
+        tracker.require_buffer_state(buffer, ResourceState(
+            VK_PIPELINE_STAGE_2_HOST_BIT_KHR, VK_ACCESS_2_HOST_READ_BIT_KHR
+        ));
+        tracker.flush(command_buffer, cmd_pipeline_barrier2);
+    }
+
+    void ReadbackRing::submit(
+        const uint32_t& slot, const uint64_t& frame_value
+    ) {
+        if (m_slots[slot].frame_value != 0) {
+            VK_TUT_LOG_DEBUG("Dropped a frame that was never read back.");
+        }
+        m_slots[slot].frame_value = frame_value;
+    }
+
+    void ReadbackRing::retrieve(
+        const VkDevice& logical_device,
+        const uint64_t& completed_value,
+        const ::std::function<void(const ReadbackFrame&)>& consume
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        // Slots are visited oldest frame first.
+        while (true) {
+            Slot* ptr_oldest = nullptr;
+            for (Slot& slot : m_slots) {
+                if (slot.frame_value == 0 ||
+                slot.frame_value > completed_value) {
+                    continue;
+                }
+                if (ptr_oldest == nullptr ||
+                slot.frame_value < ptr_oldest->frame_value) {
+                    ptr_oldest = &slot;
+                }
+            }
+            if (ptr_oldest == nullptr) return;
+
+            if (m_needs_invalidate) {
+                VkMappedMemoryRange range{};
+                range.sType = VkStructureType
+                    ::VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+                range.memory = ptr_oldest->memory;
+                range.offset = 0;
+                range.size = VK_WHOLE_SIZE;
+
+                result = vkInvalidateMappedMemoryRanges(
+                    logical_device, 1, &range
+                );
+                if (result != VkResult::VK_SUCCESS) {
+                    VK_TUT_LOG_ERROR("Failed to invalidate readback memory.");
+                }
+            }
+
+            consume(ReadbackFrame(
+                ptr_oldest->frame_value, m_format, m_extent,
+                ptr_oldest->ptr_data, m_size
+            ));
+            ptr_oldest->frame_value = 0;
+        }
+    }
+
+    size_t ReadbackRing::get_pending_count() const {
+        return static_cast<size_t>(::std::count_if(
+            m_slots.begin(), m_slots.end(),
+            [](const Slot& slot) { return slot.frame_value != 0; }
+        ));
+    }
+}
\ No newline at end of file
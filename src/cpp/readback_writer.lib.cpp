@@ -0,0 +1,172 @@
+#include "vk_tut/readback_writer.h"
+#include "vk_tut/logging.h"
+#include "vk_tut/trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace vk::tut {
+    ReadbackWriter::ReadbackWriter(
+        const ::std::string& directory,
+        const uint32_t& buffer_count
+    ) : m_directory(directory) {
+        const uint32_t count = ::std::max(buffer_count, 1U);
+        m_buffers.resize(count);
+        m_free_buffers.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            m_free_buffers.emplace_back(count - 1 - i);
+        }
+        m_queued_buffers.resize(count);
+
+        m_thread = ::std::thread(&ReadbackWriter::writer_main, this);
+    }
+
+    ReadbackWriter::~ReadbackWriter() {
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_queued.notify_one();
+        m_thread.join();
+    }
+
+    void ReadbackWriter::write(const ReadbackFrame& frame) {
+        uint32_t index;
+        {
+            ::std::unique_lock<::std::mutex> lock(m_mutex);
+            rethrow_exception();
+            m_written.wait(lock, [this]() {
+                return !m_free_buffers.empty();
+            });
+            index = m_free_buffers.back();
+            m_free_buffers.pop_back();
+        }
+
+        // The buffer belongs to this thread until it is queued.
+        Buffer& buffer = m_buffers[index];
+        buffer.frame_value = frame.get_frame_value();
+        buffer.format = frame.get_format();
+        buffer.extent = frame.get_extent();
+        buffer.pixels.resize(static_cast<size_t>(frame.get_size()));
+        ::std::memcpy(buffer.pixels.data(), frame.get_data(),
+            buffer.pixels.size());
+
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_queued_buffers[(m_queue_head + m_queued_count) %
+                m_queued_buffers.size()] = index;
+            m_queued_count++;
+        }
+        m_queued.notify_one();
+    }
+
+    void ReadbackWriter::wait_idle() {
+        ::std::unique_lock<::std::mutex> lock(m_mutex);
+        m_written.wait(lock, [this]() { return m_queued_count == 0; });
+        rethrow_exception();
+    }
+
+    uint64_t ReadbackWriter::get_written_count() const {
+        ::std::lock_guard<::std::mutex> lock(m_mutex);
+        return m_written_count;
+    }
+
+    void ReadbackWriter::encode_ppm(
+        const VkFormat& format,
+        const VkExtent2D& extent,
+        const uint8_t* ptr_pixels,
+        ::std::vector<char>& encoded
+    ) {
+        char header[64];
+        const int header_size = ::std::snprintf(header, sizeof(header),
+            "P6\n%u %u\n255\n", extent.width, extent.height);
+
+        const size_t pixel_count =
+            static_cast<size_t>(extent.width) * extent.height;
+        encoded.resize(static_cast<size_t>(header_size) + pixel_count * 3);
+        ::std::memcpy(encoded.data(), header,
+            static_cast<size_t>(header_size));
+
+        // PPM stores RGB, so each pixel drops the alpha channel
+        // and swaps red and blue for BGRA formats.
+        const bool bgra =
+            format == VkFormat::VK_FORMAT_B8G8R8A8_SRGB ||
+            format == VkFormat::VK_FORMAT_B8G8R8A8_UNORM;
+        char* ptr_rgb = encoded.data() + header_size;
+        for (size_t i = 0; i < pixel_count; i++) {
+            const uint8_t* ptr_pixel = ptr_pixels + i * 4;
+            ptr_rgb[i * 3 + 0] = static_cast<char>(ptr_pixel[bgra ? 2 : 0]);
+            ptr_rgb[i * 3 + 1] = static_cast<char>(ptr_pixel[1]);
+            ptr_rgb[i * 3 + 2] = static_cast<char>(ptr_pixel[bgra ? 0 : 2]);
+        }
+    }
+
+    void ReadbackWriter::writer_main() {
+        VK_TUT_TRACE_THREAD_NAME("readback writer");
+
+        // Reused for every frame, like the buffers.
+        ::std::vector<char> encoded;
+        while (true) {
+            uint32_t index;
+            {
+                ::std::unique_lock<::std::mutex> lock(m_mutex);
+                m_queued.wait(lock, [this]() {
+                    return m_stop || m_queued_count > 0;
+                });
+                // Stopping only once the queue is empty.
+                if (m_queued_count == 0) return;
+                index = m_queued_buffers[m_queue_head];
+            }
+
+            // The buffer stays queued, and so untouched by write(),
+            // until it is written.
+            ::std::exception_ptr exception;
+            try {
+                VK_TUT_TRACE_SCOPE("write_readback_frame");
+
+                const Buffer& buffer = m_buffers[index];
+                encode_ppm(buffer.format, buffer.extent,
+                    buffer.pixels.data(), encoded);
+
+                // Zero padded, so the files sort in frame order.
+                char file_name[32];
+                ::std::snprintf(file_name, sizeof(file_name),
+                    "frame_%06llu.ppm",
+                    static_cast<unsigned long long>(buffer.frame_value));
+                const ::std::string path = m_directory + "/" + file_name;
+
+                ::std::ofstream file(path, ::std::ios::binary);
+                if (!file.is_open()) {
+                    VK_TUT_LOG_ERROR("Failed to open " + path + ".");
+                }
+                file.write(encoded.data(),
+                    static_cast<::std::streamsize>(encoded.size()));
+            }
+            catch (...) {
+                exception = ::std::current_exception();
+            }
+
+            {
+                ::std::lock_guard<::std::mutex> lock(m_mutex);
+                m_queue_head = (m_queue_head + 1) % m_queued_buffers.size();
+                m_queued_count--;
+                m_free_buffers.emplace_back(index);
+                m_written_count++;
+                if (exception != nullptr && m_exception == nullptr) {
+                    m_exception = exception;
+                }
+            }
+            m_written.notify_all();
+        }
+    }
+
+    void ReadbackWriter::rethrow_exception() {
+        if (m_exception == nullptr) return;
+
+        ::std::exception_ptr exception = m_exception;
+        m_exception = nullptr;
+        ::std::rethrow_exception(exception);
+    }
+}
\ No newline at end of file
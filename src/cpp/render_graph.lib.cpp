@@ -0,0 +1,623 @@
+#include "vk_tut/render_graph.h"
+#include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
+#include "vk_tut/logging.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace vk::tut {
+    // < --------------------- RenderGraphImageInfo ---------------------- >
+
+    // Copy initializer list constructor.
+    RenderGraphImageInfo::RenderGraphImageInfo(
+        const VkFormat& format,
+        const VkExtent2D& extent,
+        const VkImageUsageFlags& usage,
+        const VkImageAspectFlags& aspect_mask,
+        const VkSampleCountFlagBits& samples
+    ) : m_format(format), m_extent(extent), m_usage(usage),
+    m_aspect_mask(aspect_mask), m_samples(samples) {}
+
+    // Copy constructor.
+    RenderGraphImageInfo::RenderGraphImageInfo(
+        const RenderGraphImageInfo& from
+    ) : m_format(from.m_format), m_extent(from.m_extent),
+    m_usage(from.m_usage), m_aspect_mask(from.m_aspect_mask),
+    m_samples(from.m_samples) {}
+
+    // Move constructor.
+    RenderGraphImageInfo::RenderGraphImageInfo(
+        RenderGraphImageInfo&& from
+    ) : m_format(::std::move(from.m_format)),
+    m_extent(::std::move(from.m_extent)),
+    m_usage(::std::move(from.m_usage)),
+    m_aspect_mask(::std::move(from.m_aspect_mask)),
+    m_samples(::std::move(from.m_samples)) {}
+
+    // Copy re-assignment.
+    RenderGraphImageInfo& RenderGraphImageInfo::operator= (
+        const RenderGraphImageInfo& from
+    ) {
+        m_format = from.m_format;
+        m_extent = from.m_extent;
+        m_usage = from.m_usage;
+        m_aspect_mask = from.m_aspect_mask;
+        m_samples = from.m_samples;
+
+        return *this;
+    }
+
+    // Move re-assignment.
+    RenderGraphImageInfo& RenderGraphImageInfo::operator= (
+        RenderGraphImageInfo&& from
+    ) {
+        m_format = ::std::move(from.m_format);
+        m_extent = ::std::move(from.m_extent);
+        m_usage = ::std::move(from.m_usage);
+        m_aspect_mask = ::std::move(from.m_aspect_mask);
+        m_samples = ::std::move(from.m_samples);
+
+        return *this;
+    }
+
+    // < ------------------------ RenderGraphPass ------------------------- >
+
+    // Copy initializer list constructor.
+    RenderGraphPass::RenderGraphPass(
+        const ::std::string& name,
+        ::std::function<void(const VkCommandBuffer&)>&& record
+    ) : m_name(name), m_record(::std::move(record)) {}
+
+    RenderGraphPass& RenderGraphPass::read(
+        const RenderGraphResource& resource,
+        const ResourceState& state
+    ) {
+        m_accesses.push_back({resource, false, state, state});
+        return *this;
+    }
+
+    RenderGraphPass& RenderGraphPass::write(
+        const RenderGraphResource& resource,
+        const ResourceState& state
+    ) {
+        m_accesses.push_back({resource, true, state, state});
+        return *this;
+    }
+
+    RenderGraphPass& RenderGraphPass::write(
+        const RenderGraphResource& resource,
+        const ResourceState& state,
+        const ResourceState& end_state
+    ) {
+        m_accesses.push_back({resource, true, state, end_state});
+        return *this;
+    }
+
+    RenderGraphPass& RenderGraphPass::set_side_effect() {
+        m_side_effect = true;
+        return *this;
+    }
+
+    // < -------------------------- RenderGraph --------------------------- >
+
+    RenderGraphResource RenderGraph::create_image(
+        const ::std::string& name,
+        const RenderGraphImageInfo& info
+    ) {
+        Resource resource;
+        resource.name = name;
+        resource.info = info;
+        m_resources.emplace_back(::std::move(resource));
+
+        return static_cast<RenderGraphResource>(m_resources.size() - 1);
+    }
+
+    RenderGraphResource RenderGraph::import_image(
+        const ::std::string& name,
+        const VkImageAspectFlags& aspect_mask,
+        const ResourceState& initial_state,
+        const ResourceState& final_state
+    ) {
+        Resource resource;
+        resource.name = name;
+        resource.info = RenderGraphImageInfo(
+            VkFormat::VK_FORMAT_UNDEFINED, {0, 0}, 0, aspect_mask
+        );
+        resource.imported = true;
+        resource.initial_state = initial_state;
+        resource.final_state = final_state;
+        m_resources.emplace_back(::std::move(resource));
+
+        return static_cast<RenderGraphResource>(m_resources.size() - 1);
+    }
+
+    void RenderGraph::set_imported_image(
+        const RenderGraphResource& resource,
+        const VkImage& image,
+        const VkImageView& image_view
+    ) {
+        m_resources[resource].image = image;
+        m_resources[resource].image_view = image_view;
+    }
+
+    RenderGraphPass& RenderGraph::add_pass(
+        const ::std::string& name,
+        ::std::function<void(const VkCommandBuffer&)>&& record
+    ) {
+        m_passes.emplace_back(
+            ::std::make_unique<RenderGraphPass>(name, ::std::move(record))
+        );
+        return *m_passes.back();
+    }
+
+    void RenderGraph::compile() {
+        const uint32_t pass_count = static_cast<uint32_t>(m_passes.size());
+
+        // Read after write, write after write and write after read
+        // hazards, in the order the passes were declared.
+        m_dependencies.assign(pass_count, {});
+        ::std::vector<uint32_t> last_writers(m_resources.size(), UNUSED);
+        ::std::vector<::std::vector<uint32_t>> readers(m_resources.size());
+        auto add_dependency = [this](uint32_t pass, uint32_t dependency) {
+            ::std::vector<uint32_t>& dependencies = m_dependencies[pass];
+            if (dependency == pass || ::std::find(dependencies.begin(),
+            dependencies.end(), dependency) != dependencies.end()) {
+                return;
+            }
+            dependencies.emplace_back(dependency);
+        };
+        for (uint32_t pass = 0; pass < pass_count; pass++) {
+            for (const RenderGraphPass::Access& access :
+            m_passes[pass]->m_accesses) {
+                const RenderGraphResource& resource = access.resource;
+                if (last_writers[resource] != UNUSED) {
+                    add_dependency(pass, last_writers[resource]);
+                }
+                if (!access.write) {
+                    readers[resource].emplace_back(pass);
+                    continue;
+                }
+                for (const uint32_t& reader : readers[resource]) {
+                    add_dependency(pass, reader);
+                }
+                readers[resource].clear();
+                last_writers[resource] = pass;
+            }
+        }
+
+        // Keep the passes with a visible result and what they depend on.
+        m_pass_culled.assign(pass_count, true);
+        ::std::vector<uint32_t> live_passes;
+        for (uint32_t pass = 0; pass < pass_count; pass++) {
+            bool root = m_passes[pass]->m_side_effect;
+            for (const RenderGraphPass::Access& access :
+            m_passes[pass]->m_accesses) {
+                root |= access.write && m_resources[access.resource].imported;
+            }
+            if (root) {
+                m_pass_culled[pass] = false;
+                live_passes.emplace_back(pass);
+            }
+        }
+        while (!live_passes.empty()) {
+            const uint32_t pass = live_passes.back();
+            live_passes.pop_back();
+            for (const uint32_t& dependency : m_dependencies[pass]) {
+                if (!m_pass_culled[dependency]) continue;
+                m_pass_culled[dependency] = false;
+                live_passes.emplace_back(dependency);
+            }
+        }
+
+        // Topological order. Of the passes ready to run, the one consuming
+        // the most recent output goes first, which keeps the lifetimes of
+        // the transient images short and lets more of them share memory.
+        // Ties keep the declaration order.
+        ::std::vector<uint32_t> positions(pass_count, UNUSED);
+        m_execution_order.clear();
+        bool scheduled = true;
+        while (scheduled) {
+            scheduled = false;
+            uint32_t best_pass = UNUSED;
+            uint32_t best_score = 0;
+            for (uint32_t pass = 0; pass < pass_count; pass++) {
+                if (m_pass_culled[pass] || positions[pass] != UNUSED) continue;
+
+                bool ready = true;
+                uint32_t score = 0;
+                for (const uint32_t& dependency : m_dependencies[pass]) {
+                    if (positions[dependency] == UNUSED) {
+                        ready = false;
+                        break;
+                    }
+                    score = ::std::max(score, positions[dependency] + 1);
+                }
+                if (ready && (best_pass == UNUSED || score > best_score)) {
+                    best_pass = pass;
+                    best_score = score;
+                }
+            }
+
+            if (best_pass != UNUSED) {
+                positions[best_pass] = static_cast<uint32_t>(
+                    m_execution_order.size()
+                );
+                m_execution_order.emplace_back(best_pass);
+                scheduled = true;
+            }
+        }
+
+        // The lifetimes of the images.
+        for (Resource& resource : m_resources) {
+            resource.first_use = UNUSED;
+            resource.last_use = UNUSED;
+        }
+        for (uint32_t position = 0; position < m_execution_order.size();
+        position++) {
+            for (const RenderGraphPass::Access& access :
+            m_passes[m_execution_order[position]]->m_accesses) {
+                Resource& resource = m_resources[access.resource];
+                if (resource.first_use == UNUSED) {
+                    resource.first_use = position;
+                }
+                resource.last_use = position;
+            }
+        }
+
+        VK_TUT_LOG_DEBUG("Successfully compiled render graph.");
+    }
+
+    VkDeviceSize RenderGraph::assign_memory(
+        const ::std::vector<VkMemoryRequirements>& requirements
+    ) {
+        m_memory_blocks.clear();
+
+        // The largest images first, so that the smaller
+        // ones fill the blocks the larger ones created.
+        ::std::vector<RenderGraphResource> transient_resources;
+        for (RenderGraphResource resource = 0;
+        resource < m_resources.size(); resource++) {
+            m_resources[resource].memory_block = UNUSED;
+            if (m_resources[resource].imported ||
+            m_resources[resource].first_use == UNUSED) {
+                continue;
+            }
+            transient_resources.emplace_back(resource);
+        }
+        ::std::stable_sort(
+            transient_resources.begin(), transient_resources.end(),
+            [&requirements](
+                const RenderGraphResource& a, const RenderGraphResource& b
+            ) {
+                return requirements[a].size > requirements[b].size;
+            }
+        );
+
+        for (const RenderGraphResource& resource : transient_resources) {
+            Resource& placed = m_resources[resource];
+            const VkMemoryRequirements& placed_requirements =
+                requirements[resource];
+
+            // The first block whose images are all dead while this one
+            // lives, and that has a memory type this one can use.
+            uint32_t block_index = 0;
+            for (; block_index < m_memory_blocks.size(); block_index++) {
+                const MemoryBlock& block = m_memory_blocks[block_index];
+                if ((block.memory_type_bits &
+                placed_requirements.memoryTypeBits) == 0) {
+                    continue;
+                }
+
+                bool overlaps = false;
+                for (const RenderGraphResource& other : block.resources) {
+                    overlaps |=
+                        placed.first_use <= m_resources[other].last_use &&
+                        m_resources[other].first_use <= placed.last_use;
+                }
+                if (!overlaps) break;
+            }
+            if (block_index == m_memory_blocks.size()) {
+                MemoryBlock block;
+                block.memory_type_bits = placed_requirements.memoryTypeBits;
+                m_memory_blocks.emplace_back(::std::move(block));
+            }
+
+            // Every image is bound at the start of its block.
+            MemoryBlock& block = m_memory_blocks[block_index];
+            block.size = ::std::max(block.size, placed_requirements.size);
+            block.memory_type_bits &= placed_requirements.memoryTypeBits;
+            block.resources.emplace_back(resource);
+            placed.memory_block = block_index;
+        }
+
+        VkDeviceSize total_size = 0;
+        for (const MemoryBlock& block : m_memory_blocks) {
+            total_size += block.size;
+        }
+
+        return total_size;
+    }
+
+    void RenderGraph::realize(
+        const VkPhysicalDevice& physical_device,
+        const VkDevice& logical_device
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        ::std::vector<VkMemoryRequirements> requirements(m_resources.size());
+        for (RenderGraphResource index = 0;
+        index < m_resources.size(); index++) {
+            Resource& resource = m_resources[index];
+            if (resource.imported || resource.first_use == UNUSED) continue;
+
+            VkImageCreateInfo image_info{};
+            image_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            image_info.imageType = VkImageType::VK_IMAGE_TYPE_2D;
+            image_info.extent.width = resource.info.get_extent().width;
+            image_info.extent.height = resource.info.get_extent().height;
+            image_info.extent.depth = 1;
+            image_info.mipLevels = 1;
+            image_info.arrayLayers = 1;
+            image_info.format = resource.info.get_format();
+            image_info.tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL;
+            image_info.initialLayout = VkImageLayout
+                ::VK_IMAGE_LAYOUT_UNDEFINED;
+            image_info.usage = resource.info.get_usage();
+            image_info.sharingMode = VkSharingMode
+                ::VK_SHARING_MODE_EXCLUSIVE;
+            image_info.samples = resource.info.get_samples();
+
+            result = vkCreateImage(
+                logical_device, &image_info,
+                get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE), &resource.image
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to create render graph image.");
+            }
+
+            vkGetImageMemoryRequirements(
+                logical_device, resource.image, &requirements[index]
+            );
+        }
+
+        assign_memory(requirements);
+
+        for (MemoryBlock& block : m_memory_blocks) {
+            // Attachments never stored can live in the tile memory.
+            bool transient_attachments = true;
+            for (const RenderGraphResource& index : block.resources) {
+                transient_attachments &= (
+                    m_resources[index].info.get_usage() &
+                    VkImageUsageFlagBits
+                        ::VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+                ) != 0;
+            }
+
+            VkMemoryAllocateInfo memory_alloc_info{};
+            memory_alloc_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            memory_alloc_info.allocationSize = block.size;
+            memory_alloc_info.memoryTypeIndex = find_memory_requirements(
+                physical_device, block.memory_type_bits,
+                transient_attachments ?
+                find_transient_attachment_memory_properties(physical_device) :
+                VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+            );
+
+            result = vkAllocateMemory(
+                logical_device, &memory_alloc_info,
+                get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY),
+                &block.memory
+            );
+            if (result != VkResult::VK_SUCCESS) {
+                VK_TUT_LOG_ERROR("Failed to allocate render graph memory.");
+            }
+
+            for (const RenderGraphResource& index : block.resources) {
+                Resource& resource = m_resources[index];
+                vkBindImageMemory(
+                    logical_device, resource.image, block.memory, 0
+                );
+
+                VkImageViewCreateInfo view_info{};
+                view_info.sType = VkStructureType
+                    ::VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+                view_info.image = resource.image;
+                view_info.viewType = VkImageViewType::VK_IMAGE_VIEW_TYPE_2D;
+                view_info.format = resource.info.get_format();
+                view_info.subresourceRange.aspectMask =
+                    resource.info.get_aspect_mask();
+                view_info.subresourceRange.baseMipLevel = 0;
+                view_info.subresourceRange.levelCount = 1;
+                view_info.subresourceRange.baseArrayLayer = 0;
+                view_info.subresourceRange.layerCount = 1;
+
+                result = vkCreateImageView(
+                    logical_device, &view_info,
+                    get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE_VIEW),
+                    &resource.image_view
+                );
+                if (result != VkResult::VK_SUCCESS) {
+                    VK_TUT_LOG_ERROR(
+                        "Failed to create render graph image view."
+                    );
+                }
+            }
+        }
+
+        VK_TUT_LOG_DEBUG("Successfully realized render graph.");
+    }
+
+    void RenderGraph::release(
+        const VkDevice& logical_device,
+        ResourceStateTracker& tracker
+    ) {
+        for (Resource& resource : m_resources) {
+            if (resource.imported) continue;
+
+            tracker.forget_image(resource.image);
+            vkDestroyImageView(logical_device, resource.image_view,
+                get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE_VIEW));
+            vkDestroyImage(logical_device, resource.image,
+                get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE));
+            resource.image_view = VK_NULL_HANDLE;
+            resource.image = VK_NULL_HANDLE;
+        }
+        for (MemoryBlock& block : m_memory_blocks) {
+            vkFreeMemory(logical_device, block.memory,
+                get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+        }
+        m_memory_blocks.clear();
+
+        VK_TUT_LOG_DEBUG("Released render graph.");
+    }
+
+    void RenderGraph::clear() {
+        m_passes.clear();
+        m_resources.clear();
+        m_dependencies.clear();
+        m_pass_culled.clear();
+        m_execution_order.clear();
+        m_memory_blocks.clear();
+    }
+
+    void RenderGraph::execute(
+        const VkCommandBuffer& command_buffer,
+        ResourceStateTracker& tracker,
+        PFN_vkCmdPipelineBarrier2KHR cmd_pipeline_barrier2
+    ) {
+        for (const Resource& resource : m_resources) {
+            if (!resource.imported || resource.image == VK_NULL_HANDLE) {
+                continue;
+            }
+            tracker.track_image(resource.image,
+                resource.info.get_aspect_mask(), resource.initial_state
+            );
+        }
+        // The first image of each block waits on whatever used the block
+        // in an earlier submission, which is not known when recording.
+        for (MemoryBlock& block : m_memory_blocks) {
+            block.src_stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+            block.src_access = VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+        }
+
+        for (uint32_t position = 0; position < m_execution_order.size();
+        position++) {
+            const RenderGraphPass& pass =
+                *m_passes[m_execution_order[position]];
+
+            for (const RenderGraphPass::Access& access : pass.m_accesses) {
+                const Resource& resource = m_resources[access.resource];
+
+                // A transient image starts with undefined contents, once
+                // the previous image in its memory is done with it.
+                if (!resource.imported && position == resource.first_use) {
+                    const MemoryBlock& block =
+                        m_memory_blocks[resource.memory_block];
+                    tracker.track_image(resource.image,
+                        resource.info.get_aspect_mask(),
+                        ResourceState(
+                            VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
+                            block.src_stages, block.src_access
+                        )
+                    );
+                }
+
+                if (access.state.get_layout() !=
+                VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED) {
+                    tracker.require_image_state(resource.image, access.state);
+                }
+                // The pass transitions the image itself, so no image
+                // barrier orders it after the previous image in the block.
+                // Its first use still has to wait on that image.
+                else if (!resource.imported &&
+                position == resource.first_use) {
+                    const MemoryBlock& block =
+                        m_memory_blocks[resource.memory_block];
+                    // A pass declaring no stages waits with every stage.
+                    const bool any_stage = access.state.get_stages() ==
+                        VK_PIPELINE_STAGE_2_NONE_KHR;
+                    tracker.require_memory_dependency(
+                        block.src_stages, block.src_access,
+                        any_stage ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR :
+                            access.state.get_stages(),
+                        any_stage ? VK_ACCESS_2_MEMORY_READ_BIT_KHR |
+                            VK_ACCESS_2_MEMORY_WRITE_BIT_KHR :
+                            access.state.get_access()
+                    );
+                }
+            }
+            tracker.flush(command_buffer, cmd_pipeline_barrier2);
+
+            pass.m_record(command_buffer);
+
+            for (const RenderGraphPass::Access& access : pass.m_accesses) {
+                const Resource& resource = m_resources[access.resource];
+                if (access.end_state.get_layout() !=
+                access.state.get_layout() ||
+                access.state.get_layout() ==
+                VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED) {
+                    tracker.set_image_state(resource.image, access.end_state);
+                }
+
+                // The next image in the block waits on the last use.
+                if (!resource.imported && position == resource.last_use) {
+                    MemoryBlock& block =
+                        m_memory_blocks[resource.memory_block];
+                    const ResourceState last_state =
+                        tracker.get_image_state(resource.image);
+                    block.src_stages = last_state.get_stages();
+                    block.src_access = last_state.get_access();
+                }
+            }
+        }
+
+        // Hand the imported images back in the state their owner expects.
+        for (const Resource& resource : m_resources) {
+            if (!resource.imported || resource.image == VK_NULL_HANDLE ||
+            resource.first_use == UNUSED || resource.final_state.get_layout()
+            == VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED) {
+                continue;
+            }
+            tracker.require_image_state(resource.image, resource.final_state);
+        }
+        tracker.flush(command_buffer, cmd_pipeline_barrier2);
+    }
+
+    bool RenderGraph::is_pass_culled(const uint32_t& pass_index) const {
+        return m_pass_culled[pass_index];
+    }
+
+    uint32_t RenderGraph::get_first_use(
+        const RenderGraphResource& resource
+    ) const {
+        return m_resources[resource].first_use;
+    }
+
+    uint32_t RenderGraph::get_last_use(
+        const RenderGraphResource& resource
+    ) const {
+        return m_resources[resource].last_use;
+    }
+
+    uint32_t RenderGraph::get_memory_block(
+        const RenderGraphResource& resource
+    ) const {
+        return m_resources[resource].memory_block;
+    }
+
+    VkImage RenderGraph::get_image(
+        const RenderGraphResource& resource
+    ) const {
+        return m_resources[resource].image;
+    }
+
+    VkImageView RenderGraph::get_image_view(
+        const RenderGraphResource& resource
+    ) const {
+        return m_resources[resource].image_view;
+    }
+}
\ No newline at end of file
@@ -1,65 +1,207 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 
+#include <vector>
+
 namespace vk::tut {
+    void Application::select_attachment_formats() {
+        m_msaa_samples = find_msaa_sample_count(
+            m_physical_device, m_config.get_msaa_sample_count()
+        );
+        m_depth_format = find_depth_format(m_physical_device);
+    }
+
     void Application::create_render_pass() {
+        VK_TUT_TRACE_SCOPE("create_render_pass");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
-        // Colour Attachment.
+        // Whether the colour attachment is multisampled
+        // and resolved into the swapchain image.
+        const bool msaa_enabled =
+            m_msaa_samples != VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT;
+
+        // Colour Attachment. With MSAA the samples are
+        // discarded once resolved, and never leave the tile memory.
         VkAttachmentDescription colour_attachment{};
         colour_attachment.format = m_swapchain_image_format;
-        colour_attachment.samples = VkSampleCountFlagBits
-            ::VK_SAMPLE_COUNT_1_BIT;
+        colour_attachment.samples = m_msaa_samples;
         colour_attachment.loadOp = VkAttachmentLoadOp
             ::VK_ATTACHMENT_LOAD_OP_CLEAR;
-        colour_attachment.storeOp = VkAttachmentStoreOp
-            ::VK_ATTACHMENT_STORE_OP_STORE;
+        colour_attachment.storeOp = msaa_enabled ?
+            VkAttachmentStoreOp::VK_ATTACHMENT_STORE_OP_DONT_CARE :
+            VkAttachmentStoreOp::VK_ATTACHMENT_STORE_OP_STORE;
         colour_attachment.stencilLoadOp = VkAttachmentLoadOp
             ::VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         colour_attachment.stencilStoreOp = VkAttachmentStoreOp
             ::VK_ATTACHMENT_STORE_OP_DONT_CARE;
         colour_attachment.initialLayout = VkImageLayout
             ::VK_IMAGE_LAYOUT_UNDEFINED;
-        colour_attachment.finalLayout = VkImageLayout
-            ::VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        
+        colour_attachment.finalLayout = msaa_enabled ?
+            VkImageLayout::VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL :
+            get_output_image_layout();
+
+        // Resolve Attachment. The swapchain image, only with MSAA.
+        VkAttachmentDescription resolve_attachment{};
+        resolve_attachment.format = m_swapchain_image_format;
+        resolve_attachment.samples = VkSampleCountFlagBits
+            ::VK_SAMPLE_COUNT_1_BIT;
+        resolve_attachment.loadOp = VkAttachmentLoadOp
+            ::VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        resolve_attachment.storeOp = VkAttachmentStoreOp
+            ::VK_ATTACHMENT_STORE_OP_STORE;
+        resolve_attachment.stencilLoadOp = VkAttachmentLoadOp
+            ::VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        resolve_attachment.stencilStoreOp = VkAttachmentStoreOp
+            ::VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        resolve_attachment.initialLayout = VkImageLayout
+            ::VK_IMAGE_LAYOUT_UNDEFINED;
+        resolve_attachment.finalLayout = get_output_image_layout();
+
+        // Depth Attachment. Cleared to 0, the far plane under reverse-Z.
+        VkAttachmentDescription depth_attachment{};
+        depth_attachment.format = m_depth_format;
+        depth_attachment.samples = m_msaa_samples;
+        depth_attachment.loadOp = VkAttachmentLoadOp
+            ::VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depth_attachment.storeOp = VkAttachmentStoreOp
+            ::VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depth_attachment.stencilLoadOp = VkAttachmentLoadOp
+            ::VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depth_attachment.stencilStoreOp = VkAttachmentStoreOp
+            ::VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depth_attachment.initialLayout = VkImageLayout
+            ::VK_IMAGE_LAYOUT_UNDEFINED;
+        depth_attachment.finalLayout = VkImageLayout
+            ::VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        ::std::vector<VkAttachmentDescription> attachments = {
+            colour_attachment, depth_attachment
+        };
+        if (msaa_enabled) attachments.emplace_back(resolve_attachment);
+
         VkAttachmentReference colour_attachment_ref{};
         colour_attachment_ref.attachment = 0;
         colour_attachment_ref.layout = VkImageLayout
             ::VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        
+
+        VkAttachmentReference depth_attachment_ref{};
+        depth_attachment_ref.attachment = 1;
+        depth_attachment_ref.layout = VkImageLayout
+            ::VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference resolve_attachment_ref{};
+        resolve_attachment_ref.attachment = 2;
+        resolve_attachment_ref.layout = VkImageLayout
+            ::VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        // The depth prepass subpass only writes depth.
+        VkSubpassDescription depth_prepass_subpass{};
+        depth_prepass_subpass.pipelineBindPoint = VkPipelineBindPoint
+            ::VK_PIPELINE_BIND_POINT_GRAPHICS;
+        depth_prepass_subpass.colorAttachmentCount = 0;
+        depth_prepass_subpass.pDepthStencilAttachment = &depth_attachment_ref;
+
         VkSubpassDescription subpass{};
         subpass.pipelineBindPoint = VkPipelineBindPoint
             ::VK_PIPELINE_BIND_POINT_GRAPHICS;
         subpass.colorAttachmentCount = 1;
         subpass.pColorAttachments = &colour_attachment_ref;
+        subpass.pDepthStencilAttachment = &depth_attachment_ref;
+        // Resolved at the end of the subpass, within the render pass.
+        subpass.pResolveAttachments =
+            msaa_enabled ? &resolve_attachment_ref : nullptr;
+
+        ::std::vector<VkSubpassDescription> subpasses;
+        if (m_config.get_depth_prepass()) {
+            subpasses.emplace_back(depth_prepass_subpass);
+        }
+        subpasses.emplace_back(subpass);
+
+        // The subpass that writes the colour attachments.
+        const uint32_t shading_subpass = static_cast<uint32_t>(
+            subpasses.size() - 1
+        );
 
-        // Renderpass subpass depencency.
+        // Renderpass subpass depencency. The multisampled colour attachment
+        // is shared by the frames in flight, so the colour writes of the
+        // previous frame are waited on before the shading subpass writes.
         VkSubpassDependency dependency{};
         dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-        dependency.dstSubpass = 0;
+        dependency.dstSubpass = shading_subpass;
         dependency.srcStageMask = VkPipelineStageFlagBits
             ::VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.srcAccessMask = 0;
+        dependency.srcAccessMask = VkAccessFlagBits
+            ::VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
         dependency.dstStageMask = VkPipelineStageFlagBits
             ::VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
         dependency.dstAccessMask = VkAccessFlagBits
             ::VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
+        // So is the depth attachment, whose first writer is subpass 0.
+        VkSubpassDependency depth_dependency{};
+        depth_dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        depth_dependency.dstSubpass = 0;
+        depth_dependency.srcStageMask =
+            VkPipelineStageFlagBits
+                ::VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+            VkPipelineStageFlagBits
+                ::VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        depth_dependency.srcAccessMask = VkAccessFlagBits
+            ::VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        depth_dependency.dstStageMask =
+            VkPipelineStageFlagBits
+                ::VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+            VkPipelineStageFlagBits
+                ::VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        depth_dependency.dstAccessMask =
+            VkAccessFlagBits::VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+            VkAccessFlagBits::VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        // The shading subpass tests against the depth of the prepass.
+        VkSubpassDependency depth_prepass_dependency{};
+        depth_prepass_dependency.srcSubpass = 0;
+        depth_prepass_dependency.dstSubpass = 1;
+        depth_prepass_dependency.srcStageMask = VkPipelineStageFlagBits
+            ::VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        depth_prepass_dependency.srcAccessMask = VkAccessFlagBits
+            ::VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        depth_prepass_dependency.dstStageMask = VkPipelineStageFlagBits
+            ::VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        depth_prepass_dependency.dstAccessMask = VkAccessFlagBits
+            ::VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        depth_prepass_dependency.dependencyFlags = VkDependencyFlagBits
+            ::VK_DEPENDENCY_BY_REGION_BIT;
+
+        ::std::vector<VkSubpassDependency> dependencies = {
+            dependency, depth_dependency
+        };
+        if (m_config.get_depth_prepass()) {
+            dependencies.emplace_back(depth_prepass_dependency);
+        }
+
         // Render pass info.
         VkRenderPassCreateInfo render_pass_info{};
         render_pass_info.sType = VkStructureType
             ::VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        render_pass_info.attachmentCount = 1;
-        render_pass_info.pAttachments = &colour_attachment;
-        render_pass_info.subpassCount = 1;
-        render_pass_info.pSubpasses = &subpass;
-        render_pass_info.dependencyCount = 1;
-        render_pass_info.pDependencies = &dependency;
+        render_pass_info.attachmentCount = static_cast<uint32_t>(
+            attachments.size()
+        );
+        render_pass_info.pAttachments = attachments.data();
+        render_pass_info.subpassCount = static_cast<uint32_t>(
+            subpasses.size()
+        );
+        render_pass_info.pSubpasses = subpasses.data();
+        render_pass_info.dependencyCount = static_cast<uint32_t>(
+            dependencies.size()
+        );
+        render_pass_info.pDependencies = dependencies.data();
 
         result = vkCreateRenderPass(
-            m_logical_device, &render_pass_info, nullptr, &m_render_pass
+            m_logical_device, &render_pass_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_RENDER_PASS), &m_render_pass
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -71,8 +213,157 @@ namespace vk::tut {
     }
 
     void Application::destroy_render_pass() {
-        vkDestroyRenderPass(m_logical_device, m_render_pass, nullptr);
+        vkDestroyRenderPass(m_logical_device, m_render_pass,
+            get_allocation_callbacks(VK_OBJECT_TYPE_RENDER_PASS));
 
         VK_TUT_LOG_DEBUG("Destroyed render pass.");
     }
+
+    void Application::create_render_graph() {
+        VK_TUT_TRACE_SCOPE("create_render_graph");
+
+        m_ptr_render_graph = ::std::make_unique<RenderGraph>();
+
+        // Every frame starts with a swapchain image whose contents are
+        // discarded, once the image available semaphore was waited on.
+        // It ends in the present layout, unless nothing is presented.
+        m_swapchain_image_resource = m_ptr_render_graph->import_image(
+            "swapchain", VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
+            ResourceState(
+                VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
+                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                VK_ACCESS_2_NONE_KHR
+            ),
+            m_config.get_headless() ? ResourceState() : ResourceState(
+                VkImageLayout::VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                VK_PIPELINE_STAGE_2_NONE_KHR, VK_ACCESS_2_NONE_KHR
+            )
+        );
+
+        // The attachments only the main render pass uses. Without MSAA
+        // the swapchain image is rendered to directly. Only ever used
+        // within the render pass, so with lazily allocated memory the
+        // contents never have to leave the tile memory.
+        const bool msaa_enabled =
+            m_msaa_samples != VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT;
+        m_depth_image_resource = m_ptr_render_graph->create_image(
+            "depth", RenderGraphImageInfo(
+                m_depth_format, m_swapchain_extent,
+                VkImageUsageFlagBits
+                    ::VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+                VkImageAspectFlagBits::VK_IMAGE_ASPECT_DEPTH_BIT,
+                m_msaa_samples
+            )
+        );
+        if (msaa_enabled) {
+            m_colour_image_resource = m_ptr_render_graph->create_image(
+                "msaa_colour", RenderGraphImageInfo(
+                    m_swapchain_image_format, m_swapchain_extent,
+                    VkImageUsageFlagBits
+                        ::VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                    VkImageUsageFlagBits
+                        ::VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+                    VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
+                    m_msaa_samples
+                )
+            );
+        }
+
+        // The main render pass transitions its attachments itself,
+        // from their undefined initial layouts to their final layouts.
+        RenderGraphPass& main_pass = m_ptr_render_graph->add_pass("main",
+        [this](const VkCommandBuffer& command_buffer) {
+            m_gpu_profiler.begin_region(
+                command_buffer, m_current_frame_index, "main"
+            );
+            m_pipeline_statistics.begin(command_buffer, m_current_frame_index);
+            record_main_pass(command_buffer);
+            m_pipeline_statistics.end(command_buffer, m_current_frame_index);
+            m_gpu_profiler.end_region(
+                command_buffer, m_current_frame_index, "main"
+            );
+        }).write(m_swapchain_image_resource,
+            ResourceState(
+                VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
+                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+            ),
+            ResourceState(
+                get_output_image_layout(),
+                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+            )
+        );
+        main_pass.write(m_depth_image_resource,
+            ResourceState(
+                VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR |
+                VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR |
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR
+            ),
+            ResourceState(
+                VkImageLayout::VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR
+            )
+        );
+        if (msaa_enabled) {
+            main_pass.write(m_colour_image_resource,
+                ResourceState(
+                    VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+                ),
+                ResourceState(
+                    VkImageLayout::VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                    VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+                )
+            );
+        }
+
+        // Copies the finished image into the buffer of the frame slot
+        // the command buffer is recorded for.
+        if (m_ptr_readback_ring != nullptr) {
+            m_ptr_render_graph->add_pass("readback",
+            [this](const VkCommandBuffer& command_buffer) {
+                m_gpu_profiler.begin_region(
+                    command_buffer, m_current_frame_index, "readback"
+                );
+                m_ptr_readback_ring->record_copy(command_buffer,
+                    m_swapchain_images[m_recording_image_index],
+                    m_current_frame_index, m_resource_state_tracker,
+                    m_vk_cmd_pipeline_barrier2
+                );
+                m_gpu_profiler.end_region(
+                    command_buffer, m_current_frame_index, "readback"
+                );
+            }).read(m_swapchain_image_resource,
+                ResourceState(
+                    VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                    VK_ACCESS_2_TRANSFER_READ_BIT_KHR
+                )
+            ).set_side_effect();
+        }
+
+        m_ptr_render_graph->compile();
+        m_ptr_render_graph->realize(m_physical_device, m_logical_device);
+
+        VK_TUT_LOG_DEBUG("Successfully created render graph.");
+    }
+
+    void Application::destroy_render_graph() {
+        m_resource_state_tracker.forget_image(
+            m_ptr_render_graph->get_image(m_swapchain_image_resource)
+        );
+        m_ptr_render_graph->release(
+            m_logical_device, m_resource_state_tracker
+        );
+        m_ptr_render_graph.reset();
+
+        VK_TUT_LOG_DEBUG("Destroyed render graph.");
+    }
 }
\ No newline at end of file
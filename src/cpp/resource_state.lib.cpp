@@ -0,0 +1,336 @@
+#include "vk_tut/resource_state.h"
+
+#include <algorithm>
+
+namespace vk::tut {
+    // Copy initializer list constructor.
+    ResourceState::ResourceState(
+        const VkImageLayout& layout,
+        const VkPipelineStageFlags2KHR& stages,
+        const VkAccessFlags2KHR& access
+    ) : m_layout(layout), m_stages(stages), m_access(access) {}
+
+    // Copy initializer list constructor for buffers.
+    ResourceState::ResourceState(
+        const VkPipelineStageFlags2KHR& stages,
+        const VkAccessFlags2KHR& access
+    ) : m_stages(stages), m_access(access) {}
+
+    void ResourceStateTracker::track_image(
+        const VkImage& image,
+        const VkImageAspectFlags& aspect_mask,
+        const ResourceState& initial_state
+    ) {
+        forget_image(image);
+        m_images[image] = make_tracked_state(aspect_mask, initial_state);
+    }
+
+    void ResourceStateTracker::track_buffer(
+        const VkBuffer& buffer,
+        const ResourceState& initial_state
+    ) {
+        forget_buffer(buffer);
+        m_buffers[buffer] = make_tracked_state(0, initial_state);
+    }
+
+    void ResourceStateTracker::forget_image(const VkImage& image) {
+        m_images.erase(image);
+        m_pending_image_barriers.erase(
+            ::std::remove_if(
+                m_pending_image_barriers.begin(),
+                m_pending_image_barriers.end(),
+                [&image](const VkImageMemoryBarrier2KHR& barrier) {
+                    return barrier.image == image;
+                }
+            ),
+            m_pending_image_barriers.end()
+        );
+    }
+
+    void ResourceStateTracker::forget_buffer(const VkBuffer& buffer) {
+        m_buffers.erase(buffer);
+        m_pending_buffer_barriers.erase(
+            ::std::remove_if(
+                m_pending_buffer_barriers.begin(),
+                m_pending_buffer_barriers.end(),
+                [&buffer](const VkBufferMemoryBarrier2KHR& barrier) {
+                    return barrier.buffer == buffer;
+                }
+            ),
+            m_pending_buffer_barriers.end()
+        );
+    }
+
+    void ResourceStateTracker::require_image_state(
+        const VkImage& image, const ResourceState& state
+    ) {
+        // Untracked images are assumed to be unused.
+        auto iterator = m_images.find(image);
+        if (iterator == m_images.end()) {
+            iterator = m_images.emplace(
+                image, make_tracked_state(
+                    VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
+                    ResourceState()
+                )
+            ).first;
+        }
+        TrackedState& tracked = iterator->second;
+
+        const VkImageLayout old_layout = tracked.layout;
+        VkPipelineStageFlags2KHR src_stages;
+        VkAccessFlags2KHR src_access;
+        if (!transition(tracked, state, true, src_stages, src_access)) {
+            return;
+        }
+
+        // A second requirement before a flush extends the queued barrier,
+        // as no command could have used the resource in between.
+        for (VkImageMemoryBarrier2KHR& barrier : m_pending_image_barriers) {
+            if (barrier.image != image) continue;
+
+            barrier.newLayout = state.get_layout();
+            barrier.dstStageMask |= state.get_stages();
+            barrier.dstAccessMask |= state.get_access();
+            return;
+        }
+
+        VkImageMemoryBarrier2KHR barrier{};
+        barrier.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+        barrier.srcStageMask = src_stages;
+        barrier.srcAccessMask = src_access;
+        barrier.dstStageMask = state.get_stages();
+        barrier.dstAccessMask = state.get_access();
+        barrier.oldLayout = old_layout;
+        barrier.newLayout = state.get_layout();
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = tracked.aspect_mask;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+        m_pending_image_barriers.emplace_back(barrier);
+    }
+
+    void ResourceStateTracker::require_buffer_state(
+        const VkBuffer& buffer, const ResourceState& state
+    ) {
+        // Untracked buffers are assumed to be unused.
+        TrackedState& tracked = m_buffers.try_emplace(
+            buffer, make_tracked_state(0, ResourceState())
+        ).first->second;
+
+        VkPipelineStageFlags2KHR src_stages;
+        VkAccessFlags2KHR src_access;
+        if (!transition(tracked, state, false, src_stages, src_access)) {
+            return;
+        }
+
+        // A second requirement before a flush extends the queued barrier.
+        for (VkBufferMemoryBarrier2KHR& barrier : m_pending_buffer_barriers) {
+            if (barrier.buffer != buffer) continue;
+
+            barrier.dstStageMask |= state.get_stages();
+            barrier.dstAccessMask |= state.get_access();
+            return;
+        }
+
+        VkBufferMemoryBarrier2KHR barrier{};
+        barrier.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+        barrier.srcStageMask = src_stages;
+        barrier.srcAccessMask = src_access;
+        barrier.dstStageMask = state.get_stages();
+        barrier.dstAccessMask = state.get_access();
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = buffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+
+        m_pending_buffer_barriers.emplace_back(barrier);
+    }
+
+    void ResourceStateTracker::require_memory_dependency(
+        const VkPipelineStageFlags2KHR& src_stages,
+        const VkAccessFlags2KHR& src_access,
+        const VkPipelineStageFlags2KHR& dst_stages,
+        const VkAccessFlags2KHR& dst_access
+    ) {
+        if (src_stages == VK_PIPELINE_STAGE_2_NONE_KHR) return;
+
+        // One barrier waits on the union of everything queued.
+        if (!m_pending_memory_barriers.empty()) {
+            VkMemoryBarrier2KHR& barrier = m_pending_memory_barriers[0];
+            barrier.srcStageMask |= src_stages;
+            barrier.srcAccessMask |= src_access & WRITE_ACCESS_FLAGS;
+            barrier.dstStageMask |= dst_stages;
+            barrier.dstAccessMask |= dst_access;
+            return;
+        }
+
+        // Only writes have to be made available, reads just need
+        // an execution dependency.
+        VkMemoryBarrier2KHR barrier{};
+        barrier.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+        barrier.srcStageMask = src_stages;
+        barrier.srcAccessMask = src_access & WRITE_ACCESS_FLAGS;
+        barrier.dstStageMask = dst_stages;
+        barrier.dstAccessMask = dst_access;
+
+        m_pending_memory_barriers.emplace_back(barrier);
+    }
+
+    void ResourceStateTracker::set_image_state(
+        const VkImage& image, const ResourceState& state
+    ) {
+        auto iterator = m_images.find(image);
+        VkImageAspectFlags aspect_mask = iterator != m_images.end() ?
+            iterator->second.aspect_mask :
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT;
+
+        m_images[image] = make_tracked_state(aspect_mask, state);
+    }
+
+    ResourceState ResourceStateTracker::get_image_state(
+        const VkImage& image
+    ) const {
+        auto iterator = m_images.find(image);
+        if (iterator == m_images.end()) return ResourceState();
+
+        const TrackedState& tracked = iterator->second;
+        return ResourceState(
+            tracked.layout,
+            tracked.write_stages | tracked.read_stages,
+            tracked.write_access | tracked.read_access
+        );
+    }
+
+    ResourceState ResourceStateTracker::get_buffer_state(
+        const VkBuffer& buffer
+    ) const {
+        auto iterator = m_buffers.find(buffer);
+        if (iterator == m_buffers.end()) return ResourceState();
+
+        const TrackedState& tracked = iterator->second;
+        return ResourceState(
+            tracked.write_stages | tracked.read_stages,
+            tracked.write_access | tracked.read_access
+        );
+    }
+
+    size_t ResourceStateTracker::get_pending_barrier_count() const {
+        return m_pending_image_barriers.size() +
+            m_pending_buffer_barriers.size() +
+            m_pending_memory_barriers.size();
+    }
+
+    void ResourceStateTracker::flush(
+        const VkCommandBuffer& command_buffer,
+        PFN_vkCmdPipelineBarrier2KHR cmd_pipeline_barrier2
+    ) {
+        if (get_pending_barrier_count() == 0) return;
+
+        VkDependencyInfoKHR dependency_info{};
+        dependency_info.sType = VkStructureType
+            ::VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dependency_info.memoryBarrierCount = static_cast<uint32_t>(
+            m_pending_memory_barriers.size()
+        );
+        dependency_info.pMemoryBarriers = m_pending_memory_barriers.data();
+        dependency_info.imageMemoryBarrierCount = static_cast<uint32_t>(
+            m_pending_image_barriers.size()
+        );
+        dependency_info.pImageMemoryBarriers =
+            m_pending_image_barriers.data();
+        dependency_info.bufferMemoryBarrierCount = static_cast<uint32_t>(
+            m_pending_buffer_barriers.size()
+        );
+        dependency_info.pBufferMemoryBarriers =
+            m_pending_buffer_barriers.data();
+
+        cmd_pipeline_barrier2(command_buffer, &dependency_info);
+
+        // Keeps the capacity for the next batch.
+        m_pending_image_barriers.clear();
+        m_pending_buffer_barriers.clear();
+        m_pending_memory_barriers.clear();
+    }
+
+    ResourceStateTracker::TrackedState
+    ResourceStateTracker::make_tracked_state(
+        const VkImageAspectFlags& aspect_mask,
+        const ResourceState& state
+    ) {
+        TrackedState tracked;
+        tracked.aspect_mask = aspect_mask;
+        tracked.layout = state.get_layout();
+        // The stages of the initial state are what the next
+        // barrier has to wait on, such as a semaphore wait stage.
+        tracked.write_stages = state.get_stages();
+        tracked.write_access = state.get_access() & WRITE_ACCESS_FLAGS;
+        if (!state.is_write()) {
+            tracked.read_stages = state.get_stages();
+            tracked.read_access = state.get_access();
+        }
+
+        return tracked;
+    }
+
+    bool ResourceStateTracker::transition(
+        TrackedState& tracked, const ResourceState& state,
+        const bool& is_image,
+        VkPipelineStageFlags2KHR& src_stages,
+        VkAccessFlags2KHR& src_access
+    ) {
+        const bool layout_change = is_image &&
+            tracked.layout != state.get_layout();
+
+        // Read after write only has to wait for the last write, and only
+        // once for each stage. Read after read needs no barrier at all.
+        if (!layout_change && !state.is_write()) {
+            const bool already_visible =
+                (state.get_stages() & ~tracked.read_stages) == 0 &&
+                (state.get_access() & ~tracked.read_access) == 0;
+
+            tracked.read_stages |= state.get_stages();
+            tracked.read_access |= state.get_access();
+
+            if (tracked.write_stages == VK_PIPELINE_STAGE_2_NONE_KHR ||
+            already_visible) {
+                return false;
+            }
+
+            src_stages = tracked.write_stages;
+            src_access = tracked.write_access;
+            return true;
+        }
+
+        // Writes and layout transitions wait for every previous access.
+        // Only writes have to be made available, reads just need
+        // an execution dependency.
+        src_stages = tracked.write_stages | tracked.read_stages;
+        src_access = tracked.write_access;
+
+        tracked.layout = state.get_layout();
+        tracked.write_stages = state.get_stages();
+        tracked.write_access = state.get_access() & WRITE_ACCESS_FLAGS;
+        if (state.is_write()) {
+            tracked.read_stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+            tracked.read_access = VK_ACCESS_2_NONE_KHR;
+        }
+        else {
+            // The stages of a layout transition to a read only
+            // layout can read the resource right away.
+            tracked.read_stages = state.get_stages();
+            tracked.read_access = state.get_access();
+        }
+
+        // Nothing to wait for on a resource that was never used.
+        return layout_change || src_stages != VK_PIPELINE_STAGE_2_NONE_KHR;
+    }
+}
\ No newline at end of file
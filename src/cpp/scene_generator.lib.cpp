@@ -0,0 +1,244 @@
+#include "vk_tut/scene_generator.h"
+#include "vk_tut/mesh.h"
+#include "vk_tut/logging.h"
+
+#include <algorithm>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace vk::tut {
+    // The side of the cube the objects are laid out in, around the
+    // origin. Sized to fit the view of update_uniform_buffer.
+    static const float SCENE_EXTENT = 1.0f;
+    // The part of its grid cell an object spans.
+    static const float OBJECT_CELL_FILL = 0.8f;
+    // The fastest an object spins, in radians per second.
+    static const float MAX_SPIN_SPEED = ::glm::radians(180.0f);
+    // Past this many cycles through the kinds of mesh,
+    // the meshes stop getting more triangles.
+    static const uint32_t MAX_MESH_DETAIL = 6;
+
+    // Mixes the bits of a value, so that close values end up far apart.
+    static uint32_t mix_bits(uint32_t value) {
+        value ^= value >> 16;
+        value *= 0x7feb352dU;
+        value ^= value >> 15;
+        value *= 0x846ca68bU;
+        value ^= value >> 16;
+        return value;
+    }
+
+    // A reproducible number in [0, 1). Each stream of an object
+    // gives a different number.
+    static float get_random(
+        const uint32_t& seed, const uint32_t& object, const uint32_t& stream
+    ) {
+        const uint32_t bits = mix_bits(mix_bits(seed ^ mix_bits(object)) +
+            stream);
+        // The 24 bits a float holds exactly.
+        return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // The product of two quaternions, rotating by b then by a.
+    static ::glm::vec4 multiply_quaternions(
+        const ::glm::vec4& a, const ::glm::vec4& b
+    ) {
+        const ::glm::vec3 a_vector(a.x, a.y, a.z);
+        const ::glm::vec3 b_vector(b.x, b.y, b.z);
+        return ::glm::vec4(
+            a.w * b_vector + b.w * a_vector + ::glm::cross(a_vector, b_vector),
+            a.w * b.w - ::glm::dot(a_vector, b_vector)
+        );
+    }
+
+    // Generates scenes as described. Counts of 0 count as 1.
+    SceneGenerator::SceneGenerator(const Parameters& parameters) :
+    m_parameters(parameters) {
+        m_parameters.object_count = ::std::max(parameters.object_count, 1U);
+        m_parameters.mesh_count = ::std::max(parameters.mesh_count, 1U);
+        m_parameters.instances_per_draw =
+            ::std::max(parameters.instances_per_draw, 1U);
+        m_parameters.texture_count = ::std::max(parameters.texture_count, 1U);
+    }
+
+    void SceneGenerator::generate(
+        const ::std::vector<uint32_t>& texture_indices,
+        ::std::vector<Vertex>& ref_vertices,
+        ::std::vector<uint32_t>& ref_indices,
+        ::std::vector<DrawCommand>& ref_draw_commands,
+        ::std::vector<InstanceTransform>& ref_instances
+    ) const {
+        const uint32_t object_count = m_parameters.object_count;
+        const uint32_t mesh_count = m_parameters.mesh_count;
+        const uint32_t texture_count = m_parameters.texture_count;
+        const uint32_t instances_per_draw = m_parameters.instances_per_draw;
+
+        if (texture_indices.size() < texture_count) {
+            VK_TUT_LOG_ERROR("Fewer texture slots than scene textures.");
+        }
+
+        // The range of indices of each mesh.
+        ::std::vector<uint32_t> mesh_first_indices(mesh_count);
+        ::std::vector<uint32_t> mesh_index_counts(mesh_count);
+        for (uint32_t mesh = 0; mesh < mesh_count; mesh++) {
+            mesh_first_indices[mesh] =
+                static_cast<uint32_t>(ref_indices.size());
+
+            const uint32_t detail = ::std::min(mesh / 3, MAX_MESH_DETAIL);
+            switch (mesh % 3) {
+            case 0:
+                generate_cube_mesh(ref_vertices, ref_indices);
+                break;
+            case 1:
+                generate_sphere_mesh(8U << detail, ref_vertices, ref_indices);
+                break;
+            default:
+                generate_colour_wheel_mesh(
+                    16U << detail, ref_vertices, ref_indices
+                );
+                break;
+            }
+
+            mesh_index_counts[mesh] = static_cast<uint32_t>(
+                ref_indices.size()
+            ) - mesh_first_indices[mesh];
+        }
+
+        // The objects cycle through the meshes, and through the textures
+        // every full cycle of the meshes, so every pair of a mesh and a
+        // texture gets used. The objects of a pair form a group.
+        const uint32_t group_count = mesh_count * texture_count;
+        auto get_group = [&](const uint32_t& object) {
+            return (object % mesh_count) * texture_count +
+                (object / mesh_count) % texture_count;
+        };
+
+        // The instances are sorted by group, so the instances a draw
+        // draws are contiguous. Find where each group starts.
+        ::std::vector<uint32_t> group_first_instances(group_count + 1, 0);
+        for (uint32_t object = 0; object < object_count; object++) {
+            group_first_instances[get_group(object) + 1]++;
+        }
+        for (uint32_t group = 0; group < group_count; group++) {
+            group_first_instances[group + 1] += group_first_instances[group];
+        }
+
+        // The objects fill the cells of a grid, one per cell.
+        uint32_t grid_size = 1;
+        while (static_cast<uint64_t>(grid_size) * grid_size * grid_size <
+        object_count) {
+            grid_size++;
+        }
+        const float cell_size = SCENE_EXTENT / grid_size;
+
+        const uint32_t first_instance =
+            static_cast<uint32_t>(ref_instances.size());
+        ref_instances.resize(first_instance + object_count);
+        // Where the next instance of each group goes.
+        ::std::vector<uint32_t> group_next_instances(
+            group_first_instances.begin(), group_first_instances.end() - 1
+        );
+        for (uint32_t object = 0; object < object_count; object++) {
+            const ::glm::vec3 cell(
+                object % grid_size,
+                (object / grid_size) % grid_size,
+                object / (grid_size * grid_size)
+            );
+            const ::glm::vec3 position =
+                (cell + 0.5f) * cell_size - 0.5f * SCENE_EXTENT;
+
+            // A random axis and angle, for a random orientation.
+            ::glm::vec3 axis(
+                get_random(m_parameters.seed, object, 0) - 0.5f,
+                get_random(m_parameters.seed, object, 1) - 0.5f,
+                get_random(m_parameters.seed, object, 2) - 0.5f
+            );
+            axis = ::glm::dot(axis, axis) > 1e-6f ?
+                ::glm::normalize(axis) : ::glm::vec3(0.0f, 0.0f, 1.0f);
+            const float half_angle = get_random(m_parameters.seed, object, 3) *
+                ::glm::radians(180.0f);
+
+            ref_instances[first_instance +
+                group_next_instances[get_group(object)]++] =
+                InstanceTransform(
+                    position, OBJECT_CELL_FILL * cell_size,
+                    ::glm::vec4(
+                        ::glm::sin(half_angle) * axis, ::glm::cos(half_angle)
+                    )
+                );
+        }
+
+        // Split each group into draws of up to instances_per_draw.
+        ref_draw_commands.reserve(ref_draw_commands.size() + group_count +
+            object_count / instances_per_draw);
+        for (uint32_t group = 0; group < group_count; group++) {
+            const uint32_t mesh = group / texture_count;
+            const uint32_t texture = group % texture_count;
+            const uint32_t group_end = group_first_instances[group + 1];
+            for (uint32_t instance = group_first_instances[group];
+            instance < group_end; instance += instances_per_draw) {
+                ref_draw_commands.emplace_back(
+                    mesh_index_counts[mesh], mesh_first_indices[mesh], 0,
+                    texture_indices[texture],
+                    ::std::min(instances_per_draw, group_end - instance),
+                    first_instance + instance
+                );
+            }
+        }
+    }
+
+    void SceneGenerator::animate(
+        const float& time,
+        const ::std::vector<InstanceTransform>& instances,
+        InstanceTransform* ptr_animated
+    ) const {
+        for (size_t i = 0; i < instances.size(); i++) {
+            // Each instance spins about its own z axis, at its own speed.
+            const float speed = MAX_SPIN_SPEED * (2.0f * get_random(
+                m_parameters.seed, static_cast<uint32_t>(i), 4
+            ) - 1.0f);
+            const float half_angle = 0.5f * time * speed;
+            const ::glm::vec4 spin(
+                0.0f, 0.0f, ::glm::sin(half_angle), ::glm::cos(half_angle)
+            );
+
+            // Written once, as ptr_animated is often mapped device memory.
+            InstanceTransform animated(instances[i]);
+            animated.set_rotation(
+                multiply_quaternions(instances[i].get_rotation(), spin)
+            );
+            ptr_animated[i] = animated;
+        }
+    }
+
+    void SceneGenerator::generate_texture(
+        const uint32_t& texture_index,
+        ::std::vector<uint8_t>& ref_pixels
+    ) {
+        // The number of squares along each side of the checkerboard.
+        const uint32_t square_count = 8;
+        const uint32_t square_size = TEXTURE_SIZE / square_count;
+
+        const uint32_t colour_bits = mix_bits(texture_index + 1);
+        const uint8_t colour[] = {
+            static_cast<uint8_t>(128 | colour_bits),
+            static_cast<uint8_t>(128 | (colour_bits >> 8)),
+            static_cast<uint8_t>(128 | (colour_bits >> 16))
+        };
+
+        ref_pixels.resize(TEXTURE_SIZE * TEXTURE_SIZE * 4);
+        for (uint32_t y = 0; y < TEXTURE_SIZE; y++) {
+            for (uint32_t x = 0; x < TEXTURE_SIZE; x++) {
+                // The dark squares are half as bright.
+                const bool dark = (x / square_size + y / square_size) % 2;
+                uint8_t* ptr_pixel = &ref_pixels[(y * TEXTURE_SIZE + x) * 4];
+                for (uint32_t channel = 0; channel < 3; channel++) {
+                    ptr_pixel[channel] = dark ?
+                        colour[channel] / 2 : colour[channel];
+                }
+                ptr_pixel[3] = 255;
+            }
+        }
+    }
+}
\ No newline at end of file
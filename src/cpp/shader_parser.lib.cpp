@@ -1,4 +1,5 @@
 #include "vk_tut/shader_parser.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 
 #include <filesystem>
@@ -57,7 +58,9 @@ namespace vk::tut {
         VkShaderModule shader_module;
 
         result = vkCreateShaderModule(
-            logical_device, &shader_module_info, nullptr, &shader_module
+            logical_device, &shader_module_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE),
+            &shader_module
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
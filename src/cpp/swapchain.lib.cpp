@@ -1,4 +1,5 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 #include "vk_tut/swapchain_support.h"
 #include "vk_tut/queue_family.h"
@@ -8,6 +9,14 @@
 
 namespace vk::tut {
     void Application::create_swapchain() {
+        VK_TUT_TRACE_SCOPE("create_swapchain");
+
+        // Nothing is presented in headless mode.
+        if (m_config.get_headless()) {
+            create_headless_images();
+            return;
+        }
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -63,10 +72,24 @@ namespace vk::tut {
         swapchain_info.imageFormat = m_swapchain_image_format;
         swapchain_info.presentMode = present_mode;
         swapchain_info.clipped = VK_TRUE; // Simply clip the obscured pixels.
+        // Lets the presentation engine hand over the
+        // resources of the swapchain being replaced.
+        swapchain_info.oldSwapchain = m_swapchain;
         swapchain_info.imageExtent = m_swapchain_extent;
         swapchain_info.imageArrayLayers = 1;
         swapchain_info.imageUsage = VkImageUsageFlagBits
             ::VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        // The rendered images are copied from to be read back.
+        if (!m_config.get_readback_directory().empty()) {
+            if ((swapchan_support.get_capabilities().supportedUsageFlags &
+            VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_SRC_BIT) == 0) {
+                VK_TUT_LOG_ERROR(
+                    "The swapchain images can not be read back."
+                );
+            }
+            swapchain_info.imageUsage |= VkImageUsageFlagBits
+                ::VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        }
         swapchain_info.preTransform = swapchan_support
             .get_capabilities().currentTransform;
         // Used for blending with other windows in the
@@ -86,7 +109,8 @@ namespace vk::tut {
         }
         
         result = vkCreateSwapchainKHR(
-            m_logical_device, &swapchain_info, nullptr, &m_swapchain
+            m_logical_device, &swapchain_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SWAPCHAIN_KHR), &m_swapchain
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -114,6 +138,8 @@ namespace vk::tut {
     }
 
     void Application::create_swapchain_image_views() {
+        VK_TUT_TRACE_SCOPE("create_swapchain_image_views");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -147,7 +173,8 @@ namespace vk::tut {
             VkImageView image_view;
 
             result = vkCreateImageView(
-                m_logical_device, &image_view_info, nullptr, &image_view
+                m_logical_device, &image_view_info,
+                get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE_VIEW), &image_view
             );
             if (result != VkResult::VK_SUCCESS) {
                 VK_TUT_LOG_ERROR(
@@ -162,6 +189,8 @@ namespace vk::tut {
     }
 
     void Application::create_swapchain_frame_buffers() {
+        VK_TUT_TRACE_SCOPE("create_swapchain_frame_buffers");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -171,8 +200,22 @@ namespace vk::tut {
 
         // Loop through each image view.
         for (const VkImageView& image_view : m_swapchain_image_views) {
-            // The image view the framebuffer is attaching to.
-            VkImageView attachments[] = {image_view};
+            // The image views the framebuffer is attaching to. The depth
+            // and multisampled colour attachments are made by the render
+            // graph. With MSAA the swapchain image is the resolve attachment.
+            const VkImageView depth_image_view =
+                m_ptr_render_graph->get_image_view(m_depth_image_resource);
+            ::std::vector<VkImageView> attachments;
+            if (m_msaa_samples ==
+            VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT) {
+                attachments = {image_view, depth_image_view};
+            }
+            else {
+                attachments = {
+                    m_ptr_render_graph->get_image_view(m_colour_image_resource),
+                    depth_image_view, image_view
+                };
+            }
 
             // The information about the framebuffer to be created.
             VkFramebufferCreateInfo frame_buffer_info{};
@@ -182,15 +225,19 @@ namespace vk::tut {
             frame_buffer_info.width = m_swapchain_extent.width;
             frame_buffer_info.height = m_swapchain_extent.height;
             frame_buffer_info.layers = 1;
-            frame_buffer_info.attachmentCount = 1;
-            frame_buffer_info.pAttachments = attachments;
+            frame_buffer_info.attachmentCount = static_cast<uint32_t>(
+                attachments.size()
+            );
+            frame_buffer_info.pAttachments = attachments.data();
 
             // The framebuffer to be created.
             VkFramebuffer frame_buffer;
 
             // Create the framebuffer.
             result = vkCreateFramebuffer(
-                m_logical_device, &frame_buffer_info, nullptr, &frame_buffer
+                m_logical_device, &frame_buffer_info,
+                get_allocation_callbacks(VK_OBJECT_TYPE_FRAMEBUFFER),
+                &frame_buffer
             );
             if (result != VkResult::VK_SUCCESS) {
                 VK_TUT_LOG_ERROR(
@@ -207,7 +254,8 @@ namespace vk::tut {
     void Application::destroy_swapchain_frame_buffers() {
         // Loop through each framebuffer and destroy them.
         for (const VkFramebuffer& frame_buffer : m_swapchain_frame_buffers) {
-            vkDestroyFramebuffer(m_logical_device, frame_buffer, nullptr);
+            vkDestroyFramebuffer(m_logical_device, frame_buffer,
+                get_allocation_callbacks(VK_OBJECT_TYPE_FRAMEBUFFER));
         }
 
         // Clear the list.
@@ -219,7 +267,8 @@ namespace vk::tut {
 
     void Application::destroy_swapchain_image_views() {
         for (const VkImageView& image_view : m_swapchain_image_views) {
-            vkDestroyImageView(m_logical_device, image_view, nullptr);
+            vkDestroyImageView(m_logical_device, image_view,
+                get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE_VIEW));
         }
 
         m_swapchain_image_views.clear();
@@ -229,28 +278,129 @@ namespace vk::tut {
     }
 
     void Application::destroy_swapchain() {
-        vkDestroySwapchainKHR(m_logical_device, m_swapchain, nullptr);
+        if (m_config.get_headless()) {
+            destroy_headless_images();
+            return;
+        }
+
+        vkDestroySwapchainKHR(m_logical_device, m_swapchain,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SWAPCHAIN_KHR));
 
         VK_TUT_LOG_DEBUG("Destroyed swapchain.");
     }
 
     void Application::recreate_swapchain() {
-        // Wait for resources to be free.
-        vkDeviceWaitIdle(m_logical_device);
-
-        // Destroy the current swapchain related objects.
-        destroy_swapchain_frame_buffers();
-        destroy_graphics_pipeline();
-        destroy_render_pass();
-        destroy_swapchain_image_views();
-        destroy_swapchain();
+        VK_TUT_TRACE_SCOPE("recreate_swapchain");
+
+        // The frames in flight may still use the current swapchain related
+        // objects. Hand them to the deletion queue instead of waiting for
+        // the device to be idle.
+        VkDevice logical_device = m_logical_device;
+        VkQueue present_queue = m_present_queue;
+        VkSwapchainKHR old_swapchain = m_swapchain;
+        ::std::vector<VkFramebuffer> old_frame_buffers =
+            ::std::move(m_swapchain_frame_buffers);
+        ::std::vector<VkImageView> old_image_views =
+            ::std::move(m_swapchain_image_views);
+        VkPipeline old_graphics_pipeline = m_graphics_pipeline;
+        VkPipelineLayout old_graphics_pipeline_layout =
+            m_graphics_pipeline_layout;
+        VkShaderModule old_vertex_shader_module = m_vertex_shader_module;
+        VkShaderModule old_fragment_shader_module = m_fragment_shader_module;
+        VkShaderModule old_depth_prepass_shader_module =
+            m_depth_prepass_shader_module;
+        VkPipeline old_depth_prepass_pipeline = m_depth_prepass_pipeline;
+        VkShaderModule old_debug_draw_vertex_shader_module =
+            m_debug_draw_vertex_shader_module;
+        VkShaderModule old_debug_draw_fragment_shader_module =
+            m_debug_draw_fragment_shader_module;
+        VkPipeline old_debug_line_pipeline = m_debug_line_pipeline;
+        VkPipeline old_debug_point_pipeline = m_debug_point_pipeline;
+        VkRenderPass old_render_pass = m_render_pass;
+        ::std::shared_ptr<RenderGraph> ptr_old_render_graph =
+            ::std::move(m_ptr_render_graph);
+        ::std::shared_ptr<ReadbackRing> ptr_old_readback_ring =
+            ::std::move(m_ptr_readback_ring);
+        m_swapchain_frame_buffers.clear();
+        m_swapchain_image_views.clear();
 
         // Recreate swapchain and related objects.
+        // The current swapchain is passed as the old swapchain.
         create_swapchain();
         create_swapchain_image_views();
         create_render_pass();
         create_graphics_pipeline();
+        create_readback_ring();
+        create_render_graph();
         create_swapchain_frame_buffers();
+
+        // The cached command buffers refer to the old frame buffers.
+        retire_cached_command_buffers();
+
+        m_deletion_queue.enqueue(m_frame_counter, [=, this]() {
+            for (const VkFramebuffer& frame_buffer : old_frame_buffers) {
+                vkDestroyFramebuffer(logical_device, frame_buffer,
+                    get_allocation_callbacks(VK_OBJECT_TYPE_FRAMEBUFFER));
+            }
+            // Every frame copied into the old ring has finished by now.
+            if (ptr_old_readback_ring != nullptr) {
+                ptr_old_readback_ring->retrieve(logical_device,
+                ::std::numeric_limits<uint64_t>::max(),
+                [this](const ReadbackFrame& frame) {
+                    write_readback_frame(frame);
+                });
+                ptr_old_readback_ring->destroy(
+                    logical_device, m_resource_state_tracker
+                );
+            }
+            ptr_old_render_graph->release(
+                logical_device, m_resource_state_tracker
+            );
+            vkDestroyPipeline(logical_device, old_graphics_pipeline,
+                get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE));
+            vkDestroyPipeline(logical_device,
+                old_depth_prepass_pipeline,
+                get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE));
+            vkDestroyPipeline(logical_device, old_debug_line_pipeline,
+                get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE));
+            vkDestroyPipeline(logical_device, old_debug_point_pipeline,
+                get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE));
+            vkDestroyPipelineLayout(logical_device,
+                old_graphics_pipeline_layout,
+                get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE_LAYOUT));
+            vkDestroyShaderModule(logical_device,
+                old_vertex_shader_module,
+                get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
+            vkDestroyShaderModule(logical_device,
+                old_fragment_shader_module,
+                get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
+            vkDestroyShaderModule(logical_device,
+                old_depth_prepass_shader_module,
+                get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
+            vkDestroyShaderModule(logical_device,
+                old_debug_draw_vertex_shader_module,
+                get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
+            vkDestroyShaderModule(logical_device,
+                old_debug_draw_fragment_shader_module,
+                get_allocation_callbacks(VK_OBJECT_TYPE_SHADER_MODULE));
+            vkDestroyRenderPass(logical_device, old_render_pass,
+                get_allocation_callbacks(VK_OBJECT_TYPE_RENDER_PASS));
+            for (const VkImageView& image_view : old_image_views) {
+                vkDestroyImageView(logical_device, image_view,
+                    get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE_VIEW));
+            }
+            // The fences only cover the rendering. Without a present
+            // fence nothing tells when the presentation engine is done
+            // with the old images, which must be the case before the
+            // swapchain is destroyed. Waiting for the present queue to
+            // be idle is the portable way, and only stalls once per
+            // recreation.
+            vkQueueWaitIdle(present_queue);
+            vkDestroySwapchainKHR(logical_device, old_swapchain,
+                get_allocation_callbacks(VK_OBJECT_TYPE_SWAPCHAIN_KHR));
+
+            VK_TUT_LOG_DEBUG("Destroyed retired swapchain objects.");
+        });
     }
 
     // This dictates the resoultion of the swapchain images.
@@ -31,19 +31,19 @@ namespace vk::tut {
     }
 
     // Gets the value of m_capabilities.
-    VkSurfaceCapabilitiesKHR
+    const VkSurfaceCapabilitiesKHR&
     SwapChainSupportDetails::get_capabilities() const {
         return m_capabilities;
     }
 
     // Gets the value of m_formats.
-    ::std::vector<VkSurfaceFormatKHR>
+    const ::std::vector<VkSurfaceFormatKHR>&
     SwapChainSupportDetails::get_formats() const {
         return m_formats;
     }
 
     // Gets the value of m_present_modes.
-    ::std::vector<VkPresentModeKHR>
+    const ::std::vector<VkPresentModeKHR>&
     SwapChainSupportDetails::get_present_modes() const {
         return m_present_modes;
     }
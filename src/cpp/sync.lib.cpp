@@ -1,8 +1,11 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 
 namespace vk::tut {
     void Application::create_sync_objects() {
+        VK_TUT_TRACE_SCOPE("create_sync_objects");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -20,7 +23,8 @@ namespace vk::tut {
 
             result = vkCreateSemaphore(
                 m_logical_device, &image_available_semaphore_info,
-                nullptr, &image_available_semaphore
+                get_allocation_callbacks(VK_OBJECT_TYPE_SEMAPHORE),
+                &image_available_semaphore
             );
             if (result != VkResult::VK_SUCCESS) {
                 VK_TUT_LOG_ERROR(
@@ -47,7 +51,8 @@ namespace vk::tut {
 
             result = vkCreateSemaphore(
                 m_logical_device, &render_finished_semaphore_info,
-                nullptr, &render_finished_semaphore
+                get_allocation_callbacks(VK_OBJECT_TYPE_SEMAPHORE),
+                &render_finished_semaphore
             );
             if (result != VkResult::VK_SUCCESS) {
                 VK_TUT_LOG_ERROR("Failed to create render_finished_semaphore.");
@@ -73,7 +78,7 @@ namespace vk::tut {
 
             result = vkCreateFence(
                 m_logical_device, &in_flight_fence_info,
-                nullptr, &in_flight_fence
+                get_allocation_callbacks(VK_OBJECT_TYPE_FENCE), &in_flight_fence
             );
             if (result != VkResult::VK_SUCCESS) {
                 VK_TUT_LOG_ERROR("Failed to create in_flight_fence.");
@@ -82,14 +87,41 @@ namespace vk::tut {
             m_in_flight_fences.emplace_back(::std::move(in_flight_fence));
         }
 
+        // No frame has been submitted with the fences yet.
+        m_frame_submit_values.assign(m_in_flight_fences.size(), 0);
+
         VK_TUT_LOG_DEBUG("Successfully created sync objects.");
     }
 
+    void Application::create_frame_arenas() {
+        VK_TUT_TRACE_SCOPE("create_frame_arenas");
+
+        // One arena per frame in flight, reset as a
+        // whole once the fence of its frame signals.
+        m_frame_arenas.reserve(m_in_flight_fences.size());
+        for (size_t i = 0; i < m_in_flight_fences.size(); i++) {
+            m_frame_arenas.emplace_back(::std::make_unique<FrameArena>());
+        }
+
+        VK_TUT_LOG_DEBUG("Successfully created frame arenas.");
+    }
+
+    FrameArena& Application::get_frame_arena() {
+        return *m_frame_arenas[m_current_frame_index];
+    }
+
+    void Application::destroy_frame_arenas() {
+        m_frame_arenas.clear();
+
+        VK_TUT_LOG_DEBUG("Destroyed frame arenas.");
+    }
+
     void Application::destroy_sync_objects() {
         for (const VkSemaphore& image_available_semaphore :
         m_image_available_semaphores) {
             vkDestroySemaphore(m_logical_device,
-                image_available_semaphore, nullptr
+                image_available_semaphore,
+                get_allocation_callbacks(VK_OBJECT_TYPE_SEMAPHORE)
             );
         }
         m_image_available_semaphores.clear();
@@ -98,7 +130,8 @@ namespace vk::tut {
         for (const VkSemaphore& render_finished_semaphore :
         m_render_finished_semaphores) {
             vkDestroySemaphore(m_logical_device,
-                render_finished_semaphore, nullptr
+                render_finished_semaphore,
+                get_allocation_callbacks(VK_OBJECT_TYPE_SEMAPHORE)
             );
         }
         m_render_finished_semaphores.clear();
@@ -106,11 +139,12 @@ namespace vk::tut {
 
         for (const VkFence& in_flight_fence : m_in_flight_fences) {
             vkDestroyFence(m_logical_device,
-                in_flight_fence, nullptr
+                in_flight_fence, get_allocation_callbacks(VK_OBJECT_TYPE_FENCE)
             );
         }
         m_in_flight_fences.clear();
         m_in_flight_fences.resize(0);
+        m_frame_submit_values.clear();
 
         VK_TUT_LOG_DEBUG("Destroyed sync objects.");
     }
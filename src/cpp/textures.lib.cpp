@@ -1,4 +1,5 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -6,8 +7,7 @@
 
 namespace vk::tut {
     void Application::create_texture_image() {
-        // The variable that stores the result of any vulkan function called.
-        VkResult result;
+        VK_TUT_TRACE_SCOPE("create_texture_image");
 
         int texture_width, texture_height, texture_channels;
 
@@ -15,12 +15,35 @@ namespace vk::tut {
             _VK_TUT_TEXTURE_PATH_, &texture_width, &texture_height,
             &texture_channels, STBI_rgb_alpha
         );
-        VkDeviceSize image_size = texture_width * texture_height * 4;
 
         if(!pixels) {
             VK_TUT_LOG_ERROR("Failed to load texture image.");
         }
 
+        upload_texture(
+            pixels,
+            static_cast<uint32_t>(texture_width),
+            static_cast<uint32_t>(texture_height),
+            &m_texture_image, &m_texture_image_memory
+        );
+
+        stbi_image_free(pixels);
+
+        VK_TUT_LOG_DEBUG("Successfully created texture image.");
+    }
+
+    void Application::upload_texture(
+        const void* ptr_pixels,
+        const uint32_t& width, const uint32_t& height,
+        VkImage* ptr_image, VkDeviceMemory* ptr_image_memory
+    ) {
+        // The variable that stores the result of any vulkan function called.
+        VkResult result;
+
+        // The pixels are 8 bit RGBA.
+        VkDeviceSize image_size = static_cast<VkDeviceSize>(width) *
+            height * 4;
+
         VkBuffer staging_buffer;
         VkDeviceMemory staging_buffer_memory;
 
@@ -42,55 +65,87 @@ namespace vk::tut {
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR("Failed to map memory.");
         }
-        memcpy(data, pixels, static_cast<size_t>(image_size));
+        memcpy(data, ptr_pixels, static_cast<size_t>(image_size));
         vkUnmapMemory(m_logical_device, staging_buffer_memory);
 
-        stbi_image_free(pixels);
-
         create_and_allocate_image(
             m_physical_device, m_logical_device,
-            texture_width, texture_height,
+            static_cast<int>(width), static_cast<int>(height),
             VkFormat::VK_FORMAT_R8G8B8A8_SRGB,
             VkImageTiling::VK_IMAGE_TILING_OPTIMAL,
             VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_DST_BIT |
             VkImageUsageFlagBits::VK_IMAGE_USAGE_SAMPLED_BIT,
             VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            &m_texture_image, &m_texture_image_memory
+            VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT,
+            ptr_image, ptr_image_memory
         );
 
-        transition_image_layout(
-            m_logical_device, m_command_pool, m_graphics_queue,
-            VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
-            VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            m_texture_image
+        // Record the upload and both layout transitions
+        // in a single submission.
+        VkCommandBuffer upload_command_buffer = begin_single_time_commands(
+            m_logical_device, m_command_pool
+        );
+
+        m_resource_state_tracker.track_image(*ptr_image,
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT
+        );
+        m_resource_state_tracker.require_image_state(*ptr_image,
+            ResourceState(
+                VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+            )
         );
+        m_resource_state_tracker.flush(
+            upload_command_buffer, m_vk_cmd_pipeline_barrier2
+        );
+
         copy_buffer_to_image(
-            m_logical_device, m_command_pool, m_graphics_queue,
-            static_cast<uint32_t>(texture_width),
-            static_cast<uint32_t>(texture_height),
-            staging_buffer, m_texture_image
+            upload_command_buffer, width, height,
+            staging_buffer, *ptr_image
         );
-        transition_image_layout(
-            m_logical_device, m_command_pool, m_graphics_queue,
-            VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            m_texture_image
+
+        m_resource_state_tracker.require_image_state(*ptr_image,
+            ResourceState(
+                VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR
+            )
+        );
+        m_resource_state_tracker.flush(
+            upload_command_buffer, m_vk_cmd_pipeline_barrier2
         );
 
-        vkFreeMemory(m_logical_device, staging_buffer_memory, nullptr);
-        vkDestroyBuffer(m_logical_device, staging_buffer, nullptr);
+        end_single_time_commands(
+            m_logical_device, m_command_pool, m_graphics_queue,
+            upload_command_buffer
+        );
 
-        VK_TUT_LOG_DEBUG("Successfully created texture image.");
+        vkFreeMemory(m_logical_device, staging_buffer_memory,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+        vkDestroyBuffer(m_logical_device, staging_buffer,
+            get_allocation_callbacks(VK_OBJECT_TYPE_BUFFER));
     }
 
     void Application::create_texture_image_view() {
+        VK_TUT_TRACE_SCOPE("create_texture_image_view");
+
+        create_texture_view(m_texture_image, &m_texture_image_view);
+        m_texture_index = register_bindless_texture(m_texture_image_view);
+
+        VK_TUT_LOG_DEBUG("Successfully created texture image view.");
+    }
+
+    void Application::create_texture_view(
+        const VkImage& image, VkImageView* ptr_image_view
+    ) {
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
         VkImageViewCreateInfo view_info{};
         view_info.sType = VkStructureType
             ::VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        view_info.image = m_texture_image;
+        view_info.image = image;
         view_info.viewType = VkImageViewType::VK_IMAGE_VIEW_TYPE_2D;
         view_info.format = VkFormat::VK_FORMAT_R8G8B8A8_SRGB;
         view_info.subresourceRange.aspectMask = VkImageAspectFlagBits
@@ -101,16 +156,64 @@ namespace vk::tut {
         view_info.subresourceRange.layerCount = 1;
 
         result = vkCreateImageView(
-            m_logical_device, &view_info, nullptr, &m_texture_image_view
+            m_logical_device, &view_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE_VIEW), ptr_image_view
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR("Failed to create texture image view.");
         }
+    }
 
-        VK_TUT_LOG_DEBUG("Successfully created texture image view.");
+    void Application::create_scene_textures() {
+        VK_TUT_TRACE_SCOPE("create_scene_textures");
+
+        const uint32_t texture_count =
+            m_ptr_scene_generator->get_parameters().texture_count;
+
+        m_scene_texture_images.resize(texture_count);
+        m_scene_texture_image_memories.resize(texture_count);
+        m_scene_texture_image_views.resize(texture_count);
+        ::std::vector<uint8_t> pixels;
+        for (uint32_t i = 0; i < texture_count; i++) {
+            SceneGenerator::generate_texture(i, pixels);
+            upload_texture(
+                pixels.data(),
+                SceneGenerator::TEXTURE_SIZE, SceneGenerator::TEXTURE_SIZE,
+                &m_scene_texture_images[i], &m_scene_texture_image_memories[i]
+            );
+            create_texture_view(
+                m_scene_texture_images[i], &m_scene_texture_image_views[i]
+            );
+
+            // Reuse the slots of the previous scene before taking more.
+            if (i < m_scene_texture_indices.size()) {
+                write_bindless_texture(
+                    m_scene_texture_indices[i], m_scene_texture_image_views[i]
+                );
+            }
+            else {
+                m_scene_texture_indices.emplace_back(
+                    register_bindless_texture(m_scene_texture_image_views[i])
+                );
+            }
+        }
+        // The slots left over from a scene with more textures
+        // must not keep the views destroyed with it.
+        for (size_t i = texture_count; i < m_scene_texture_indices.size();
+        i++) {
+            write_bindless_texture(
+                m_scene_texture_indices[i], m_texture_image_view
+            );
+        }
+        write_texture_tables();
+
+        VK_TUT_LOG_DEBUG("Successfully created " +
+            ::std::to_string(texture_count) + " scene textures.");
     }
 
     void Application::create_texture_sampler() {
+        VK_TUT_TRACE_SCOPE("create_texture_sampler");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -142,7 +245,8 @@ namespace vk::tut {
         sampler_info.maxLod = 0.0f;
 
         result = vkCreateSampler(
-            m_logical_device, &sampler_info, nullptr, &m_texture_sampler
+            m_logical_device, &sampler_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SAMPLER), &m_texture_sampler
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR("Failed to create sampler.");
@@ -151,28 +255,50 @@ namespace vk::tut {
         VK_TUT_LOG_DEBUG("Successfully created texture sampler.");
     }
 
+    void Application::destroy_scene_textures() {
+        for (const VkImageView& image_view : m_scene_texture_image_views) {
+            vkDestroyImageView(m_logical_device, image_view,
+                get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE_VIEW));
+        }
+        m_scene_texture_image_views.clear();
+        for (const VkImage& image : m_scene_texture_images) {
+            m_resource_state_tracker.forget_image(image);
+            vkDestroyImage(m_logical_device, image,
+                get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE));
+        }
+        m_scene_texture_images.clear();
+        for (const VkDeviceMemory& image_memory :
+        m_scene_texture_image_memories) {
+            vkFreeMemory(m_logical_device, image_memory,
+                get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+        }
+        m_scene_texture_image_memories.clear();
+
+        VK_TUT_LOG_DEBUG("Destroyed scene textures.");
+    }
+
     void Application::destroy_texture_sampler() {
-        vkDestroySampler(m_logical_device, m_texture_sampler, nullptr);
+        vkDestroySampler(m_logical_device, m_texture_sampler,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SAMPLER));
 
         VK_TUT_LOG_DEBUG("Destroyed texture sampler.");
     }
 
     void Application::destroy_texture_image_view() {
-        vkDestroyImageView(m_logical_device, m_texture_image_view, nullptr);
+        vkDestroyImageView(m_logical_device, m_texture_image_view,
+            get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE_VIEW));
+        m_bindless_texture_views.clear();
 
         VK_TUT_LOG_DEBUG("Destroyed texture image view.");
     }
 
     void Application::destroy_texture_image() {
-        transition_image_layout(
-            m_logical_device, m_command_pool, m_graphics_queue,
-            VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            m_texture_image
-        );
+        m_resource_state_tracker.forget_image(m_texture_image);
 
-        vkFreeMemory(m_logical_device, m_texture_image_memory, nullptr);
-        vkDestroyImage(m_logical_device, m_texture_image, nullptr);
+        vkFreeMemory(m_logical_device, m_texture_image_memory,
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY));
+        vkDestroyImage(m_logical_device, m_texture_image,
+            get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE));
 
         VK_TUT_LOG_DEBUG("Destroyed texture image.");
     }
@@ -184,6 +310,7 @@ namespace vk::tut {
         const VkFormat& format, const VkImageTiling& tiling,
         const VkImageUsageFlags& usage,
         const VkMemoryPropertyFlags& memory_properties,
+        const VkSampleCountFlagBits& samples,
         VkImage* ptr_image,
         VkDeviceMemory* ptr_image_memory
     ) {
@@ -206,12 +333,11 @@ namespace vk::tut {
         image_info.usage = usage;
         image_info.sharingMode = VkSharingMode
             ::VK_SHARING_MODE_EXCLUSIVE;
-        image_info.samples = VkSampleCountFlagBits
-            ::VK_SAMPLE_COUNT_1_BIT;
+        image_info.samples = samples;
 
         result = vkCreateImage(
             logical_device, &image_info,
-            nullptr, ptr_image
+            get_allocation_callbacks(VK_OBJECT_TYPE_IMAGE), ptr_image
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
@@ -235,7 +361,8 @@ namespace vk::tut {
 
         result = vkAllocateMemory(
             logical_device, &texture_memory_alloc_info,
-            nullptr, ptr_image_memory
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEVICE_MEMORY),
+            ptr_image_memory
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR("Failed to allocate texture image memory.");
@@ -247,16 +374,10 @@ namespace vk::tut {
     }
 
     void copy_buffer_to_image(
-        const VkDevice& logical_device,
-        const VkCommandPool& command_pool,
-        const VkQueue& queue,
+        const VkCommandBuffer& command_buffer,
         const uint32_t& width, const uint32_t& height,
         const VkBuffer& src_buffer, const VkImage& dst_image
     ) {
-        VkCommandBuffer copy_command_buffer = begin_single_time_commands(
-            logical_device, command_pool
-        );
-
         VkBufferImageCopy copy_region{};
         copy_region.bufferOffset = 0;
         copy_region.bufferRowLength = 0;
@@ -276,59 +397,12 @@ namespace vk::tut {
         };
 
         vkCmdCopyBufferToImage(
-            copy_command_buffer,
+            command_buffer,
             src_buffer,
             dst_image,
             VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
             1,
             &copy_region
         );
-
-        end_single_time_commands(
-            logical_device, command_pool, queue, copy_command_buffer
-        );
-    }
-
-    void transition_image_layout(
-        const VkDevice& logical_device,
-        const VkCommandPool& command_pool,
-        const VkQueue& queue,
-        const VkImageLayout& old_layout,
-        const VkImageLayout& new_layout,
-        const VkImage& image
-    ) {
-        VkCommandBuffer transition_command_buffer = begin_single_time_commands(
-            logical_device, command_pool
-        );
-
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VkStructureType
-            ::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = old_layout;
-        barrier.newLayout = new_layout;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = image;
-        barrier.subresourceRange.aspectMask = VkImageAspectFlagBits
-            ::VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = 0; // TODO
-        barrier.dstAccessMask = 0; // TODO
-
-        vkCmdPipelineBarrier(
-            transition_command_buffer,
-            0 /* TODO */, 0 /* TODO */,
-            0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier
-        );
-
-        end_single_time_commands(
-            logical_device, command_pool, queue, transition_command_buffer
-        );
     }
 }
\ No newline at end of file
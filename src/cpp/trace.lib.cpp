@@ -0,0 +1,168 @@
+#include "vk_tut/trace.h"
+#include "vk_tut/logging.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace vk::tut {
+    // The buffer of the current thread. Owned by the tracer.
+    static thread_local TraceBuffer* t_ptr_trace_buffer = nullptr;
+    // The name of the innermost scope of the current thread.
+    static thread_local const char* t_scope_name = nullptr;
+
+    // Writes a string as a JSON string literal.
+    static void write_json_string(::std::ostream& stream, const char* text) {
+        stream << '"';
+        for (const char* ptr_char = text; *ptr_char != '\0'; ptr_char++) {
+            if (*ptr_char == '"' || *ptr_char == '\\') stream << '\\';
+            stream << *ptr_char;
+        }
+        stream << '"';
+    }
+
+    // < -------------------------- TraceBuffer -------------------------- >
+
+    // Creates an empty buffer for the thread.
+    TraceBuffer::TraceBuffer(
+        const uint32_t& thread_id, const uint32_t& capacity
+    ) : m_events(capacity), m_thread_id(thread_id) {}
+
+    void TraceBuffer::push(
+        const char* name,
+        const uint64_t& start_ns,
+        const uint64_t& duration_ns
+    ) {
+        const uint32_t count = m_count.load(::std::memory_order_relaxed);
+        if (count == m_events.size()) {
+            m_dropped_count.fetch_add(1, ::std::memory_order_relaxed);
+            return;
+        }
+
+        m_events[count] = {name, start_ns, duration_ns};
+        // Publishes the event to the exporting thread.
+        m_count.store(count + 1, ::std::memory_order_release);
+    }
+
+    void TraceBuffer::clear() {
+        m_count.store(0, ::std::memory_order_release);
+        m_dropped_count.store(0, ::std::memory_order_relaxed);
+    }
+
+    // < ----------------------------- Tracer ----------------------------- >
+
+    Tracer& Tracer::get_instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    uint64_t Tracer::now() {
+        static const auto start_time = ::std::chrono::steady_clock::now();
+        return static_cast<uint64_t>(
+            ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+                ::std::chrono::steady_clock::now() - start_time
+            ).count()
+        );
+    }
+
+    TraceBuffer& Tracer::get_thread_buffer() {
+        if (t_ptr_trace_buffer != nullptr) return *t_ptr_trace_buffer;
+
+        // Only locked once per thread.
+        ::std::lock_guard<::std::mutex> lock(m_mutex);
+        m_buffers.emplace_back(::std::make_unique<TraceBuffer>(
+            static_cast<uint32_t>(m_buffers.size()), EVENTS_PER_THREAD
+        ));
+        t_ptr_trace_buffer = m_buffers.back().get();
+        return *t_ptr_trace_buffer;
+    }
+
+    void Tracer::set_thread_name(const ::std::string& name) {
+        TraceBuffer& buffer = get_thread_buffer();
+
+        ::std::lock_guard<::std::mutex> lock(m_mutex);
+        buffer.m_thread_name = name;
+    }
+
+    void Tracer::write_chrome_trace(::std::ostream& stream) const {
+        ::std::lock_guard<::std::mutex> lock(m_mutex);
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        char numbers[64];
+        for (const ::std::unique_ptr<TraceBuffer>& ptr_buffer : m_buffers) {
+            const uint32_t thread_id = ptr_buffer->get_thread_id();
+            if (!ptr_buffer->m_thread_name.empty()) {
+                stream << (first ? "\n" : ",\n")
+                    << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                    << "\"tid\":" << thread_id << ",\"args\":{\"name\":";
+                write_json_string(stream, ptr_buffer->m_thread_name.c_str());
+                stream << "}}";
+                first = false;
+            }
+
+            // Complete events, with times in microseconds.
+            const uint32_t count = ptr_buffer->get_count();
+            for (uint32_t i = 0; i < count; i++) {
+                const TraceBuffer::Event& event = ptr_buffer->get_event(i);
+                ::std::snprintf(numbers, sizeof(numbers),
+                    "\"ts\":%.3f,\"dur\":%.3f",
+                    static_cast<double>(event.start_ns) / 1.0e3,
+                    static_cast<double>(event.duration_ns) / 1.0e3
+                );
+                stream << (first ? "\n" : ",\n") << "{\"name\":";
+                write_json_string(stream, event.name);
+                stream << ",\"ph\":\"X\"," << numbers
+                    << ",\"pid\":1,\"tid\":" << thread_id << "}";
+                first = false;
+            }
+
+            if (ptr_buffer->get_dropped_count() > 0) {
+                VK_TUT_LOG_DEBUG("Dropped " +
+                    ::std::to_string(ptr_buffer->get_dropped_count()) +
+                    " trace events of thread " +
+                    ::std::to_string(thread_id) + ".");
+            }
+        }
+        stream << "\n]}\n";
+    }
+
+    void Tracer::write_chrome_trace(const ::std::string& path) const {
+        ::std::ofstream file(path);
+        if (!file.is_open()) {
+            VK_TUT_LOG_ERROR("Failed to open " + path + ".");
+        }
+
+        write_chrome_trace(file);
+
+        VK_TUT_LOG_DEBUG("Wrote the CPU trace to " + path + ".");
+    }
+
+    void Tracer::clear() {
+        ::std::lock_guard<::std::mutex> lock(m_mutex);
+        for (const ::std::unique_ptr<TraceBuffer>& ptr_buffer : m_buffers) {
+            ptr_buffer->clear();
+        }
+    }
+
+    // < --------------------------- TraceScope --------------------------- >
+
+    // Starts timing. The name must outlive the trace.
+    TraceScope::TraceScope(const char* name) :
+    m_name(name), m_parent_name(t_scope_name), m_start_ns(Tracer::now()) {
+        t_scope_name = name;
+    }
+
+    // Stops timing and records the event.
+    TraceScope::~TraceScope() {
+        const uint64_t end_ns = Tracer::now();
+        t_scope_name = m_parent_name;
+        Tracer::get_instance().get_thread_buffer().push(
+            m_name, m_start_ns, end_ns - m_start_ns
+        );
+    }
+
+    const char* TraceScope::get_current_name() {
+        return t_scope_name;
+    }
+}
\ No newline at end of file
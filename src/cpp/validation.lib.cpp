@@ -4,6 +4,7 @@
 // only if _VK_TUT_VALIDATION_LAYER_ENABLED_ is defined
 #if defined(_VK_TUT_VALIDATION_LAYER_ENABLED_)
 
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 #include <cstring>
 
@@ -45,6 +46,8 @@ namespace vk::tut {
     }
 
     void Application::setup_debug_messenger() {
+        VK_TUT_TRACE_SCOPE("setup_debug_messenger");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -53,7 +56,8 @@ namespace vk::tut {
 
         result = create_debug_utils_messengerEXT(
             m_vulkan_instance, &debug_messenger_info,
-            nullptr, &m_debug_messenger
+            get_allocation_callbacks(VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT),
+            &m_debug_messenger
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR(
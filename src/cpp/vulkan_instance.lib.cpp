@@ -1,8 +1,11 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 
 namespace vk::tut {
     void Application::init_vulkan_instance() {
+        VK_TUT_TRACE_SCOPE("init_vulkan_instance");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
@@ -24,10 +27,14 @@ namespace vk::tut {
         vulkan_application_info.engineVersion = VK_MAKE_VERSION(0, 0, 1);
         vulkan_application_info.apiVersion = VK_API_VERSION_1_2;
 
-        // Retrieve the number of glfw extensions.
+        // Retrieve the number of glfw extensions. Headless mode
+        // presents nothing, so it needs no surface extensions.
         uint32_t glfw_extensions_count = 0;
-        const char** glfw_extensions =
-            glfwGetRequiredInstanceExtensions(&glfw_extensions_count);
+        const char** glfw_extensions = nullptr;
+        if (!m_config.get_headless()) {
+            glfw_extensions =
+                glfwGetRequiredInstanceExtensions(&glfw_extensions_count);
+        }
         // Store the extension names to the required extensions.
 #if defined(_VK_TUT_VALIDATION_LAYER_ENABLED_)
         ::std::vector<const char*> required_extensions;
@@ -81,7 +88,9 @@ namespace vk::tut {
 
         // Create the Vulkan instance.
         result = vkCreateInstance(
-            &vulkan_instance_info, nullptr, &m_vulkan_instance
+            &vulkan_instance_info,
+            get_allocation_callbacks(VK_OBJECT_TYPE_INSTANCE),
+            &m_vulkan_instance
         );
         if (result == VkResult::VK_ERROR_INCOMPATIBLE_DRIVER) {
             VK_TUT_LOG_ERROR(
@@ -98,7 +107,8 @@ namespace vk::tut {
 
     void Application::destroy_vulkan_instance() {
         // Destroy the vulkan instance handle.
-        vkDestroyInstance(m_vulkan_instance, nullptr);
+        vkDestroyInstance(m_vulkan_instance,
+            get_allocation_callbacks(VK_OBJECT_TYPE_INSTANCE));
 
         VK_TUT_LOG_DEBUG("Destroyed the Vulkan Instance.");
     }
@@ -1,8 +1,19 @@
 #include "vk_tut/application.h"
+#include "vk_tut/host_allocator.h"
 #include "vk_tut/logging.h"
 
 namespace vk::tut {
     void Application::create_and_show_window() {
+        VK_TUT_TRACE_SCOPE("create_and_show_window");
+
+        // GLFW is never initialized in headless mode,
+        // so no display server is needed.
+        if (m_config.get_headless()) {
+            m_ptr_window = nullptr;
+            VK_TUT_LOG_DEBUG("Headless mode. No window created.");
+            return;
+        }
+
         // Initialize the GLFW library.
         glfwInit();
 
@@ -18,11 +29,20 @@ namespace vk::tut {
     }
 
     void Application::create_surface() {
+        VK_TUT_TRACE_SCOPE("create_surface");
+
         // The variable that stores the result of any vulkan function called.
         VkResult result;
 
+        // Nothing is presented in headless mode.
+        if (m_config.get_headless()) {
+            m_surface = VK_NULL_HANDLE;
+            return;
+        }
+
         result = glfwCreateWindowSurface(
-            m_vulkan_instance, m_ptr_window, nullptr, &m_surface
+            m_vulkan_instance, m_ptr_window,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SURFACE_KHR), &m_surface
         );
         if (result != VkResult::VK_SUCCESS) {
             VK_TUT_LOG_ERROR("Failed to create a surface.");
@@ -32,12 +52,17 @@ namespace vk::tut {
     }
     
     void Application::destroy_surface() {
-        vkDestroySurfaceKHR(m_vulkan_instance, m_surface, nullptr);
+        if (m_config.get_headless()) return;
+
+        vkDestroySurfaceKHR(m_vulkan_instance, m_surface,
+            get_allocation_callbacks(VK_OBJECT_TYPE_SURFACE_KHR));
 
         VK_TUT_LOG_DEBUG("Destroyed surface.");
     }
 
     void Application::destroy_window() {
+        if (m_config.get_headless()) return;
+
         // Destroy the GLFW window that was created.
         glfwDestroyWindow(m_ptr_window);
         // Terminate the GLFW library.
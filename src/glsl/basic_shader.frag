@@ -1,5 +1,9 @@
 #version 450
 
+// The number of slots in the bindless texture table.
+// Overridden by MAX_BINDLESS_TEXTURES from push_constant.h.
+layout(constant_id = 0) const uint MAX_BINDLESS_TEXTURES = 1;
+
 // Defined previously in the vertex shader.
 layout(location = 0) in vec3 frag_colour;
 layout(location = 1) in vec2 texture_coordinates;
@@ -7,13 +11,23 @@ layout(location = 1) in vec2 texture_coordinates;
 // The colour to be assigned to the pixels.
 layout(location = 0) out vec4 out_colour;
 
-// The texture sampler.
-layout(binding = 1) uniform sampler2D texture_sampler;
+// The sampler shared by all textures.
+layout(binding = 1) uniform sampler texture_sampler;
+// The bindless texture table.
+layout(binding = 2) uniform texture2D textures[MAX_BINDLESS_TEXTURES];
+
+// Data pushed per draw.
+layout(push_constant) uniform PushConstant {
+    uint texture_index;
+} push_constant;
 
 // Shader entrypoint.
 void main() {
     out_colour = vec4(
-        frag_colour * texture(texture_sampler, texture_coordinates).rgb,
+        frag_colour * texture(
+            sampler2D(textures[push_constant.texture_index], texture_sampler),
+            texture_coordinates
+        ).rgb,
         1.0
     );
 }
\ No newline at end of file
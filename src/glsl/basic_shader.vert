@@ -14,17 +14,35 @@ layout(location = 1) in vec3 in_colour;
 // The final 2 floats layed out in the vertex
 // input are the texture coordinates.
 layout(location = 2) in vec2 in_texture_coordinates;
+// The position of the instance in xyz and its scale in w.
+layout(location = 3) in vec4 in_position_scale;
+// The rotation of the instance as a unit quaternion, real part in w.
+layout(location = 4) in vec4 in_rotation;
 
 // To be passed to the next shader stage,
 // which in our case is the fragment shader.
 layout(location = 0) out vec3 out_frag_colour;
 layout(location = 1) out vec2 out_texture_coordinates;
 
+// Matches the depth prepass bit for bit for the equal depth test.
+invariant gl_Position;
+
+// Rotates, scales then moves a position as the instance says.
+// Must match the same function in depth_prepass.vert.
+vec3 transform_by_instance(vec3 position) {
+    vec3 rotated = position + 2.0 * cross(
+        in_rotation.xyz, cross(in_rotation.xyz, position) +
+        in_rotation.w * position
+    );
+    return in_position_scale.xyz + in_position_scale.w * rotated;
+}
+
 // Shader entrypoint.
 void main() {
     // gl_Position is a built in shader variable specifying the vertex position.
     gl_Position = bound_uniform.projection * bound_uniform.view *
-        bound_uniform.model * vec4(in_3D_position, 1.0);
+        bound_uniform.model *
+        vec4(transform_by_instance(in_3D_position), 1.0);
     out_frag_colour = in_colour;
     out_texture_coordinates = in_texture_coordinates;
 }
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 450
+
+// Defined previously in the vertex shader.
+layout(location = 0) in vec4 frag_colour;
+
+// The colour to be assigned to the pixels.
+layout(location = 0) out vec4 out_colour;
+
+// Shader entrypoint. Debug primitives are not lit nor textured.
+void main() {
+    out_colour = frag_colour;
+}
\ No newline at end of file
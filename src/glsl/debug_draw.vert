@@ -0,0 +1,26 @@
+#version 450
+
+layout(binding = 0) uniform Uniform {
+    mat4 model;
+    mat4 view;
+    mat4 projection;
+} bound_uniform;
+
+// The size of the points, in pixels. Overridden when the device
+// supports points larger than a pixel.
+layout(constant_id = 0) const float POINT_SIZE = 1.0;
+
+// The position, in the space the instances are placed in.
+layout(location = 0) in vec3 in_3D_position;
+// The colour, unpacked from 8 bits per component.
+layout(location = 1) in vec4 in_colour;
+
+layout(location = 0) out vec4 out_frag_colour;
+
+// Shader entrypoint.
+void main() {
+    gl_Position = bound_uniform.projection * bound_uniform.view *
+        bound_uniform.model * vec4(in_3D_position, 1.0);
+    gl_PointSize = POINT_SIZE;
+    out_frag_colour = in_colour;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#version 450
+
+layout(binding = 0) uniform Uniform {
+    mat4 model;
+    mat4 view;
+    mat4 projection;
+} bound_uniform;
+
+// Only the positions and the instance transforms
+// are read from the vertex input.
+layout(location = 0) in vec3 in_3D_position;
+layout(location = 3) in vec4 in_position_scale;
+layout(location = 4) in vec4 in_rotation;
+
+// The shading pass tests for equal depth, so the position
+// must be computed exactly as in basic_shader.vert.
+invariant gl_Position;
+
+// Rotates, scales then moves a position as the instance says.
+// Must match the same function in basic_shader.vert.
+vec3 transform_by_instance(vec3 position) {
+    vec3 rotated = position + 2.0 * cross(
+        in_rotation.xyz, cross(in_rotation.xyz, position) +
+        in_rotation.w * position
+    );
+    return in_position_scale.xyz + in_position_scale.w * rotated;
+}
+
+// Shader entrypoint.
+void main() {
+    gl_Position = bound_uniform.projection * bound_uniform.view *
+        bound_uniform.model *
+        vec4(transform_by_instance(in_3D_position), 1.0);
+}
\ No newline at end of file
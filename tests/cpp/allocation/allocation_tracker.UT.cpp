@@ -0,0 +1,143 @@
+#include "vk_tut/allocation_tracker.h"
+#include "vk_tut/application.h"
+#include "vk_tut/frame_statistics.h"
+#include "vk_tut/scene_generator.h"
+#include "vk_tut/trace.h"
+
+#include <gtest/gtest.h>
+#include <exception>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace vk::tut {
+    // Allocation tracker test fixture.
+    class AllocationTrackerTests : public ::testing::Test {
+    protected:
+        // Starts counting from zero.
+        void SetUp() override {
+            // Creates the trace buffer of the thread before counting.
+            { TraceScope scope("set_up"); }
+            m_kept_values.reserve(16);
+            m_tracker.reset();
+            m_tracker.set_counting(true);
+        }
+
+        // Leaves the other tests uncounted.
+        void TearDown() override {
+            m_tracker.set_counting(false);
+            m_tracker.reset();
+        }
+
+        // The sites that allocated, with counting stopped.
+        ::std::vector<AllocationTracker::Site> get_sites() {
+            m_tracker.set_counting(false);
+            ::std::vector<AllocationTracker::Site> sites;
+            m_tracker.get_sites(sites);
+            return sites;
+        }
+
+        // Keeps an allocation alive, so it is not optimized out.
+        void allocate_kept_value() {
+            m_kept_values.emplace_back(::std::make_unique<int>(0));
+        }
+
+        AllocationTracker& m_tracker = AllocationTracker::get_instance();
+        // The values allocated by allocate_kept_value().
+        ::std::vector<::std::unique_ptr<int>> m_kept_values;
+    };
+
+    TEST_F(AllocationTrackerTests, counts_allocations_while_counting) {
+        allocate_kept_value();
+        allocate_kept_value();
+        m_tracker.set_counting(false);
+        allocate_kept_value();
+
+        EXPECT_EQ(m_tracker.get_count(), 2);
+        EXPECT_EQ(m_tracker.get_bytes(), 2 * sizeof(int));
+    }
+
+    TEST_F(AllocationTrackerTests, names_sites_by_trace_scope) {
+        // The scopes are made directly, as VK_TUT_TRACE_SCOPE
+        // is compiled out of release builds.
+        {
+            TraceScope allocating_scope("allocating_scope");
+            for (int i = 0; i < 3; i++) {
+                allocate_kept_value();
+            }
+            {
+                TraceScope nested_scope("nested_scope");
+                allocate_kept_value();
+            }
+            allocate_kept_value();
+        }
+        allocate_kept_value();
+
+        const ::std::vector<AllocationTracker::Site> sites = get_sites();
+        ASSERT_EQ(sites.size(), 3);
+        EXPECT_STREQ(sites[0].name, "allocating_scope");
+        EXPECT_EQ(sites[0].count, 4);
+        EXPECT_EQ(sites[0].bytes, 4 * sizeof(int));
+        EXPECT_EQ(sites[1].count, 1);
+        EXPECT_EQ(sites[2].count, 1);
+        EXPECT_STREQ(TraceScope::get_current_name(), nullptr);
+    }
+
+    TEST_F(AllocationTrackerTests, reset_forgets_counts) {
+        allocate_kept_value();
+        m_tracker.reset();
+
+        EXPECT_EQ(m_tracker.get_count(), 0);
+        EXPECT_EQ(m_tracker.get_bytes(), 0);
+        EXPECT_TRUE(get_sites().empty());
+    }
+
+    // Renders an animated scene recorded again every frame on the
+    // first suitable device, without a window, and checks that the
+    // frames past the first window of statistics never allocate.
+    // Skipped where no device can render.
+    TEST_F(AllocationTrackerTests, steady_state_frames_do_not_allocate) {
+        m_tracker.set_counting(false);
+
+        ApplicationConfig config;
+        config.set_headless(true);
+        config.set_headless_width(64);
+        config.set_headless_height(64);
+        // Two windows of statistics. The second is checked.
+        config.set_frame_count(600);
+        config.set_hitch_threshold_ms(0.0f);
+
+        SceneGenerator::Parameters parameters;
+        parameters.object_count = 512;
+        parameters.instances_per_draw = 1;
+
+        ::std::unique_ptr<Application> ptr_app;
+        try {
+            ptr_app = ::std::make_unique<Application>(config);
+            ptr_app->load_scene(parameters);
+        }
+        catch (const ::std::exception& ex) {
+            GTEST_SKIP() << "No device to render with: " << ex.what();
+        }
+        ptr_app->set_dynamic_scene(true);
+
+        m_tracker.reset();
+        m_tracker.set_counting(true);
+        ptr_app->run();
+        m_tracker.set_counting(false);
+
+        const FrameStatistics::Summary summary =
+            ptr_app->get_frame_statistics().get_window_summary(
+                FrameMetric::ALLOCATION_COUNT
+            );
+        ::std::stringstream sites_stream;
+        for (const AllocationTracker::Site& site : get_sites()) {
+            sites_stream << "\n  " << site.name << ": " << site.count
+                << " allocations, " << site.bytes << " bytes";
+        }
+        ASSERT_GT(summary.count, 0);
+        EXPECT_EQ(summary.max, 0)
+            << "Allocations over the whole run:" << sites_stream.str();
+    }
+}
\ No newline at end of file
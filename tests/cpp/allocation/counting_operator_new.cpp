@@ -0,0 +1,102 @@
+#include "vk_tut/allocation_tracker.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// Counting replacements of the global operator new and delete. Only
+// linked into the allocation unit tests, so that no other test runs
+// through them. They count nothing until a test turns counting on.
+namespace {
+    // Allocates size bytes, counting them.
+    void* allocate(const ::std::size_t& size) {
+        ::vk::tut::AllocationTracker::get_instance().record(size);
+        return ::std::malloc(size == 0 ? 1 : size);
+    }
+
+    // Allocates size bytes aligned to alignment, counting them.
+    void* allocate_aligned(
+        const ::std::size_t& size, const ::std::align_val_t& alignment
+    ) {
+        ::vk::tut::AllocationTracker::get_instance().record(size);
+        const ::std::size_t align = static_cast<::std::size_t>(alignment);
+#if defined(_WIN32)
+        return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+        // The size must be a multiple of the alignment.
+        return ::std::aligned_alloc(
+            align, (size + align - 1) / align * align + (size == 0 ? align : 0)
+        );
+#endif
+    }
+
+    // Frees what allocate() allocated.
+    void deallocate(void* ptr) {
+        ::std::free(ptr);
+    }
+
+    // Frees what allocate_aligned() allocated.
+    void deallocate_aligned(void* ptr) {
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        ::std::free(ptr);
+#endif
+    }
+}
+
+void* operator new(::std::size_t size) {
+    void* ptr = allocate(size);
+    if (ptr == nullptr) throw ::std::bad_alloc();
+    return ptr;
+}
+void* operator new[](::std::size_t size) {
+    void* ptr = allocate(size);
+    if (ptr == nullptr) throw ::std::bad_alloc();
+    return ptr;
+}
+void* operator new(::std::size_t size, const ::std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+void* operator new[](::std::size_t size, const ::std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+void* operator new(::std::size_t size, ::std::align_val_t alignment) {
+    void* ptr = allocate_aligned(size, alignment);
+    if (ptr == nullptr) throw ::std::bad_alloc();
+    return ptr;
+}
+void* operator new[](::std::size_t size, ::std::align_val_t alignment) {
+    void* ptr = allocate_aligned(size, alignment);
+    if (ptr == nullptr) throw ::std::bad_alloc();
+    return ptr;
+}
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, ::std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, ::std::size_t) noexcept {
+    deallocate(ptr);
+}
+void operator delete(void* ptr, const ::std::nothrow_t&) noexcept {
+    deallocate(ptr);
+}
+void operator delete[](void* ptr, const ::std::nothrow_t&) noexcept {
+    deallocate(ptr);
+}
+void operator delete(void* ptr, ::std::align_val_t) noexcept {
+    deallocate_aligned(ptr);
+}
+void operator delete[](void* ptr, ::std::align_val_t) noexcept {
+    deallocate_aligned(ptr);
+}
+void operator delete(void* ptr, ::std::size_t, ::std::align_val_t) noexcept {
+    deallocate_aligned(ptr);
+}
+void operator delete[](
+    void* ptr, ::std::size_t, ::std::align_val_t
+) noexcept {
+    deallocate_aligned(ptr);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "vk_tut/application_config.h"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace vk::tut {
+    TEST(ApplicationConfigTests, rejects_empty_headless_extents) {
+        ApplicationConfig config;
+        EXPECT_THROW(config.set_headless_width(0), ::std::runtime_error);
+        EXPECT_THROW(config.set_headless_height(0), ::std::runtime_error);
+
+        // The previous extent is kept.
+        EXPECT_EQ(config.get_headless_width(), 900);
+        EXPECT_EQ(config.get_headless_height(), 600);
+
+        config.set_headless_width(1);
+        config.set_headless_height(2);
+        EXPECT_EQ(config.get_headless_width(), 1);
+        EXPECT_EQ(config.get_headless_height(), 2);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "vk_tut/debug_draw.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace vk::tut {
+    // Debug draw test fixture.
+    class DebugDrawTests : public ::testing::Test {
+    protected:
+        // Starts a frame with room for capacity vertices.
+        void begin(const uint32_t& capacity) {
+            m_vertices.assign(capacity, DebugVertex{});
+            m_debug_draw.begin(m_vertices.data(), capacity);
+        }
+
+        // Whether the lines drawn include one between a and b.
+        bool has_line(const ::glm::vec3& a, const ::glm::vec3& b) const {
+            for (uint32_t i = 0; i < m_debug_draw.get_line_vertex_count();
+            i += 2) {
+                const ::glm::vec3& from = m_vertices[i].position;
+                const ::glm::vec3& to = m_vertices[i + 1].position;
+                if ((is_near(from, a) && is_near(to, b)) ||
+                (is_near(from, b) && is_near(to, a))) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Whether two positions are the same, up to rounding.
+        static bool is_near(const ::glm::vec3& a, const ::glm::vec3& b) {
+            return ::std::fabs(a.x - b.x) < 1e-4f &&
+                ::std::fabs(a.y - b.y) < 1e-4f &&
+                ::std::fabs(a.z - b.z) < 1e-4f;
+        }
+
+        DebugDraw m_debug_draw;
+        // The vertex memory of the frame.
+        ::std::vector<DebugVertex> m_vertices;
+    };
+
+    TEST_F(DebugDrawTests, lines_fill_the_front_and_points_the_back) {
+        begin(8);
+        const ::glm::vec4 red(1.0f, 0.0f, 0.0f, 1.0f);
+        m_debug_draw.add_line(
+            ::glm::vec3(0.0f, 0.0f, 0.0f), ::glm::vec3(1.0f, 0.0f, 0.0f), red
+        );
+        m_debug_draw.add_point(::glm::vec3(2.0f, 0.0f, 0.0f), red);
+        m_debug_draw.add_point(::glm::vec3(3.0f, 0.0f, 0.0f), red);
+
+        EXPECT_EQ(m_debug_draw.get_line_vertex_count(), 2);
+        EXPECT_EQ(m_debug_draw.get_point_vertex_count(), 2);
+        EXPECT_EQ(m_debug_draw.get_first_point_vertex(), 6);
+        EXPECT_EQ(m_vertices[1].position.x, 1.0f);
+        EXPECT_EQ(m_vertices[7].position.x, 2.0f);
+        EXPECT_EQ(m_vertices[6].position.x, 3.0f);
+        EXPECT_EQ(m_vertices[0].colour, 0xFF0000FFu);
+    }
+
+    TEST_F(DebugDrawTests, drops_primitives_past_the_capacity) {
+        begin(6);
+        const ::glm::vec4 white(1.0f);
+        m_debug_draw.add_point(::glm::vec3(0.0f), white);
+        m_debug_draw.add_line(::glm::vec3(0.0f), ::glm::vec3(1.0f), white);
+        m_debug_draw.add_line(::glm::vec3(0.0f), ::glm::vec3(1.0f), white);
+        // No room for a third line, but room for a point.
+        m_debug_draw.add_line(::glm::vec3(0.0f), ::glm::vec3(1.0f), white);
+        m_debug_draw.add_point(::glm::vec3(0.0f), white);
+        m_debug_draw.add_point(::glm::vec3(0.0f), white);
+
+        EXPECT_EQ(m_debug_draw.get_line_vertex_count(), 4);
+        EXPECT_EQ(m_debug_draw.get_point_vertex_count(), 2);
+        EXPECT_EQ(m_debug_draw.get_dropped_count(), 2);
+
+        // The next frame starts empty.
+        begin(6);
+        EXPECT_EQ(m_debug_draw.get_line_vertex_count(), 0);
+        EXPECT_EQ(m_debug_draw.get_point_vertex_count(), 0);
+        EXPECT_EQ(m_debug_draw.get_dropped_count(), 0);
+    }
+
+    TEST_F(DebugDrawTests, boxes_have_twelve_edges) {
+        begin(64);
+        m_debug_draw.add_box(
+            ::glm::vec3(0.0f, 0.0f, 0.0f), ::glm::vec3(1.0f, 2.0f, 3.0f),
+            ::glm::vec4(1.0f)
+        );
+
+        EXPECT_EQ(m_debug_draw.get_line_vertex_count(), 24);
+        EXPECT_TRUE(has_line(
+            ::glm::vec3(0.0f, 0.0f, 0.0f), ::glm::vec3(1.0f, 0.0f, 0.0f)
+        ));
+        EXPECT_TRUE(has_line(
+            ::glm::vec3(1.0f, 2.0f, 0.0f), ::glm::vec3(1.0f, 2.0f, 3.0f)
+        ));
+        // Diagonals are not edges.
+        EXPECT_FALSE(has_line(
+            ::glm::vec3(0.0f, 0.0f, 0.0f), ::glm::vec3(1.0f, 2.0f, 0.0f)
+        ));
+    }
+
+    TEST_F(DebugDrawTests, frustums_end_at_the_clip_volume) {
+        begin(64);
+        // Maps x and y from -2 to 2, and z from 0 to 4, to the clip volume.
+        ::glm::mat4 view_projection(1.0f);
+        view_projection[0][0] = 0.5f;
+        view_projection[1][1] = 0.5f;
+        view_projection[2][2] = 0.25f;
+        m_debug_draw.add_frustum(view_projection, ::glm::vec4(1.0f));
+
+        EXPECT_EQ(m_debug_draw.get_line_vertex_count(), 24);
+        EXPECT_TRUE(has_line(
+            ::glm::vec3(-2.0f, -2.0f, 0.0f), ::glm::vec3(-2.0f, -2.0f, 4.0f)
+        ));
+        EXPECT_TRUE(has_line(
+            ::glm::vec3(2.0f, 2.0f, 4.0f), ::glm::vec3(-2.0f, 2.0f, 4.0f)
+        ));
+    }
+
+    TEST_F(DebugDrawTests, packs_colours_red_lowest) {
+        EXPECT_EQ(DebugDraw::pack_colour(::glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
+            0xFF000000u);
+        EXPECT_EQ(DebugDraw::pack_colour(::glm::vec4(0.0f, 1.0f, 0.0f, 0.0f)),
+            0x0000FF00u);
+        // Clamped to the range of a component.
+        EXPECT_EQ(DebugDraw::pack_colour(::glm::vec4(2.0f, -1.0f, 0.0f, 0.0f)),
+            0x000000FFu);
+    }
+
+    TEST_F(DebugDrawTests, drops_everything_before_begin) {
+        m_debug_draw.add_point(::glm::vec3(0.0f), ::glm::vec4(1.0f));
+        EXPECT_EQ(m_debug_draw.get_point_vertex_count(), 0);
+        EXPECT_EQ(m_debug_draw.get_dropped_count(), 1);
+    }
+}
\ No newline at end of file
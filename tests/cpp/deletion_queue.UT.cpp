@@ -0,0 +1,43 @@
+#include "vk_tut/deletion_queue.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace vk::tut {
+    // Deletion queue test fixture.
+    class DeletionQueueTests : public ::testing::Test {
+    protected:
+        DeletionQueue m_deletion_queue;
+        // The ids of the destroys in the order they ran.
+        ::std::vector<int> m_destroyed;
+    };
+
+    TEST_F(DeletionQueueTests, runs_only_passed_values) {
+        m_deletion_queue.enqueue(1, [this]() { m_destroyed.push_back(1); });
+        m_deletion_queue.enqueue(2, [this]() { m_destroyed.push_back(2); });
+        m_deletion_queue.enqueue(3, [this]() { m_destroyed.push_back(3); });
+
+        m_deletion_queue.flush(0);
+        EXPECT_TRUE(m_destroyed.empty());
+
+        m_deletion_queue.flush(2);
+        EXPECT_EQ(m_destroyed, ::std::vector<int>({1, 2}));
+        EXPECT_EQ(m_deletion_queue.get_size(), 1);
+
+        m_deletion_queue.flush_all();
+        EXPECT_EQ(m_destroyed, ::std::vector<int>({1, 2, 3}));
+        EXPECT_EQ(m_deletion_queue.get_size(), 0);
+    }
+
+    TEST_F(DeletionQueueTests, never_runs_early) {
+        m_deletion_queue.enqueue(5, [this]() { m_destroyed.push_back(5); });
+        // An older value queued later waits for the newer one.
+        m_deletion_queue.enqueue(2, [this]() { m_destroyed.push_back(2); });
+
+        m_deletion_queue.flush(2);
+        EXPECT_TRUE(m_destroyed.empty());
+
+        m_deletion_queue.flush(5);
+        EXPECT_EQ(m_destroyed, ::std::vector<int>({5, 2}));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "vk_tut/descriptor_allocator.h"
+
+#include <vulkan/vulkan.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace vk::tut {
+    // Descriptor allocator test fixture. Needs a Vulkan device,
+    // the tests are skipped where there is none.
+    class DescriptorAllocatorTests : public ::testing::Test {
+    protected:
+        // Runs before each test.
+        void SetUp() override {
+            VkInstanceCreateInfo vulkan_instance_info{};
+            vulkan_instance_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+            if (vkCreateInstance(&vulkan_instance_info, nullptr,
+            &m_vulkan_instance) != VkResult::VK_SUCCESS) {
+                m_vulkan_instance = VK_NULL_HANDLE;
+                GTEST_SKIP() << "No Vulkan instance.";
+            }
+
+            uint32_t physical_device_count = 1;
+            VkPhysicalDevice physical_device = VK_NULL_HANDLE;
+            vkEnumeratePhysicalDevices(
+                m_vulkan_instance, &physical_device_count, &physical_device
+            );
+            if (physical_device == VK_NULL_HANDLE) {
+                GTEST_SKIP() << "No Vulkan device.";
+            }
+
+            // Descriptor pools need no particular queue.
+            const float queue_priority = 1.0f;
+            VkDeviceQueueCreateInfo queue_info{};
+            queue_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queue_info.queueFamilyIndex = 0;
+            queue_info.queueCount = 1;
+            queue_info.pQueuePriorities = &queue_priority;
+
+            VkDeviceCreateInfo logical_device_info{};
+            logical_device_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+            logical_device_info.queueCreateInfoCount = 1;
+            logical_device_info.pQueueCreateInfos = &queue_info;
+            if (vkCreateDevice(physical_device, &logical_device_info,
+            nullptr, &m_logical_device) != VkResult::VK_SUCCESS) {
+                m_logical_device = VK_NULL_HANDLE;
+                GTEST_SKIP() << "Failed to create a Vulkan device.";
+            }
+
+            // One uniform buffer per set.
+            VkDescriptorSetLayoutBinding binding{};
+            binding.binding = 0;
+            binding.descriptorType = VkDescriptorType
+                ::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            binding.descriptorCount = 1;
+            binding.stageFlags = VkShaderStageFlagBits
+                ::VK_SHADER_STAGE_VERTEX_BIT;
+
+            VkDescriptorSetLayoutCreateInfo layout_info{};
+            layout_info.sType = VkStructureType
+                ::VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            layout_info.bindingCount = 1;
+            layout_info.pBindings = &binding;
+            vkCreateDescriptorSetLayout(
+                m_logical_device, &layout_info, nullptr, &m_layout
+            );
+        }
+
+        // Runs after each test.
+        void TearDown() override {
+            m_allocator.destroy();
+            if (m_logical_device != VK_NULL_HANDLE) {
+                vkDestroyDescriptorSetLayout(
+                    m_logical_device, m_layout, nullptr
+                );
+                vkDestroyDevice(m_logical_device, nullptr);
+            }
+            if (m_vulkan_instance != VK_NULL_HANDLE) {
+                vkDestroyInstance(m_vulkan_instance, nullptr);
+            }
+        }
+
+        // Creates the allocator with first pools of sets_per_pool sets.
+        void create(const uint32_t& sets_per_pool) {
+            m_allocator.create(m_logical_device, {
+                {VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}
+            }, sets_per_pool, 0);
+        }
+
+        // Allocates count sets in a single batch.
+        void allocate(const size_t& count) {
+            ::std::vector<VkDescriptorSet> descriptor_sets;
+            m_allocator.allocate(
+                ::std::vector<VkDescriptorSetLayout>(count, m_layout),
+                descriptor_sets
+            );
+            ASSERT_EQ(descriptor_sets.size(), count);
+        }
+
+        // The handle to the Vulkan library.
+        VkInstance m_vulkan_instance = VK_NULL_HANDLE;
+        // The device the pools are created from.
+        VkDevice m_logical_device = VK_NULL_HANDLE;
+        // The layout of every set allocated.
+        VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+        // The allocator under test.
+        DescriptorAllocator m_allocator;
+    };
+
+    TEST_F(DescriptorAllocatorTests, grows_when_a_pool_runs_out) {
+        create(2);
+        EXPECT_EQ(m_allocator.get_pool_count(), 0);
+
+        allocate(1);
+        allocate(1);
+        EXPECT_EQ(m_allocator.get_pool_count(), 1);
+
+        // The first pool is full. The next one is larger.
+        for (int i = 0; i < 4; i++) {
+            allocate(1);
+        }
+        EXPECT_EQ(m_allocator.get_pool_count(), 2);
+    }
+
+    TEST_F(DescriptorAllocatorTests, reset_pools_are_reused) {
+        create(2);
+        for (int i = 0; i < 6; i++) {
+            allocate(1);
+        }
+        ASSERT_EQ(m_allocator.get_pool_count(), 2);
+
+        // Every pool is ready again, so as many sets fit in them.
+        m_allocator.reset();
+        EXPECT_EQ(m_allocator.get_pool_count(), 2);
+        for (int i = 0; i < 6; i++) {
+            allocate(1);
+        }
+        EXPECT_EQ(m_allocator.get_pool_count(), 2);
+    }
+
+    TEST_F(DescriptorAllocatorTests, reset_pools_take_larger_batches) {
+        create(4);
+        allocate(4);
+        // Does not fit in the rest of the first pool.
+        allocate(6);
+        ASSERT_EQ(m_allocator.get_pool_count(), 2);
+
+        // The second pool has room for the whole batch again.
+        m_allocator.reset();
+        allocate(6);
+        allocate(4);
+        EXPECT_EQ(m_allocator.get_pool_count(), 2);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "vk_tut/descriptor_set_contents.h"
+#include "vk_tut/push_constant.h"
+
+#include <gtest/gtest.h>
+
+namespace vk::tut {
+    // Descriptor set contents test fixture.
+    class DescriptorSetContentsTests : public ::testing::Test {
+    protected:
+        // Contents with a uniform buffer range of the given size.
+        static DescriptorSetContents make_contents(const VkDeviceSize& range) {
+            VkDescriptorBufferInfo uniform_buffer_info{};
+            uniform_buffer_info.range = range;
+
+            return DescriptorSetContents(
+                uniform_buffer_info, VkDescriptorImageInfo{}
+            );
+        }
+    };
+
+    TEST_F(DescriptorSetContentsTests, compares_descriptors) {
+        EXPECT_EQ(make_contents(64), make_contents(64));
+        EXPECT_NE(make_contents(64), make_contents(128));
+    }
+
+    TEST_F(DescriptorSetContentsTests, template_entries_stay_in_bounds) {
+        const ::std::vector<VkDescriptorSetLayoutBinding> bindings =
+            DescriptorSetContents::get_layout_bindings();
+        const ::std::vector<VkDescriptorUpdateTemplateEntry> entries =
+            DescriptorSetContents::get_update_template_entries(bindings);
+
+        // Every binding but the texture table is held by the contents.
+        EXPECT_EQ(entries.size(), bindings.size() - 1);
+        for (const VkDescriptorUpdateTemplateEntry& entry : entries) {
+            EXPECT_NE(entry.dstBinding,
+                DescriptorSetContents::TEXTURE_TABLE_BINDING);
+            EXPECT_LE(entry.offset + entry.stride * entry.descriptorCount,
+                sizeof(DescriptorSetContents));
+        }
+    }
+
+    TEST_F(DescriptorSetContentsTests, texture_table_entry_covers_every_slot) {
+        const ::std::vector<VkDescriptorUpdateTemplateEntry> entries =
+            DescriptorSetContents::get_texture_table_template_entries(
+                DescriptorSetContents::get_layout_bindings()
+            );
+
+        ASSERT_EQ(entries.size(), 1);
+        EXPECT_EQ(entries[0].dstBinding,
+            DescriptorSetContents::TEXTURE_TABLE_BINDING);
+        EXPECT_EQ(entries[0].descriptorCount, MAX_BINDLESS_TEXTURES);
+        EXPECT_EQ(entries[0].stride, sizeof(VkDescriptorImageInfo));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "vk_tut/frame_arena.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+
+namespace vk::tut {
+    // Frame arena test fixture.
+    class FrameArenaTests : public ::testing::Test {
+    protected:
+        FrameArena m_arena{1024};
+    };
+
+    TEST_F(FrameArenaTests, aligns_allocations) {
+        for (size_t alignment : {1, 2, 8, 16, 64, 256}) {
+            void* ptr = m_arena.allocate(3, alignment);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0);
+        }
+        EXPECT_EQ(m_arena.get_block_count(), 1);
+    }
+
+    TEST_F(FrameArenaTests, reset_reuses_the_memory) {
+        void* ptr_first = m_arena.allocate(100, 8);
+        EXPECT_NE(m_arena.allocate(200, 8), nullptr);
+        EXPECT_GE(m_arena.get_used_bytes(), 300);
+
+        m_arena.reset();
+        EXPECT_EQ(m_arena.get_used_bytes(), 0);
+        EXPECT_EQ(m_arena.allocate(100, 8), ptr_first);
+        EXPECT_GE(m_arena.get_peak_bytes(), 300);
+    }
+
+    TEST_F(FrameArenaTests, merges_overflow_blocks_on_reset) {
+        for (int i = 0; i < 10; i++) {
+            ::std::memset(m_arena.allocate(400, 16), i, 400);
+        }
+        EXPECT_GT(m_arena.get_block_count(), 1);
+        const size_t capacity = m_arena.get_capacity();
+
+        m_arena.reset();
+        EXPECT_EQ(m_arena.get_block_count(), 1);
+        EXPECT_EQ(m_arena.get_capacity(), capacity);
+
+        // A frame as large now fits in the one block.
+        for (int i = 0; i < 10; i++) {
+            EXPECT_NE(m_arena.allocate(400, 16), nullptr);
+        }
+        EXPECT_EQ(m_arena.get_block_count(), 1);
+    }
+
+    TEST_F(FrameArenaTests, backs_pmr_containers) {
+        FrameVector<uint32_t> values(&m_arena);
+        for (uint32_t i = 0; i < 100; i++) {
+            values.emplace_back(i);
+        }
+        EXPECT_EQ(values.get_allocator().resource(), &m_arena);
+        EXPECT_EQ(values[99], 99);
+        EXPECT_GE(m_arena.get_used_bytes(), 100 * sizeof(uint32_t));
+
+        uint64_t* ptr_array = m_arena.allocate_array<uint64_t>(4);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr_array) %
+            alignof(uint64_t), 0);
+    }
+}
\ No newline at end of file
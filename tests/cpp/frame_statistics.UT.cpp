@@ -0,0 +1,115 @@
+#include "vk_tut/frame_statistics.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+namespace vk::tut {
+    // Latency histogram test fixture.
+    class LatencyHistogramTests : public ::testing::Test {
+    protected:
+        LatencyHistogram m_histogram;
+    };
+
+    TEST_F(LatencyHistogramTests, small_values_are_exact) {
+        for (uint64_t value = 1; value <= 10; value++) {
+            m_histogram.record(value);
+        }
+
+        EXPECT_EQ(m_histogram.get_count(), 10);
+        EXPECT_EQ(m_histogram.get_percentile(50.0), 5);
+        EXPECT_EQ(m_histogram.get_percentile(90.0), 9);
+        EXPECT_EQ(m_histogram.get_percentile(100.0), 10);
+        EXPECT_EQ(m_histogram.get_max(), 10);
+    }
+
+    TEST_F(LatencyHistogramTests, large_values_keep_their_precision) {
+        for (uint64_t value = 1000; value <= 100000; value += 1000) {
+            m_histogram.record(value);
+        }
+
+        // Within the bucket width of about 3%.
+        EXPECT_NEAR(m_histogram.get_percentile(50.0), 50000.0, 1600.0);
+        EXPECT_NEAR(m_histogram.get_percentile(99.0), 99000.0, 3100.0);
+        EXPECT_EQ(m_histogram.get_max(), 100000);
+    }
+
+    TEST_F(LatencyHistogramTests, buckets_are_contiguous) {
+        for (uint32_t i = 1; i < LatencyHistogram::BUCKET_COUNT; i++) {
+            const uint64_t first_value =
+                LatencyHistogram::get_bucket_max(i - 1) + 1;
+            EXPECT_EQ(LatencyHistogram::get_bucket_index(first_value), i);
+            EXPECT_EQ(LatencyHistogram::get_bucket_index(
+                LatencyHistogram::get_bucket_max(i)), i);
+        }
+    }
+
+    TEST_F(LatencyHistogramTests, clear_forgets_every_value) {
+        m_histogram.record(42);
+        m_histogram.clear();
+
+        EXPECT_EQ(m_histogram.get_count(), 0);
+        EXPECT_EQ(m_histogram.get_max(), 0);
+        EXPECT_EQ(m_histogram.get_percentile(50.0), 0);
+    }
+
+    // Frame statistics test fixture.
+    class FrameStatisticsTests : public ::testing::Test {
+    protected:
+        FrameStatistics m_statistics{4};
+    };
+
+    TEST_F(FrameStatisticsTests, windows_roll_over) {
+        for (uint64_t frame = 0; frame < 4; frame++) {
+            m_statistics.record(FrameMetric::CPU_FRAME_TIME, 10);
+            m_statistics.end_frame();
+        }
+        m_statistics.record(FrameMetric::CPU_FRAME_TIME, 50);
+        m_statistics.end_frame();
+
+        // The latest complete window only saw the first frames.
+        const FrameStatistics::Summary window =
+            m_statistics.get_window_summary(FrameMetric::CPU_FRAME_TIME);
+        EXPECT_EQ(window.count, 4);
+        EXPECT_EQ(window.max, 10);
+
+        const FrameStatistics::Summary total =
+            m_statistics.get_total_summary(FrameMetric::CPU_FRAME_TIME);
+        EXPECT_EQ(total.count, 5);
+        EXPECT_EQ(total.max, 50);
+        EXPECT_EQ(m_statistics.get_frame_count(), 5);
+    }
+
+    TEST_F(FrameStatisticsTests, counts_hitches_above_the_threshold) {
+        m_statistics.set_hitch_threshold(FrameMetric::GPU_FRAME_TIME, 100);
+        m_statistics.record(FrameMetric::GPU_FRAME_TIME, 100);
+        m_statistics.record(FrameMetric::GPU_FRAME_TIME, 101);
+        m_statistics.record(FrameMetric::FENCE_WAIT_TIME, 1000);
+
+        EXPECT_EQ(m_statistics.get_total_summary(
+            FrameMetric::GPU_FRAME_TIME).hitch_count, 1);
+        EXPECT_EQ(m_statistics.get_window_summary(
+            FrameMetric::GPU_FRAME_TIME).hitch_count, 1);
+        EXPECT_EQ(m_statistics.get_total_summary(
+            FrameMetric::FENCE_WAIT_TIME).hitch_count, 0);
+    }
+
+    TEST_F(FrameStatisticsTests, writes_every_metric_as_json) {
+        m_statistics.record(FrameMetric::CPU_FRAME_TIME, 16000);
+        m_statistics.end_frame();
+
+        ::std::stringstream stream;
+        m_statistics.write_json(stream);
+        const ::std::string json = stream.str();
+
+        EXPECT_EQ(json.rfind("{\"frame_count\":1,\"window_size\":4,", 0), 0);
+        for (uint32_t i = 0;
+        i < static_cast<uint32_t>(FrameMetric::COUNT); i++) {
+            const ::std::string name =
+                get_frame_metric_name(static_cast<FrameMetric>(i));
+            EXPECT_NE(json.find("\"" + name + "\":{\"window\":"),
+                ::std::string::npos);
+        }
+        EXPECT_NE(json.find("\"max\":16000"), ::std::string::npos);
+    }
+}
\ No newline at end of file
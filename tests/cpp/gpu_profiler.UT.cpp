@@ -0,0 +1,60 @@
+#include "vk_tut/gpu_profiler.h"
+
+#include <gtest/gtest.h>
+
+namespace vk::tut {
+    // GPU timing statistics test fixture.
+    class GpuTimingStatsTests : public ::testing::Test {
+    protected:
+        GpuTimingStats m_stats;
+    };
+
+    TEST_F(GpuTimingStatsTests, empty_stats_are_zero) {
+        EXPECT_EQ(m_stats.get_sample_count(), 0);
+        EXPECT_DOUBLE_EQ(m_stats.get_average(), 0.0);
+        EXPECT_DOUBLE_EQ(m_stats.get_min(), 0.0);
+        EXPECT_DOUBLE_EQ(m_stats.get_max(), 0.0);
+    }
+
+    TEST_F(GpuTimingStatsTests, tracks_average_min_and_max) {
+        m_stats.add_sample(2.0);
+        m_stats.add_sample(1.0);
+        m_stats.add_sample(6.0);
+
+        EXPECT_EQ(m_stats.get_sample_count(), 3);
+        EXPECT_DOUBLE_EQ(m_stats.get_average(), 3.0);
+        EXPECT_DOUBLE_EQ(m_stats.get_min(), 1.0);
+        EXPECT_DOUBLE_EQ(m_stats.get_max(), 6.0);
+    }
+
+    TEST_F(GpuTimingStatsTests, only_keeps_the_latest_window) {
+        // An outlier followed by a full window of steady frames.
+        m_stats.add_sample(100.0);
+        for (uint32_t i = 0; i < GpuTimingStats::WINDOW_SIZE; i++) {
+            m_stats.add_sample(4.0);
+        }
+
+        EXPECT_EQ(m_stats.get_sample_count(), GpuTimingStats::WINDOW_SIZE);
+        EXPECT_EQ(m_stats.get_total_sample_count(),
+            GpuTimingStats::WINDOW_SIZE + 1);
+        EXPECT_DOUBLE_EQ(m_stats.get_average(), 4.0);
+        EXPECT_DOUBLE_EQ(m_stats.get_max(), 4.0);
+        EXPECT_DOUBLE_EQ(m_stats.get_latest(), 4.0);
+    }
+
+    // GPU profiler test fixture.
+    class GpuProfilerTests : public ::testing::Test {
+    protected:
+        GpuProfiler m_profiler;
+    };
+
+    TEST_F(GpuProfilerTests, does_nothing_until_created) {
+        EXPECT_FALSE(m_profiler.is_enabled());
+        m_profiler.begin_frame(nullptr, 0);
+        m_profiler.begin_region(nullptr, 0, "main");
+        m_profiler.end_region(nullptr, 0, "main");
+        m_profiler.submit(0);
+        EXPECT_TRUE(m_profiler.get_region_names().empty());
+        EXPECT_EQ(m_profiler.get_stats("main").get_sample_count(), 0);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "vk_tut/host_allocator.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace vk::tut {
+    // Host allocator test fixture. The allocator is shared, so the
+    // tests check the usage they add to it.
+    class HostAllocatorTests : public ::testing::Test {
+    protected:
+        // Allocates through the callbacks of an object type.
+        void* allocate(
+            const VkObjectType& object_type,
+            const size_t& size,
+            const size_t& alignment,
+            const VkSystemAllocationScope& scope
+        ) {
+            const VkAllocationCallbacks* ptr_callbacks =
+                m_allocator.get_callbacks(object_type);
+            return ptr_callbacks->pfnAllocation(
+                ptr_callbacks->pUserData, size, alignment, scope
+            );
+        }
+
+        // Frees through the callbacks of an object type.
+        void free(const VkObjectType& object_type, void* ptr) {
+            const VkAllocationCallbacks* ptr_callbacks =
+                m_allocator.get_callbacks(object_type);
+            ptr_callbacks->pfnFree(ptr_callbacks->pUserData, ptr);
+        }
+
+        HostAllocator& m_allocator = HostAllocator::get_instance();
+    };
+
+    TEST_F(HostAllocatorTests, aligns_pooled_and_large_allocations) {
+        ::std::vector<void*> allocations;
+        for (size_t size : {1, 24, 100, 3000, 20000}) {
+            for (size_t alignment : {1, 8, 64, 256}) {
+                void* ptr = allocate(VK_OBJECT_TYPE_BUFFER, size, alignment,
+                    VK_SYSTEM_ALLOCATION_SCOPE_OBJECT
+                );
+                ASSERT_NE(ptr, nullptr);
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0);
+                // The whole allocation is usable.
+                ::std::memset(ptr, 0xAB, size);
+                allocations.emplace_back(ptr);
+            }
+        }
+
+        for (void* ptr : allocations) {
+            free(VK_OBJECT_TYPE_BUFFER, ptr);
+        }
+    }
+
+    TEST_F(HostAllocatorTests, counts_usage_per_scope_and_object_type) {
+        const HostAllocator::Usage scope_before = m_allocator.get_scope_usage(
+            VK_SYSTEM_ALLOCATION_SCOPE_CACHE
+        );
+        const HostAllocator::Usage type_before =
+            m_allocator.get_object_type_usage(VK_OBJECT_TYPE_SAMPLER);
+
+        void* ptr_small = allocate(VK_OBJECT_TYPE_SAMPLER, 100, 8,
+            VK_SYSTEM_ALLOCATION_SCOPE_CACHE
+        );
+        void* ptr_large = allocate(VK_OBJECT_TYPE_SAMPLER, 50000, 8,
+            VK_SYSTEM_ALLOCATION_SCOPE_CACHE
+        );
+
+        HostAllocator::Usage scope_usage = m_allocator.get_scope_usage(
+            VK_SYSTEM_ALLOCATION_SCOPE_CACHE
+        );
+        const HostAllocator::Usage type_usage =
+            m_allocator.get_object_type_usage(VK_OBJECT_TYPE_SAMPLER);
+        EXPECT_EQ(scope_usage.allocation_count,
+            scope_before.allocation_count + 2);
+        EXPECT_EQ(scope_usage.bytes, scope_before.bytes + 50100);
+        EXPECT_GE(scope_usage.peak_bytes, scope_before.bytes + 50100);
+        EXPECT_EQ(type_usage.bytes, type_before.bytes + 50100);
+        EXPECT_EQ(type_usage.total_allocation_count,
+            type_before.total_allocation_count + 2);
+
+        free(VK_OBJECT_TYPE_SAMPLER, ptr_small);
+        free(VK_OBJECT_TYPE_SAMPLER, ptr_large);
+        scope_usage = m_allocator.get_scope_usage(
+            VK_SYSTEM_ALLOCATION_SCOPE_CACHE
+        );
+        EXPECT_EQ(scope_usage.allocation_count, scope_before.allocation_count);
+        EXPECT_EQ(scope_usage.bytes, scope_before.bytes);
+    }
+
+    TEST_F(HostAllocatorTests, counts_other_object_types_as_unknown) {
+        EXPECT_EQ(m_allocator.get_callbacks(VK_OBJECT_TYPE_EVENT),
+            m_allocator.get_callbacks(VK_OBJECT_TYPE_UNKNOWN));
+        EXPECT_NE(m_allocator.get_callbacks(VK_OBJECT_TYPE_IMAGE),
+            m_allocator.get_callbacks(VK_OBJECT_TYPE_UNKNOWN));
+    }
+
+    TEST_F(HostAllocatorTests, reallocation_keeps_contents) {
+        const VkAllocationCallbacks* ptr_callbacks =
+            m_allocator.get_callbacks(VK_OBJECT_TYPE_PIPELINE);
+        const HostAllocator::Usage before =
+            m_allocator.get_object_type_usage(VK_OBJECT_TYPE_PIPELINE);
+
+        char* ptr = static_cast<char*>(ptr_callbacks->pfnReallocation(
+            ptr_callbacks->pUserData, nullptr, 16, 16,
+            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT
+        ));
+        ASSERT_NE(ptr, nullptr);
+        ::std::memcpy(ptr, "fifteen chars..", 16);
+
+        ptr = static_cast<char*>(ptr_callbacks->pfnReallocation(
+            ptr_callbacks->pUserData, ptr, 10000, 16,
+            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT
+        ));
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_STREQ(ptr, "fifteen chars..");
+        EXPECT_EQ(m_allocator.get_object_type_usage(
+            VK_OBJECT_TYPE_PIPELINE).bytes, before.bytes + 10000);
+
+        EXPECT_EQ(ptr_callbacks->pfnReallocation(
+            ptr_callbacks->pUserData, ptr, 0, 16,
+            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT
+        ), nullptr);
+        EXPECT_EQ(m_allocator.get_object_type_usage(
+            VK_OBJECT_TYPE_PIPELINE).bytes, before.bytes);
+    }
+
+    TEST_F(HostAllocatorTests, reuses_freed_blocks) {
+        void* ptr = allocate(VK_OBJECT_TYPE_FENCE, 40, 8,
+            VK_SYSTEM_ALLOCATION_SCOPE_COMMAND
+        );
+        free(VK_OBJECT_TYPE_FENCE, ptr);
+        const uint64_t arena_bytes = m_allocator.get_arena_bytes();
+
+        for (int i = 0; i < 1000; i++) {
+            free(VK_OBJECT_TYPE_FENCE, allocate(VK_OBJECT_TYPE_FENCE, 40, 8,
+                VK_SYSTEM_ALLOCATION_SCOPE_COMMAND
+            ));
+        }
+        EXPECT_EQ(m_allocator.get_arena_bytes(), arena_bytes);
+    }
+
+    TEST_F(HostAllocatorTests, counts_internal_allocations) {
+        const VkAllocationCallbacks* ptr_callbacks =
+            m_allocator.get_callbacks(VK_OBJECT_TYPE_DEVICE);
+        const HostAllocator::Usage before = m_allocator.get_internal_usage(
+            VK_SYSTEM_ALLOCATION_SCOPE_DEVICE
+        );
+
+        ptr_callbacks->pfnInternalAllocation(ptr_callbacks->pUserData, 4096,
+            VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE,
+            VK_SYSTEM_ALLOCATION_SCOPE_DEVICE
+        );
+        EXPECT_EQ(m_allocator.get_internal_usage(
+            VK_SYSTEM_ALLOCATION_SCOPE_DEVICE).bytes, before.bytes + 4096);
+
+        ptr_callbacks->pfnInternalFree(ptr_callbacks->pUserData, 4096,
+            VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE,
+            VK_SYSTEM_ALLOCATION_SCOPE_DEVICE
+        );
+        EXPECT_EQ(m_allocator.get_internal_usage(
+            VK_SYSTEM_ALLOCATION_SCOPE_DEVICE).bytes, before.bytes);
+    }
+
+    TEST_F(HostAllocatorTests, allocates_from_many_threads) {
+        const HostAllocator::Usage before =
+            m_allocator.get_object_type_usage(VK_OBJECT_TYPE_COMMAND_POOL);
+
+        ::std::vector<::std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([this]() {
+                ::std::vector<void*> allocations;
+                for (size_t i = 0; i < 2000; i++) {
+                    allocations.emplace_back(allocate(
+                        VK_OBJECT_TYPE_COMMAND_POOL, 16 + i % 500, 16,
+                        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT
+                    ));
+                }
+                for (void* ptr : allocations) {
+                    free(VK_OBJECT_TYPE_COMMAND_POOL, ptr);
+                }
+            });
+        }
+        for (::std::thread& thread : threads) {
+            thread.join();
+        }
+
+        const HostAllocator::Usage usage =
+            m_allocator.get_object_type_usage(VK_OBJECT_TYPE_COMMAND_POOL);
+        EXPECT_EQ(usage.allocation_count, before.allocation_count);
+        EXPECT_EQ(usage.bytes, before.bytes);
+        EXPECT_EQ(usage.total_allocation_count,
+            before.total_allocation_count + 8000);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "vk_tut/job_system.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace vk::tut {
+    // Job system test fixture.
+    class JobSystemTests : public ::testing::Test {
+    protected:
+        JobSystem m_job_system{3};
+    };
+
+    TEST_F(JobSystemTests, deque_pops_newest_and_steals_oldest) {
+        WorkStealingDeque deque(4);
+        ::std::vector<::std::unique_ptr<Job>> jobs;
+        for (int i = 0; i < 3; i++) {
+            jobs.emplace_back(::std::make_unique<Job>([]() {}, nullptr));
+            EXPECT_TRUE(deque.push(jobs.back().get()));
+        }
+
+        EXPECT_EQ(deque.steal(), jobs[0].get());
+        EXPECT_EQ(deque.pop(), jobs[2].get());
+        EXPECT_EQ(deque.pop(), jobs[1].get());
+        EXPECT_EQ(deque.pop(), nullptr);
+        EXPECT_EQ(deque.steal(), nullptr);
+    }
+
+    TEST_F(JobSystemTests, deque_rejects_push_when_full) {
+        WorkStealingDeque deque(2);
+        Job job([]() {}, nullptr);
+
+        EXPECT_TRUE(deque.push(&job));
+        EXPECT_TRUE(deque.push(&job));
+        EXPECT_FALSE(deque.push(&job));
+        EXPECT_EQ(deque.get_size(), 2);
+    }
+
+    TEST_F(JobSystemTests, deque_hands_each_job_out_once) {
+        constexpr int job_count = 100000;
+        WorkStealingDeque deque(job_count);
+        ::std::vector<::std::unique_ptr<Job>> jobs;
+        jobs.reserve(job_count);
+
+        // The number of times each job was taken.
+        ::std::vector<::std::atomic<int>> taken(job_count);
+        ::std::atomic<bool> done{false};
+
+        // Thieves race the owner for every job.
+        auto thief = [&]() {
+            while (!done.load()) {
+                Job* ptr_job = deque.steal();
+                if (ptr_job != nullptr) ptr_job->execute();
+            }
+        };
+        ::std::thread thief_a(thief), thief_b(thief);
+
+        for (int i = 0; i < job_count; i++) {
+            jobs.emplace_back(::std::make_unique<Job>(
+                [&taken, i]() { taken[i]++; }, nullptr
+            ));
+            deque.push(jobs.back().get());
+            if (i % 3 == 0) {
+                Job* ptr_job = deque.pop();
+                if (ptr_job != nullptr) ptr_job->execute();
+            }
+        }
+        while (Job* ptr_job = deque.pop()) ptr_job->execute();
+        done.store(true);
+        thief_a.join();
+        thief_b.join();
+
+        for (int i = 0; i < job_count; i++) {
+            ASSERT_EQ(taken[i].load(), 1) << "Job " << i;
+        }
+    }
+
+    TEST_F(JobSystemTests, wait_returns_after_every_job) {
+        JobCounter counter;
+        ::std::atomic<int> sum{0};
+        for (int i = 1; i <= 1000; i++) {
+            m_job_system.run([&sum, i]() { sum += i; }, &counter);
+        }
+
+        m_job_system.wait(counter);
+        EXPECT_EQ(counter.get_value(), 0);
+        EXPECT_EQ(sum.load(), 500500);
+    }
+
+    TEST_F(JobSystemTests, nested_jobs_complete) {
+        JobCounter counter;
+        ::std::atomic<int> leaves{0};
+        for (int i = 0; i < 16; i++) {
+            m_job_system.run([&]() {
+                for (int j = 0; j < 16; j++) {
+                    m_job_system.run([&leaves]() { leaves++; }, &counter);
+                }
+            }, &counter);
+        }
+
+        m_job_system.wait(counter);
+        EXPECT_EQ(leaves.load(), 256);
+    }
+
+    TEST_F(JobSystemTests, run_after_waits_for_dependency) {
+        JobCounter first, second;
+        ::std::atomic<int> first_done{0};
+        ::std::atomic<bool> ordered{true};
+        for (int i = 0; i < 64; i++) {
+            m_job_system.run([&first_done]() { first_done++; }, &first);
+        }
+        m_job_system.run_after(first, [&]() {
+            if (first_done.load() != 64) ordered = false;
+        }, &second);
+
+        m_job_system.wait(second);
+        EXPECT_TRUE(ordered.load());
+
+        // A dependency already at zero runs the job right away.
+        JobCounter third;
+        bool ran = false;
+        m_job_system.run_after(first, [&ran]() { ran = true; }, &third);
+        m_job_system.wait(third);
+        EXPECT_TRUE(ran);
+    }
+
+    TEST_F(JobSystemTests, parallel_for_covers_range_once) {
+        constexpr size_t count = 10007;
+        ::std::vector<::std::atomic<int>> visits(count);
+
+        m_job_system.parallel_for(count, 64, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) visits[i]++;
+        });
+
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQ(visits[i].load(), 1) << "Index " << i;
+        }
+    }
+
+    TEST_F(JobSystemTests, thread_indices) {
+        EXPECT_EQ(m_job_system.get_thread_count(), 4);
+        EXPECT_EQ(m_job_system.get_current_thread_index(), 0);
+
+        JobCounter counter;
+        ::std::atomic<bool> in_range{true};
+        for (int i = 0; i < 64; i++) {
+            m_job_system.run([&]() {
+                uint32_t index = m_job_system.get_current_thread_index();
+                if (index >= m_job_system.get_thread_count()) {
+                    in_range = false;
+                }
+            }, &counter);
+        }
+        m_job_system.wait(counter);
+        EXPECT_TRUE(in_range.load());
+    }
+
+    TEST_F(JobSystemTests, wait_rethrows_the_first_exception) {
+        JobCounter counter;
+        ::std::atomic<int> finished{0};
+        for (int i = 0; i < 64; i++) {
+            m_job_system.run([&finished, i]() {
+                finished++;
+                if (i % 8 == 0) throw ::std::runtime_error("job failed");
+            }, &counter);
+        }
+
+        EXPECT_THROW(m_job_system.wait(counter), ::std::runtime_error);
+        EXPECT_EQ(finished.load(), 64);
+        EXPECT_EQ(counter.get_value(), 0);
+
+        // The exception is handed over once.
+        EXPECT_NO_THROW(m_job_system.wait(counter));
+    }
+
+    TEST_F(JobSystemTests, parallel_for_rethrows_from_any_range) {
+        for (size_t failing_begin : {size_t(0), size_t(640)}) {
+            EXPECT_THROW(m_job_system.parallel_for(1024, 64,
+            [failing_begin](size_t begin, size_t) {
+                if (begin == failing_begin) {
+                    throw ::std::runtime_error("range failed");
+                }
+            }), ::std::runtime_error);
+        }
+    }
+}
\ No newline at end of file
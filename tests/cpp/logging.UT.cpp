@@ -1,6 +1,11 @@
 #include "vk_tut/logging.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace vk::tut {
     using ::std::cout;
@@ -14,8 +19,18 @@ namespace vk::tut {
         }
         // Runs after each test.
         inline void TearDown() override {
+            Logger::get_instance().set_level(LogLevel::TRACE);
+            Logger::get_instance().flush();
             cout << "\n";
         }
+
+        // The number of lines written to a stream.
+        static size_t count_lines(const ::std::ostringstream& stream) {
+            const ::std::string text = stream.str();
+            return static_cast<size_t>(
+                ::std::count(text.begin(), text.end(), '\n')
+            );
+        }
     };
 
     TEST_F(LoggingTests, general_logs) {
@@ -57,4 +72,103 @@ namespace vk::tut {
             );
         }
     }
+
+    TEST_F(LoggingTests, file_names_are_found_at_compile_time) {
+        constexpr const char* file_name =
+            get_file_basename("/a/b\\c/logging.UT.cpp");
+        static_assert(file_name[0] == 'l');
+
+        EXPECT_STREQ(file_name, "logging.UT.cpp");
+        EXPECT_STREQ(get_file_basename("main.cpp"), "main.cpp");
+    }
+
+    TEST_F(LoggingTests, level_names_ignore_case) {
+        EXPECT_EQ(get_log_level("TRACE"), LogLevel::TRACE);
+        EXPECT_EQ(get_log_level("debug"), LogLevel::DEBUG);
+        EXPECT_EQ(get_log_level("Error"), LogLevel::ERROR);
+        EXPECT_EQ(get_log_level("DEMO"), LogLevel::INFO);
+    }
+
+    TEST_F(LoggingTests, messages_are_written_once_flushed) {
+        ::std::ostringstream stream;
+        VK_TUT_LOG(DEMO, \033[0;95m, stream, "Value " << 42 << ".");
+        Logger::get_instance().flush();
+
+        const ::std::string text = stream.str();
+        EXPECT_NE(text.find("[DEMO]"), ::std::string::npos);
+        EXPECT_NE(text.find("Value 42."), ::std::string::npos);
+        EXPECT_NE(text.find("of logging.UT.cpp]"), ::std::string::npos);
+    }
+
+    TEST_F(LoggingTests, messages_below_the_level_are_skipped) {
+        Logger::get_instance().set_level(LogLevel::ERROR);
+
+        ::std::ostringstream stream;
+        int formatted_count = 0;
+        VK_TUT_LOG(DEBUG, \033[0;96m, stream, ++formatted_count);
+        VK_TUT_LOG(DEMO, \033[0;95m, stream, ++formatted_count);
+        Logger::get_instance().flush();
+
+        EXPECT_EQ(formatted_count, 0);
+        EXPECT_TRUE(stream.str().empty());
+    }
+
+    TEST_F(LoggingTests, errors_are_written_before_throwing) {
+        ::std::ostringstream stream;
+        try {
+            VK_TUT_LOG(ERROR, \033[0;91m, stream, "Failed.");
+            throw ::std::runtime_error("Failed.");
+        }
+        catch (const ::std::exception&) {
+            EXPECT_NE(stream.str().find("Failed."), ::std::string::npos);
+        }
+    }
+
+    TEST_F(LoggingTests, long_messages_are_cut_short) {
+        ::std::ostringstream stream;
+        VK_TUT_LOG(DEMO, \033[0;95m, stream,
+            ::std::string(2 * LogRecord::TEXT_CAPACITY, 'a'));
+        Logger::get_instance().flush();
+
+        const ::std::string text = stream.str();
+        EXPECT_NE(text.find(
+            ::std::string(LogRecord::TEXT_CAPACITY - 3, 'a') + "... "
+        ), ::std::string::npos);
+        EXPECT_EQ(text.find(
+            ::std::string(LogRecord::TEXT_CAPACITY - 2, 'a')
+        ), ::std::string::npos);
+    }
+
+    TEST_F(LoggingTests, messages_of_every_thread_are_written_in_order) {
+        const uint32_t thread_count = 4;
+        const uint32_t message_count = 100;
+
+        ::std::ostringstream stream;
+        ::std::vector<::std::thread> threads;
+        for (uint32_t thread = 0; thread < thread_count; thread++) {
+            threads.emplace_back([&stream, thread] {
+                for (uint32_t i = 0; i < message_count; i++) {
+                    VK_TUT_LOG(DEMO, \033[0;95m, stream,
+                        "thread " << thread << " message " << i);
+                }
+            });
+        }
+        for (::std::thread& thread : threads) thread.join();
+        Logger::get_instance().flush();
+
+        EXPECT_EQ(count_lines(stream), thread_count * message_count);
+        // The messages of a thread keep their order.
+        const ::std::string text = stream.str();
+        for (uint32_t thread = 0; thread < thread_count; thread++) {
+            const ::std::string prefix =
+                "thread " + ::std::to_string(thread) + " message ";
+            size_t position = 0;
+            for (uint32_t i = 0; i < message_count; i++) {
+                position = text.find(
+                    prefix + ::std::to_string(i) + " ", position
+                );
+                ASSERT_NE(position, ::std::string::npos);
+            }
+        }
+    }
 }
\ No newline at end of file
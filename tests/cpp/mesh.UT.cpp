@@ -0,0 +1,87 @@
+#include "vk_tut/mesh.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace vk::tut {
+    // Mesh generation test fixture.
+    class MeshTests : public ::testing::Test {
+    protected:
+        ::std::vector<Vertex> m_vertices;
+        ::std::vector<uint32_t> m_indices;
+    };
+
+    TEST_F(MeshTests, colour_wheel_is_a_fan_around_its_centre) {
+        generate_colour_wheel_mesh(8, m_vertices, m_indices);
+
+        EXPECT_EQ(m_vertices.size(), 9);
+        ASSERT_EQ(m_indices.size(), 24);
+        for (size_t i = 0; i < m_indices.size(); i += 3) {
+            EXPECT_EQ(m_indices[i], 0);
+        }
+        for (const uint32_t& index : m_indices) {
+            EXPECT_LT(index, m_vertices.size());
+        }
+    }
+
+    TEST_F(MeshTests, colour_wheel_indices_follow_existing_vertices) {
+        generate_colour_wheel_mesh(4, m_vertices, m_indices);
+        generate_colour_wheel_mesh(4, m_vertices, m_indices);
+
+        EXPECT_EQ(m_vertices.size(), 10);
+        ASSERT_EQ(m_indices.size(), 24);
+        EXPECT_EQ(m_indices[12], 5);
+        for (size_t i = 12; i < m_indices.size(); i++) {
+            EXPECT_GE(m_indices[i], 5);
+        }
+    }
+
+    TEST_F(MeshTests, no_triangles_generate_nothing) {
+        generate_colour_wheel_mesh(0, m_vertices, m_indices);
+
+        EXPECT_TRUE(m_vertices.empty());
+        EXPECT_TRUE(m_indices.empty());
+    }
+
+    TEST_F(MeshTests, cube_has_four_vertices_per_face) {
+        generate_cube_mesh(m_vertices, m_indices);
+
+        EXPECT_EQ(m_vertices.size(), 24);
+        ASSERT_EQ(m_indices.size(), 36);
+        for (const Vertex& vertex : m_vertices) {
+            const ::glm::vec3 position = vertex.get_3D_position();
+            EXPECT_FLOAT_EQ(
+                ::std::max({::std::abs(position.x), ::std::abs(position.y),
+                ::std::abs(position.z)}), 0.5f
+            );
+        }
+    }
+
+    TEST_F(MeshTests, sphere_vertices_lie_on_its_surface) {
+        generate_colour_wheel_mesh(4, m_vertices, m_indices);
+        const size_t first_vertex = m_vertices.size();
+        const size_t first_index = m_indices.size();
+        generate_sphere_mesh(8, m_vertices, m_indices);
+
+        // 4 rings of 8 segments, each ring closed by a repeated vertex.
+        EXPECT_EQ(m_vertices.size() - first_vertex, 5 * 9);
+        ASSERT_EQ(m_indices.size() - first_index, 4 * 8 * 6);
+        for (size_t i = first_vertex; i < m_vertices.size(); i++) {
+            const ::glm::vec3 position = m_vertices[i].get_3D_position();
+            EXPECT_NEAR(::glm::length(position), 0.5f, 1e-5f);
+        }
+        for (size_t i = first_index; i < m_indices.size(); i++) {
+            EXPECT_GE(m_indices[i], first_vertex);
+            EXPECT_LT(m_indices[i], m_vertices.size());
+        }
+    }
+
+    TEST_F(MeshTests, sphere_needs_three_segments) {
+        generate_sphere_mesh(2, m_vertices, m_indices);
+
+        EXPECT_TRUE(m_vertices.empty());
+        EXPECT_TRUE(m_indices.empty());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "vk_tut/pipeline_statistics.h"
+
+#include <gtest/gtest.h>
+#include <bit>
+
+namespace vk::tut {
+    // Pipeline statistics queries test fixture.
+    class PipelineStatisticsQueriesTests : public ::testing::Test {
+    protected:
+        PipelineStatisticsQueries m_queries;
+    };
+
+    TEST_F(PipelineStatisticsQueriesTests, does_nothing_until_created) {
+        EXPECT_FALSE(m_queries.is_enabled());
+        m_queries.begin(nullptr, 0);
+        m_queries.end(nullptr, 0);
+        m_queries.submit(0);
+        EXPECT_FALSE(m_queries.collect(nullptr, 0));
+        EXPECT_EQ(m_queries.get_latest(
+            PipelineStatisticsQueries::Counter::FRAGMENT_SHADER_INVOCATIONS
+        ), 0);
+    }
+
+    TEST_F(PipelineStatisticsQueriesTests, queries_one_statistic_per_counter) {
+        // One bit per counter, since each bit adds a result.
+        EXPECT_EQ(::std::popcount(PipelineStatisticsQueries::get_flags()),
+            static_cast<int>(PipelineStatisticsQueries::Counter::COUNT));
+    }
+}
\ No newline at end of file
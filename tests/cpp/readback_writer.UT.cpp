@@ -0,0 +1,95 @@
+#include "vk_tut/readback_writer.h"
+
+#include <gtest/gtest.h>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace vk::tut {
+    // Readback writer test fixture.
+    class ReadbackWriterTests : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            ::std::filesystem::remove_all(m_directory);
+            ::std::filesystem::create_directories(m_directory);
+        }
+
+        void TearDown() override {
+            ::std::filesystem::remove_all(m_directory);
+        }
+
+        // A 2x1 frame, red then blue, in BGRA.
+        ReadbackFrame make_frame(const uint64_t& frame_value) const {
+            return ReadbackFrame(frame_value,
+                VkFormat::VK_FORMAT_B8G8R8A8_UNORM, {2, 1},
+                m_pixels.data(), m_pixels.size()
+            );
+        }
+
+        // The contents of a written file.
+        ::std::string read_file(const ::std::string& file_name) const {
+            ::std::ifstream file(m_directory + "/" + file_name,
+                ::std::ios::binary);
+            return ::std::string(::std::istreambuf_iterator<char>(file), {});
+        }
+
+        // Cleared before and after each test.
+        const ::std::string m_directory = (
+            ::std::filesystem::temp_directory_path() /
+            "vk_tut_readback_writer_tests"
+        ).string();
+        // Red then blue, in BGRA.
+        const ::std::array<uint8_t, 8> m_pixels = {
+            0, 0, 255, 255, 255, 0, 0, 255
+        };
+    };
+
+    TEST_F(ReadbackWriterTests, encodes_bgra_as_rgb) {
+        ::std::vector<char> encoded;
+        ReadbackWriter::encode_ppm(VkFormat::VK_FORMAT_B8G8R8A8_UNORM,
+            {2, 1}, m_pixels.data(), encoded);
+
+        const ::std::string expected = ::std::string("P6\n2 1\n255\n") +
+            ::std::string("\xff\x00\x00\x00\x00\xff", 6);
+        EXPECT_EQ(::std::string(encoded.begin(), encoded.end()), expected);
+    }
+
+    TEST_F(ReadbackWriterTests, writes_more_frames_than_buffers) {
+        {
+            ReadbackWriter writer(m_directory, 2);
+            for (uint64_t i = 1; i <= 5; i++) writer.write(make_frame(i));
+            writer.wait_idle();
+            EXPECT_EQ(writer.get_written_count(), 5);
+        }
+
+        for (const char* file_name : {"frame_000001.ppm",
+        "frame_000005.ppm"}) {
+            EXPECT_EQ(read_file(file_name),
+                ::std::string("P6\n2 1\n255\n") +
+                ::std::string("\xff\x00\x00\x00\x00\xff", 6));
+        }
+    }
+
+    TEST_F(ReadbackWriterTests, destructor_writes_queued_frames) {
+        {
+            ReadbackWriter writer(m_directory, 4);
+            for (uint64_t i = 1; i <= 4; i++) writer.write(make_frame(i));
+        }
+
+        EXPECT_TRUE(::std::filesystem::exists(
+            m_directory + "/frame_000004.ppm"
+        ));
+    }
+
+    TEST_F(ReadbackWriterTests, rethrows_write_errors) {
+        ReadbackWriter writer(m_directory + "/missing", 1);
+        writer.write(make_frame(1));
+
+        EXPECT_THROW(writer.wait_idle(), ::std::runtime_error);
+        // The exception is only rethrown once.
+        EXPECT_NO_THROW(writer.wait_idle());
+    }
+}
\ No newline at end of file
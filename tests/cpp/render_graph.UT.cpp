@@ -0,0 +1,278 @@
+#include "vk_tut/render_graph.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+namespace vk::tut {
+    // Render graph test fixture.
+    class RenderGraphTests : public ::testing::Test {
+    protected:
+        // Runs before each test.
+        inline void SetUp() override {
+            s_image_barrier_count = 0;
+            s_memory_barriers.clear();
+        }
+
+        // Stands in for vkCmdPipelineBarrier2KHR.
+        static VKAPI_ATTR void VKAPI_CALL fake_pipeline_barrier2(
+            VkCommandBuffer command_buffer,
+            const VkDependencyInfoKHR* ptr_dependency_info
+        ) {
+            s_image_barrier_count +=
+                ptr_dependency_info->imageMemoryBarrierCount;
+            s_memory_barriers.insert(s_memory_barriers.end(),
+                ptr_dependency_info->pMemoryBarriers,
+                ptr_dependency_info->pMemoryBarriers +
+                ptr_dependency_info->memoryBarrierCount
+            );
+        }
+
+        // A colour image of the given size.
+        inline RenderGraphResource create_colour_image(
+            const char* name, const uint32_t& size
+        ) {
+            return m_graph.create_image(name, RenderGraphImageInfo(
+                VkFormat::VK_FORMAT_R8G8B8A8_UNORM, {size, size},
+                VkImageUsageFlagBits::VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                VkImageUsageFlagBits::VK_IMAGE_USAGE_SAMPLED_BIT,
+                VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT
+            ));
+        }
+
+        // Memory requirements with the given size and memory types.
+        static inline VkMemoryRequirements requirements(
+            const VkDeviceSize& size, const uint32_t& memory_type_bits
+        ) {
+            VkMemoryRequirements memory_requirements{};
+            memory_requirements.size = size;
+            memory_requirements.alignment = 256;
+            memory_requirements.memoryTypeBits = memory_type_bits;
+            return memory_requirements;
+        }
+
+        // The state of an image written as a colour attachment.
+        const ResourceState m_colour_write = ResourceState(
+            VkImageLayout::VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+        );
+        // The state of an image sampled by a fragment shader.
+        const ResourceState m_sampled_read = ResourceState(
+            VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR
+        );
+
+        RenderGraph m_graph;
+
+        static inline uint32_t s_image_barrier_count = 0;
+        // The global memory barriers recorded.
+        static inline ::std::vector<VkMemoryBarrier2KHR> s_memory_barriers;
+    };
+
+    TEST_F(RenderGraphTests, unused_passes_are_culled) {
+        RenderGraphResource output = m_graph.import_image("output",
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, ResourceState()
+        );
+        RenderGraphResource used = create_colour_image("used", 64);
+        RenderGraphResource unused = create_colour_image("unused", 64);
+
+        m_graph.add_pass("producer", [](const VkCommandBuffer&) {})
+            .write(used, m_colour_write);
+        m_graph.add_pass("orphan", [](const VkCommandBuffer&) {})
+            .write(unused, m_colour_write);
+        m_graph.add_pass("debug", [](const VkCommandBuffer&) {})
+            .set_side_effect();
+        m_graph.add_pass("consumer", [](const VkCommandBuffer&) {})
+            .read(used, m_sampled_read)
+            .write(output, m_colour_write);
+        m_graph.compile();
+
+        EXPECT_FALSE(m_graph.is_pass_culled(0));
+        EXPECT_TRUE(m_graph.is_pass_culled(1));
+        EXPECT_FALSE(m_graph.is_pass_culled(2));
+        EXPECT_FALSE(m_graph.is_pass_culled(3));
+        EXPECT_EQ(m_graph.get_execution_order().size(), 3);
+        EXPECT_EQ(m_graph.get_first_use(unused), RenderGraph::UNUSED);
+    }
+
+    TEST_F(RenderGraphTests, consumers_run_right_after_producers) {
+        RenderGraphResource output = m_graph.import_image("output",
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, ResourceState()
+        );
+        RenderGraphResource first = create_colour_image("first", 64);
+        RenderGraphResource second = create_colour_image("second", 64);
+
+        // Declared as both producers, then both consumers.
+        m_graph.add_pass("produce_first", [](const VkCommandBuffer&) {})
+            .write(first, m_colour_write);
+        m_graph.add_pass("produce_second", [](const VkCommandBuffer&) {})
+            .write(second, m_colour_write);
+        m_graph.add_pass("consume_first", [](const VkCommandBuffer&) {})
+            .read(first, m_sampled_read)
+            .write(output, m_colour_write);
+        m_graph.add_pass("consume_second", [](const VkCommandBuffer&) {})
+            .read(second, m_sampled_read)
+            .write(output, m_colour_write);
+        m_graph.compile();
+
+        const ::std::vector<uint32_t> expected_order = {0, 2, 1, 3};
+        EXPECT_EQ(m_graph.get_execution_order(), expected_order);
+
+        // The lifetimes no longer overlap, so both share one block.
+        const VkDeviceSize total_size = m_graph.assign_memory({
+            requirements(0, 0), requirements(4096, 0b11),
+            requirements(1024, 0b01)
+        });
+        EXPECT_EQ(m_graph.get_memory_block_count(), 1);
+        EXPECT_EQ(total_size, 4096);
+        EXPECT_EQ(
+            m_graph.get_memory_block(first), m_graph.get_memory_block(second)
+        );
+    }
+
+    TEST_F(RenderGraphTests, overlapping_images_do_not_alias) {
+        RenderGraphResource output = m_graph.import_image("output",
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, ResourceState()
+        );
+        RenderGraphResource first = create_colour_image("first", 64);
+        RenderGraphResource second = create_colour_image("second", 64);
+        RenderGraphResource third = create_colour_image("third", 64);
+
+        m_graph.add_pass("produce", [](const VkCommandBuffer&) {})
+            .write(first, m_colour_write)
+            .write(second, m_colour_write);
+        m_graph.add_pass("combine", [](const VkCommandBuffer&) {})
+            .read(first, m_sampled_read)
+            .read(second, m_sampled_read)
+            .write(third, m_colour_write);
+        m_graph.add_pass("present", [](const VkCommandBuffer&) {})
+            .read(third, m_sampled_read)
+            .write(output, m_colour_write);
+        m_graph.compile();
+
+        // first and second overlap. third only overlaps with them in the
+        // pass combining them, but a pass can not read and write the
+        // same memory.
+        m_graph.assign_memory({
+            requirements(0, 0), requirements(1024, 1),
+            requirements(1024, 1), requirements(1024, 1)
+        });
+        EXPECT_EQ(m_graph.get_memory_block_count(), 3);
+
+        // Incompatible memory types never share a block.
+        m_graph.assign_memory({
+            requirements(0, 0), requirements(1024, 0b01),
+            requirements(1024, 0b01), requirements(1024, 0b10)
+        });
+        EXPECT_EQ(m_graph.get_memory_block_count(), 3);
+    }
+
+    TEST_F(RenderGraphTests, execute_records_barriers_between_passes) {
+        RenderGraphResource intermediate = m_graph.import_image("intermediate",
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, ResourceState()
+        );
+        RenderGraphResource output = m_graph.import_image("output",
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, ResourceState()
+        );
+        m_graph.set_imported_image(intermediate, (VkImage) 1, nullptr);
+        m_graph.set_imported_image(output, (VkImage) 2, nullptr);
+
+        ::std::vector<uint32_t> recorded;
+        m_graph.add_pass("draw", [&recorded](const VkCommandBuffer&) {
+            recorded.emplace_back(0);
+        }).write(intermediate, m_colour_write);
+        m_graph.add_pass("post", [&recorded](const VkCommandBuffer&) {
+            recorded.emplace_back(1);
+        }).read(intermediate, m_sampled_read)
+            .write(output, m_colour_write);
+        m_graph.compile();
+
+        ResourceStateTracker tracker;
+        m_graph.execute(nullptr, tracker, fake_pipeline_barrier2);
+
+        const ::std::vector<uint32_t> expected_recorded = {0, 1};
+        EXPECT_EQ(recorded, expected_recorded);
+        // Two layout transitions out of undefined, then the
+        // colour attachment to shader read transition.
+        EXPECT_EQ(s_image_barrier_count, 3);
+        EXPECT_EQ(
+            tracker.get_image_state((VkImage) 1).get_layout(),
+            VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        );
+    }
+
+    TEST_F(RenderGraphTests, imported_images_end_in_their_final_state) {
+        RenderGraphResource output = m_graph.import_image("output",
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, ResourceState(),
+            ResourceState(
+                VkImageLayout::VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                VK_PIPELINE_STAGE_2_NONE_KHR, VK_ACCESS_2_NONE_KHR
+            )
+        );
+        m_graph.set_imported_image(output, (VkImage) 1, nullptr);
+
+        m_graph.add_pass("draw", [](const VkCommandBuffer&) {})
+            .write(output, m_colour_write);
+        m_graph.compile();
+
+        ResourceStateTracker tracker;
+        m_graph.execute(nullptr, tracker, fake_pipeline_barrier2);
+
+        // Out of undefined before the pass, then to the present layout.
+        EXPECT_EQ(s_image_barrier_count, 2);
+        EXPECT_EQ(
+            tracker.get_image_state((VkImage) 1).get_layout(),
+            VkImageLayout::VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+        );
+    }
+
+    TEST_F(RenderGraphTests, aliased_images_wait_on_the_previous_occupant) {
+        RenderGraphResource output = m_graph.import_image("output",
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, ResourceState()
+        );
+        m_graph.set_imported_image(output, (VkImage) 1, nullptr);
+        RenderGraphResource first = create_colour_image("first", 64);
+        RenderGraphResource second = create_colour_image("second", 64);
+
+        m_graph.add_pass("produce_first", [](const VkCommandBuffer&) {})
+            .write(first, m_colour_write);
+        m_graph.add_pass("consume_first", [](const VkCommandBuffer&) {})
+            .read(first, m_sampled_read)
+            .write(output, m_colour_write);
+        // A render pass that transitions second out of undefined itself.
+        m_graph.add_pass("produce_second", [](const VkCommandBuffer&) {})
+            .write(second,
+                ResourceState(
+                    VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+                ),
+                m_colour_write
+            );
+        m_graph.add_pass("consume_second", [](const VkCommandBuffer&) {})
+            .read(second, m_sampled_read)
+            .write(output, m_colour_write);
+        m_graph.compile();
+        m_graph.assign_memory({
+            requirements(0, 0), requirements(4096, 1), requirements(4096, 1)
+        });
+        ASSERT_EQ(
+            m_graph.get_memory_block(first), m_graph.get_memory_block(second)
+        );
+
+        ResourceStateTracker tracker;
+        m_graph.execute(nullptr, tracker, fake_pipeline_barrier2);
+
+        // No image barrier comes before the second image, but its writes
+        // still wait on the reads of the first one.
+        ASSERT_EQ(s_memory_barriers.size(), 1);
+        EXPECT_EQ(s_memory_barriers[0].srcStageMask,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR);
+        EXPECT_EQ(s_memory_barriers[0].dstStageMask,
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+        EXPECT_EQ(s_memory_barriers[0].dstAccessMask,
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "vk_tut/resource_state.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+
+namespace vk::tut {
+    // Resource state tracker test fixture.
+    class ResourceStateTests : public ::testing::Test {
+    protected:
+        // Runs before each test.
+        inline void SetUp() override {
+            s_call_count = 0;
+            s_image_barrier_count = 0;
+            s_buffer_barrier_count = 0;
+        }
+
+        // Stands in for vkCmdPipelineBarrier2KHR.
+        static VKAPI_ATTR void VKAPI_CALL fake_pipeline_barrier2(
+            VkCommandBuffer command_buffer,
+            const VkDependencyInfoKHR* ptr_dependency_info
+        ) {
+            s_call_count++;
+            s_image_barrier_count +=
+                ptr_dependency_info->imageMemoryBarrierCount;
+            s_buffer_barrier_count +=
+                ptr_dependency_info->bufferMemoryBarrierCount;
+            if (ptr_dependency_info->imageMemoryBarrierCount > 0) {
+                s_last_image_barrier =
+                    ptr_dependency_info->pImageMemoryBarriers[0];
+            }
+        }
+
+        // Fake handles. They are never dereferenced.
+        inline VkImage fake_image(const uintptr_t& value) {
+            return (VkImage) value;
+        }
+        inline VkBuffer fake_buffer(const uintptr_t& value) {
+            return (VkBuffer) value;
+        }
+
+        ResourceStateTracker m_tracker;
+
+        static inline uint32_t s_call_count = 0;
+        static inline uint32_t s_image_barrier_count = 0;
+        static inline uint32_t s_buffer_barrier_count = 0;
+        static inline VkImageMemoryBarrier2KHR s_last_image_barrier{};
+    };
+
+    TEST_F(ResourceStateTests, first_write_needs_no_barrier) {
+        m_tracker.require_buffer_state(fake_buffer(1), ResourceState(
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+        ));
+
+        EXPECT_EQ(m_tracker.get_pending_barrier_count(), 0);
+        m_tracker.flush(nullptr, fake_pipeline_barrier2);
+        EXPECT_EQ(s_call_count, 0);
+    }
+
+    TEST_F(ResourceStateTests, read_after_read_needs_no_barrier) {
+        const VkBuffer buffer = fake_buffer(1);
+        m_tracker.require_buffer_state(buffer, ResourceState(
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+        ));
+        m_tracker.require_buffer_state(buffer, ResourceState(
+            VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR,
+            VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR
+        ));
+        m_tracker.flush(nullptr, fake_pipeline_barrier2);
+        EXPECT_EQ(s_buffer_barrier_count, 1);
+
+        // Same stage and access again.
+        m_tracker.require_buffer_state(buffer, ResourceState(
+            VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR,
+            VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR
+        ));
+        EXPECT_EQ(m_tracker.get_pending_barrier_count(), 0);
+    }
+
+    TEST_F(ResourceStateTests, layout_change_records_barrier) {
+        const VkImage image = fake_image(1);
+        m_tracker.track_image(image,
+            VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT);
+        m_tracker.require_image_state(image, ResourceState(
+            VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+        ));
+        m_tracker.flush(nullptr, fake_pipeline_barrier2);
+
+        EXPECT_EQ(s_call_count, 1);
+        EXPECT_EQ(s_last_image_barrier.oldLayout,
+            VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED);
+        EXPECT_EQ(s_last_image_barrier.newLayout,
+            VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        m_tracker.require_image_state(image, ResourceState(
+            VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR
+        ));
+        m_tracker.flush(nullptr, fake_pipeline_barrier2);
+
+        EXPECT_EQ(s_call_count, 2);
+        // The copy has to be made available to the fragment shader.
+        EXPECT_EQ(s_last_image_barrier.srcStageMask,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR);
+        EXPECT_EQ(s_last_image_barrier.srcAccessMask,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        EXPECT_EQ(m_tracker.get_image_state(image).get_layout(),
+            VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    TEST_F(ResourceStateTests, write_after_read_waits_on_readers) {
+        const VkBuffer buffer = fake_buffer(1);
+        m_tracker.track_buffer(buffer, ResourceState(
+            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR,
+            VK_ACCESS_2_SHADER_READ_BIT_KHR
+        ));
+        m_tracker.require_buffer_state(buffer, ResourceState(
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+        ));
+
+        EXPECT_EQ(m_tracker.get_pending_barrier_count(), 1);
+    }
+
+    TEST_F(ResourceStateTests, barriers_are_batched) {
+        for (uintptr_t i = 1; i <= 16; i++) {
+            m_tracker.track_image(fake_image(i),
+                VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT);
+            m_tracker.require_image_state(fake_image(i), ResourceState(
+                VkImageLayout::VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+            ));
+        }
+        m_tracker.flush(nullptr, fake_pipeline_barrier2);
+
+        EXPECT_EQ(s_call_count, 1);
+        EXPECT_EQ(s_image_barrier_count, 16);
+        EXPECT_EQ(m_tracker.get_pending_barrier_count(), 0);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "vk_tut/scene_generator.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace vk::tut {
+    // Scene generation test fixture.
+    class SceneGeneratorTests : public ::testing::Test {
+    protected:
+        // Generates a scene with the given parameters into the members.
+        void generate(const SceneGenerator::Parameters& parameters) {
+            SceneGenerator generator(parameters);
+            m_texture_indices.clear();
+            for (uint32_t i = 0;
+            i < generator.get_parameters().texture_count; i++) {
+                m_texture_indices.push_back(10 + i);
+            }
+            generator.generate(
+                m_texture_indices, m_vertices, m_indices,
+                m_draw_commands, m_instances
+            );
+        }
+
+        ::std::vector<uint32_t> m_texture_indices;
+        ::std::vector<Vertex> m_vertices;
+        ::std::vector<uint32_t> m_indices;
+        ::std::vector<DrawCommand> m_draw_commands;
+        ::std::vector<InstanceTransform> m_instances;
+    };
+
+    TEST_F(SceneGeneratorTests, draws_cover_every_instance_once) {
+        SceneGenerator::Parameters parameters;
+        parameters.object_count = 100;
+        parameters.mesh_count = 4;
+        parameters.instances_per_draw = 8;
+        parameters.texture_count = 3;
+        generate(parameters);
+
+        ASSERT_EQ(m_instances.size(), 100);
+        ::std::vector<uint32_t> draw_counts(m_instances.size(), 0);
+        for (const DrawCommand& draw : m_draw_commands) {
+            EXPECT_GE(draw.get_instance_count(), 1);
+            EXPECT_LE(draw.get_instance_count(), 8);
+            ASSERT_LE(draw.get_first_instance() + draw.get_instance_count(),
+                m_instances.size());
+            for (uint32_t i = 0; i < draw.get_instance_count(); i++) {
+                draw_counts[draw.get_first_instance() + i]++;
+            }
+
+            EXPECT_GE(draw.get_texture_index(), 10);
+            EXPECT_LT(draw.get_texture_index(), 13);
+            EXPECT_LE(draw.get_first_index() + draw.get_index_count(),
+                m_indices.size());
+        }
+        for (const uint32_t& draw_count : draw_counts) {
+            EXPECT_EQ(draw_count, 1);
+        }
+    }
+
+    TEST_F(SceneGeneratorTests, one_instance_per_draw_draws_each_object) {
+        SceneGenerator::Parameters parameters;
+        parameters.object_count = 50;
+        generate(parameters);
+
+        EXPECT_EQ(m_draw_commands.size(), 50);
+        for (const uint32_t& index : m_indices) {
+            EXPECT_LT(index, m_vertices.size());
+        }
+    }
+
+    TEST_F(SceneGeneratorTests, animation_starts_from_generated_instances) {
+        SceneGenerator::Parameters parameters;
+        parameters.object_count = 20;
+        SceneGenerator generator(parameters);
+        generator.generate(
+            {0}, m_vertices, m_indices, m_draw_commands, m_instances
+        );
+
+        ::std::vector<InstanceTransform> animated(m_instances.size());
+        generator.animate(0.0f, m_instances, animated.data());
+        for (size_t i = 0; i < m_instances.size(); i++) {
+            const ::glm::vec4 rotation = m_instances[i].get_rotation();
+            const ::glm::vec4 animated_rotation = animated[i].get_rotation();
+            for (int j = 0; j < 4; j++) {
+                EXPECT_NEAR(animated_rotation[j], rotation[j], 1e-6f);
+            }
+        }
+
+        generator.animate(1.0f, m_instances, animated.data());
+        for (size_t i = 0; i < m_instances.size(); i++) {
+            const ::glm::vec4 position = m_instances[i].get_position_scale();
+            const ::glm::vec4 rotation = animated[i].get_rotation();
+            EXPECT_EQ(animated[i].get_position_scale(), position);
+            EXPECT_NEAR(::glm::dot(rotation, rotation), 1.0f, 1e-5f);
+        }
+    }
+
+    TEST_F(SceneGeneratorTests, counts_of_zero_count_as_one) {
+        SceneGenerator::Parameters parameters;
+        parameters.object_count = 0;
+        parameters.mesh_count = 0;
+        parameters.instances_per_draw = 0;
+        parameters.texture_count = 0;
+        generate(parameters);
+
+        EXPECT_EQ(m_instances.size(), 1);
+        EXPECT_EQ(m_draw_commands.size(), 1);
+    }
+
+    TEST_F(SceneGeneratorTests, missing_texture_slots_throw) {
+        SceneGenerator::Parameters parameters;
+        parameters.texture_count = 2;
+        SceneGenerator generator(parameters);
+
+        EXPECT_THROW(generator.generate(
+            {0}, m_vertices, m_indices, m_draw_commands, m_instances
+        ), ::std::runtime_error);
+    }
+
+    TEST_F(SceneGeneratorTests, textures_are_opaque_and_square) {
+        ::std::vector<uint8_t> pixels;
+        SceneGenerator::generate_texture(3, pixels);
+
+        const uint32_t size = SceneGenerator::TEXTURE_SIZE;
+        ASSERT_EQ(pixels.size(), size * size * 4);
+        for (size_t i = 3; i < pixels.size(); i += 4) {
+            EXPECT_EQ(pixels[i], 255);
+        }
+    }
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "vk_tut/logging.h"
 
 #include <gtest/gtest.h>
+#include <filesystem>
 #include <string>
 #include <iostream>
 #include <time.h>
@@ -0,0 +1,80 @@
+#include "vk_tut/trace.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace vk::tut {
+    // Trace buffer test fixture.
+    class TraceBufferTests : public ::testing::Test {
+    protected:
+        TraceBuffer m_buffer{7, 2};
+    };
+
+    TEST_F(TraceBufferTests, records_events_in_order) {
+        m_buffer.push("first", 10, 5);
+        m_buffer.push("second", 20, 1);
+
+        ASSERT_EQ(m_buffer.get_count(), 2);
+        EXPECT_STREQ(m_buffer.get_event(0).name, "first");
+        EXPECT_EQ(m_buffer.get_event(0).start_ns, 10);
+        EXPECT_EQ(m_buffer.get_event(0).duration_ns, 5);
+        EXPECT_STREQ(m_buffer.get_event(1).name, "second");
+        EXPECT_EQ(m_buffer.get_thread_id(), 7);
+    }
+
+    TEST_F(TraceBufferTests, drops_events_once_full) {
+        m_buffer.push("first", 0, 1);
+        m_buffer.push("second", 1, 1);
+        m_buffer.push("third", 2, 1);
+
+        EXPECT_EQ(m_buffer.get_count(), 2);
+        EXPECT_EQ(m_buffer.get_dropped_count(), 1);
+        EXPECT_STREQ(m_buffer.get_event(1).name, "second");
+
+        m_buffer.clear();
+        EXPECT_EQ(m_buffer.get_count(), 0);
+        EXPECT_EQ(m_buffer.get_dropped_count(), 0);
+    }
+
+    // Tracer test fixture.
+    class TracerTests : public ::testing::Test {
+    protected:
+        void SetUp() override { Tracer::get_instance().clear(); }
+        void TearDown() override { Tracer::get_instance().clear(); }
+    };
+
+    TEST_F(TracerTests, each_thread_records_into_its_own_buffer) {
+        TraceBuffer* ptr_main_buffer = &Tracer::get_instance()
+            .get_thread_buffer();
+        TraceBuffer* ptr_other_buffer = nullptr;
+        ::std::thread other([&]() {
+            { TraceScope scope("other"); }
+            ptr_other_buffer = &Tracer::get_instance().get_thread_buffer();
+        });
+        other.join();
+
+        ASSERT_NE(ptr_other_buffer, ptr_main_buffer);
+        EXPECT_NE(ptr_other_buffer->get_thread_id(),
+            ptr_main_buffer->get_thread_id());
+        EXPECT_EQ(ptr_other_buffer->get_count(), 1);
+        EXPECT_EQ(ptr_main_buffer->get_count(), 0);
+    }
+
+    TEST_F(TracerTests, writes_complete_events_as_chrome_trace) {
+        Tracer::get_instance().set_thread_name("main");
+        { TraceScope scope("draw_frame"); }
+
+        ::std::stringstream stream;
+        Tracer::get_instance().write_chrome_trace(stream);
+        const ::std::string trace = stream.str();
+
+        EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ms\",", 0), 0);
+        EXPECT_NE(trace.find("{\"name\":\"draw_frame\",\"ph\":\"X\","),
+            ::std::string::npos);
+        EXPECT_NE(trace.find("\"args\":{\"name\":\"main\"}"),
+            ::std::string::npos);
+        EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    }
+}
\ No newline at end of file